@@ -0,0 +1,71 @@
+#include "SkBenchmark.h"
+#include "SkAnimator.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkString.h"
+
+// a screenplay whose elements are moved and shown by formulas and conditions
+static void make_screenplay(SkString* xml, int count) {
+    xml->set("<screenplay>\n<float id='phase' value='0.25' />\n"
+             "<int id='limit' value='30' />\n");
+    for (int i = 0; i < count; i++) {
+        xml->appendf("<rect id='r%d' left='%d' top='%d' right='%d' bottom='%d' />\n",
+                     i, i * 3, i * 2, i * 3 + 10, i * 2 + 10);
+        xml->appendf("<group id='g%d' condition='r%d.top %% 7 &lt; 5 || phase &gt; 0.5'>",
+                     i, i);
+        xml->appendf("<add use='r%d' /></group>\n", i);
+        xml->appendf("<apply scope='g%d'>\n", i);
+        xml->appendf("<animate target='r%d' field='left' dur='100000' ", i);
+        xml->appendf("formula='(phase * 40 + r%d.top / 2 + (r%d.right - r%d.left) * 0.5) %% limit' />\n",
+                     i, i, i);
+        xml->appendf("<animate target='r%d' field='bottom' dur='100000' ", i);
+        xml->appendf("formula='r%d.top + 10 + (phase &gt; 0.2 ? limit / 3 : 1)' />\n", i);
+        xml->append("</apply>\n");
+    }
+    xml->append("</screenplay>");
+}
+
+class AnimatorBench : public SkBenchmark {
+    SkAnimator fAnimator;
+    SkString fName;
+    SkMSec fTime;
+    bool fValid;
+    enum { COUNT = 40, N = 10 };
+public:
+    AnimatorBench(void* param, bool compile) : SkBenchmark(param) {
+        fName.printf("animator_formulas_%s", compile ? "compiled" : "interpreted");
+        fTime = 0;
+        fAnimator.setCompileScripts(compile);
+        SkString xml;
+        make_screenplay(&xml, COUNT);
+        fValid = fAnimator.decodeMemory(xml.c_str(), xml.size());
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        if (!fValid) {
+            return;
+        }
+        SkPaint paint;
+        this->setupPaint(&paint);
+        for (int i = 0; i < N; i++) {
+            fAnimator.setScalar("phase", "value",
+                                SkIntToScalar(fTime % 10) / 10);
+            fAnimator.draw(canvas, &paint, fTime * 10);
+            fTime += 1;
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new AnimatorBench(p, false); }
+static SkBenchmark* Fact1(void* p) { return new AnimatorBench(p, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
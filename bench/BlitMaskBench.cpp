@@ -0,0 +1,94 @@
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkMask.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// LCD glyph masks blitted the way text draws them, one glyph at a time
+class BlitMaskBench : public SkBenchmark {
+public:
+    BlitMaskBench(void* param, SkBitmap::Config config, SkMask::Format format,
+                  SkColor color) : INHERITED(param) {
+        fName.printf("blitmask_%s_%s_%s",
+                     SkBitmap::kARGB_8888_Config == config ? "8888" : "565",
+                     SkMask::kLCD16_Format == format ? "lcd16" : "lcd32",
+                     0xFF == SkColorGetA(color) ? "opaque" : "blend");
+        fPaint.setColor(color);
+
+        fDevice.setConfig(config, kW * kCols, kH * kRows);
+        fDevice.allocPixels();
+        fDevice.eraseColor(SK_ColorWHITE);
+
+        // roughly a glyph: empty margins, full strokes, partial edges
+        size_t bpp = SkMask::kLCD16_Format == format ? sizeof(uint16_t)
+                                                     : sizeof(uint32_t);
+        fMask.fImage = (uint8_t*)fStorage.alloc(kW * kH * bpp);
+        fMask.fBounds.set(0, 0, kW, kH);
+        fMask.fRowBytes = kW * bpp;
+        fMask.fFormat = format;
+        SkRandom rand;
+        for (int i = 0; i < kW * kH; i++) {
+            int x = i % kW;
+            uint32_t m;
+            if (x < 2 || x >= kW - 2) {
+                m = 0;
+            } else if (x == 5 || x == 6) {
+                m = 0xFFFFFFFF;
+            } else {
+                m = rand.nextU();
+            }
+            if (SkMask::kLCD16_Format == format) {
+                ((uint16_t*)fMask.fImage)[i] = (uint16_t)m;
+            } else {
+                ((uint32_t*)fMask.fImage)[i] = m;
+            }
+        }
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkBlitter* blitter = SkBlitter::Choose(fDevice, SkMatrix::I(), fPaint);
+        for (int i = 0; i < N; i++) {
+            for (int y = 0; y < kRows; y++) {
+                for (int x = 0; x < kCols; x++) {
+                    fMask.fBounds.set(x * kW, y * kH, (x + 1) * kW, (y + 1) * kH);
+                    blitter->blitMask(fMask, fMask.fBounds);
+                }
+            }
+        }
+        delete blitter;
+    }
+
+private:
+    enum {
+        N = 20,
+        kW = 11,
+        kH = 14,
+        kCols = 40,
+        kRows = 20
+    };
+    SkString            fName;
+    SkPaint             fPaint;
+    SkBitmap            fDevice;
+    SkMask              fMask;
+    SkAutoMalloc        fStorage;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new BlitMaskBench(p, SkBitmap::kARGB_8888_Config, SkMask::kLCD16_Format, SK_ColorBLACK); }
+static SkBenchmark* Fact1(void* p) { return new BlitMaskBench(p, SkBitmap::kARGB_8888_Config, SkMask::kLCD16_Format, 0x80336699); }
+static SkBenchmark* Fact2(void* p) { return new BlitMaskBench(p, SkBitmap::kARGB_8888_Config, SkMask::kLCD32_Format, SK_ColorBLACK); }
+static SkBenchmark* Fact3(void* p) { return new BlitMaskBench(p, SkBitmap::kRGB_565_Config, SkMask::kLCD16_Format, SK_ColorBLACK); }
+static SkBenchmark* Fact4(void* p) { return new BlitMaskBench(p, SkBitmap::kRGB_565_Config, SkMask::kLCD32_Format, 0x80336699); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
+static BenchRegistry gReg4(Fact4);
@@ -0,0 +1,112 @@
+#include "SkBenchmark.h"
+#include "SkColorFilterProcs.h"
+#include "SkColorMatrixFilter.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+/*  Runs a filter's spans directly, with and without the platform procs, so the
+    two can be compared on the same machine.
+ */
+class ColorFilterBench : public SkBenchmark {
+public:
+    ColorFilterBench(void* param, const char name[], SkColorFilter* cf,
+                     bool use16, bool usePlatform)
+            : INHERITED(param), fFilter(cf), fUse16(use16),
+              fUsePlatform(usePlatform) {
+        fName.printf("colorfilter_%s%s_%s", name, use16 ? "_16" : "",
+                     usePlatform ? "platform" : "portable");
+        SkRandom rand;
+        for (int i = 0; i < W; i++) {
+            fSrc[i] = SkPreMultiplyARGB(rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                        rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+            fSrc16[i] = rand.nextU() & 0xFFFF;
+        }
+    }
+
+    virtual ~ColorFilterBench() {
+        fFilter->unref();
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkColorFilterProcs::SetUsePlatformProcs(fUsePlatform);
+        for (int i = 0; i < N; i++) {
+            if (fUse16) {
+                fFilter->filterSpan16(fSrc16, W, fDst16);
+            } else {
+                fFilter->filterSpan(fSrc, W, fDst);
+            }
+        }
+        SkColorFilterProcs::SetUsePlatformProcs(true);
+    }
+
+private:
+    enum {
+        N = 1000,
+        W = 640
+    };
+    SkColorFilter*  fFilter;
+    bool            fUse16;
+    bool            fUsePlatform;
+    SkString        fName;
+    SkPMColor       fSrc[W];
+    SkPMColor       fDst[W];
+    uint16_t        fSrc16[W];
+    uint16_t        fDst16[W];
+
+    typedef SkBenchmark INHERITED;
+};
+
+static SkColorFilter* make_desaturate() {
+    SkColorMatrix cm;
+    cm.setSaturation(0);
+    return new SkColorMatrixFilter(cm);
+}
+
+static SkColorFilter* make_sepia() {
+    static const SkScalar gSepia[20] = {
+        SkFloatToScalar(0.393f), SkFloatToScalar(0.769f), SkFloatToScalar(0.189f), 0, 0,
+        SkFloatToScalar(0.349f), SkFloatToScalar(0.686f), SkFloatToScalar(0.168f), 0, 0,
+        SkFloatToScalar(0.272f), SkFloatToScalar(0.534f), SkFloatToScalar(0.131f), 0, 0,
+        0, 0, 0, SK_Scalar1, 0
+    };
+    return new SkColorMatrixFilter(gSepia);
+}
+
+static SkColorFilter* make_brightness() {
+    SkColorMatrix cm;
+    cm.setIdentity();
+    cm.fMat[4] = cm.fMat[9] = cm.fMat[14] = SkIntToScalar(40);
+    return new SkColorMatrixFilter(cm);
+}
+
+static SkColorFilter* make_lighting() {
+    return SkColorFilter::CreateLightingFilter(0xC0E0FF, 0x402010);
+}
+
+static SkBenchmark* Fact0(void* p) { return new ColorFilterBench(p, "desaturate", make_desaturate(), false, false); }
+static SkBenchmark* Fact1(void* p) { return new ColorFilterBench(p, "desaturate", make_desaturate(), false, true); }
+static SkBenchmark* Fact2(void* p) { return new ColorFilterBench(p, "sepia", make_sepia(), false, false); }
+static SkBenchmark* Fact3(void* p) { return new ColorFilterBench(p, "sepia", make_sepia(), false, true); }
+static SkBenchmark* Fact4(void* p) { return new ColorFilterBench(p, "brightness", make_brightness(), false, false); }
+static SkBenchmark* Fact5(void* p) { return new ColorFilterBench(p, "brightness", make_brightness(), false, true); }
+static SkBenchmark* Fact6(void* p) { return new ColorFilterBench(p, "desaturate", make_desaturate(), true, false); }
+static SkBenchmark* Fact7(void* p) { return new ColorFilterBench(p, "desaturate", make_desaturate(), true, true); }
+static SkBenchmark* Fact8(void* p) { return new ColorFilterBench(p, "lighting", make_lighting(), false, false); }
+static SkBenchmark* Fact9(void* p) { return new ColorFilterBench(p, "lighting", make_lighting(), false, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
+static BenchRegistry gReg4(Fact4);
+static BenchRegistry gReg5(Fact5);
+static BenchRegistry gReg6(Fact6);
+static BenchRegistry gReg7(Fact7);
+static BenchRegistry gReg8(Fact8);
+static BenchRegistry gReg9(Fact9);
@@ -0,0 +1,109 @@
+#include "SkBenchmark.h"
+#include "SkDOM.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+// a view layout: nested containers of widgets with a handful of attributes
+static void make_document(SkString* xml) {
+    SkRandom rand;
+    xml->set("<screen id='main' width='480' height='800'>\n");
+    for (int c = 0; c < 20; c++) {
+        xml->appendf("<container id='c%d' layout='stack' orient='vert'>\n", c);
+        for (int w = 0; w < 10; w++) {
+            xml->appendf("<widget id='w%d_%d' x='%u' y='%u' width='%u' height='%u' ",
+                         c, w, rand.nextU() % 480, rand.nextU() % 800,
+                         rand.nextU() % 100, rand.nextU() % 40);
+            xml->appendf("color='#%06X' text='Label &amp; value %d' />\n",
+                         rand.nextU() & 0xFFFFFF, w);
+        }
+        xml->append("</container>\n");
+    }
+    xml->append("</screen>");
+}
+
+class DOMBench : public SkBenchmark {
+public:
+    enum Mode {
+        kParse_Mode,        // SkXMLParser, every string copied
+        kParseInPlace_Mode, // scanned from a memory stream, only values copied
+        kFindName_Mode,     // attribute lookups by name
+        kFindAtom_Mode      // attribute lookups by atom
+    };
+
+    DOMBench(void* param, Mode mode) : INHERITED(param), fMode(mode) {
+        static const char* gNames[] = {
+            "parse", "parse_in_place", "find_name", "find_atom"
+        };
+        fName.printf("dom_%s", gNames[mode]);
+        make_document(&fDocument);
+        fStream.setMemory(fDocument.c_str(), fDocument.size());
+        fDOM.build(fStream);
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        for (int i = 0; i < N; i++) {
+            switch (fMode) {
+                case kParse_Mode: {
+                    SkDOM dom;
+                    dom.build(fDocument.c_str(), fDocument.size());
+                } break;
+                case kParseInPlace_Mode: {
+                    SkDOM dom;
+                    dom.build(fStream);
+                } break;
+                default:
+                    this->findAttrs();
+                    break;
+            }
+        }
+    }
+
+private:
+    void findAttrs() {
+        static const char* gAttrs[] = { "x", "y", "width", "height", "color" };
+        const SkDOM::Node* root = fDOM.getRootNode();
+        if (NULL == root) {
+            return;
+        }
+        SkDOM::Atom atoms[SK_ARRAY_COUNT(gAttrs)];
+        for (size_t i = 0; i < SK_ARRAY_COUNT(gAttrs); i++) {
+            atoms[i] = fDOM.findAtom(gAttrs[i]);
+        }
+        size_t length;
+        for (const SkDOM::Node* c = fDOM.getFirstChild(root); c; c = fDOM.getNextSibling(c)) {
+            for (const SkDOM::Node* w = fDOM.getFirstChild(c); w; w = fDOM.getNextSibling(w)) {
+                for (size_t i = 0; i < SK_ARRAY_COUNT(gAttrs); i++) {
+                    if (kFindName_Mode == fMode) {
+                        fDOM.findAttr(w, gAttrs[i]);
+                    } else {
+                        fDOM.findAttr(w, atoms[i], &length);
+                    }
+                }
+            }
+        }
+    }
+
+    enum { N = 10 };
+    Mode            fMode;
+    SkString        fDocument;
+    SkMemoryStream  fStream;
+    SkDOM           fDOM;
+    SkString        fName;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new DOMBench(p, DOMBench::kParse_Mode); }
+static SkBenchmark* Fact1(void* p) { return new DOMBench(p, DOMBench::kParseInPlace_Mode); }
+static SkBenchmark* Fact2(void* p) { return new DOMBench(p, DOMBench::kFindName_Mode); }
+static SkBenchmark* Fact3(void* p) { return new DOMBench(p, DOMBench::kFindAtom_Mode); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
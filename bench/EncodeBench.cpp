@@ -0,0 +1,69 @@
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+static const char* gTypeName[] = {
+    "jpeg", "png"
+};
+
+class EncodeBench : public SkBenchmark {
+    SkImageEncoder::Type fType;
+    int fThreadCount;
+    SkBitmap fBitmap;
+    SkString fName;
+    enum { W = 1024, H = 768, N = 2 };
+public:
+    EncodeBench(void* param, SkImageEncoder::Type type, int threadCount)
+            : SkBenchmark(param) {
+        fType = type;
+        fThreadCount = threadCount;
+        fName.printf("encode_%s_%d", gTypeName[type], threadCount);
+
+        // a noisy gradient, so the encoders have some work to do
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, W, H);
+        fBitmap.allocPixels();
+        SkRandom rand;
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                *fBitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x * 255 / W,
+                                        y * 255 / H, rand.nextU() & 0x1F);
+            }
+        }
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkImageEncoder* encoder = SkImageEncoder::Create(fType);
+        if (NULL == encoder) {
+            return;
+        }
+        encoder->setThreadCount(fThreadCount);
+        for (int i = 0; i < N; i++) {
+            SkDynamicMemoryWStream stream;
+            encoder->encodeStream(&stream, fBitmap,
+                                  SkImageEncoder::kDefaultQuality);
+        }
+        delete encoder;
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new EncodeBench(p, SkImageEncoder::kPNG_Type, 1); }
+static SkBenchmark* Fact1(void* p) { return new EncodeBench(p, SkImageEncoder::kPNG_Type, 4); }
+static SkBenchmark* Fact2(void* p) { return new EncodeBench(p, SkImageEncoder::kJPEG_Type, 1); }
+static SkBenchmark* Fact3(void* p) { return new EncodeBench(p, SkImageEncoder::kJPEG_Type, 4); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
@@ -0,0 +1,96 @@
+#include "SkBenchmark.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkLayerRasterizer.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+#include "SkXfermode.h"
+
+class LayerRasterizerBench : public SkBenchmark {
+public:
+    enum Mode {
+        kShadow_Mode,   // offset copies of one fill, differing in alpha
+        kBlur_Mode,     // a blurred glow under the fill
+        kEngrave_Mode   // layers that have to be drawn one by one
+    };
+
+    LayerRasterizerBench(void* param, Mode mode) : INHERITED(param), fMode(mode) {
+        static const char* gNames[] = { "shadow", "blur", "engrave" };
+        fName.printf("layerrasterizer_%s", gNames[mode]);
+
+        fPath.addCircle(SkIntToScalar(40), SkIntToScalar(40), SkIntToScalar(30));
+        fPath.addCircle(SkIntToScalar(40), SkIntToScalar(40), SkIntToScalar(20),
+                        SkPath::kCCW_Direction);
+        fRast = new SkLayerRasterizer;
+
+        SkPaint p;
+        p.setAntiAlias(true);
+        switch (mode) {
+            case kShadow_Mode:
+                for (int i = 4; i > 0; i--) {
+                    p.setAlpha(0x100 / (i + 1));
+                    fRast->addLayer(p, SkIntToScalar(i), SkIntToScalar(i));
+                }
+                p.setAlpha(0xFF);
+                fRast->addLayer(p);
+                break;
+            case kBlur_Mode:
+                p.setAlpha(0x80);
+                SkSafeUnref(p.setMaskFilter(SkBlurMaskFilter::Create(
+                        SkIntToScalar(3), SkBlurMaskFilter::kNormal_BlurStyle)));
+                fRast->addLayer(p, SkIntToScalar(3), SkIntToScalar(3));
+                fRast->addLayer(p, -SkIntToScalar(3), -SkIntToScalar(3));
+                p.setAlpha(0xFF);
+                p.setMaskFilter(NULL);
+                fRast->addLayer(p);
+                break;
+            case kEngrave_Mode:
+                p.setAlpha(0x80);
+                fRast->addLayer(p, SK_Scalar1 / 2, SK_Scalar1 / 2);
+                p.setAlpha(0xFF);
+                fRast->addLayer(p);
+                p.setStyle(SkPaint::kStroke_Style);
+                p.setXfermode(SkXfermode::Create(SkXfermode::kClear_Mode))->unref();
+                fRast->addLayer(p);
+                break;
+        }
+    }
+
+    virtual ~LayerRasterizerBench() {
+        fRast->unref();
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkMatrix matrix;
+        SkMask mask;
+        matrix.reset();
+        for (int i = 0; i < N; i++) {
+            if (fRast->rasterize(fPath, matrix, NULL, NULL, &mask,
+                                 SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
+                SkMask::FreeImage(mask.fImage);
+            }
+        }
+    }
+
+private:
+    enum { N = 100 };
+    Mode                fMode;
+    SkPath              fPath;
+    SkLayerRasterizer*  fRast;
+    SkString            fName;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new LayerRasterizerBench(p, LayerRasterizerBench::kShadow_Mode); }
+static SkBenchmark* Fact1(void* p) { return new LayerRasterizerBench(p, LayerRasterizerBench::kBlur_Mode); }
+static SkBenchmark* Fact2(void* p) { return new LayerRasterizerBench(p, LayerRasterizerBench::kEngrave_Mode); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
@@ -0,0 +1,189 @@
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+#include "SkString.h"
+
+/*  Large, sparse antialiased fills in the style of GIS map layers: a fractal
+    coastline with islands and lakes, and a scattering of small land parcels
+    crossed by long, thin rivers. These span the whole (large) canvas, but
+    only touch a small fraction of its pixels. The "scroll" variants draw
+    each frame shifted by a few whole pixels, as when panning the map, and
+    the "banded" ones fill each path as 4 concurrent bands of rows.
+ */
+
+enum {
+    kMapSize = 2048
+};
+
+// like tiled map data, coordinates are quantized (here to 1/16 of a pixel)
+static SkScalar snap(SkScalar x) {
+    return SkIntToScalar(SkScalarRound(x * 16)) / 16;
+}
+
+// recursively displace the midpoint of each segment, like a coastline
+static void add_fractal_edge(SkPath* path, SkRandom* rand,
+                             const SkPoint& p0, const SkPoint& p1, int depth) {
+    if (0 == depth) {
+        path->lineTo(snap(p1.fX), snap(p1.fY));
+        return;
+    }
+    SkScalar dx = p1.fX - p0.fX;
+    SkScalar dy = p1.fY - p0.fY;
+    SkScalar t = SkScalarMul(rand->nextSScalar1(), SK_Scalar1 / 4);
+    SkPoint mid;
+    mid.set(SkScalarAve(p0.fX, p1.fX) - SkScalarMul(dy, t),
+            SkScalarAve(p0.fY, p1.fY) + SkScalarMul(dx, t));
+    add_fractal_edge(path, rand, p0, mid, depth - 1);
+    add_fractal_edge(path, rand, mid, p1, depth - 1);
+}
+
+static void add_fractal_polygon(SkPath* path, SkRandom* rand, SkScalar cx,
+                                SkScalar cy, SkScalar radius, int depth) {
+    static const int kSides = 7;
+    SkPoint pts[kSides];
+    for (int i = 0; i < kSides; i++) {
+        SkScalar cos;
+        SkScalar sin = SkScalarSinCos(SK_ScalarPI * 2 * i / kSides, &cos);
+        pts[i].set(snap(cx + SkScalarMul(radius, cos)),
+                   snap(cy + SkScalarMul(radius, sin)));
+    }
+    path->moveTo(pts[0]);
+    for (int i = 0; i < kSides; i++) {
+        add_fractal_edge(path, rand, pts[i], pts[(i + 1) % kSides], depth);
+    }
+    path->close();
+}
+
+class MapPathBench : public SkBenchmark {
+    SkPath      fPath;
+    SkString    fName;
+    const char* fType;
+    bool        fScroll;
+    bool        fTiled;
+    int         fBands;
+public:
+    MapPathBench(void* param, const char type[], bool scroll = false,
+                 bool tiled = false, int bands = 1)
+            : INHERITED(param), fType(type), fScroll(scroll), fTiled(tiled)
+            , fBands(bands) {
+        SkRandom rand;
+        const SkScalar size = SkIntToScalar(kMapSize);
+
+        fPath.setFillType(SkPath::kEvenOdd_FillType);
+        if (!strcmp(type, "coastline")) {
+            add_fractal_polygon(&fPath, &rand, size / 2, size / 2,
+                                size * 9 / 20, 9);
+            for (int i = 0; i < 40; i++) {
+                add_fractal_polygon(&fPath, &rand,
+                                    SkScalarMul(rand.nextUScalar1(), size),
+                                    SkScalarMul(rand.nextUScalar1(), size),
+                                    SkIntToScalar(10 + (rand.nextU() % 60)), 5);
+            }
+        } else {
+            for (int i = 0; i < 5000; i++) {
+                SkScalar x = snap(SkScalarMul(rand.nextUScalar1(), size));
+                SkScalar y = snap(SkScalarMul(rand.nextUScalar1(), size));
+                SkScalar w = SkIntToScalar(3 + (rand.nextU() % 10));
+                SkScalar h = SkIntToScalar(3 + (rand.nextU() % 10));
+                fPath.moveTo(x, y);
+                fPath.lineTo(x + w, snap(y + h / 4));
+                fPath.lineTo(snap(x + w - w / 5), y + h);
+                fPath.lineTo(snap(x - w / 6), snap(y + h - h / 5));
+                fPath.close();
+            }
+            for (int i = 0; i < 6; i++) {
+                SkScalar y = snap(SkScalarMul(rand.nextUScalar1(), size));
+                SkScalar width = SkIntToScalar(2 + (rand.nextU() % 4));
+                SkScalar bank[kMapSize / 64 + 1];
+                for (int j = 0; j <= kMapSize / 64; j++) {
+                    bank[j] = y;
+                    y += SkIntToScalar((int)(rand.nextU() % 41) - 20);
+                }
+                fPath.moveTo(0, bank[0]);
+                for (int j = 1; j <= kMapSize / 64; j++) {
+                    fPath.lineTo(SkIntToScalar(j * 64), bank[j]);
+                }
+                for (int j = kMapSize / 64; j >= 0; j--) {
+                    fPath.lineTo(SkIntToScalar(j * 64), bank[j] + width);
+                }
+                fPath.close();
+            }
+        }
+    }
+
+protected:
+    virtual const char* onGetName() {
+        fName.printf("map_%s", fType);
+        if (fScroll) {
+            fName.append("_scroll");
+        }
+        if (fTiled) {
+            fName.append("_tiled");
+        }
+        if (fBands > 1) {
+            fName.append("_banded");
+        }
+        return fName.c_str();
+    }
+
+    virtual SkIPoint onGetSize() {
+        return SkIPoint::Make(kMapSize, kMapSize);
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setColor(0xFF336699);
+
+        bool useTiled = SkScan::SetUseTiledAA(fTiled);
+        int threadCount = SkGraphics::GetFillPathThreadCount();
+        SkGraphics::SetFillPathThreadCount(fBands);
+        for (int i = 0; i < 4; i++) {
+            if (fScroll) {
+                canvas->translate(SkIntToScalar(3), SkIntToScalar(-5));
+            }
+            canvas->drawPath(fPath, paint);
+        }
+        SkGraphics::SetFillPathThreadCount(threadCount);
+        SkScan::SetUseTiledAA(useTiled);
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new MapPathBench(p, "coastline"); }
+static SkBenchmark* Fact1(void* p) { return new MapPathBench(p, "parcels"); }
+static SkBenchmark* Fact2(void* p) {
+    return new MapPathBench(p, "coastline", true);
+}
+static SkBenchmark* Fact3(void* p) {
+    return new MapPathBench(p, "parcels", true);
+}
+
+static SkBenchmark* Fact4(void* p) {
+    return new MapPathBench(p, "coastline", false, true);
+}
+static SkBenchmark* Fact5(void* p) {
+    return new MapPathBench(p, "parcels", false, true);
+}
+
+static SkBenchmark* Fact6(void* p) {
+    return new MapPathBench(p, "coastline", false, false, 4);
+}
+static SkBenchmark* Fact7(void* p) {
+    return new MapPathBench(p, "parcels", false, false, 4);
+}
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
+static BenchRegistry gReg4(Fact4);
+static BenchRegistry gReg5(Fact5);
+static BenchRegistry gReg6(Fact6);
+static BenchRegistry gReg7(Fact7);
@@ -256,6 +256,74 @@ private:
     typedef MatrixBench INHERITED;
 };
 
+// Maps kCount points through mapPoints(), which dispatches on the matrix type
+// (and may be vectorized). With N loops that is 10 million points per draw, so
+// the throughput in millions of points per second is 10000 / ms.
+class MapPointsMatrixBench : public MatrixBench {
+public:
+    MapPointsMatrixBench(void* param, const char name[], const SkMatrix& m)
+            : INHERITED(param, name), fMatrix(m) {
+        SkRandom rand;
+        for (int i = 0; i < kCount; i++) {
+            fSrc[i].set(SkScalarMul(rand.nextSScalar1(), SkIntToScalar(1000)),
+                        SkScalarMul(rand.nextSScalar1(), SkIntToScalar(1000)));
+        }
+        // compute the type now, rather than on the first timed loop
+        (void)fMatrix.getType();
+    }
+protected:
+    virtual void performTest() {
+        fMatrix.mapPoints(fDst, fSrc, kCount);
+    }
+private:
+    enum { kCount = 100 };
+    SkMatrix fMatrix;
+    SkPoint  fSrc[kCount];
+    SkPoint  fDst[kCount];
+    typedef MatrixBench INHERITED;
+};
+
+static SkBenchmark* make_mappoints(void* p, const char name[],
+                                   const SkMatrix& m) {
+    SkString str;
+    str.printf("mappoints_%s", name);
+    return new MapPointsMatrixBench(p, str.c_str(), m);
+}
+
+static SkBenchmark* MP0(void* p) {
+    SkMatrix m;
+    m.setTranslate(SkIntToScalar(7), -SkIntToScalar(3));
+    return make_mappoints(p, "trans", m);
+}
+static SkBenchmark* MP1(void* p) {
+    SkMatrix m;
+    m.setScale(SkIntToScalar(3), SK_Scalar1/2);
+    return make_mappoints(p, "scale", m);
+}
+static SkBenchmark* MP2(void* p) {
+    SkMatrix m;
+    m.setScale(SkIntToScalar(3), SK_Scalar1/2);
+    m.postTranslate(SkIntToScalar(7), -SkIntToScalar(3));
+    return make_mappoints(p, "scaletrans", m);
+}
+static SkBenchmark* MP3(void* p) {
+    SkMatrix m;
+    m.setRotate(SkIntToScalar(30));
+    return make_mappoints(p, "rotate", m);
+}
+static SkBenchmark* MP4(void* p) {
+    SkMatrix m;
+    m.setRotate(SkIntToScalar(30), SkIntToScalar(50), SkIntToScalar(70));
+    return make_mappoints(p, "rotatetrans", m);
+}
+static SkBenchmark* MP5(void* p) {
+    SkMatrix m;
+    m.setRotate(SkIntToScalar(30), SkIntToScalar(50), SkIntToScalar(70));
+    m.setPerspX(SK_Scalar1/1000);
+    m.setPerspY(SK_Scalar1/2000);
+    return make_mappoints(p, "persp", m);
+}
+
 #ifdef SK_SCALAR_IS_FLOAT
 class ScaleTransMixedMatrixBench : public MatrixBench {
  public:
@@ -353,6 +421,13 @@ static BenchRegistry gReg3(M3);
 static BenchRegistry gReg4(M4);
 static BenchRegistry gReg5(M5);
 
+static BenchRegistry gMPReg0(MP0);
+static BenchRegistry gMPReg1(MP1);
+static BenchRegistry gMPReg2(MP2);
+static BenchRegistry gMPReg3(MP3);
+static BenchRegistry gMPReg4(MP4);
+static BenchRegistry gMPReg5(MP5);
+
 #ifdef SK_SCALAR_IS_FLOAT
 static SkBenchmark* FlM0(void* p) { return new ScaleTransMixedMatrixBench(p); }
 static SkBenchmark* FlM1(void* p) { return new ScaleTransDoubleMatrixBench(p); }
@@ -0,0 +1,63 @@
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkColor.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkString.h"
+
+/*  Records a picture of many draws, each with its own paint and matrix, so
+    that recording time is dominated by looking up the flattened paints and
+    matrices seen so far. The "repeat" variant cycles through a few paints,
+    so most lookups find an existing entry.
+ */
+class PictureRecordBench : public SkBenchmark {
+    SkString    fName;
+    bool        fRepeat;
+
+    enum {
+        N = 2000
+    };
+public:
+    PictureRecordBench(void* param, bool repeat)
+            : INHERITED(param), fRepeat(repeat) {
+        fName.printf("picture_record_%s", repeat ? "repeat" : "unique");
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkRect r;
+        r.set(0, 0, SkIntToScalar(10), SkIntToScalar(10));
+
+        SkPicture picture;
+        SkCanvas* canvas = picture.beginRecording(100, 100);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < N; i++) {
+            int key = fRepeat ? (i & 15) : i;
+            paint.setColor(SkColorSetARGB(0xFF, key, key >> 8, 0x80));
+            paint.setStrokeWidth(SkIntToScalar(key) / 64);
+
+            SkMatrix matrix;
+            matrix.setTranslate(SkIntToScalar(key % 100),
+                                SkIntToScalar(key / 100) / 20);
+            canvas->save(SkCanvas::kMatrix_SaveFlag);
+            canvas->concat(matrix);
+            canvas->drawRect(r, paint);
+            canvas->restore();
+        }
+        picture.endRecording();
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new PictureRecordBench(p, false); }
+static SkBenchmark* Fact1(void* p) { return new PictureRecordBench(p, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
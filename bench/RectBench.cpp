@@ -121,6 +121,57 @@ protected:
     virtual const char* onGetName() { return fName; }
 };
 
+/*  Draws many tiny rects (or sprites of a tiny bitmap) with one paint, either
+    one call at a time or batched into a single drawRects (drawSprites) call,
+    so that the per-call setup dominates.
+ */
+class BatchBench : public RectBench {
+public:
+    bool        fBatch;
+    bool        fSprites;
+    SkBitmap    fBitmap;
+    SkIPoint    fPts[N];
+
+    BatchBench(void* param, bool batch, bool sprites)
+            : RectBench(param, 6), fBatch(batch), fSprites(sprites) {
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, 8, 8);
+        fBitmap.allocPixels();
+        fBitmap.eraseColor(0xFF336699);
+        for (int i = 0; i < N; i++) {
+            fPts[i].set(SkScalarRound(fRects[i].fLeft),
+                        SkScalarRound(fRects[i].fTop));
+        }
+    }
+
+protected:
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setColor(fColors[0]);
+        if (fBatch) {
+            if (fSprites) {
+                canvas->drawSprites(fBitmap, fPts, N, &paint);
+            } else {
+                canvas->drawRects(fRects, N, paint);
+            }
+        } else {
+            for (int i = 0; i < N; i++) {
+                if (fSprites) {
+                    canvas->drawSprite(fBitmap, fPts[i].fX, fPts[i].fY, &paint);
+                } else {
+                    canvas->drawRect(fRects[i], paint);
+                }
+            }
+        }
+    }
+
+    virtual const char* onGetName() {
+        fName.printf("%s_%s", fSprites ? "sprites" : "rects",
+                     fBatch ? "batch" : "single");
+        return fName.c_str();
+    }
+};
+
 /*******************************************************************************
  * to bench BlitMask [Opaque, Black, color, shader]
  *******************************************************************************/
@@ -208,6 +259,18 @@ static SkBenchmark* OvalFactory1(void* p) { return SkNEW_ARGS(OvalBench, (p, 1))
 static SkBenchmark* OvalFactory2(void* p) { return SkNEW_ARGS(OvalBench, (p, 3)); }
 static SkBenchmark* RRectFactory1(void* p) { return SkNEW_ARGS(RRectBench, (p, 1)); }
 static SkBenchmark* RRectFactory2(void* p) { return SkNEW_ARGS(RRectBench, (p, 3)); }
+static SkBenchmark* RectSingleFactory(void* p) {
+    return SkNEW_ARGS(BatchBench, (p, false, false));
+}
+static SkBenchmark* RectBatchFactory(void* p) {
+    return SkNEW_ARGS(BatchBench, (p, true, false));
+}
+static SkBenchmark* SpriteSingleFactory(void* p) {
+    return SkNEW_ARGS(BatchBench, (p, false, true));
+}
+static SkBenchmark* SpriteBatchFactory(void* p) {
+    return SkNEW_ARGS(BatchBench, (p, true, true));
+}
 static SkBenchmark* PointsFactory(void* p) {
     return SkNEW_ARGS(PointsBench, (p, SkCanvas::kPoints_PointMode, "points"));
 }
@@ -253,6 +316,10 @@ static BenchRegistry gOvalReg1(OvalFactory1);
 static BenchRegistry gOvalReg2(OvalFactory2);
 static BenchRegistry gRRectReg1(RRectFactory1);
 static BenchRegistry gRRectReg2(RRectFactory2);
+static BenchRegistry gRectSingleReg(RectSingleFactory);
+static BenchRegistry gRectBatchReg(RectBatchFactory);
+static BenchRegistry gSpriteSingleReg(SpriteSingleFactory);
+static BenchRegistry gSpriteBatchReg(SpriteBatchFactory);
 static BenchRegistry gPointsReg(PointsFactory);
 static BenchRegistry gLinesReg(LinesFactory);
 static BenchRegistry gPolygonReg(PolygonFactory);
@@ -0,0 +1,105 @@
+#include "SkBenchmark.h"
+#include "SkAnimator.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkSVG.h"
+#include "SkSVGParser.h"
+
+// an icon sized document: grouped rects, circles and paths
+static void make_document(SkString* svg) {
+    SkRandom rand;
+    svg->set("<svg width='64' height='64' viewBox='0 0 64 64'>\n");
+    for (int g = 0; g < 8; g++) {
+        svg->appendf("<g transform='matrix(1 0 0 1 %d %d)' stroke-width='1.5'>\n",
+                     g * 4, g * 3);
+        for (int i = 0; i < 6; i++) {
+            unsigned x = rand.nextU() % 48;
+            unsigned y = rand.nextU() % 48;
+            unsigned color = rand.nextU() & 0xFFFFFF;
+            switch (i % 3) {
+                case 0:
+                    svg->appendf("<rect x='%u' y='%u' width='12' height='9' "
+                                 "fill='#%06X' />\n", x, y, color);
+                    break;
+                case 1:
+                    svg->appendf("<circle cx='%u' cy='%u' r='6' fill='#%06X' "
+                                 "stroke='#000000' />\n", x, y, color);
+                    break;
+                default:
+                    svg->appendf("<path d='M%u,%u l10,2 l-3,9 q-4,2 -7,-5 z' "
+                                 "fill='none' stroke='#%06X' />\n", x, y, color);
+                    break;
+            }
+        }
+        svg->append("</g>\n");
+    }
+    svg->append("</svg>");
+}
+
+class SVGBench : public SkBenchmark {
+public:
+    enum Mode {
+        kAnimator_Mode,     // SVG -> animator XML -> SkAnimator
+        kPicture_Mode,      // SVG -> SkPicture
+        kCachedPicture_Mode // SVG -> SkPicture, found in the cache
+    };
+
+    SVGBench(void* param, Mode mode) : SkBenchmark(param), fMode(mode) {
+        static const char* gNames[] = { "animator", "picture", "picture_cached" };
+        fName.printf("svg_%s", gNames[mode]);
+        make_document(&fDocument);
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        for (int i = 0; i < N; i++) {
+            if (kAnimator_Mode == fMode) {
+                SkSVGParser parser;
+                if (!parser.parse(fDocument.c_str(), fDocument.size())) {
+                    return;
+                }
+                const char* xml = parser.getFinal();
+                SkAnimator animator;
+                if (!animator.decodeMemory(xml, strlen(xml))) {
+                    return;
+                }
+                animator.draw(canvas, &paint, 0);
+            } else {
+                if (kPicture_Mode == fMode) {
+                    SkSVG::PurgeCache();
+                }
+                SkPicture* picture = SkSVG::DecodeMemory(fDocument.c_str(),
+                                                         fDocument.size());
+                if (NULL == picture) {
+                    return;
+                }
+                picture->draw(canvas);
+                picture->unref();
+            }
+        }
+    }
+
+private:
+    enum { N = 10 };
+    Mode fMode;
+    SkString fDocument;
+    SkString fName;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new SVGBench(p, SVGBench::kAnimator_Mode); }
+static SkBenchmark* Fact1(void* p) { return new SVGBench(p, SVGBench::kPicture_Mode); }
+static SkBenchmark* Fact2(void* p) { return new SVGBench(p, SVGBench::kCachedPicture_Mode); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
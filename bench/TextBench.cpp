@@ -6,6 +6,7 @@
 #include "SkSfntUtils.h"
 #include "SkString.h"
 #include "SkTemplates.h"
+#include "SkUtils.h"
 
 /*  Some considerations for performance:
         short -vs- long strings (measuring overhead)
@@ -133,3 +134,122 @@ static BenchRegistry gReg5(Fact5);
 static BenchRegistry gReg6(Fact6);
 static BenchRegistry gReg7(Fact7);
 
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Throughput on long strings, where decoding and looking up each character
+    costs as much as (or more than) the tiny glyphs drawn for it.
+ */
+class LongTextBench : public SkBenchmark {
+public:
+    enum Mode {
+        kCount_Mode,    // textToGlyphs(NULL), just counting characters
+        kGlyphs_Mode,   // textToGlyphs into an array
+        kMeasure_Mode,  // measureText
+        kDraw_Mode      // drawText at a size small enough to be all overhead
+    };
+
+    LongTextBench(void* param, Mode mode, SkPaint::TextEncoding encoding)
+            : INHERITED(param), fMode(mode) {
+        static const char* gModeNames[] = { "count", "glyphs", "measure", "draw" };
+        static const char* gEncodingNames[] = { "utf8", "utf16" };
+        fName.printf("text_long_%s_%s", gModeNames[mode], gEncodingNames[encoding]);
+
+        // a paragraph of mostly ascii, with a few accented characters
+        static const SkUnichar gWords[][8] = {
+            { 'L', 'o', 'r', 'e', 'm' }, { 'i', 'p', 's', 'u', 'm' },
+            { 'd', 0xF6, 'l', 'o', 'r' }, { 's', 'i', 't' },
+            { 'a', 'm', 'e', 't', ',' }, { 'c', 'a', 'f', 0xE9 }
+        };
+        SkRandom rand;
+        int count = 0;
+        while (count < kCharCount) {
+            const SkUnichar* word = gWords[rand.nextU() % SK_ARRAY_COUNT(gWords)];
+            for (; *word && count < kCharCount; word++, count++) {
+                this->append(*word, encoding);
+            }
+            if (count < kCharCount) {
+                this->append(' ', encoding);
+                count += 1;
+            }
+        }
+        fGlyphs = new uint16_t[kCharCount];
+
+        fPaint.setTextEncoding(encoding);
+        fPaint.setTextSize(SkIntToScalar(kDraw_Mode == mode ? 2 : 12));
+    }
+
+    virtual ~LongTextBench() {
+        delete[] fGlyphs;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint(fPaint);
+        this->setupPaint(&paint);
+        paint.setTextEncoding(fPaint.getTextEncoding());
+
+        const void* text = fText.begin();
+        size_t length = fText.count();
+        for (int i = 0; i < N; i++) {
+            switch (fMode) {
+                case kCount_Mode:
+                    paint.textToGlyphs(text, length, NULL);
+                    break;
+                case kGlyphs_Mode:
+                    paint.textToGlyphs(text, length, fGlyphs);
+                    break;
+                case kMeasure_Mode:
+                    paint.measureText(text, length);
+                    break;
+                case kDraw_Mode:
+                    canvas->drawText(text, length, 0, SkIntToScalar(10 + i), paint);
+                    break;
+            }
+        }
+    }
+
+private:
+    void append(SkUnichar uni, SkPaint::TextEncoding encoding) {
+        if (SkPaint::kUTF8_TextEncoding == encoding) {
+            size_t n = SkUTF8_FromUnichar(uni);
+            SkUTF8_FromUnichar(uni, fText.append(n));
+        } else {
+            size_t n = SkUTF16_FromUnichar(uni);
+            SkUTF16_FromUnichar(uni, (uint16_t*)fText.append(n << 1));
+        }
+    }
+
+    enum {
+        N = 20,
+        kCharCount = 10000
+    };
+    Mode            fMode;
+    SkTDArray<char> fText;
+    uint16_t*       fGlyphs;
+    SkPaint         fPaint;
+    SkString        fName;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* LongFact0(void* p) { return new LongTextBench(p, LongTextBench::kCount_Mode, SkPaint::kUTF8_TextEncoding); }
+static SkBenchmark* LongFact1(void* p) { return new LongTextBench(p, LongTextBench::kGlyphs_Mode, SkPaint::kUTF8_TextEncoding); }
+static SkBenchmark* LongFact2(void* p) { return new LongTextBench(p, LongTextBench::kMeasure_Mode, SkPaint::kUTF8_TextEncoding); }
+static SkBenchmark* LongFact3(void* p) { return new LongTextBench(p, LongTextBench::kDraw_Mode, SkPaint::kUTF8_TextEncoding); }
+static SkBenchmark* LongFact4(void* p) { return new LongTextBench(p, LongTextBench::kCount_Mode, SkPaint::kUTF16_TextEncoding); }
+static SkBenchmark* LongFact5(void* p) { return new LongTextBench(p, LongTextBench::kGlyphs_Mode, SkPaint::kUTF16_TextEncoding); }
+static SkBenchmark* LongFact6(void* p) { return new LongTextBench(p, LongTextBench::kMeasure_Mode, SkPaint::kUTF16_TextEncoding); }
+static SkBenchmark* LongFact7(void* p) { return new LongTextBench(p, LongTextBench::kDraw_Mode, SkPaint::kUTF16_TextEncoding); }
+
+static BenchRegistry gLongReg0(LongFact0);
+static BenchRegistry gLongReg1(LongFact1);
+static BenchRegistry gLongReg2(LongFact2);
+static BenchRegistry gLongReg3(LongFact3);
+static BenchRegistry gLongReg4(LongFact4);
+static BenchRegistry gLongReg5(LongFact5);
+static BenchRegistry gLongReg6(LongFact6);
+static BenchRegistry gLongReg7(LongFact7);
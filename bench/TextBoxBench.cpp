@@ -0,0 +1,95 @@
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkString.h"
+#include "SkTextBox.h"
+
+static const char gParagraph[] =
+    "Skia is a complete 2D graphic library for drawing Text, Geometries, and "
+    "Images. It draws 3x3 matrices w/ perspective, antialiasing, transparency "
+    "and filters, shaders (bitmaps, linear-gradient, radial-gradient), "
+    "transfer-modes (all porter-duff modes, blend modes, etc.) and more.";
+
+class TextBoxBench : public SkBenchmark {
+public:
+    enum Mode {
+        kDrawText_Mode, // measure with breakText, draw with drawText, each draw
+        kUncached_Mode, // SkTextBox with the line cache disabled
+        kCached_Mode    // SkTextBox, finding its lines in the cache
+    };
+
+    TextBoxBench(void* param, Mode mode) : INHERITED(param), fMode(mode) {
+        static const char* gNames[] = { "drawtext", "uncached", "cached" };
+        fName.printf("textbox_%s", gNames[mode]);
+        fPaint.setAntiAlias(true);
+        fPaint.setTextSize(SkIntToScalar(14));
+        fBox.setBox(0, 0, SkIntToScalar(320), SkIntToScalar(480));
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        size_t budget = 0;
+        if (kUncached_Mode == fMode) {
+            budget = SkTextLines::SetCacheBudget(0);
+        }
+        for (int i = 0; i < N; i++) {
+            if (kDrawText_Mode == fMode) {
+                this->drawParagraph(canvas);
+            } else {
+                fBox.draw(canvas, gParagraph, sizeof(gParagraph) - 1, fPaint);
+            }
+        }
+        if (kUncached_Mode == fMode) {
+            SkTextLines::SetCacheBudget(budget);
+        }
+    }
+
+private:
+    // lines break at the last space that fits, measured again on every draw
+    void drawParagraph(SkCanvas* canvas) {
+        SkRect box;
+        fBox.getBox(&box);
+        SkPaint::FontMetrics metrics;
+        SkScalar spacing = fPaint.getFontMetrics(&metrics);
+        SkScalar y = box.fTop - metrics.fAscent;
+        const char* text = gParagraph;
+        const char* stop = gParagraph + sizeof(gParagraph) - 1;
+        while (text < stop) {
+            size_t len = fPaint.breakText(text, stop - text, box.width());
+            if (text + len < stop) {
+                size_t word = len;
+                while (word > 0 && text[word] != ' ') {
+                    word -= 1;
+                }
+                if (word > 0) {
+                    len = word + 1;
+                }
+            }
+            if (0 == len) {
+                len = 1;
+            }
+            canvas->drawText(text, len, box.fLeft, y, fPaint);
+            text += len;
+            y += spacing;
+        }
+    }
+
+    enum { N = 20 };
+    Mode        fMode;
+    SkTextBox   fBox;
+    SkPaint     fPaint;
+    SkString    fName;
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact0(void* p) { return new TextBoxBench(p, TextBoxBench::kDrawText_Mode); }
+static SkBenchmark* Fact1(void* p) { return new TextBoxBench(p, TextBoxBench::kUncached_Mode); }
+static SkBenchmark* Fact2(void* p) { return new TextBoxBench(p, TextBoxBench::kCached_Mode); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
@@ -41,6 +41,8 @@
         '../src/animator/SkBoundable.cpp',
         '../src/animator/SkBoundable.h',
         '../src/animator/SkBuildCondensedInfo.cpp',
+        '../src/animator/SkCompiledScript.cpp',
+        '../src/animator/SkCompiledScript.h',
         #'../src/animator/SkCondensedDebug.cpp', fails on windows
         #'../src/animator/SkCondensedRelease.cpp',
         '../src/animator/SkDisplayable.cpp',
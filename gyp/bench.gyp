@@ -15,6 +15,9 @@
     {
       'target_name': 'bench',
       'type': 'executable',
+      'include_dirs' : [
+        '../src/core',
+      ],
       'sources': [
         '../bench/benchmain.cpp',
         '../bench/BenchTimer.h',
@@ -33,24 +36,38 @@
         '../bench/SkBenchmark.h',
         '../bench/SkBenchmark.cpp',
         
+        '../bench/AnimatorBench.cpp',
         '../bench/BitmapBench.cpp',
+        '../bench/BlitMaskBench.cpp',
+        '../bench/ColorFilterBench.cpp',
         '../bench/DecodeBench.cpp',
+        '../bench/DOMBench.cpp',
+        '../bench/EncodeBench.cpp',
         '../bench/FPSBench.cpp',
         '../bench/GradientBench.cpp',
+        '../bench/LayerRasterizerBench.cpp',
+        '../bench/MapPathBench.cpp',
         '../bench/MatrixBench.cpp',
         '../bench/PathBench.cpp',
+        '../bench/PictureRecordBench.cpp',
         '../bench/RectBench.cpp',
         '../bench/RepeatTileBench.cpp',
         '../bench/ScalarBench.cpp',
+        '../bench/SVGBench.cpp',
         '../bench/TextBench.cpp',
+        '../bench/TextBoxBench.cpp',
       ],
       'dependencies': [
+        'animator.gyp:animator',
         'core.gyp:core',
         'effects.gyp:effects',
         'gpu.gyp:gr',
         'gpu.gyp:skgr',
         'images.gyp:images',
+        'svg.gyp:svg',
         'utils.gyp:utils',
+        'views.gyp:views',
+        'xml.gyp:xml',
       ],
       'conditions': [
         [ 'OS != "mac"', {
@@ -46,6 +46,7 @@
         '../src/core/SkClipStack.cpp',
         '../src/core/SkColor.cpp',
         '../src/core/SkColorFilter.cpp',
+        '../src/core/SkColorFilterProcs.h',
         '../src/core/SkColorTable.cpp',
         '../src/core/SkComposeShader.cpp',
         '../src/core/SkConcaveToTriangles.cpp',
@@ -61,6 +62,8 @@
         '../src/core/SkDevice.cpp',
         '../src/core/SkDither.cpp',
         '../src/core/SkDraw.cpp',
+        '../src/core/SkDrawArena.cpp',
+        '../src/core/SkDrawArena.h',
         '../src/core/SkDrawProcs.h',
         '../src/core/SkEdgeBuilder.cpp',
         '../src/core/SkEdgeClipper.cpp',
@@ -83,6 +86,7 @@
         '../src/core/SkMallocPixelRef.cpp',
         '../src/core/SkMask.cpp',
         '../src/core/SkMaskFilter.cpp',
+        '../src/core/SkMaskFilterProcs.h',
         '../src/core/SkMath.cpp',
         '../src/core/SkMatrix.cpp',
         '../src/core/SkMetaData.cpp',
@@ -10,6 +10,7 @@
         '../include/config',
         '../include/core',
         '../include/effects',
+        '../src/core',
       ],
       'sources': [
         '../include/effects/Sk1DPathEffect.h',
@@ -33,6 +34,7 @@
         '../include/effects/SkPixelXorXfermode.h',
         '../include/effects/SkPorterDuff.h',
         '../include/effects/SkRectShape.h',
+        '../include/effects/SkTableMaskFilter.h',
         '../include/effects/SkTransparentShader.h',
 
         '../src/effects/Sk1DPathEffect.cpp',
@@ -63,6 +65,7 @@
         '../src/effects/SkPorterDuff.cpp',
         '../src/effects/SkRadialGradient_Table.h',
         '../src/effects/SkRectShape.cpp',
+        '../src/effects/SkTableMaskFilter.cpp',
         '../src/effects/SkTransparentShader.cpp',
       ],
       'direct_dependent_settings': {
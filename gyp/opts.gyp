@@ -39,6 +39,9 @@
       'sources': [
         '../src/opts/SkBitmapProcState_opts_SSE2.cpp',
         '../src/opts/SkBlitRow_opts_SSE2.cpp',
+        '../src/opts/SkColorFilter_opts_SSE2.cpp',
+        '../src/opts/SkMaskFilter_opts_SSE2.cpp',
+        '../src/opts/SkMatrix_opts_SSE2.cpp',
         '../src/opts/SkUtils_opts_SSE2.cpp',
       ],
     },
@@ -9,17 +9,20 @@
       'include_dirs': [
         '../include/config',
         '../include/core',
+        '../include/effects',
         '../include/xml',
         '../include/utils',
         '../include/svg',
       ],
       'sources': [
+        '../include/svg/SkSVG.h',
         '../include/svg/SkSVGAttribute.h',
         '../include/svg/SkSVGBase.h',
         '../include/svg/SkSVGPaintState.h',
         '../include/svg/SkSVGParser.h',
         '../include/svg/SkSVGTypes.h',
 
+        '../src/svg/SkSVG.cpp',
         '../src/svg/SkSVGCircle.cpp',
         '../src/svg/SkSVGCircle.h',
         '../src/svg/SkSVGClipPath.cpp',
@@ -62,6 +65,8 @@
         '../src/svg/SkSVGRadialGradient.h',
         '../src/svg/SkSVGRect.cpp',
         '../src/svg/SkSVGRect.h',
+        '../src/svg/SkSVGRenderer.cpp',
+        '../src/svg/SkSVGRenderer.h',
         '../src/svg/SkSVGStop.cpp',
         '../src/svg/SkSVGStop.h',
         '../src/svg/SkSVGSVG.cpp',
@@ -72,9 +77,6 @@
         '../src/svg/SkSVGText.h',
         '../src/svg/SkSVGUse.cpp',
       ],
-      'sources!' : [
-          '../src/svg/SkSVG.cpp', # doesn't compile, maybe this is test code?
-      ],
       'direct_dependent_settings': {
         'include_dirs': [
           '../include/svg',
@@ -9,9 +9,13 @@
       'target_name': 'tests',
       'type': 'executable',
       'include_dirs' : [
+        '../include/pipe',
         '../src/core',
+        '../src/effects',
+        '../src/pipe',
       ],
       'sources': [
+        '../tests/AnimatorTest.cpp',
         '../tests/BitmapCopyTest.cpp',
         '../tests/BitmapGetColorTest.cpp',
         '../tests/BlitRowTest.cpp',
@@ -21,13 +25,20 @@
         '../tests/ClipperTest.cpp',
         '../tests/ColorFilterTest.cpp',
         '../tests/ColorTest.cpp',
+        '../tests/DamageTest.cpp',
         '../tests/DataRefTest.cpp',
         '../tests/DequeTest.cpp',
+        '../tests/DOMTest.cpp',
+        '../tests/DrawArenaTest.cpp',
+        '../tests/DrawBatchTest.cpp',
         '../tests/DrawBitmapRectTest.cpp',
         '../tests/FillPathTest.cpp',
         '../tests/FlateTest.cpp',
         '../tests/GeometryTest.cpp',
+        '../tests/ImageEncoderTest.cpp',
         '../tests/InfRectTest.cpp',
+        '../tests/LayerRasterizerTest.cpp',
+        '../tests/MaskFilterTest.cpp',
         '../tests/MathTest.cpp',
         '../tests/MatrixTest.cpp',
         '../tests/Matrix44Test.cpp',
@@ -39,6 +50,8 @@
         '../tests/PathMeasureTest.cpp',
         '../tests/PathTest.cpp',
         '../tests/PDFPrimitivesTest.cpp',
+        '../tests/PictureTest.cpp',
+        '../tests/PipeTest.cpp',
         '../tests/PointTest.cpp',
         '../tests/Reader32Test.cpp',
         '../tests/RefDictTest.cpp',
@@ -49,19 +62,30 @@
         '../tests/SrcOverTest.cpp',
         '../tests/StreamTest.cpp',
         '../tests/StringTest.cpp',
+        '../tests/SVGTest.cpp',
         '../tests/Test.cpp',
+        '../tests/TestBitmap.cpp',
+        '../tests/TextBoxTest.cpp',
         '../tests/TestSize.cpp',
         '../tests/UtilsTest.cpp',
         '../tests/Writer32Test.cpp',
         '../tests/XfermodeTest.cpp',
+
+        # pipe sources, which are not part of a library
+        '../src/pipe/SkGPipeRead.cpp',
+        '../src/pipe/SkGPipeWrite.cpp',
       ],
       'dependencies': [
+        'animator.gyp:animator',
         'core.gyp:core',
         'effects.gyp:effects',
         'experimental.gyp:experimental',
         'images.gyp:images',
         'pdf.gyp:pdf',
+        'svg.gyp:svg',
         'utils.gyp:utils',
+        'views.gyp:views',
+        'xml.gyp:xml',
       ],
     },
   ],
@@ -455,6 +455,15 @@ public:
     */
     void setTimeline(const Timeline& );
 
+    /** Optional; if called with true, numeric scripts, such as formulas and conditions,
+        are compiled the first time they are evaluated, and the compiled script is run
+        each time the value is needed again. By default each script is parsed and
+        interpreted each time, since the compiled scripts have yet to be checked against
+        the interpreter on a 32-bit build (the only kind the animator supports).
+        @param compile true to compile scripts the first time they are evaluated
+    */
+    void setCompileScripts(bool compile);
+
     static void Init(bool runUnitTests);
     static void Term();
     
@@ -498,6 +507,7 @@ private:
     friend class SkAnimatorScript;
     friend class SkAnimatorScript2;
     friend class SkApply;
+    friend class SkCompiledScript;
     friend class SkDisplayMovie;
     friend class SkDisplayType;
     friend class SkPost;
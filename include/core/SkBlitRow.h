@@ -3,6 +3,7 @@
 
 #include "SkBitmap.h"
 #include "SkColor.h"
+#include "SkMask.h"
 
 class SkBlitRow {
 public:
@@ -98,14 +99,20 @@ public:
                         const uint8_t* mask, size_t maskRB, SkColor color,
                         int width, int height);
 
-    /* Public entry-point to return a blitmask function ptr
+    /* Public entry-point to return a blitmask function ptr, or NULL if
+     * masks of this format can't be blitted into dstConfig. The format is
+     * kA8, or kLCD16/kLCD32 whose rows are uint16_t/uint32_t (maskRB is
+     * still in bytes). LCD masks are blended per subpixel, scaled by the
+     * alpha of color.
      */
-    static Proc Factory(SkBitmap::Config dstConfig, SkColor color);
+    static Proc Factory(SkBitmap::Config dstConfig, SkMask::Format,
+                        SkColor color);
 
     /* return either platform specific optimized blitmask function-ptr,
      * or NULL if no optimized
      */
-    static Proc PlatformProcs(SkBitmap::Config dstConfig, SkColor color);
+    static Proc PlatformProcs(SkBitmap::Config dstConfig, SkMask::Format,
+                              SkColor color);
 };
 
 
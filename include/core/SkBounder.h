@@ -87,6 +87,7 @@ private:
 
     const SkRegion* fClip;
     friend class SkAutoBounderCommit;
+    friend class SkDamageBounder;
     friend class SkDraw;
     friend class SkDrawIter;
     friend struct Draw1Glyph;
@@ -472,6 +472,16 @@ public:
     */
     virtual void drawRect(const SkRect& rect, const SkPaint& paint);
 
+    /** Draw each of the rectangles, as drawRect() would, with the same paint.
+        Drawing a run of (small) rects this way sets up the paint's looper,
+        layers and blitter once rather than for every rect.
+        @param rects    Array of rects to draw
+        @param count    The number of rects in the array
+        @param paint    The paint used to draw the rects
+    */
+    virtual void drawRects(const SkRect rects[], size_t count,
+                           const SkPaint& paint);
+
     /** Draw the specified rectangle using the specified paint. The rectangle
         will be filled or framed based on the Style in the paint.
         @param rect     The rect to be drawn
@@ -586,6 +596,16 @@ public:
     virtual void drawSprite(const SkBitmap& bitmap, int left, int top,
                             const SkPaint* paint = NULL);
 
+    /** Draw the bitmap with its top/left corner at each of the points, as
+        drawSprite() would, setting up the paint and blitter just once.
+        @param bitmap   The bitmap to be drawn
+        @param pts      Array of top/left positions for the bitmap
+        @param count    The number of points in the array
+        @param paint    The paint used to draw the bitmap, or NULL
+    */
+    virtual void drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                             size_t count, const SkPaint* paint = NULL);
+
     /** Draw the text, with origin at (x,y), using the specified paint.
         The origin is interpreted based on the Align setting in the paint.
         @param text The text to be drawn
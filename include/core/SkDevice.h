@@ -23,7 +23,9 @@
 #include "SkCanvas.h"
 #include "SkColor.h"
 
+class SkBounder;
 class SkClipStack;
+class SkDamageBounder;
 class SkDevice;
 class SkDraw;
 struct SkIRect;
@@ -161,6 +163,31 @@ public:
      */
     void eraseColor(SkColor eraseColor) { this->clear(eraseColor); }
 
+    /** Turns damage tracking on or off (the default). While it is on, the
+        device accumulates the bounds (in device coordinates) of everything
+        drawn into it through a canvas, as well as clear() and writePixels(),
+        so that a compositor can update just the pixels that changed. The
+        bounds are those reported to SkBounder, and so may be a little larger
+        than the pixels actually touched. Pixels changed directly through
+        accessBitmap() are not seen, and devices that don't draw with SkDraw
+        (e.g. GPU and PDF) report nothing. Turning tracking off discards the
+        damage.
+    */
+    void setTrackDamage(bool track);
+    bool isTrackingDamage() const { return NULL != fDamage; }
+
+    /** Returns the damage accumulated since tracking was turned on, or since
+        the last resetDamage(). Empty if the device isn't tracking damage.
+    */
+    const SkRegion& getDamage() const;
+    /** Empties the accumulated damage, e.g. once it has been composited.
+    */
+    void resetDamage();
+    /** Adds r (in device coordinates) to the damage if tracking, for changes
+        made to the pixels some other way.
+    */
+    void addDamage(const SkIRect& r);
+
     /** Called when this device is installed into a Canvas. Balanaced by a call
         to unlockPixels() when the device is removed from a Canvas.
     */
@@ -222,6 +249,14 @@ public:
                             const SkPoint[], const SkPaint& paint);
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint);
+    /**
+     *  Draws a run of rects with the same paint (see SkCanvas::drawRects).
+     *  The raster device sets up its blitter once for the whole run; devices
+     *  that override drawRect should override this too (if only to call
+     *  drawRect for each rect).
+     */
+    virtual void drawRects(const SkDraw&, const SkRect rects[], size_t count,
+                           const SkPaint& paint);
     /**
      *  If pathIsMutable, then the implementation is allowed to cast path to a
      *  non-const pointer and modify it in place (as an optimization). Canvas
@@ -242,6 +277,13 @@ public:
                             const SkMatrix& matrix, const SkPaint& paint);
     virtual void drawSprite(const SkDraw&, const SkBitmap& bitmap,
                             int x, int y, const SkPaint& paint);
+    /**
+     *  Draws bitmap at each of the points (see SkCanvas::drawSprites). As with
+     *  drawRects, devices that override drawSprite should override this too.
+     */
+    virtual void drawSprites(const SkDraw&, const SkBitmap& bitmap,
+                             const SkIPoint pts[], size_t count,
+                             const SkPaint& paint);
     virtual void drawText(const SkDraw&, const void* text, size_t len,
                           SkScalar x, SkScalar y, const SkPaint& paint);
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
@@ -321,8 +363,12 @@ protected:
 
 private:
     friend class SkCanvas;
+    friend class SkDrawIter;
     // just called by SkCanvas when built as a layer
     void setOrigin(int x, int y) { fOrigin.set(x, y); }
+    // just called by SkDrawIter when we track damage; the returned bounder
+    // reports to chain (the canvas' bounder, may be null) before us
+    SkBounder* getDamageBounder(SkBounder* chain);
     // just called by SkCanvas for saveLayer
     SkDevice* createCompatibleDeviceForSaveLayer(SkBitmap::Config config, 
                                                  int width, int height,
@@ -331,6 +377,7 @@ private:
     SkBitmap    fBitmap;
     SkIPoint    fOrigin;
     SkMetaData* fMetaData;
+    SkDamageBounder* fDamage;
 
     SkDeviceFactory* fCachedDeviceFactory;
 };
@@ -58,6 +58,16 @@ public:
     static Factory NameToFactory(const char name[]);
     static const char* FactoryToName(Factory);
     static void Register(const char name[], Factory);
+
+    /** Built-in flattenables also have a small numeric ID, which is the same
+        in every build, so it can be written in place of the name. Returns 0
+        if the factory is not a registered built-in.
+     */
+    static uint32_t FactoryToID(Factory);
+    /** Returns the factory for a built-in's ID, or NULL if that built-in has
+        not been registered (e.g. it was not linked in).
+     */
+    static Factory IDToFactory(uint32_t id);
     
     class Registrar {
     public:
@@ -121,6 +131,15 @@ public:
         fFactoryArray = NULL;
         fFactoryCount = 0;
     }
+
+    /**
+     *  Call this when the buffer's memory outlives everything unflattened from
+     *  it (e.g. it is a mapped file that the caller keeps open). Bitmap pixels
+     *  (raw, or in an SkMallocPixelRef) then point into the buffer, rather
+     *  than being copied. SkPicture uses this.
+     */
+    void setSharePixels(bool share) { fSharePixels = share; }
+    bool sharePixels() const { return fSharePixels; }
     
     SkTypeface* readTypeface();
     SkRefCnt* readRefCnt();
@@ -137,6 +156,8 @@ private:
     SkTDArray<SkFlattenable::Factory>* fFactoryTDArray;
     SkFlattenable::Factory* fFactoryArray;
     int                     fFactoryCount;
+
+    bool fSharePixels;
     
     typedef SkReader32 INHERITED;
 };
@@ -186,6 +207,7 @@ public:
         /**
          *  Instructs the writer to inline Factory names as there are seen the
          *  first time (after that we store an index). The pipe code uses this.
+         *  Built-in factories are written by their ID instead of their name.
          */
         kInlineFactoryNames_Flag = 0x02,
     };
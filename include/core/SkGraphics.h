@@ -34,6 +34,29 @@ public:
     */
     static bool SetFontCacheUsed(size_t usageInBytes);
 
+    /** Return the number of threads used to fill a single large path (see
+        SetFillPathThreadCount). The default is 1.
+    */
+    static int GetFillPathThreadCount();
+
+    /** Very large, complex paths (e.g. full-page maps) can be filled as
+        horizontal bands of rows that are rasterized concurrently, with the
+        same result as filling them on one thread. This sets the number of
+        threads (and bands) to use; 1 (the default) always fills serially.
+        Paints with a shader or maskfilter are always filled serially.
+    */
+    static void SetFillPathThreadCount(int count);
+
+    /** Return how many blocks of per-draw scratch memory (path edges, masks,
+        blitter span buffers, antialiasing runs) the calling thread has asked
+        for since the last ResetDrawAllocCounts(), and how many of those went
+        to the heap. Once a frame has been drawn, redrawing it should report
+        no heap allocations. Objects that may outlive a draw (e.g. shaders
+        that the blitters wrap a paint's color in) are not counted.
+    */
+    static void GetDrawAllocCounts(int* allocCount, int* heapAllocCount);
+    static void ResetDrawAllocCounts();
+
     /** Return the version numbers for the library. If the parameter is not
         null, it is set to the version number.
      */
@@ -55,6 +55,8 @@ private:
     void*           fStorage;
     size_t          fSize;
     SkColorTable*   fCTable;
+    // false if fStorage points into the buffer we were unflattened from
+    bool            fOwnsStorage;
 
     typedef SkPixelRef INHERITED;
 };
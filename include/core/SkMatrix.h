@@ -561,8 +561,17 @@ private:
     static void RotTrans_pts(const SkMatrix&, SkPoint dst[], const SkPoint[],
                              int count);
     static void Persp_pts(const SkMatrix&, SkPoint dst[], const SkPoint[], int);
-    
-    static const MapPtsProc gMapPtsProcs[];
+    static void Stub_pts(const SkMatrix&, SkPoint dst[], const SkPoint[], int);
+
+    /** Return a platform-optimized version of the mapPts proc for the given
+        type mask, or NULL if the portable one should be used. This is
+        implemented in src/opts.
+    */
+    static MapPtsProc PlatformMapPtsProc(TypeMask mask);
+
+    static const MapPtsProc gPortableMapPtsProcs[];
+    // starts out as all Stub_pts, which installs the real procs on first use
+    static MapPtsProc gMapPtsProcs[];
 
     friend class SkPerspIter;
 };
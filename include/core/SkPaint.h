@@ -870,6 +870,7 @@ private:
         kCanonicalTextSizeForPaths = 64
     };
     friend class SkAutoGlyphCache;
+    friend class SkCanonicalizePaint;
     friend class SkCanvas;
     friend class SkDraw;
     friend class SkPDFDevice;
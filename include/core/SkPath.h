@@ -20,14 +20,6 @@
 #include "SkMatrix.h"
 #include "SkTDArray.h"
 
-#ifdef ANDROID
-#define GEN_ID_INC              fGenerationID++
-#define GEN_ID_PTR_INC(ptr)     ptr->fGenerationID++
-#else
-#define GEN_ID_INC
-#define GEN_ID_PTR_INC(ptr)
-#endif
-
 class SkReader32;
 class SkWriter32;
 class SkAutoPathBoundsUpdate;
@@ -82,7 +74,7 @@ public:
     */
     void setFillType(FillType ft) {
         fFillType = SkToU8(ft);
-        GEN_ID_INC;
+        this->newGenerationID();
     }
 
     /** Returns true if the filltype is one of the Inverse variants */
@@ -94,7 +86,7 @@ public:
      */
     void toggleInverseFillType() {
         fFillType ^= 2;
-        GEN_ID_INC;
+        this->newGenerationID();
      }
 
     enum Convexity {
@@ -639,9 +631,13 @@ public:
     void flatten(SkWriter32&) const;
     void unflatten(SkReader32&);
 
-#ifdef ANDROID
+    /** Returns a non-zero value that identifies the current contents of this
+        path. Each time the path is edited, a different generation ID will be
+        returned. A copy of a path shares its generation ID until either one
+        is edited, so the ID can be used as a key for caching work derived
+        from the path's points and verbs.
+    */
     uint32_t getGenerationID() const;
-#endif
 
     SkDEBUGCODE(void validate() const;)
 
@@ -652,9 +648,11 @@ private:
     mutable uint8_t     fBoundsIsDirty;
     uint8_t             fFillType;
     mutable uint8_t     fConvexity;
-#ifdef ANDROID
     uint32_t            fGenerationID;
-#endif
+
+    // edits give the path a new generation ID right away, so that
+    // getGenerationID() is a plain read, safe while other threads draw us
+    void newGenerationID();
 
     // called, if dirty, by getBounds()
     void computeBounds() const;
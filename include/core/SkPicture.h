@@ -20,8 +20,10 @@
 #include "SkRefCnt.h"
 
 class SkCanvas;
+class SkMemoryStream;
 class SkPicturePlayback;
 class SkPictureRecord;
+class SkRegion;
 class SkStream;
 class SkWStream;
 
@@ -43,6 +45,17 @@ public:
     SkPicture(const SkPicture& src);
     explicit SkPicture(SkStream*);
     virtual ~SkPicture();
+
+    /** Recreate a picture that was serialized into memory, e.g. a file opened
+        with SkMMAPStream. Instead of copying its contents, the picture plays
+        its ops (and draws its bitmaps' pixels) straight from the stream's
+        memory, so a mapped file is only paged in as it is drawn, and its pages
+        are shared by every process that maps it. The picture refs the stream,
+        whose memory must not change while the picture is alive. Pictures from
+        older versions of the format are copied, as SkPicture(SkStream*) does.
+        The caller must unref() the returned picture.
+    */
+    static SkPicture* CreateFromMemoryStream(SkMemoryStream*);
     
     /**
      *  Swap the contents of the two pictures. Guaranteed to succeed.
@@ -58,7 +71,15 @@ public:
             clip-query calls will reflect the path's bounds, not the actual
             path.
          */
-        kUsePathBoundsForClip_RecordingFlag = 0x01
+        kUsePathBoundsForClip_RecordingFlag = 0x01,
+        /*  This flag has the recording canvas drop or merge calls that cannot
+            change what the picture draws: save/restore pairs with no drawing
+            between them, matrix changes that nothing sees, clipRects that
+            contain the previous clipRect, saveLayers around a single opaque
+            draw, and drawRects that abut the previous drawRect. Playback then
+            makes fewer calls, with pixel-identical results.
+         */
+        kOptimizeOps_RecordingFlag = 0x02
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -83,10 +104,24 @@ public:
     void endRecording();
     
     /** Replays the drawing commands on the specified canvas. This internally
-        calls endRecording() if that has not already been called.
+        calls endRecording() if that has not already been called. Once
+        recording has ended, several threads may draw the same picture at
+        once, each into its own canvas.
         @param surface the canvas receiving the drawing commands.
     */
     void draw(SkCanvas* surface);
+
+    /** Replays the drawing commands on the specified canvas, but only within
+        damage (in the canvas' device coordinates, e.g. from
+        SkDevice::getDamage()). The canvas is clipped to damage while the
+        picture draws, so pixels outside it are left alone, and the commands
+        that fall entirely outside it are skipped cheaply (by the canvas'
+        quickReject). Clips the picture makes with SkRegion::kReplace_Op are
+        not limited to damage.
+        @param surface the canvas receiving the drawing commands.
+        @param damage  the part of surface to redraw.
+    */
+    void draw(SkCanvas* surface, const SkRegion& damage);
     
     /** Return the width of the picture's recording canvas. This
         value reflects what was passed to setSize(), and does not necessarily
@@ -104,9 +139,16 @@ public:
 
     void serialize(SkWStream*) const;
 
+    /** Returns the number of calls made to the recording canvas (0 if the
+        picture was read from a stream), and sets removedCount (if not NULL)
+        to how many of those kOptimizeOps_RecordingFlag dropped or merged.
+    */
+    int getRecordedOpCount(int* removedCount = NULL) const;
+
     /** Signals that the caller is prematurely done replaying the drawing
         commands. This can be called from a canvas virtual while the picture
-        is drawing. Has no effect if the picture is not drawing. 
+        is drawing. Has no effect if the picture is not drawing. If the
+        picture is being drawn on several threads, all of them stop.
     */
     void abortPlayback();
     
@@ -115,6 +157,9 @@ private:
     SkPictureRecord* fRecord;
     SkPicturePlayback* fPlayback;
 
+    // if memory is not NULL (it is then also the stream), play from it in place
+    void parse(SkStream*, SkMemoryStream* memory);
+
     friend class SkFlatPicture;
     friend class SkPicturePlayback;
 };
@@ -22,6 +22,7 @@
 
 class SkRegion;
 class SkBlitter;
+class SkEdgeBuilder;
 class SkPath;
 
 /** Defines a fixed-point rectangle, identical to the integer SkIRect, but its
@@ -43,6 +44,20 @@ public:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
 #endif
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    /** Builds the sorted edges that FillPath(path, clip, blitter) walks, so
+        that the bands of a large path can be filled from them (see below)
+        without each band building them again. Returns false if there is
+        nothing to fill. The path must not have an inverse filltype.
+     */
+    static bool BuildFillEdges(const SkPath&, const SkRegion& clip,
+                               SkEdgeBuilder* edges);
+    /** Fills just the rows [startY, stopY) of the path, from the edges that
+        BuildFillEdges() built for it, exactly as the complete fill would.
+        This lets a large path be split into bands that are filled
+        concurrently, each into its own blitter; the edges are only read.
+     */
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         int startY, int stopY, const SkEdgeBuilder& edges);
 
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
     static void FillTriangle(const SkPoint& a, const SkPoint& b,
@@ -71,6 +86,22 @@ public:
 #endif
     
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    // see BuildFillEdges() and FillPath(path, clip, blitter, startY, ...)
+    static bool BuildAntiFillEdges(const SkPath&, const SkRegion& clip,
+                                   SkEdgeBuilder* edges);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                             int startY, int stopY, const SkEdgeBuilder& edges);
+    /** Antialiased fills of at least 256x256 can be supersampled into 32x32
+        tiles of coverage deltas, rather than into runs. That is off by
+        default, since it has yet to beat the runs on real content. Returns
+        the previous setting.
+    */
+    static bool SetUseTiledAA(bool);
+    /** Returns true if AntiFillPath hands the coverage of a (non-inverse)
+        path whose bounds round out to ir to its blitter in one blitMask
+        call, rather than row by row through blitAntiH.
+    */
+    static bool AntiFillPathBlitsMask(const SkIRect& ir);
 
     static void AntiHairLine(const SkPoint&, const SkPoint&, const SkRegion*,
                              SkBlitter*);
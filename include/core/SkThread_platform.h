@@ -17,6 +17,24 @@
 #ifndef SkThread_platform_DEFINED
 #define SkThread_platform_DEFINED
 
+typedef void (*SkParallelProc)(void* context, int index);
+typedef void* (*SkThreadDataCreateProc)();
+typedef void (*SkThreadDataDeleteProc)(void* data);
+
+/** Implemented by the porting layer, this function returns the calling
+    thread's own instance of some data, identified by createProc, which is
+    called to make it the first time that thread asks for it. When the thread
+    exits, deleteProc (if not NULL) is called on it, on ports that can tell.
+*/
+SK_API void* sk_thread_data(SkThreadDataCreateProc createProc,
+                            SkThreadDataDeleteProc deleteProc);
+
+/** Deletes all of the calling thread's data from sk_thread_data() now, rather
+    than when it exits (which no port sees for the main thread). Asking for
+    the data again makes a new instance.
+*/
+SK_API void sk_delete_thread_data();
+
 #if defined(ANDROID) && !defined(SK_BUILD_FOR_ANDROID_NDK)
 
 #include <utils/threads.h>
@@ -36,6 +54,13 @@ public:
     void    release() { this->unlock(); }
 };
 
+static inline void sk_parallel_for(SkParallelProc proc, void* context,
+                                   int count) {
+    for (int i = 0; i < count; i++) {
+        proc(context, i);
+    }
+}
+
 #else
 
 /** Implemented by the porting layer, this function adds 1 to the int specified
@@ -47,6 +72,13 @@ SK_API int32_t sk_atomic_inc(int32_t* addr);
     value.
 */
 SK_API int32_t sk_atomic_dec(int32_t* addr);
+/** Implemented by the porting layer, this function calls proc(context, i) for
+    each i in [0, count), spreading the calls across up to count threads, and
+    returns once they have all finished. The threads are kept between calls.
+    Ports without threads, or that are already running another such call, may
+    simply make the calls in order.
+*/
+SK_API void sk_parallel_for(SkParallelProc proc, void* context, int count);
 
 class SkMutex {
 public:
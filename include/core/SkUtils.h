@@ -76,6 +76,15 @@ SkUnichar   SkUTF8_ToUnichar(const char utf8[]);
 SkUnichar   SkUTF8_NextUnichar(const char**);
 SkUnichar   SkUTF8_PrevUnichar(const char**);
 
+/** Return the number of bytes at the start of utf8[] (looking at no more
+    than byteLength) that are 7-bit ASCII, i.e. that are each a whole unichar.
+    This is how callers find runs of text that need no decoding.
+*/
+size_t SkUTF8_CountASCII_portable(const char utf8[], size_t byteLength);
+typedef size_t (*SkUTF8CountASCIIProc)(const char utf8[], size_t byteLength);
+SkUTF8CountASCIIProc SkUTF8CountASCIIGetPlatformProc();
+extern SkUTF8CountASCIIProc SkUTF8_CountASCII;
+
 /** Return the number of bytes need to convert a unichar
     into a utf8 sequence. Will be 1..kMaxBytesInUTF8Sequence,
     or 0 if uni is illegal.
@@ -94,6 +103,16 @@ int SkUTF16_CountUnichars(const uint16_t utf16[],
 SkUnichar SkUTF16_NextUnichar(const uint16_t**);
 // this guy backs up to the previus unichar value, and returns it (*--p)
 SkUnichar SkUTF16_PrevUnichar(const uint16_t**);
+
+/** Return the number of 16bit values at the start of utf16[] (looking at no
+    more than numberOf16BitValues) that are not surrogates, i.e. that are each
+    a whole unichar in the BMP.
+*/
+int SkUTF16_CountBMP_portable(const uint16_t utf16[], int numberOf16BitValues);
+typedef int (*SkUTF16CountBMPProc)(const uint16_t utf16[],
+                                   int numberOf16BitValues);
+SkUTF16CountBMPProc SkUTF16CountBMPGetPlatformProc();
+extern SkUTF16CountBMPProc SkUTF16_CountBMP;
 size_t SkUTF16_FromUnichar(SkUnichar uni, uint16_t utf16[] = NULL);
 
 SK_API size_t SkUTF16_ToUTF8(const uint16_t utf16[], int numberOf16BitValues,
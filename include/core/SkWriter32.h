@@ -127,6 +127,10 @@ public:
     // be a multiple of 4. This does not allocate any new space, so the returned
     // address is only valid for 1 int.
     uint32_t* peek32(size_t offset);
+
+    // drop everything written after offset (which must be a multiple of 4, and
+    // no larger than size()), so that the next write lands at offset.
+    void rewindToOffset(size_t offset);
     
     // copy into a single buffer (allocated by caller). Must be at least size()
     void flatten(void* dst) const;
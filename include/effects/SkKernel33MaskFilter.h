@@ -25,6 +25,13 @@ public:
         : fPercent256(percent256) {}
 
     virtual uint8_t computeValue(uint8_t* const* srcRows) = 0;
+
+    /** Compute the values for count pixels of a row. srcRows[0..2] point to
+        the 3x3 pixels around the first one, and each next pixel's are one
+        further along. The default calls computeValue() for each pixel;
+        subclasses can override it to do the whole row at once.
+    */
+    virtual void computeRow(uint8_t* const* srcRows, int count, uint8_t dst[]);
     
     // overrides from SkMaskFilter
     virtual SkMask::Format getFormat();
@@ -52,8 +59,9 @@ public:
         fShift = shift;
     }
     
-    // override from SkKernel33ProcMaskFilter
+    // overrides from SkKernel33ProcMaskFilter
     virtual uint8_t computeValue(uint8_t* const* srcRows);
+    virtual void computeRow(uint8_t* const* srcRows, int count, uint8_t dst[]);
     
     // overrides from SkFlattenable
     virtual void flatten(SkFlattenableWriteBuffer& wb);
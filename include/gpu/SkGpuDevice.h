@@ -105,6 +105,8 @@ public:
                             const SkPoint[], const SkPaint& paint);
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint);
+    virtual void drawRects(const SkDraw&, const SkRect rects[], size_t count,
+                           const SkPaint& paint);
     virtual void drawPath(const SkDraw&, const SkPath& path,
                           const SkPaint& paint, const SkMatrix* prePathMatrix,
                           bool pathIsMutable);
@@ -113,6 +115,9 @@ public:
                             const SkMatrix& matrix, const SkPaint& paint);
     virtual void drawSprite(const SkDraw&, const SkBitmap& bitmap,
                             int x, int y, const SkPaint& paint);
+    virtual void drawSprites(const SkDraw&, const SkBitmap& bitmap,
+                             const SkIPoint pts[], size_t count,
+                             const SkPaint& paint);
     virtual void drawText(const SkDraw&, const void* text, size_t len,
                           SkScalar x, SkScalar y, const SkPaint& paint);
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
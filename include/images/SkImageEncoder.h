@@ -14,6 +14,7 @@ public:
     };
     static SkImageEncoder* Create(Type);
 
+    SkImageEncoder();
     virtual ~SkImageEncoder();
     
     /*  Quality ranges from 0..100 */
@@ -21,6 +22,18 @@ public:
         kDefaultQuality = 80
     };
 
+    /** Returns the number of threads this encoder may use (default is 1).
+    */
+    int getThreadCount() const { return fThreadCount; }
+
+    /** Set the number of threads this encoder may use. With more than one,
+        encoders that support it (PNG and JPEG) split the image into bands of
+        rows and compress them concurrently, then stitch the bands into a
+        single valid image. The result may be slightly larger than a serial
+        encode. Images too small to split are always encoded serially.
+    */
+    void setThreadCount(int count);
+
     bool encodeFile(const char file[], const SkBitmap&, int quality);
     bool encodeStream(SkWStream*, const SkBitmap&, int quality);
 
@@ -31,6 +44,9 @@ public:
 
 protected:
     virtual bool onEncode(SkWStream*, const SkBitmap&, int quality) = 0;
+
+private:
+    int fThreadCount;
 };
 
 #endif
@@ -23,11 +23,40 @@
 
 class SkCanvas;
 
+/**
+ *  Memory that both the writer's and the reader's process can address, e.g. a
+ *  shared memory segment that each has mapped. Given one, the writer copies a
+ *  bitmap's pixels into it once, and the pipe then refers to them by handle,
+ *  rather than copying the pixels into the pipe on every draw. The reader must
+ *  be given an instance that sees the same memory under the same handles.
+ */
+class SkGPipeSharedMemory : public SkRefCnt {
+public:
+    /**
+     *  Called by the writer. Returns size bytes of shared memory, 4-byte
+     *  aligned, and sets their handle (which must not be 0). The memory must
+     *  stay valid for as long as a reader might draw from it. Return NULL if
+     *  there is no room; the writer then copies the pixels into the pipe.
+     */
+    virtual void* alloc(size_t size, uint32_t* handle) = 0;
+
+    /**
+     *  Called by the reader. Returns the address of the memory with this
+     *  handle, or NULL if the handle is unknown.
+     */
+    virtual void* lookup(uint32_t handle) = 0;
+};
+
 class SkGPipeReader {
 public:
     SkGPipeReader(SkCanvas* target);
     ~SkGPipeReader();
 
+    /**
+     *  Must be set (before playback) if the writer was given shared memory.
+     */
+    void setSharedMemory(SkGPipeSharedMemory*);
+
     enum Status {
         kDone_Status,   //!< no more data expected from reader
         kEOF_Status,    //!< need more data from reader
@@ -42,6 +71,7 @@ public:
 private:
     SkCanvas*           fCanvas;
     class SkGPipeState* fState;
+    SkGPipeSharedMemory* fSharedMemory;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -81,17 +111,35 @@ public:
         kCrossProcess_Flag = 1 << 0,
     };
 
-    SkCanvas* startRecording(SkGPipeController*, uint32_t flags = 0);
+    /**
+     *  If sharedMemory is not NULL, bitmap pixels are copied into it (once for
+     *  each bitmap, across recordings) instead of into the pipe.
+     */
+    SkCanvas* startRecording(SkGPipeController*, uint32_t flags = 0,
+                             SkGPipeSharedMemory* sharedMemory = NULL);
 
     // called in destructor, but can be called sooner once you know there
     // should be no more drawing calls made into the recording canvas.
     void endRecording();
 
 private:
+    friend class SkGPipeCanvas;
+
+    // pixels already copied into fSharedMemory, and their handle
+    struct SharedBitmap {
+        uint32_t    fGenerationID;
+        uint32_t    fPixelRefOffset;
+        int         fWidth;
+        int         fHeight;
+        uint32_t    fHandle;
+    };
+
     class SkGPipeCanvas* fCanvas;
     SkGPipeController*   fController;
     SkFactorySet         fFactorySet;
     SkWriter32 fWriter;
+    SkGPipeSharedMemory* fSharedMemory;
+    SkTDArray<SharedBitmap> fSharedBitmaps;
 };
 
 #endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SkSVG_DEFINED
+#define SkSVG_DEFINED
+
+#include "SkTypes.h"
+
+class SkPicture;
+class SkStream;
+class SkXMLParserError;
+
+/** Loads SVG documents as pictures. The paths, paints and shaders are built
+    straight from the parsed SVG elements and recorded into an SkPicture,
+    without translating the document into animator XML and parsing that in
+    turn.
+
+    Loaded pictures are cached by the content of the document, so loading the
+    same icon again returns the picture already recorded.
+*/
+class SkSVG {
+public:
+    /** Returns a picture that draws the SVG document in data, or NULL if the
+        document could not be parsed (error, if not NULL, then describes why).
+        The caller must unref() the returned picture, which may be shared
+        with other callers that loaded the same document.
+    */
+    static SkPicture* DecodeMemory(const void* data, size_t length,
+                                   SkXMLParserError* error = NULL);
+    static SkPicture* DecodeStream(SkStream* stream,
+                                   SkXMLParserError* error = NULL);
+    static SkPicture* DecodeFile(const char path[],
+                                 SkXMLParserError* error = NULL);
+
+    /** Returns the number of pictures the cache keeps (the least recently
+        loaded are dropped first).
+    */
+    static int GetCacheCountLimit();
+    /** Sets the number of pictures the cache keeps, returning the previous
+        limit. Zero disables the cache.
+    */
+    static int SetCacheCountLimit(int count);
+    /** Drops every picture in the cache. */
+    static void PurgeCache();
+};
+
+#endif
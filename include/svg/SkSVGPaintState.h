@@ -90,6 +90,7 @@ private:
     bool writeChangedElements(SkSVGParser& , SkSVGPaint& , bool* changed);
     SkSVGPaint* fNext;
     friend class SkSVGParser;
+    friend class SkSVGRenderer;
     typedef SkSVGPaint BASE_CLASS;
 };
 
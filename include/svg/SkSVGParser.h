@@ -42,13 +42,25 @@ public:
         fXMLWriter.addAttributeLen(attrName, attrValue, len); }
     void _endElement() { fXMLWriter.endElement(); }
     int findAttribute(SkSVGBase* , const char* attrValue, size_t len, bool isPaint);
-//    const char* getFinal();
+    /** Returns the parsed document translated into animator XML (the
+        translation consumes the element tree).
+    */
+    const char* getFinal();
+    /** Returns the top level elements of the parsed document. The first is
+        the svg element itself.
+    */
+    const SkTDArray<SkSVGElement*>& getChildren() const { return fChildren; }
     SkTDict<SkSVGElement*>& getIDs() { return fIDs; }
     SkString& getPaintLast(SkSVGPaint::Field field);
     void _startElement(const char name[]) { fXMLWriter.startElement(name); }
     void translate(SkSVGElement*, bool isDef);
     void translateMatrix(SkString& , SkString* id);
     static void ConvertToArray(SkString& vals);
+    /** Parses an SVG transform list, such as "translate(10,20) scale(2)",
+        into matrix.
+        @return false if str is not a valid transform list
+    */
+    static bool ParseTransform(const char str[], SkMatrix* matrix);
 protected:
     virtual bool onAddAttribute(const char name[], const char value[]);
     bool onAddAttributeLen(const char name[], const char value[], size_t len);
@@ -70,6 +82,7 @@ private:
     SkTDict<SkSVGElement*> fIDs;
     SkTDArray<SkSVGElement*> fParents;
     SkDynamicMemoryWStream fStream;
+    SkString fFinal;
     SkXMLStreamWriter fXMLWriter;
     SkSVGElement*   fCurrElement;
     SkBool8 fInSVG;
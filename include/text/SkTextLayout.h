@@ -3,6 +3,9 @@
 
 #include "SkPaint.h"
 #include "SkRefCnt.h"
+#include "SkTDArray.h"
+
+class SkCanvas;
 
 class SkTextStyle : public SkRefCnt {
 public:
@@ -33,17 +36,16 @@ public:
 
 //    SkTextStyle* setStyle(SkTextStyle*, size_t offset, size_t length);
 
+    /** Breaks the text into lines the width of the bounds, and draws as many
+        as fit. The lines are cached (see SkTextLines), so drawing the same
+        text again doesn't lay it out again.
+    */
     void draw(SkCanvas* canvas);
 
 private:
     SkTDArray<char> fText;
     SkTextStyle*    fDefaultStyle;
     SkRect          fBounds;
-
-    // cache
-    struct Line;
-    struct GlyphRun;
-    SkTDArray<Line*> fLines;
 };
 
 #endif
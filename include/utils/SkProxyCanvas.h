@@ -44,6 +44,8 @@ public:
     virtual void drawPoints(PointMode mode, size_t count, const SkPoint pts[],
                             const SkPaint& paint);
     virtual void drawRect(const SkRect& rect, const SkPaint& paint);
+    virtual void drawRects(const SkRect rects[], size_t count,
+                           const SkPaint& paint);
     virtual void drawPath(const SkPath& path, const SkPaint& paint);
     virtual void drawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar top,
                             const SkPaint* paint = NULL);
@@ -53,6 +55,8 @@ public:
                                   const SkPaint* paint = NULL);
     virtual void drawSprite(const SkBitmap& bitmap, int left, int top,
                             const SkPaint* paint = NULL);
+    virtual void drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                             size_t count, const SkPaint* paint = NULL);
     virtual void drawText(const void* text, size_t byteLength, SkScalar x,
                           SkScalar y, const SkPaint& paint);
     virtual void drawPosText(const void* text, size_t byteLength,
@@ -19,6 +19,8 @@
 
 #include "SkCanvas.h"
 
+class SkGlyphCache;
+
 /** \class SkTextBox
 
     SkTextBox is a helper class for drawing 1 or more lines of text
@@ -81,5 +83,74 @@ public:
     static int CountLines(const char text[], size_t len, const SkPaint&, SkScalar width);
 };
 
+class SkDescriptor;
+
+/** \class SkTextLines
+
+    SkTextLines holds a paragraph of UTF-8 text converted to glyphs, broken
+    into lines for a width, with the position of every glyph. Lines are
+    shared through a global cache keyed by the text, the paint's font and
+    the width, so redrawing the same paragraph neither measures it nor looks
+    up its glyphs again. The least recently used paragraphs are dropped once
+    the cache is over its budget.
+*/
+class SkTextLines : public SkRefCnt {
+public:
+    virtual ~SkTextLines();
+
+    /** Returns the lines for the text, laid out with the paint, which the
+        caller must unref().
+    */
+    static SkTextLines* Find(const char text[], size_t len, const SkPaint&, SkScalar width);
+
+    int         countLines() const { return fLineCount; }
+    SkScalar    getLineWidth(int index) const;
+    /** Returns the UTF-8 text of the line, and its length in bytes */
+    const char* getLineText(int index, size_t* length) const;
+    /** Draws the line with its baseline at y, aligned on x according to the
+        paint's text align.
+    */
+    void        drawLine(SkCanvas*, int index, SkScalar x, SkScalar y, const SkPaint&) const;
+
+    /** Returns the number of bytes the cache may use */
+    static size_t GetCacheBudget();
+    /** Sets the number of bytes the cache may use, returning the previous
+        budget. Zero disables the cache.
+    */
+    static size_t SetCacheBudget(size_t bytes);
+    static void PurgeCache();
+
+private:
+    SkTextLines();
+
+    struct Line {
+        int     fStart;     // index of the line's first glyph
+        int     fCount;
+        SkFixed fWidth;
+        int     fTextStart; // byte offset of the line's first character
+        int     fTextLength;
+    };
+
+    void        layout(SkGlyphCache*, SkScalar width);
+    bool        matches(const char text[], size_t len, const SkDescriptor&, SkScalar width) const;
+    static void DetachTail();
+
+    SkDescriptor*   fDesc;
+    const char*     fText;
+    size_t          fLen;
+    SkScalar        fWidth;
+    uint32_t        fHash;
+    size_t          fSize;      // bytes charged to the cache
+
+    void*           fStorage;   // holds the text, lines, offsets and glyphs
+    const Line*     fLines;
+    int             fLineCount;
+    const SkFixed*  fOffsets;   // from the start of each line
+    const uint16_t* fGlyphs;
+
+    SkTextLines*    fPrev;      // most recently used first
+    SkTextLines*    fNext;
+};
+
 #endif
 
@@ -20,8 +20,10 @@
 #include "SkChunkAlloc.h"
 #include "SkMath.h"
 #include "SkScalar.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 
+class SkStream;
 struct SkDOMNode;
 struct SkDOMAttr;
 
@@ -36,6 +38,16 @@ public:
     /** Returns null on failure
     */
     const Node* build(const char doc[], size_t len);
+    /** Parses the whole stream, returning null on failure. If the stream is
+        backed by memory (e.g. SkMMAPStream), it is scanned where it is and
+        only the attribute values are copied out of it; the tree does not
+        refer to the stream afterwards. Otherwise the document is read once
+        into the DOM's own storage, and the values are left in it.
+
+        Every value is zero-terminated while the tree is built, so the const
+        methods never write to it and several threads may read it at once.
+    */
+    const Node* build(SkStream&);
     const Node* copy(const SkDOM& dom, const Node* node);
 
     const Node* getRootNode() const;
@@ -50,7 +62,25 @@ public:
     const Node* getFirstChild(const Node*, const char elem[] = NULL) const;
     const Node* getNextSibling(const Node*, const char elem[] = NULL) const;
 
+    /** Element and attribute names are interned into atoms, which are only
+        meaningful for the tree they were built with.
+    */
+    typedef int Atom;
+    enum {
+        kNoAtom = -1
+    };
+    /** Returns kNoAtom if no element or attribute in the tree has this name
+    */
+    Atom        findAtom(const char name[]) const;
+    const char* getAtomName(Atom) const;
+    Atom        getNameAtom(const Node*) const;
+    Atom        getAttrAtom(const Node*, const Attr*) const;
+
     const char* findAttr(const Node*, const char attrName[]) const;
+    const char* findAttr(const Node*, Atom attrName) const;
+    /** Also returns the value's length, sparing the caller a strlen.
+    */
+    const char* findAttr(const Node*, Atom attrName, size_t* length) const;
     const Attr* getFirstAttr(const Node*) const;
     const Attr* getNextAttr(const Node*, const Attr*) const;
     const char* getAttrName(const Node*, const Attr*) const;
@@ -82,6 +112,7 @@ public:
         AttrIter(const class SkDOM&, const Node*);
         const char* next(const char** value);
     private:
+        const SkDOM& fDOM;
         const Attr* fAttr;
         const Attr* fStop;
     };
@@ -90,10 +121,27 @@ public:
     SkDEBUGCODE(static void UnitTest();)
 
 private:
-    SkChunkAlloc    fAlloc;
-    Node*           fRoot;
+    struct AtomRec {
+        const char* fName;
+        uint32_t    fLength;
+        uint32_t    fHash;
+    };
+
+    SkChunkAlloc        fAlloc;
+    Node*               fRoot;
+    SkTDArray<AtomRec>  fAtoms;     // indexed by Atom
+    SkTDArray<Atom>     fAtomTable; // open addressed, kNoAtom marks empty slots
+
+    void        reset();
+    void        reserve(size_t docLength);
+    Atom        addAtom(const char name[], size_t len);
+    Atom        findAtom(const char name[], size_t len, uint32_t hash) const;
+    const Attr* findAttrRec(const Node*, Atom) const;
+
     friend class AttrIter;
+    friend class SkDOMBuilder;
     friend class SkDOMParser;
+    friend class SkDOMScanner;
 };
 
 #endif
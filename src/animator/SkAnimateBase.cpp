@@ -108,6 +108,24 @@ void SkAnimateBase::dump(SkAnimateMaker* maker) {
 }
 #endif
 
+// evaluates the formula into values, which holds getValuesType() entries
+bool SkAnimateBase::evaluateFormula(SkAnimateMaker& maker, SkTDOperandArray* values) {
+    SkDisplayTypes type = fFieldInfo->getType();
+    if (fFieldInfo->fType != SkType_Array && (type == SkType_Int || type == SkType_Float || 
+            type == SkType_MSec) && fCompiledFormula.compile(maker, NULL, formula, type)) {
+        SkScriptValue scriptValue;
+        if (fCompiledFormula.execute(&scriptValue)) {
+            if (type == SkType_MSec) {
+                scriptValue.fOperand.fMSec = SkScalarMulRound(scriptValue.fOperand.fScalar, 1000);
+                scriptValue.fType = SkType_MSec;
+            }
+            return fFieldInfo->writeValue(NULL, values, 0, 0, NULL, getValuesType(), 
+                scriptValue) == false;
+        }
+    }
+    return fFieldInfo->setValue(maker, values, 0, 0, NULL, getValuesType(), formula);
+}
+
 SkDisplayable* SkAnimateBase::getParent() const {
     return (SkDisplayable*) fApply;
 }
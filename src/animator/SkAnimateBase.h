@@ -18,6 +18,7 @@
 #ifndef SkAnimateBase_DEFINED
 #define SkAnimateBase_DEFINED
 
+#include "SkCompiledScript.h"
 #include "SkDisplayable.h"
 #include "SkMath.h"
 #include "SkMemberInfo.h"
@@ -38,6 +39,7 @@ public:
     virtual void dump(SkAnimateMaker* );
 #endif
     int entries() { return fValues.count() / components(); }
+    bool evaluateFormula(SkAnimateMaker& , SkTDOperandArray* values);
     virtual bool hasExecute() const;
     bool isDynamic() const { return SkToBool(fDynamic); }
     virtual SkDisplayable* getParent() const;
@@ -72,6 +74,7 @@ protected:
     SkMSec fStart;  // corrected time when this apply was enabled
     SkDrawable* fTarget;
     SkTypedArray fValues;
+    SkCompiledScript fCompiledFormula;
     unsigned fChanged : 1; // true when value referenced by script has changed
     unsigned fDelayed : 1;  // enabled, but undrawn pending delay
     unsigned fDynamic : 1;
@@ -128,6 +128,7 @@ public:
     SkBool8 fInInclude;
     SkBool8 fInMovie;
     SkBool8 fFirstScriptError;
+    SkBool8 fCompileScripts;
 #if defined SK_DEBUG && defined SK_DEBUG_ANIMATION_TIMING
     SkMSec fDebugTimeBase;
 #endif
@@ -158,6 +159,7 @@ private:
     friend class SkAnimator;
     friend class SkAnimatorScript;
     friend class SkApply;
+    friend class SkCompiledScript;
     friend class SkDisplayMovie;
     friend class SkDisplayType;
     friend class SkEvents;
@@ -639,6 +639,10 @@ bool SkAnimator::setString(const char* id, const char* fieldID, const char* str)
     return setString(element, field, str);
 }
 
+void SkAnimator::setCompileScripts(bool compile) {
+    fMaker->fCompileScripts = compile;
+}
+
 void SkAnimator::setTimeline(const Timeline& timeline) {
     fMaker->fTimeline = &timeline;
 }
@@ -675,6 +679,7 @@ bool SkAnimator::NoLeaks() {
 #ifdef SK_SUPPORT_UNITTEST
 #include "SkAnimatorScript.h"
 #include "SkBase64.h"
+#include "SkCompiledScript.h"
 #include "SkParse.h"
 #include "SkMemberInfo.h"
 
@@ -695,7 +700,8 @@ void SkAnimator::Init(bool runUnitTests) {
         unittestline(SkParse),
         unittestline(SkScriptEngine),
 //      unittestline(SkScriptEngine2),  // compiled script experiment
-        unittestline(SkAnimatorScript)
+        unittestline(SkAnimatorScript),
+        unittestline(SkCompiledScript)
     };
     for (int i = 0; i < (int)SK_ARRAY_COUNT(gUnitTests); i++)
     {
@@ -0,0 +1,633 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SkCompiledScript.h"
+#include "SkAnimateMaker.h"
+#include "SkDisplayable.h"
+#include "SkExtras.h"
+#include "SkMemberInfo.h"
+#include "SkParse.h"
+#include "SkScript2.h"
+
+// Code generation follows SkScriptRuntime's registers: each expression leaves
+// its value in the accumulator; a binary operator pushes its left value while
+// the right value is computed, then pops it back with the right value in the
+// operand register. Ints and floats follow SkScriptEngine's rules, except
+// that / always divides floats (SkScriptEngine divides ints when the result
+// is exact, which gives the same value).
+
+static inline bool is_between(int c, int min, int max) {
+    return (unsigned)(c - min) <= (unsigned)(max - min);
+}
+
+static inline bool is_ws(int c) {
+    return is_between(c, 1, 32);
+}
+
+static int token_length(const char* start) {
+    char ch = start[0];
+    if (! is_between(ch, 'a' , 'z') &&  ! is_between(ch, 'A', 'Z') && ch != '_' && ch != '$')
+        return 0;
+    int length = 0;
+    do
+        ch = start[++length];
+    while (is_between(ch, 'a' , 'z') || is_between(ch, 'A', 'Z') || is_between(ch, '0', '9') ||
+        ch == '_' || ch == '$');
+    return length;
+}
+
+static bool numeric_member(const SkMemberInfo* info, SkOperand2::OpType* type) {
+    if (info == NULL || info->fType == SkType_Array || info->fType == SkType_MemberFunction ||
+            info->getCount() != 1)
+        return false;
+    switch (info->getType()) {
+        case SkType_ARGB:
+        case SkType_Boolean:
+        case SkType_Int:
+            *type = SkOperand2::kS32;
+            return true;
+        case SkType_Float:
+        case SkType_MSec:
+            *type = SkOperand2::kScalar;
+            return true;
+        default:
+            return false;
+    }
+}
+
+namespace {
+
+enum OpKind {
+    kArithmetic_OpKind, // int if both sides are int, else float
+    kInt_OpKind,        // always int
+    kDivide_OpKind,     // always float
+    kCompare_OpKind,    // compares as kArithmetic_OpKind, returns int
+    kLogical_OpKind     // && and ||, which may skip their right side
+};
+
+struct BinaryOp {
+    const char* fText;
+    int fPrecedence;    // as SkScriptEngine's: lower binds tighter
+    SkScriptEngine2::TypeOp fToken; // int version, followed by float version
+    OpKind fKind;
+    bool fReverse;      // operands are swapped...
+    bool fNegate;       // ...and/or the result negated to make > < and !=
+};
+
+}
+
+// two character operators first, so that e.g. '<' doesn't match "<<"
+static const BinaryOp gBinaryOps[] = {
+    { "||", 14, SkScriptEngine2::kLogicalOrInt, kLogical_OpKind, false, false },
+    { "&&", 13, SkScriptEngine2::kLogicalAndInt, kLogical_OpKind, false, false },
+    { "==", 9, SkScriptEngine2::kEqualInt, kCompare_OpKind, false, false },
+    { "!=", 9, SkScriptEngine2::kEqualInt, kCompare_OpKind, false, true },
+    { ">=", 8, SkScriptEngine2::kGreaterEqualInt, kCompare_OpKind, false, false },
+    { "<=", 8, SkScriptEngine2::kGreaterEqualInt, kCompare_OpKind, true, false },
+    { "<<", 7, SkScriptEngine2::kShiftLeftInt, kInt_OpKind, false, false },
+    { ">>", 7, SkScriptEngine2::kShiftRightInt, kInt_OpKind, false, false },
+    { ">", 8, SkScriptEngine2::kGreaterEqualInt, kCompare_OpKind, true, true },
+    { "<", 8, SkScriptEngine2::kGreaterEqualInt, kCompare_OpKind, false, true },
+    { "|", 12, SkScriptEngine2::kBitOrInt, kInt_OpKind, false, false },
+    { "^", 11, SkScriptEngine2::kXorInt, kInt_OpKind, false, false },
+    { "&", 10, SkScriptEngine2::kBitAndInt, kInt_OpKind, false, false },
+    { "+", 6, SkScriptEngine2::kAddInt, kArithmetic_OpKind, false, false },
+    { "-", 6, SkScriptEngine2::kSubtractInt, kArithmetic_OpKind, false, false },
+    { "*", 5, SkScriptEngine2::kMultiplyInt, kArithmetic_OpKind, false, false },
+    { "/", 5, SkScriptEngine2::kDivideInt, kDivide_OpKind, false, false },
+    { "%", 5, SkScriptEngine2::kModuloInt, kArithmetic_OpKind, false, false }
+};
+
+#define kTightestBinaryPrecedence   5
+#define kLogicalOrPrecedence        14
+
+class SkCompiledScript::Compiler {
+public:
+    Compiler(SkCompiledScript* script) : fScript(script), fTokens(script->fTokens) {
+        fText = script->fScript.c_str();
+    }
+
+    bool compile() {
+        if (strncmp(fText, "#script:", sizeof("#script:") - 1) == 0)
+            return false;
+        SkOperand2::OpType type;
+        if (expression(&type) == false)
+            return false;
+        skipSpace();
+        if (fText[0] != '\0')
+            return false;
+        convert(type, fScript->fType == SkType_Int ? SkOperand2::kS32 : SkOperand2::kScalar);
+        addToken(SkScriptEngine2::kEnd);
+        return true;
+    }
+
+private:
+    void addToken(SkScriptEngine2::TypeOp op) {
+        *fTokens.append() = SkToU8(op);
+    }
+
+    void addData(const void* data, size_t size) {
+        memcpy(fTokens.append(size), data, size);
+    }
+
+    // returns the offset the branch is relative to
+    int addBranch(SkScriptEngine2::TypeOp op) {
+        addToken(op);
+        int size = 0;
+        addData(&size, sizeof(size));
+        return fTokens.count();
+    }
+
+    void resolveBranch(int offset, int target) {
+        int size = target - offset;
+        memcpy(&fTokens[offset - sizeof(size)], &size, sizeof(size));
+    }
+
+    void addConstant(SkOperand2 operand, SkOperand2::OpType type, bool accumulator) {
+        if (type == SkOperand2::kS32)
+            addToken(accumulator ? SkScriptEngine2::kIntegerAccumulator : SkScriptEngine2::kIntegerOperand);
+        else
+            addToken(accumulator ? SkScriptEngine2::kScalarAccumulator : SkScriptEngine2::kScalarOperand);
+        addData(&operand, sizeof(int32_t));
+    }
+
+    // true if the tokens from offset do nothing but load a constant
+    bool isConstant(int offset, SkOperand2* operand) {
+        if (fTokens.count() != offset + 1 + (int) sizeof(int32_t))
+            return false;
+        unsigned char op = fTokens[offset];
+        if (op != SkScriptEngine2::kIntegerAccumulator && op != SkScriptEngine2::kScalarAccumulator)
+            return false;
+        memcpy(operand, &fTokens[offset + 1], sizeof(int32_t));
+        return true;
+    }
+
+    static void ConvertConstant(SkOperand2* operand, SkOperand2::OpType from,
+            SkOperand2::OpType to) {
+        if (from == to)
+            return;
+        if (to == SkOperand2::kScalar)
+            operand->fScalar = SkScriptEngine2::IntToScalar(operand->fS32);
+        else
+            operand->fS32 = SkScalarFloor(operand->fScalar);
+    }
+
+    // converts the accumulator
+    void convert(SkOperand2::OpType from, SkOperand2::OpType to) {
+        if (from == to)
+            return;
+        addToken(to == SkOperand2::kScalar ? SkScriptEngine2::kIntToScalar :
+            SkScriptEngine2::kScalarToInt);
+    }
+
+    void skipSpace() {
+        while (is_ws(fText[0]))
+            fText++;
+    }
+
+    bool expression(SkOperand2::OpType* type) {
+        if (binary(kLogicalOrPrecedence, type) == false)
+            return false;
+        skipSpace();
+        if (fText[0] != '?')
+            return true;
+        fText++;
+        convert(*type, SkOperand2::kS32);
+        int ifOffset = addBranch(SkScriptEngine2::kIfOp);
+        SkOperand2::OpType trueType, falseType;
+        if (expression(&trueType) == false)
+            return false;
+        skipSpace();
+        if (fText[0] != ':')
+            return false;
+        fText++;
+        int trueEnd = fTokens.count();
+        int elseOffset = addBranch(SkScriptEngine2::kElseOp);
+        if (expression(&falseType) == false)
+            return false;
+        *type = trueType;
+        if (trueType != falseType) {
+            *type = SkOperand2::kScalar;
+            if (trueType == SkOperand2::kS32) {
+                unsigned char op = SkScriptEngine2::kIntToScalar;
+                fTokens.insert(trueEnd, 1, &op);
+                elseOffset += 1;
+            } else
+                convert(falseType, SkOperand2::kScalar);
+        }
+        resolveBranch(ifOffset, elseOffset);
+        resolveBranch(elseOffset, fTokens.count());
+        return true;
+    }
+
+    const BinaryOp* findBinaryOp(int precedence) {
+        skipSpace();
+        for (size_t index = 0; index < SK_ARRAY_COUNT(gBinaryOps); index++) {
+            const BinaryOp& op = gBinaryOps[index];
+            size_t length = strlen(op.fText);
+            if (strncmp(fText, op.fText, length) == 0)
+                return op.fPrecedence == precedence ? &op : NULL;
+        }
+        return NULL;
+    }
+
+    bool binary(int precedence, SkOperand2::OpType* type) {
+        if (precedence < kTightestBinaryPrecedence)
+            return unary(type);
+        if (binary(precedence - 1, type) == false)
+            return false;
+        const BinaryOp* op;
+        while ((op = findBinaryOp(precedence)) != NULL) {
+            fText += strlen(op->fText);
+            SkOperand2::OpType left = *type;
+            SkOperand2::OpType right;
+            if (op->fKind == kLogical_OpKind) {
+                // SkScriptEngine only takes ints here
+                if (left != SkOperand2::kS32)
+                    return false;
+                int offset = addBranch(op->fToken);
+                if (binary(precedence - 1, &right) == false || right != SkOperand2::kS32)
+                    return false;
+                resolveBranch(offset, fTokens.count());
+                addToken(SkScriptEngine2::kToBool);
+                *type = SkOperand2::kS32;
+                continue;
+            }
+            int pushOffset = fTokens.count();
+            addToken(SkScriptEngine2::kAccumulatorPush);
+            if (binary(precedence - 1, &right) == false)
+                return false;
+            SkOperand2::OpType opType = op->fKind == kInt_OpKind ? SkOperand2::kS32 :
+                op->fKind == kDivide_OpKind ? SkOperand2::kScalar :
+                left == SkOperand2::kS32 && right == SkOperand2::kS32 ? SkOperand2::kS32 :
+                SkOperand2::kScalar;
+            SkOperand2 constant;
+            if (isConstant(pushOffset + 1, &constant)) {
+                // the left value is still in the accumulator
+                fTokens.setCount(pushOffset);
+                ConvertConstant(&constant, right, opType);
+                convert(left, opType);
+                if (op->fReverse) {
+                    addToken(SkScriptEngine2::kFlipOpsOp);
+                    addConstant(constant, opType, true);
+                } else
+                    addConstant(constant, opType, false);
+            } else {
+                convert(right, opType);
+                addToken(SkScriptEngine2::kFlipOpsOp);
+                addToken(SkScriptEngine2::kAccumulatorPop);
+                convert(left, opType);
+                if (op->fReverse)
+                    addToken(SkScriptEngine2::kFlipOpsOp);
+            }
+            addToken((SkScriptEngine2::TypeOp) (op->fToken +
+                (opType == SkOperand2::kScalar)));
+            if (op->fNegate)
+                addToken(SkScriptEngine2::kLogicalNotInt);
+            *type = op->fKind == kCompare_OpKind ? SkOperand2::kS32 : opType;
+        }
+        return true;
+    }
+
+    bool unary(SkOperand2::OpType* type) {
+        skipSpace();
+        char ch = fText[0];
+        if (ch == '+') {
+            fText++;
+            return unary(type);
+        }
+        if (ch != '-' && ch != '!' && ch != '~')
+            return primary(type);
+        fText++;
+        int offset = fTokens.count();
+        if (unary(type) == false)
+            return false;
+        if (ch == '-') {
+            SkOperand2 constant;
+            if (isConstant(offset, &constant)) {
+                fTokens.setCount(offset);
+                if (*type == SkOperand2::kS32)
+                    constant.fS32 = -constant.fS32;
+                else
+                    constant.fScalar = -constant.fScalar;
+                addConstant(constant, *type, true);
+            } else
+                addToken(*type == SkOperand2::kS32 ? SkScriptEngine2::kMinusInt :
+                    SkScriptEngine2::kMinusScalar);
+            return true;
+        }
+        convert(*type, SkOperand2::kS32);
+        addToken(ch == '!' ? SkScriptEngine2::kLogicalNotInt : SkScriptEngine2::kBitNotInt);
+        *type = SkOperand2::kS32;
+        return true;
+    }
+
+    bool primary(SkOperand2::OpType* type) {
+        skipSpace();
+        char ch = fText[0];
+        if (ch == '(') {
+            fText++;
+            if (expression(type) == false)
+                return false;
+            skipSpace();
+            if (fText[0] != ')')
+                return false;
+            fText++;
+            return true;
+        }
+        SkOperand2 operand;
+        if (ch == '0' && (fText[1] & ~0x20) == 'X') {
+            fText = SkParse::FindHex(fText + 2, (uint32_t*) &operand.fS32);
+            if (fText == NULL)
+                return false;
+            *type = SkOperand2::kS32;
+        } else if (ch == '.' || is_between(ch, '0', '9')) {
+            const char* end = ch == '.' ? fText : SkParse::FindS32(fText, &operand.fS32);
+            if (end != NULL && end[0] != '.') {
+                fText = end;
+                *type = SkOperand2::kS32;
+            } else {
+                fText = SkParse::FindScalar(fText, &operand.fScalar);
+                if (fText == NULL)
+                    return false;
+                *type = SkOperand2::kScalar;
+            }
+        } else {
+            int length = token_length(fText);
+            if (length == 0)
+                return false;
+            const char* token = fText;
+            fText += length;
+            return reference(token, length, type);
+        }
+        if (token_length(fText) > 0 || fText[0] == '.')
+            return false;
+        addConstant(operand, *type, true);
+        return true;
+    }
+
+    bool reference(const char* token, size_t len, SkOperand2::OpType* type) {
+        SkAnimateMaker& maker = *fScript->fMaker;
+        if (fText[0] == '(' || fText[0] == '[')
+            return false;   // functions and arrays are left to the interpreter
+        // property callbacks that SkAnimatorScript asks before looking for an id
+        for (SkExtras** extraPtr = maker.fExtras.begin(); extraPtr < maker.fExtras.end(); extraPtr++) {
+            SkExtras* extra = *extraPtr;
+            SkScriptValue value;
+            if (extra->fExtraCallBack &&
+                    extra->fExtraCallBack(token, len, extra->fExtraStorage, &value))
+                return false;
+        }
+        bool member = fText[0] == '.';
+        SkOperand2 operand;
+        if (member == false && SK_LITERAL_STR_EQUAL("NaN", token, len)) {
+            operand.fScalar = SK_ScalarNaN;
+            *type = SkOperand2::kScalar;
+            addConstant(operand, *type, true);
+            return true;
+        }
+        if (member == false && SK_LITERAL_STR_EQUAL("Infinity", token, len)) {
+            operand.fScalar = SK_ScalarInfinity;
+            *type = SkOperand2::kScalar;
+            addConstant(operand, *type, true);
+            return true;
+        }
+        Reference ref;
+        SkDisplayable* displayable;
+        const SkMemberInfo* info;
+        if (maker.find(token, len, &displayable)) {
+            ref.fID.set(token, len);
+            ref.fDisplayType = displayable->getType();
+            if (member) {
+                const char* name = ++fText;
+                int nameLength = token_length(name);
+                if (nameLength == 0)
+                    return false;
+                fText += nameLength;
+                if (fText[0] == '.' || fText[0] == '(' || fText[0] == '[')
+                    return false;
+                SkString nameStr(name, nameLength);
+                if (displayable->contains(nameStr) != NULL)
+                    return false;
+                info = displayable->getMember(nameStr.c_str());
+            } else {
+                // boxed values are unboxed
+                switch (ref.fDisplayType) {
+                    case SkType_Boolean:
+                    case SkType_Float:
+                    case SkType_Int:
+                        info = displayable->getMember("value");
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        } else {
+            displayable = fScript->fWorking;
+            if (displayable == NULL || member || SK_LITERAL_STR_EQUAL("parent", token, len))
+                return false;
+            SkString nameStr(token, len);
+            if (displayable->contains(nameStr) != NULL)
+                return false;
+            ref.fDisplayType = displayable->getType();
+            info = displayable->getMember(nameStr.c_str());
+        }
+        if (numeric_member(info, type) == false)
+            return false;
+        ref.fInfo = info;
+        size_t index = fScript->fReferences.count();
+        *fScript->fReferences.append() = new Reference(ref);
+        addToken(SkScriptEngine2::kCallback);
+        int callBack = 0;
+        addData(&callBack, sizeof(callBack));
+        addToken(SkScriptEngine2::kMemberOp);
+        addData(&index, sizeof(index));
+        return true;
+    }
+
+    SkCompiledScript* fScript;
+    SkTDArray<unsigned char>& fTokens;
+    const char* fText;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkCompiledScript::MemberCallBack::invoke(size_t ref, void* , SkOperand2* value) {
+    return fScript->readReference(ref, value);
+}
+
+SkCompiledScript::SkCompiledScript() : fType(SkType_Unknown), fState(kUncompiled),
+        fMaker(NULL), fWorking(NULL), fMemberCallBack(this) {
+    *fCallBacks.append() = &fMemberCallBack;
+}
+
+SkCompiledScript::~SkCompiledScript() {
+    reset();
+}
+
+bool SkCompiledScript::compile(SkAnimateMaker& maker, SkDisplayable* working,
+        const SkString& script, SkDisplayTypes type) {
+    SkASSERT(type == SkType_Int || type == SkType_Float || type == SkType_MSec);
+    if (maker.fCompileScripts == false)
+        return false;
+    if (fState != kUncompiled && fMaker == &maker && fWorking == working && fType == type &&
+            fScript == script)
+        return fState == kCompiled;
+    reset();
+    fScript = script;
+    fType = type;
+    fMaker = &maker;
+    fWorking = working;
+    fState = kInterpreted;
+    // SkAnimatorScript makes a dynamic animator depend on the ids it reads
+    if (working && working->isAnimate())
+        return false;
+    Compiler compiler(this);
+    if (compiler.compile() == false) {
+        reset();
+        fState = kInterpreted;
+        return false;
+    }
+    fState = kCompiled;
+    return true;
+}
+
+bool SkCompiledScript::execute(SkScriptValue* value) {
+    SkASSERT(fState == kCompiled);
+    SkScriptRuntime runtime(fCallBacks);
+    SkOperand2 result;
+    if (runtime.executeTokens(fTokens.begin()) == false || runtime.getResult(&result) == false)
+        return false;
+    if (fType == SkType_Int) {
+        value->fOperand.fS32 = result.fS32;
+        value->fType = SkType_Int;
+    } else {
+        value->fOperand.fScalar = result.fScalar;
+        value->fType = SkType_Float;
+    }
+    return true;
+}
+
+bool SkCompiledScript::readReference(size_t index, SkOperand2* value) {
+    const Reference* ref = fReferences[index];
+    SkDisplayable* displayable = fWorking;
+    if (ref->fID.size() > 0 && (fMaker->find(ref->fID.c_str(), ref->fID.size(), &displayable) == false ||
+            displayable->getType() != ref->fDisplayType))
+        return false;
+    const SkMemberInfo* info = ref->fInfo;
+    SkScriptValue scriptValue;
+    if (info->fType == SkType_MemberProperty) {
+        if (displayable->getProperty(info->propertyIndex(), &scriptValue) == false)
+            return false;
+    } else
+        scriptValue.fOperand.fS32 = *(int32_t*) info->memberData(displayable);   // OK for SkScalar too
+    if (info->getType() == SkType_MSec)
+        value->fScalar = SkScalarDiv((SkScalar) scriptValue.fOperand.fS32, 1000);
+    else
+        value->fS32 = scriptValue.fOperand.fS32;
+    return true;
+}
+
+void SkCompiledScript::reset() {
+    fReferences.deleteAll();
+    fTokens.reset();
+    fState = kUncompiled;
+}
+
+#if defined SK_SUPPORT_UNITTEST
+
+#include "SkAnimator.h"
+#include "SkAnimatorScript.h"
+
+static const char compiledTestSetup[] =
+"<screenplay>\n"
+    "<int id='idx' value='2' />\n"
+    "<float id='half' value='0.5' />\n"
+    "<rect id='testRect' left='1' top='2' right='12.5' bottom='5' />\n"
+    "<array id='intArray' values='[1, 4, 6]' />\n"
+    "<string id='alpha' value='abc' />\n"
+"</screenplay>";
+
+static const struct {
+    const char* fScript;
+    SkDisplayTypes fType;
+    bool fCompiles;
+} compiledTests[] = {
+    { "1 + 2 * 3", SkType_Int, true },
+    { "(1 + 2) * 3 - -4", SkType_Int, true },
+    { "7 / 2", SkType_Float, true },
+    { "7 / 2", SkType_Int, true },
+    { "1 / 0", SkType_Float, true },
+    { "7 % 3 + 7.5 % 2", SkType_Float, true },
+    { "0x10 | 3 ^ 1 & 7", SkType_Int, true },
+    { "1 << 4 >> 2", SkType_Int, true },
+    { "~5 + !0 + !2.5", SkType_Int, true },
+    { "3 > 2 && 2 >= 2 && 1 < 2 && 2 <= 2 && 1 != 2 && 2 == 2", SkType_Int, true },
+    { "0 || 1 && 2", SkType_Int, true },
+    { "0 || 0.5", SkType_Int, false },
+    { "NaN > 1", SkType_Int, true },
+    { "Infinity >= 1 ? 1 : 0", SkType_Int, true },
+    { "idx ? half : 3", SkType_Float, true },
+    { "0 ? half : idx ? 3 : 4", SkType_Float, true },
+    { "idx * 3 + idx.value", SkType_Int, true },
+    { "half + half * idx", SkType_Float, true },
+    { "testRect.left + testRect.right / idx", SkType_Float, true },
+    { "testRect.width * 2", SkType_Float, true },
+    { "-testRect.right + 1.5", SkType_Int, true },
+    { "10 - 2 - 3 + 8 / 2 / 2 * 3 % 4", SkType_Float, true },
+    { "1 + 2 < 4 == 1 & -3 % 2", SkType_Int, true },
+    { "half ? 1 : 2", SkType_Int, true },
+    { "1 ? 2.5 : 3 ? 4 : 5", SkType_Int, true },
+    { "!idx + (idx > half) + (half <= idx) - 5 - -half", SkType_Float, true },
+    { " 3*( idx+1 ) ", SkType_Int, true },
+    { "intArray.length", SkType_Int, true },
+    { "intArray[1]", SkType_Int, false },
+    { "1 +", SkType_Int, false },
+    { "idx.value.value", SkType_Int, false },
+    { "Math.sin(0)", SkType_Float, false },
+    { "alpha + idx", SkType_Int, false },
+    { "#script:1", SkType_Int, false }
+};
+
+void SkCompiledScript::UnitTest() {
+    // the animator's members go through 32-bit SkOperand slots (see
+    // SkMemberInfo::setValue), so there is nothing to test on 64-bit hosts
+    if (sizeof(void*) != sizeof(SkScalar))
+        return;
+    SkAnimator animator;
+    SkASSERT(animator.decodeMemory(compiledTestSetup, sizeof(compiledTestSetup)-1));
+    for (unsigned index = 0; index < SK_ARRAY_COUNT(compiledTests); index++) {
+        SkCompiledScript compiled;
+        SkString script(compiledTests[index].fScript);
+        SkDisplayTypes type = compiledTests[index].fType;
+        bool compiles = compiled.compile(*animator.fMaker, NULL, script, type);
+        SkASSERT(compiles == compiledTests[index].fCompiles);
+        if (compiles == false)
+            continue;
+        SkScriptValue value;
+        SkASSERT(compiled.execute(&value));
+        SkAnimatorScript engine(*animator.fMaker, NULL, type);
+        SkScriptValue expected;
+        const char* text = script.c_str();
+        SkASSERT(engine.evaluateScript(&text, &expected));
+        SkASSERT(value.fType == type);
+        if (expected.fType != type)
+            engine.convertTo(type, &expected);
+        SkASSERT(value.fOperand.fS32 == expected.fOperand.fS32);
+    }
+}
+
+#endif
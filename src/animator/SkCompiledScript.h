@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SkCompiledScript_DEFINED
+#define SkCompiledScript_DEFINED
+
+#include "SkDisplayType.h"
+#include "SkScriptCallBack.h"
+#include "SkScriptRuntime.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+
+class SkAnimateMaker;
+class SkDisplayable;
+struct SkMemberInfo;
+struct SkScriptValue;
+
+/** A numeric script, such as an animator's formula or a group's condition,
+    compiled into SkScriptEngine2 tokens the first time it is evaluated. Each
+    later evaluation runs the tokens through SkScriptRuntime, instead of
+    parsing the script again with SkAnimatorScript.
+
+    Only int and float arithmetic, comparisons, logical operators, ?:, and
+    reads of the form id, id.member or member (of the working displayable)
+    are compiled. Any other script is left to SkAnimatorScript, as is any
+    evaluation whose ids no longer name elements of the types seen when the
+    script was compiled.
+*/
+class SkCompiledScript : SkNoncopyable {
+public:
+    SkCompiledScript();
+    ~SkCompiledScript();
+
+    /** Compiles script to return type (SkType_Int, SkType_Float or
+        SkType_MSec, which is returned in seconds, as a float). Does nothing
+        if script is the script last compiled.
+        @return true if the compiled script can be executed, false if the
+            script must be interpreted instead
+    */
+    bool compile(SkAnimateMaker& , SkDisplayable* working, const SkString& script,
+        SkDisplayTypes type);
+
+    /** Runs the script last successfully compiled.
+        @return false if the script must be interpreted instead
+    */
+    bool execute(SkScriptValue* value);
+
+#ifdef SK_SUPPORT_UNITTEST
+    static void UnitTest();
+#endif
+
+private:
+    enum State {
+        kUncompiled,
+        kCompiled,
+        kInterpreted
+    };
+
+    struct Reference {
+        SkString fID;                   // empty for members of fWorking
+        SkDisplayTypes fDisplayType;    // type of the element fID named
+        const SkMemberInfo* fInfo;
+    };
+
+    class MemberCallBack : public SkScriptCallBackMember {
+    public:
+        MemberCallBack(SkCompiledScript* script) : fScript(script) {}
+        virtual bool invoke(size_t ref, void* object, SkOperand2* value);
+    private:
+        SkCompiledScript* fScript;
+    };
+
+    class Compiler;
+
+    bool readReference(size_t index, SkOperand2* value);
+    void reset();
+
+    SkString fScript;
+    SkDisplayTypes fType;
+    State fState;
+    SkAnimateMaker* fMaker;
+    SkDisplayable* fWorking;
+    SkTDArray<unsigned char> fTokens;
+    SkTDArray<Reference*> fReferences;
+    MemberCallBack fMemberCallBack;
+    SkTDScriptCallBackArray fCallBacks;
+    friend class Compiler;
+};
+
+#endif // SkCompiledScript_DEFINED
@@ -111,7 +111,7 @@ bool SkGroup::doEvent(SkDisplayEvent::Kind kind, SkEventState* state) {
 }
 
 bool SkGroup::draw(SkAnimateMaker& maker) {
-    bool conditionTrue = ifCondition(maker, this, condition);
+    bool conditionTrue = ifCondition(maker, this, condition, &fCompiledCondition);
     bool result = false;
     for (SkDrawable** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++) {
         SkDrawable* drawable = *ptr;
@@ -173,7 +173,8 @@ bool SkGroup::enable(SkAnimateMaker& maker ) {
     reset();
     for (SkDrawable** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++) {
         SkDrawable* drawable = *ptr;
-        if (ifCondition(maker, drawable, enableCondition) == false)
+        if (ifCondition(maker, drawable, enableCondition,
+                &fCompiledEnableCondition) == false)
             continue;
         drawable->enable(maker);
     }
@@ -205,11 +206,17 @@ bool SkGroup::hasEnable() const {
 }
 
 bool SkGroup::ifCondition(SkAnimateMaker& maker, SkDrawable* drawable,
-        SkString& conditionString) {
+        SkString& conditionString, SkCompiledScript* compiled) {
     if (conditionString.size() == 0)
         return true;
     int32_t result;
-    bool success = SkAnimatorScript::EvaluateInt(maker, this, conditionString.c_str(), &result);
+    bool success;
+    SkScriptValue value;
+    if (compiled->compile(maker, this, conditionString, SkType_Int) && compiled->execute(&value)) {
+        result = value.fOperand.fS32;
+        success = true;
+    } else
+        success = SkAnimatorScript::EvaluateInt(maker, this, conditionString.c_str(), &result);
 #ifdef SK_DUMP_ENABLED
     if (maker.fDumpGConditions) {
         SkDebugf("group: ");
@@ -18,6 +18,7 @@
 #ifndef SkDrawGroup_DEFINED
 #define SkDrawGroup_DEFINED
 
+#include "SkCompiledScript.h"
 #include "SkDrawable.h"
 #include "SkIntArray.h"
 #include "SkMemberInfo.h"
@@ -59,9 +60,11 @@ public:
 #endif
 protected:
     bool ifCondition(SkAnimateMaker& maker, SkDrawable* drawable,
-        SkString& conditionString);
+        SkString& conditionString, SkCompiledScript* compiled);
     SkString condition;
     SkString enableCondition;
+    SkCompiledScript fCompiledCondition;
+    SkCompiledScript fCompiledEnableCondition;
     SkTDDrawableArray fChildren;
     SkTDDrawableArray* fParentList;
     SkTDIntArray fCopies;
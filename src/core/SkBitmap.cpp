@@ -1471,7 +1471,10 @@ void SkBitmap::unflatten(SkFlattenableReadBuffer& buffer) {
                 ctable = SkNEW_ARGS(SkColorTable, (buffer));
             }
             size_t size = this->getSize();
-            if (this->allocPixels(ctable)) {
+            if (buffer.sharePixels()) {
+                // the buffer outlives us, so draw from its copy of the pixels
+                this->setPixels(const_cast<void*>(buffer.skip(size)), ctable);
+            } else if (this->allocPixels(ctable)) {
                 this->lockPixels();
                 // Just read what we need.
                 buffer.read(this->getPixels(), this->getSafeSize());
@@ -181,7 +181,9 @@ static void D32_Mask_Color(void* dst, size_t dstRB, SkBitmap::Config,
         int w = width;
         do {
             unsigned aa = *mask++;
-            *device = SkBlendARGB32(pmc, *device, aa);
+            if (aa) {
+                *device = SkBlendARGB32(pmc, *device, aa);
+            }
             device += 1;
         } while (--w != 0);
         device = (uint32_t*)((char*)device + dstOffset);
@@ -201,7 +203,11 @@ static void D32_Mask_Opaque(void* dst, size_t dstRB, SkBitmap::Config,
         int w = width;
         do {
             unsigned aa = *mask++;
-            *device = SkAlphaMulQ(pmc, SkAlpha255To256(aa)) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+            if (0xFF == aa) {
+                *device = pmc;
+            } else if (aa) {
+                *device = SkAlphaMulQ(pmc, SkAlpha255To256(aa)) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+            }
             device += 1;
         } while (--w != 0);
         device = (uint32_t*)((char*)device + dstRB);
@@ -220,7 +226,11 @@ static void D32_Mask_Black(void* dst, size_t dstRB, SkBitmap::Config,
         int w = width;
         do {
             unsigned aa = *mask++;
-            *device = (aa << SK_A32_SHIFT) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+            if (0xFF == aa) {
+                *device = 0xFF << SK_A32_SHIFT;
+            } else if (aa) {
+                *device = (aa << SK_A32_SHIFT) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+            }
             device += 1;
         } while (--w != 0);
         device = (uint32_t*)((char*)device + dstRB);
@@ -228,23 +238,224 @@ static void D32_Mask_Black(void* dst, size_t dstRB, SkBitmap::Config,
     } while (--height != 0);
 }
 
-SkBlitMask::Proc SkBlitMask::Factory(SkBitmap::Config config, SkColor color) {
-    SkBlitMask::Proc proc = PlatformProcs(config, color);
-    proc = NULL;
-    if (NULL == proc) {
-        switch (config) {
-            case SkBitmap::kARGB_8888_Config:
-                if (SK_ColorBLACK == color) {
-                    proc = D32_Mask_Black;
-                } else if (0xFF == SkColorGetA(color)) {
-                    proc = D32_Mask_Opaque;
-                } else {
-                    proc = D32_Mask_Color;
-                }
-                break;
-            default:
-                break;
+///////////////////////////////////////////////////////////////////////////////
+
+/*  LCD masks hold a coverage for each of r, g and b. Each dst channel is
+    blended toward the color by its own coverage, and dst alpha toward 0xFF by
+    the largest of them. A translucent color scales the coverages by its
+    alpha, so it is the unpremultiplied channels that are blended toward.
+    The platform procs must give the same results.
+ */
+
+static inline int upscale31To32(int value) {
+    SkASSERT((unsigned)value <= 31);
+    return value + (value >> 4);
+}
+
+static inline int blend32(int src, int dst, int scale) {
+    SkASSERT((unsigned)src <= 0xFF);
+    SkASSERT((unsigned)dst <= 0xFF);
+    SkASSERT((unsigned)scale <= 32);
+    return dst + ((src - dst) * scale >> 5);
+}
+
+static void D32_LCD16_Color(void* dst, size_t dstRB, SkBitmap::Config,
+                            const uint8_t* mask, size_t maskRB, SkColor color,
+                            int width, int height) {
+    int srcR = SkColorGetR(color);
+    int srcG = SkColorGetG(color);
+    int srcB = SkColorGetB(color);
+    int scale = SkAlpha255To256(SkColorGetA(color));
+
+    SkPMColor* device = (SkPMColor*)dst;
+    const uint16_t* src = (const uint16_t*)mask;
+    do {
+        for (int i = 0; i < width; i++) {
+            uint16_t m = src[i];
+            if (0 == m) {
+                continue;
+            }
+            // all of them in 5 bits (green has 6), then upscaled to 0..32
+            int maskR = upscale31To32(SkGetPackedR16(m) >> (SK_R16_BITS - 5));
+            int maskG = upscale31To32(SkGetPackedG16(m) >> (SK_G16_BITS - 5));
+            int maskB = upscale31To32(SkGetPackedB16(m) >> (SK_B16_BITS - 5));
+            if (scale < 256) {
+                maskR = maskR * scale >> 8;
+                maskG = maskG * scale >> 8;
+                maskB = maskB * scale >> 8;
+            }
+            int maskA = SkMax32(SkMax32(maskR, maskG), maskB);
+
+            SkPMColor d = device[i];
+            device[i] = SkPackARGB32(blend32(0xFF, SkGetPackedA32(d), maskA),
+                                     blend32(srcR, SkGetPackedR32(d), maskR),
+                                     blend32(srcG, SkGetPackedG32(d), maskG),
+                                     blend32(srcB, SkGetPackedB32(d), maskB));
+        }
+        device = (SkPMColor*)((char*)device + dstRB);
+        src = (const uint16_t*)((const char*)src + maskRB);
+    } while (--height != 0);
+}
+
+static void D32_LCD32_Color(void* dst, size_t dstRB, SkBitmap::Config,
+                            const uint8_t* mask, size_t maskRB, SkColor color,
+                            int width, int height) {
+    int srcR = SkColorGetR(color);
+    int srcG = SkColorGetG(color);
+    int srcB = SkColorGetB(color);
+    int scale = SkAlpha255To256(SkColorGetA(color));
+
+    SkPMColor* device = (SkPMColor*)dst;
+    const uint32_t* src = (const uint32_t*)mask;
+    do {
+        for (int i = 0; i < width; i++) {
+            uint32_t m = src[i];
+            if (0 == m) {
+                continue;
+            }
+            int maskR = SkAlpha255To256(SkGetPackedR32(m));
+            int maskG = SkAlpha255To256(SkGetPackedG32(m));
+            int maskB = SkAlpha255To256(SkGetPackedB32(m));
+            if (scale < 256) {
+                maskR = maskR * scale >> 8;
+                maskG = maskG * scale >> 8;
+                maskB = maskB * scale >> 8;
+            }
+            int maskA = SkMax32(SkMax32(maskR, maskG), maskB);
+
+            SkPMColor d = device[i];
+            device[i] = SkPackARGB32(SkAlphaBlend(0xFF, SkGetPackedA32(d), maskA),
+                                     SkAlphaBlend(srcR, SkGetPackedR32(d), maskR),
+                                     SkAlphaBlend(srcG, SkGetPackedG32(d), maskG),
+                                     SkAlphaBlend(srcB, SkGetPackedB32(d), maskB));
+        }
+        device = (SkPMColor*)((char*)device + dstRB);
+        src = (const uint32_t*)((const char*)src + maskRB);
+    } while (--height != 0);
+}
+
+static inline int blend16(int src, int dst, int scale) {
+    SkASSERT((unsigned)scale <= 32);
+    return dst + ((src - dst) * scale >> 5);
+}
+
+static inline uint16_t blend_lcd_16(uint16_t d, int srcR, int srcG, int srcB,
+                                    int maskR, int maskG, int maskB) {
+    return SkPackRGB16(blend16(srcR, SkGetPackedR16(d), maskR),
+                       blend16(srcG, SkGetPackedG16(d), maskG),
+                       blend16(srcB, SkGetPackedB16(d), maskB));
+}
+
+static void D16_LCD16_Color(void* dst, size_t dstRB, SkBitmap::Config,
+                            const uint8_t* mask, size_t maskRB, SkColor color,
+                            int width, int height) {
+    int srcR = SkR32ToR16(SkColorGetR(color));
+    int srcG = SkG32ToG16(SkColorGetG(color));
+    int srcB = SkB32ToB16(SkColorGetB(color));
+    int scale = SkAlpha255To256(SkColorGetA(color));
+
+    uint16_t* device = (uint16_t*)dst;
+    const uint16_t* src = (const uint16_t*)mask;
+    do {
+        for (int i = 0; i < width; i++) {
+            uint16_t m = src[i];
+            if (0 == m) {
+                continue;
+            }
+            int maskR = upscale31To32(SkGetPackedR16(m) >> (SK_R16_BITS - 5));
+            int maskG = upscale31To32(SkGetPackedG16(m) >> (SK_G16_BITS - 5));
+            int maskB = upscale31To32(SkGetPackedB16(m) >> (SK_B16_BITS - 5));
+            if (scale < 256) {
+                maskR = maskR * scale >> 8;
+                maskG = maskG * scale >> 8;
+                maskB = maskB * scale >> 8;
+            }
+            device[i] = blend_lcd_16(device[i], srcR, srcG, srcB,
+                                     maskR, maskG, maskB);
+        }
+        device = (uint16_t*)((char*)device + dstRB);
+        src = (const uint16_t*)((const char*)src + maskRB);
+    } while (--height != 0);
+}
+
+static void D16_LCD32_Color(void* dst, size_t dstRB, SkBitmap::Config,
+                            const uint8_t* mask, size_t maskRB, SkColor color,
+                            int width, int height) {
+    int srcR = SkR32ToR16(SkColorGetR(color));
+    int srcG = SkG32ToG16(SkColorGetG(color));
+    int srcB = SkB32ToB16(SkColorGetB(color));
+    int scale = SkAlpha255To256(SkColorGetA(color));
+
+    uint16_t* device = (uint16_t*)dst;
+    const uint32_t* src = (const uint32_t*)mask;
+    do {
+        for (int i = 0; i < width; i++) {
+            uint32_t m = src[i];
+            if (0 == m) {
+                continue;
+            }
+            // 0..32, like the LCD16 coverages
+            int maskR = SkAlpha255To256(SkGetPackedR32(m)) >> 3;
+            int maskG = SkAlpha255To256(SkGetPackedG32(m)) >> 3;
+            int maskB = SkAlpha255To256(SkGetPackedB32(m)) >> 3;
+            if (scale < 256) {
+                maskR = maskR * scale >> 8;
+                maskG = maskG * scale >> 8;
+                maskB = maskB * scale >> 8;
+            }
+            device[i] = blend_lcd_16(device[i], srcR, srcG, srcB,
+                                     maskR, maskG, maskB);
         }
+        device = (uint16_t*)((char*)device + dstRB);
+        src = (const uint32_t*)((const char*)src + maskRB);
+    } while (--height != 0);
+}
+
+static SkBlitMask::Proc portable_proc(SkBitmap::Config config,
+                                      SkMask::Format format, SkColor color) {
+    switch (config) {
+        case SkBitmap::kARGB_8888_Config:
+            switch (format) {
+                case SkMask::kA8_Format:
+                    if (SK_ColorBLACK == color) {
+                        return D32_Mask_Black;
+                    } else if (0xFF == SkColorGetA(color)) {
+                        return D32_Mask_Opaque;
+                    }
+                    return D32_Mask_Color;
+                case SkMask::kLCD16_Format:
+                    return D32_LCD16_Color;
+                case SkMask::kLCD32_Format:
+                    return D32_LCD32_Color;
+                default:
+                    break;
+            }
+            break;
+        case SkBitmap::kRGB_565_Config:
+            switch (format) {
+                case SkMask::kLCD16_Format:
+                    return D16_LCD16_Color;
+                case SkMask::kLCD32_Format:
+                    return D16_LCD32_Color;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+    return NULL;
+}
+
+SkBlitMask::Proc SkBlitMask::Factory(SkBitmap::Config config,
+                                     SkMask::Format format, SkColor color) {
+    SkBlitMask::Proc proc = PlatformProcs(config, format, color);
+    if (SkMask::kA8_Format == format) {
+        // the portable A8 procs are still the ones we want
+        proc = NULL;
+    }
+    if (NULL == proc) {
+        proc = portable_proc(config, format, color);
     }
     return proc;
 }
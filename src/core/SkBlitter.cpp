@@ -19,6 +19,7 @@
 #include "SkAntiRun.h"
 #include "SkColor.h"
 #include "SkColorFilter.h"
+#include "SkDrawArena.h"
 #include "SkMask.h"
 #include "SkMaskFilter.h"
 #include "SkTemplatesPriv.h"
@@ -157,8 +158,8 @@ void SkBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
         }
     } else {
         int                         width = clip.width();
-        SkAutoSTMalloc<64, int16_t> runStorage(width + 1);
-        int16_t*                    runs = runStorage.get();
+        SkAutoDrawArenaAlloc        runStorage((width + 1) * sizeof(int16_t));
+        int16_t*                    runs = (int16_t*)runStorage.get();
         const uint8_t*              aa = mask.getAddr(clip.fLeft, clip.fTop);
 
         sk_memset16((uint16_t*)runs, 1, width);
@@ -17,6 +17,7 @@
 
 #include "SkCoreBlitters.h"
 #include "SkColorPriv.h"
+#include "SkDrawArena.h"
 #include "SkDither.h"
 #include "SkShader.h"
 #include "SkTemplatesPriv.h"
@@ -373,7 +374,7 @@ public:
 SkARGB4444_Shader_Blitter(const SkBitmap& device, const SkPaint& paint)
         : INHERITED(device, paint) {
     const int width = device.width();
-    fBuffer = (SkPMColor*)sk_malloc_throw(width * sizeof(SkPMColor) + width);
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(width * sizeof(SkPMColor) + width);
     fAAExpand = (uint8_t*)(fBuffer + width);
 
     fXfermode = paint.getXfermode();
@@ -393,7 +394,7 @@ SkARGB4444_Shader_Blitter(const SkBitmap& device, const SkPaint& paint)
 
 virtual ~SkARGB4444_Shader_Blitter() {
     SkSafeUnref(fXfermode);
-    sk_free(fBuffer);
+    SkDrawArena::Free(fBuffer);
 }
 
 virtual void blitH(int x, int y, int width) {
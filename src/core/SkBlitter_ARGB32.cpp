@@ -17,133 +17,27 @@
 
 #include "SkCoreBlitters.h"
 #include "SkColorPriv.h"
+#include "SkDrawArena.h"
 #include "SkShader.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static inline int upscale31To32(int value) {
-    SkASSERT((unsigned)value <= 31);
-    return value + (value >> 4);
-}
-
-static inline int blend32(int src, int dst, int scale) {
-    SkASSERT((unsigned)src <= 0xFF);
-    SkASSERT((unsigned)dst <= 0xFF);
-    SkASSERT((unsigned)scale <= 32);
-    return dst + ((src - dst) * scale >> 5);
-}
-
-static void blit_lcd16_opaque(SkPMColor dst[], const uint16_t src[],
-                              SkPMColor color, int width) {
-    int srcR = SkGetPackedR32(color);
-    int srcG = SkGetPackedG32(color);
-    int srcB = SkGetPackedB32(color);
-
-    for (int i = 0; i < width; i++) {
-        uint16_t mask = src[i];
-        if (0 == mask) {
-            continue;
-        }
-
-        SkPMColor d = dst[i];
-        
-        /*  We want all of these in 5bits, hence the shifts in case one of them
-         *  (green) is 6bits.
-         */
-        int maskR = SkGetPackedR16(mask) >> (SK_R16_BITS - 5);
-        int maskG = SkGetPackedG16(mask) >> (SK_G16_BITS - 5);
-        int maskB = SkGetPackedB16(mask) >> (SK_B16_BITS - 5);
-
-        // Now upscale them to 0..256, so we can use SkAlphaBlend
-        maskR = upscale31To32(maskR);
-        maskG = upscale31To32(maskG);
-        maskB = upscale31To32(maskB);
-
-        int maskA = SkMax32(SkMax32(maskR, maskG), maskB);
-
-        int dstA = SkGetPackedA32(d);
-        int dstR = SkGetPackedR32(d);
-        int dstG = SkGetPackedG32(d);
-        int dstB = SkGetPackedB32(d);
-
-        dst[i] = SkPackARGB32(blend32(0xFF, dstA, maskA),
-                              blend32(srcR, dstR, maskR),
-                              blend32(srcG, dstG, maskG),
-                              blend32(srcB, dstB, maskB));
-    }
-}
-
-static void blit_lcd32_opaque(SkPMColor dst[], const uint32_t src[],
-                              SkPMColor color, int width) {
-    int srcR = SkGetPackedR32(color);
-    int srcG = SkGetPackedG32(color);
-    int srcB = SkGetPackedB32(color);
-
-    for (int i = 0; i < width; i++) {
-        uint32_t mask = src[i];
-        if (0 == mask) {
-            continue;
-        }
-
-        SkPMColor d = dst[i];
-        
-        int maskR = SkGetPackedR32(mask);
-        int maskG = SkGetPackedG32(mask);
-        int maskB = SkGetPackedB32(mask);
-
-        // Now upscale them to 0..256, so we can use SkAlphaBlend
-        maskR = SkAlpha255To256(maskR);
-        maskG = SkAlpha255To256(maskG);
-        maskB = SkAlpha255To256(maskB);
-
-        int maskA = SkMax32(SkMax32(maskR, maskG), maskB);
-
-        int dstA = SkGetPackedA32(d);
-        int dstR = SkGetPackedR32(d);
-        int dstG = SkGetPackedG32(d);
-        int dstB = SkGetPackedB32(d);
-
-        dst[i] = SkPackARGB32(SkAlphaBlend(0xFF, dstA, maskA),
-                              SkAlphaBlend(srcR, dstR, maskR),
-                              SkAlphaBlend(srcG, dstG, maskG),
-                              SkAlphaBlend(srcB, dstB, maskB));
-    }
-}
-
-static void blitmask_lcd16(const SkBitmap& device, const SkMask& mask,
-                           const SkIRect& clip, SkPMColor srcColor) {
+static void blitmask_lcd(SkBlitMask::Proc proc, const SkBitmap& device,
+                         const SkMask& mask, const SkIRect& clip,
+                         SkColor color) {
     int x = clip.fLeft;
     int y = clip.fTop;
-    int width = clip.width();
-    int height = clip.height();
-
-    SkPMColor*		dstRow = device.getAddr32(x, y);
-    const uint16_t* srcRow = mask.getAddrLCD16(x, y);
-
-    do {
-        blit_lcd16_opaque(dstRow, srcRow, srcColor, width);
-        dstRow = (SkPMColor*)((char*)dstRow + device.rowBytes());
-        srcRow = (const uint16_t*)((const char*)srcRow + mask.fRowBytes);
-    } while (--height != 0);
-}
-
-static void blitmask_lcd32(const SkBitmap& device, const SkMask& mask,
-                           const SkIRect& clip, SkPMColor srcColor) {
-    int x = clip.fLeft;
-    int y = clip.fTop;
-    int width = clip.width();
-    int height = clip.height();
-
-    SkPMColor*		dstRow = device.getAddr32(x, y);
-    const uint32_t* srcRow = mask.getAddrLCD32(x, y);
-
-    do {
-        blit_lcd32_opaque(dstRow, srcRow, srcColor, width);
-        dstRow = (SkPMColor*)((char*)dstRow + device.rowBytes());
-        srcRow = (const uint32_t*)((const char*)srcRow + mask.fRowBytes);
-    } while (--height != 0);
+    const uint8_t* maskAddr;
+    if (SkMask::kLCD16_Format == mask.fFormat) {
+        maskAddr = (const uint8_t*)mask.getAddrLCD16(x, y);
+    } else {
+        maskAddr = (const uint8_t*)mask.getAddrLCD32(x, y);
+    }
+    proc(device.getAddr32(x, y), device.rowBytes(),
+         SkBitmap::kARGB_8888_Config, maskAddr, mask.fRowBytes, color,
+         clip.width(), clip.height());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -189,7 +83,12 @@ SkARGB32_Blitter::SkARGB32_Blitter(const SkBitmap& device, const SkPaint& paint)
     fColor32Proc = SkBlitRow::ColorProcFactory();
 
     // init the pro for blitmask
-    fBlitMaskProc = SkBlitMask::Factory(SkBitmap::kARGB_8888_Config, color);
+    fBlitMaskProc = SkBlitMask::Factory(SkBitmap::kARGB_8888_Config,
+                                        SkMask::kA8_Format, color);
+    fBlitLCD16Proc = SkBlitMask::Factory(SkBitmap::kARGB_8888_Config,
+                                         SkMask::kLCD16_Format, color);
+    fBlitLCD32Proc = SkBlitMask::Factory(SkBitmap::kARGB_8888_Config,
+                                         SkMask::kLCD32_Format, color);
 }
 
 const SkBitmap* SkARGB32_Blitter::justAnOpaqueColor(uint32_t* value) {
@@ -298,10 +197,10 @@ void SkARGB32_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
 		SkARGB32_Blit32(fDevice, mask, clip, fPMColor);
 		return;
     } else if (SkMask::kLCD16_Format == mask.fFormat) {
-        blitmask_lcd16(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD16Proc, fDevice, mask, clip, fColor);
         return;
     } else if (SkMask::kLCD32_Format == mask.fFormat) {
-        blitmask_lcd32(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD32Proc, fDevice, mask, clip, fColor);
         return;
     }
 
@@ -325,10 +224,10 @@ void SkARGB32_Opaque_Blitter::blitMask(const SkMask& mask,
 		SkARGB32_Blit32(fDevice, mask, clip, fPMColor);
 		return;
     } else if (SkMask::kLCD16_Format == mask.fFormat) {
-        blitmask_lcd16(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD16Proc, fDevice, mask, clip, fColor);
         return;
     } else if (SkMask::kLCD32_Format == mask.fFormat) {
-        blitmask_lcd32(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD32Proc, fDevice, mask, clip, fColor);
         return;
 	}
 
@@ -405,9 +304,9 @@ void SkARGB32_Black_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     } else if (SkMask::kARGB32_Format == mask.fFormat) {
 		SkARGB32_Blit32(fDevice, mask, clip, fPMColor);
     } else if (SkMask::kLCD16_Format == mask.fFormat) {
-        blitmask_lcd16(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD16Proc, fDevice, mask, clip, fColor);
     } else if (SkMask::kLCD32_Format == mask.fFormat) {
-        blitmask_lcd32(fDevice, mask, clip, fPMColor);
+        blitmask_lcd(fBlitLCD32Proc, fDevice, mask, clip, fColor);
     } else {
         unsigned width = clip.width();
         unsigned height = clip.height();
@@ -423,7 +322,11 @@ void SkARGB32_Black_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
             unsigned w = width;
             do {
                 unsigned aa = *alpha++;
-                *device = (aa << SK_A32_SHIFT) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+                if (0xFF == aa) {
+                    *device = 0xFF << SK_A32_SHIFT;
+                } else if (aa) {
+                    *device = (aa << SK_A32_SHIFT) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
+                }
                 device += 1;
             } while (--w != 0);
             device = (uint32_t*)((char*)device + deviceRB);
@@ -467,7 +370,7 @@ void SkARGB32_Black_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
 
 SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkBitmap& device,
                             const SkPaint& paint) : INHERITED(device, paint) {
-    fBuffer = (SkPMColor*)sk_malloc_throw(device.width() * (sizeof(SkPMColor)));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(device.width() * (sizeof(SkPMColor)));
 
     fXfermode = paint.getXfermode();
     SkSafeRef(fXfermode);
@@ -484,7 +387,7 @@ SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkBitmap& device,
 
 SkARGB32_Shader_Blitter::~SkARGB32_Shader_Blitter() {
     SkSafeUnref(fXfermode);
-    sk_free(fBuffer);
+    SkDrawArena::Free(fBuffer);
 }
 
 void SkARGB32_Shader_Blitter::blitH(int x, int y, int width) {
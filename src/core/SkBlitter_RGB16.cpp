@@ -18,6 +18,7 @@
 #include "SkBlitRow.h"
 #include "SkCoreBlitters.h"
 #include "SkColorPriv.h"
+#include "SkDrawArena.h"
 #include "SkDither.h"
 #include "SkShader.h"
 #include "SkTemplatesPriv.h"
@@ -72,6 +73,12 @@ public:
     virtual const SkBitmap* justAnOpaqueColor(uint32_t*);
     
 protected:
+    // returns false, having drawn nothing, if the mask isn't an LCD mask
+    bool blitLCDMask(const SkMask&, const SkIRect&);
+
+    SkColor     fColor;
+    SkBlitMask::Proc fBlitLCD16Proc;
+    SkBlitMask::Proc fBlitLCD32Proc;
     SkPMColor   fSrcColor32;
     uint32_t    fExpandedRaw16;
     unsigned    fScale;
@@ -214,7 +221,7 @@ void SkRGB16_Black_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
                                      const SkIRect& SK_RESTRICT clip) {
     if (mask.fFormat == SkMask::kBW_Format) {
         SkRGB16_Black_BlitBW(fDevice, mask, clip);
-    } else {
+    } else if (!this->blitLCDMask(mask, clip)) {
         uint16_t* SK_RESTRICT device = fDevice.getAddr16(clip.fLeft, clip.fTop);
         const uint8_t* SK_RESTRICT alpha = mask.getAddr(clip.fLeft, clip.fTop);
         unsigned width = clip.width();
@@ -231,7 +238,11 @@ void SkRGB16_Black_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
             unsigned w = width;
             do {
                 unsigned aa = *alpha++;
-                *device = SkAlphaMulRGB16(*device, SkAlpha255To256(255 - aa));
+                if (0xFF == aa) {
+                    *device = 0;
+                } else if (aa) {
+                    *device = SkAlphaMulRGB16(*device, SkAlpha255To256(255 - aa));
+                }
                 device += 1;
             } while (--w != 0);
             device = (uint16_t*)((char*)device + deviceRB);
@@ -384,6 +395,9 @@ void SkRGB16_Opaque_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
         SkRGB16_BlitBW(fDevice, mask, clip, fColor16);
         return;
     }
+    if (this->blitLCDMask(mask, clip)) {
+        return;
+    }
 
     uint16_t* SK_RESTRICT device = fDevice.getAddr16(clip.fLeft, clip.fTop);
     const uint8_t* SK_RESTRICT alpha = mask.getAddr(clip.fLeft, clip.fTop);
@@ -477,8 +491,11 @@ void SkRGB16_Opaque_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
     do {
         int w = width;
         do {
-            *device = blend_compact(expanded32, SkExpand_rgb_16(*device),
-                                    SkAlpha255To256(*alpha++) >> 3);
+            unsigned aa = *alpha++;
+            if (aa) {
+                *device = blend_compact(expanded32, SkExpand_rgb_16(*device),
+                                        SkAlpha255To256(aa) >> 3);
+            }
             device += 1;
         } while (--w != 0);
         device = (uint16_t*)((char*)device + deviceRB);
@@ -532,6 +549,12 @@ SkRGB16_Blitter::SkRGB16_Blitter(const SkBitmap& device, const SkPaint& paint)
     : INHERITED(device) {
     SkColor color = paint.getColor();
 
+    fColor = color;
+    fBlitLCD16Proc = SkBlitMask::Factory(SkBitmap::kRGB_565_Config,
+                                         SkMask::kLCD16_Format, color);
+    fBlitLCD32Proc = SkBlitMask::Factory(SkBitmap::kRGB_565_Config,
+                                         SkMask::kLCD32_Format, color);
+
     fSrcColor32 = SkPreMultiplyColor(color);
     fScale = SkAlpha255To256(SkColorGetA(color));
 
@@ -560,6 +583,26 @@ const SkBitmap* SkRGB16_Blitter::justAnOpaqueColor(uint32_t* value) {
     return NULL;
 }
 
+bool SkRGB16_Blitter::blitLCDMask(const SkMask& SK_RESTRICT mask,
+                                  const SkIRect& SK_RESTRICT clip) {
+    int x = clip.fLeft;
+    int y = clip.fTop;
+    SkBlitMask::Proc proc;
+    const uint8_t* maskAddr;
+    if (SkMask::kLCD16_Format == mask.fFormat) {
+        proc = fBlitLCD16Proc;
+        maskAddr = (const uint8_t*)mask.getAddrLCD16(x, y);
+    } else if (SkMask::kLCD32_Format == mask.fFormat) {
+        proc = fBlitLCD32Proc;
+        maskAddr = (const uint8_t*)mask.getAddrLCD32(x, y);
+    } else {
+        return false;
+    }
+    proc(fDevice.getAddr16(x, y), fDevice.rowBytes(), SkBitmap::kRGB_565_Config,
+         maskAddr, mask.fRowBytes, fColor, clip.width(), clip.height());
+    return true;
+}
+
 static uint32_t pmcolor_to_expand16(SkPMColor c) {
     unsigned r = SkGetPackedR32(c);
     unsigned g = SkGetPackedG32(c);
@@ -644,6 +687,9 @@ void SkRGB16_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
         SkRGB16_BlendBW(fDevice, mask, clip, 256 - fScale, fColor16);
         return;
     }
+    if (this->blitLCDMask(mask, clip)) {
+        return;
+    }
 
     uint16_t* SK_RESTRICT device = fDevice.getAddr16(clip.fLeft, clip.fTop);
     const uint8_t* SK_RESTRICT alpha = mask.getAddr(clip.fLeft, clip.fTop);
@@ -658,10 +704,13 @@ void SkRGB16_Blitter::blitMask(const SkMask& SK_RESTRICT mask,
         int w = width;
         do {
             unsigned aa = *alpha++;
-            unsigned scale = SkAlpha255To256(aa) * scale256 >> (8 + 3);
-            uint32_t src32 = color32 * scale;
-            uint32_t dst32 = SkExpand_rgb_16(*device) * (32 - scale);
-            *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
+            if (aa) {
+                unsigned scale = SkAlpha255To256(aa) * scale256 >> (8 + 3);
+                uint32_t src32 = color32 * scale;
+                uint32_t dst32 = SkExpand_rgb_16(*device) * (32 - scale);
+                *device = SkCompact_rgb_16((src32 + dst32) >> 5);
+            }
+            device += 1;
         } while (--w != 0);
         device = (uint16_t*)((char*)device + deviceRB);
         alpha += maskRB;
@@ -825,7 +874,7 @@ SkRGB16_Shader_Blitter::SkRGB16_Shader_Blitter(const SkBitmap& device,
 : INHERITED(device, paint) {
     SkASSERT(paint.getXfermode() == NULL);
 
-    fBuffer = (SkPMColor*)sk_malloc_throw(device.width() * sizeof(SkPMColor));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(device.width() * sizeof(SkPMColor));
 
     // compute SkBlitRow::Procs
     unsigned flags = 0;
@@ -847,7 +896,7 @@ SkRGB16_Shader_Blitter::SkRGB16_Shader_Blitter(const SkBitmap& device,
 }
 
 SkRGB16_Shader_Blitter::~SkRGB16_Shader_Blitter() {
-    sk_free(fBuffer);
+    SkDrawArena::Free(fBuffer);
 }
 
 void SkRGB16_Shader_Blitter::blitH(int x, int y, int width) {
@@ -954,13 +1003,13 @@ SkRGB16_Shader_Xfermode_Blitter::SkRGB16_Shader_Xfermode_Blitter(
     fXfermode->ref();
 
     int width = device.width();
-    fBuffer = (SkPMColor*)sk_malloc_throw((width + (SkAlign4(width) >> 2)) * sizeof(SkPMColor));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc((width + (SkAlign4(width) >> 2)) * sizeof(SkPMColor));
     fAAExpand = (uint8_t*)(fBuffer + width);
 }
 
 SkRGB16_Shader_Xfermode_Blitter::~SkRGB16_Shader_Xfermode_Blitter() {
     fXfermode->unref();
-    sk_free(fBuffer);
+    SkDrawArena::Free(fBuffer);
 }
 
 void SkRGB16_Shader_Xfermode_Blitter::blitH(int x, int y, int width) {
@@ -22,6 +22,7 @@
 #include "SkDrawLooper.h"
 #include "SkPicture.h"
 #include "SkScalarCompare.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTLazy.h"
 #include "SkUtils.h"
@@ -224,7 +225,7 @@ public:
         canvas->updateDeviceCMCache();
 
         fClipStack = &canvas->getTotalClipStack();
-        fBounder = canvas->getBounder();
+        fCanvasBounder = canvas->getBounder();
         fCurrLayer = canvas->fMCRec->fTopLayer;
         fSkipEmptyClips = skipEmptyClips;
     }
@@ -250,6 +251,10 @@ public:
             SkDEBUGCODE(this->validate();)
 
             fCurrLayer = rec->fNext;
+            fBounder = fCanvasBounder;
+            if (fDevice->isTrackingDamage()) {
+                fBounder = fDevice->getDamageBounder(fCanvasBounder);
+            }
             if (fBounder) {
                 fBounder->setClip(fClip);
             }
@@ -270,6 +275,7 @@ public:
 
 private:
     SkCanvas*       fCanvas;
+    SkBounder*      fCanvasBounder;
     const DeviceCM* fCurrLayer;
     const SkPaint*  fPaint;     // May be null.
     SkBool8         fSkipEmptyClips;
@@ -1265,6 +1271,35 @@ void SkCanvas::drawRect(const SkRect& r, const SkPaint& paint) {
     LOOPER_END
 }
 
+void SkCanvas::drawRects(const SkRect rects[], size_t count,
+                         const SkPaint& paint) {
+    if ((long)count <= 0) {
+        return;
+    }
+
+    SkASSERT(rects != NULL);
+
+    if (paint.canComputeFastBounds()) {
+        SkRect bounds = rects[0];
+        for (size_t i = 1; i < count; i++) {
+            bounds.join(rects[i]);
+        }
+        SkRect storage;
+        if (this->quickReject(paint.computeFastBounds(bounds, &storage),
+                              paint2EdgeType(&paint))) {
+            return;
+        }
+    }
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kRect_Type)
+
+    while (iter.next()) {
+        iter.fDevice->drawRects(iter, rects, count, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     if (paint.canComputeFastBounds()) {
         SkRect storage;
@@ -1390,6 +1425,40 @@ void SkCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
     LOOPER_END
 }
 
+void SkCanvas::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                           size_t count, const SkPaint* paint) {
+    SkDEBUGCODE(bitmap.validate();)
+
+    if ((long)count <= 0 || reject_bitmap(bitmap)) {
+        return;
+    }
+
+    SkASSERT(pts != NULL);
+
+    SkPaint tmp;
+    if (NULL == paint) {
+        paint = &tmp;
+    }
+
+    // layers that aren't at the origin need the points in their coordinates
+    SkTDArray<SkIPoint> moved;
+
+    LOOPER_BEGIN(*paint, SkDrawFilter::kBitmap_Type)
+
+    while (iter.next()) {
+        const SkIPoint* devPts = pts;
+        if (iter.getX() || iter.getY()) {
+            moved.setCount(count);
+            for (size_t i = 0; i < count; i++) {
+                moved[i].set(pts[i].fX - iter.getX(), pts[i].fY - iter.getY());
+            }
+            devPts = moved.begin();
+        }
+        iter.fDevice->drawSprites(iter, bitmap, devPts, count, looper.paint());
+    }
+    LOOPER_END
+}
+
 class SkDeviceFilteredPaint {
 public:
     SkDeviceFilteredPaint(SkDevice* device, const SkPaint& paint) {
@@ -16,6 +16,7 @@
 */
 
 #include "SkColorFilter.h"
+#include "SkColorFilterProcs.h"
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
 
@@ -40,6 +41,42 @@ SkColor SkColorFilter::filterColor(SkColor c) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*  The platform procs are looked up once, like sk_memset16's. A racing thread
+    at worst looks them up again, and one that sees gPlatformProcsLookedUp
+    before the procs themselves just uses the portable code for that span.
+ */
+static bool gPlatformProcsLookedUp;
+static bool gUsePlatformProcs = true;
+static SkColorFilterProcs::MatrixSpanProc    gMatrixSpanProc;
+static SkColorFilterProcs::MatrixSpan16Proc  gMatrixSpan16Proc;
+static SkColorFilterProcs::LightingSpanProc  gLightingSpanProc;
+
+SkColorFilterProcs::MatrixSpanProc SkColorFilterProcs::GetMatrixSpanProc() {
+    if (!gPlatformProcsLookedUp) {
+        gMatrixSpanProc = PlatformMatrixSpanProc();
+        gMatrixSpan16Proc = PlatformMatrixSpan16Proc();
+        gLightingSpanProc = PlatformLightingSpanProc();
+        gPlatformProcsLookedUp = true;
+    }
+    return gUsePlatformProcs ? gMatrixSpanProc : NULL;
+}
+
+SkColorFilterProcs::MatrixSpan16Proc SkColorFilterProcs::GetMatrixSpan16Proc() {
+    GetMatrixSpanProc();
+    return gUsePlatformProcs ? gMatrixSpan16Proc : NULL;
+}
+
+SkColorFilterProcs::LightingSpanProc SkColorFilterProcs::GetLightingSpanProc() {
+    GetMatrixSpanProc();
+    return gUsePlatformProcs ? gLightingSpanProc : NULL;
+}
+
+void SkColorFilterProcs::SetUsePlatformProcs(bool use) {
+    gUsePlatformProcs = use;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 SkFilterShader::SkFilterShader(SkShader* shader, SkColorFilter* filter) {
     fShader = shader;   shader->ref();
     fFilter = filter;   filter->ref();
@@ -0,0 +1,66 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#ifndef SkColorFilterProcs_DEFINED
+#define SkColorFilterProcs_DEFINED
+
+#include "SkColor.h"
+
+/** Span procs that replace the per-pixel loops of the color matrix (see
+    SkColorMatrixFilter) and lighting filters, on platforms that have them
+    (e.g. SSE2). Their results match the portable code exactly.
+*/
+class SkColorFilterProcs {
+public:
+    /** matrix[] is the 4x5 matrix in 16.16 fixed point, shifted right by
+        (16 - shift) bits so that it can be multiplied by 8bit components
+        without overflow, with the rounding bias already in its add column.
+        The 16bit proc treats each pixel as opaque, but leaves its alpha
+        input at 0.
+    */
+    typedef void (*MatrixSpanProc)(const int32_t matrix[20], int shift,
+                                   const SkPMColor src[], int count,
+                                   SkPMColor dst[]);
+    typedef void (*MatrixSpan16Proc)(const int32_t matrix[20], int shift,
+                                     const uint16_t src[], int count,
+                                     uint16_t dst[]);
+    /** mul and add are as in SkColorFilter::CreateLightingFilter. If pin is
+        false, the components are not pinned to their alpha, which the caller
+        knows they cannot exceed.
+    */
+    typedef void (*LightingSpanProc)(SkColor mul, SkColor add, bool pin,
+                                     const SkPMColor src[], int count,
+                                     SkPMColor dst[]);
+
+    /** Return this platform's span procs, or NULL if the filters should use
+        their portable code. All of them return NULL while
+        SetUsePlatformProcs(false) is in effect, so that benches and tests can
+        compare the two.
+    */
+    static MatrixSpanProc GetMatrixSpanProc();
+    static MatrixSpan16Proc GetMatrixSpan16Proc();
+    static LightingSpanProc GetLightingSpanProc();
+    static void SetUsePlatformProcs(bool);
+
+private:
+    /** Implemented in src/opts. */
+    static MatrixSpanProc PlatformMatrixSpanProc();
+    static MatrixSpan16Proc PlatformMatrixSpan16Proc();
+    static LightingSpanProc PlatformLightingSpanProc();
+};
+
+#endif
@@ -55,22 +55,6 @@ void SkComposeShader::endSession() {
     this->INHERITED::endSession();
 }
 
-class SkAutoAlphaRestore {
-public:
-    SkAutoAlphaRestore(SkPaint* paint, uint8_t newAlpha) {
-        fAlpha = paint->getAlpha();
-        fPaint = paint;
-        paint->setAlpha(newAlpha);
-    }
-
-    ~SkAutoAlphaRestore() {
-        fPaint->setAlpha(fAlpha);
-    }
-private:
-    SkPaint*    fPaint;
-    uint8_t     fAlpha;
-};
-
 void SkComposeShader::flatten(SkFlattenableWriteBuffer& buffer) {
     this->INHERITED::flatten(buffer);
     buffer.writeFlattenable(fShaderA);
@@ -97,10 +81,12 @@ bool SkComposeShader::setContext(const SkBitmap& device,
     (void)this->getLocalMatrix(&tmpM);
     tmpM.setConcat(matrix, tmpM);
 
-    SkAutoAlphaRestore  restore(const_cast<SkPaint*>(&paint), 0xFF);
+    // use a copy, since other threads may be drawing with paint
+    SkPaint opaquePaint(paint);
+    opaquePaint.setAlpha(0xFF);
 
-    return  fShaderA->setContext(device, paint, tmpM) &&
-            fShaderB->setContext(device, paint, tmpM);
+    return  fShaderA->setContext(device, opaquePaint, tmpM) &&
+            fShaderB->setContext(device, opaquePaint, tmpM);
 }
 
 // larger is better (fewer times we have to loop), but we shouldn't
@@ -105,6 +105,8 @@ protected:
     SkPMColor              fPMColor;
     SkBlitRow::ColorProc   fColor32Proc;
     SkBlitMask::Proc       fBlitMaskProc;
+    SkBlitMask::Proc       fBlitLCD16Proc;
+    SkBlitMask::Proc       fBlitLCD32Proc;
 
 private:
     unsigned fSrcA, fSrcR, fSrcG, fSrcB;
@@ -1,7 +1,9 @@
 #include "SkDevice.h"
+#include "SkBounder.h"
 #include "SkDraw.h"
 #include "SkMetaData.h"
 #include "SkRect.h"
+#include "SkRegion.h"
 
 //#define TRACE_FACTORY_LIFETIME
 
@@ -35,12 +37,14 @@ SkDevice::SkDevice() : fMetaData(NULL) {
 SkDevice::SkDevice(const SkBitmap& bitmap) : fBitmap(bitmap) {
     fOrigin.setZero();
     fMetaData = NULL;
+    fDamage = NULL;
     fCachedDeviceFactory = NULL;
 }
 
 SkDevice::SkDevice(SkBitmap::Config config, int width, int height, bool isOpaque) {
     fOrigin.setZero();
     fMetaData = NULL;
+    fDamage = NULL;
     fCachedDeviceFactory = NULL;
 
     fBitmap.setConfig(config, width, height);
@@ -53,6 +57,7 @@ SkDevice::SkDevice(SkBitmap::Config config, int width, int height, bool isOpaque
 
 SkDevice::~SkDevice() {
     delete fMetaData;
+    SkSafeUnref(fDamage);
     SkSafeUnref(fCachedDeviceFactory);
 }
 
@@ -128,6 +133,11 @@ bool SkDevice::intersects(const SkIRect& r, SkIRect* sect) const {
 
 void SkDevice::clear(SkColor color) {
     fBitmap.eraseColor(color);
+    if (fDamage) {
+        SkIRect bounds;
+        this->getBounds(&bounds);
+        this->addDamage(bounds);
+    }
 }
 
 void SkDevice::onAccessBitmap(SkBitmap* bitmap) {}
@@ -138,6 +148,107 @@ void SkDevice::setMatrixClip(const SkMatrix& matrix, const SkRegion& region,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*  Accumulates the bounds that SkDraw reports for each draw. The pieces of one
+    draw (e.g. its glyphs) are joined into one rect, which is added to the
+    damage region when the next draw starts, or when the damage is asked for.
+ */
+class SkDamageBounder : public SkBounder {
+public:
+    SkDamageBounder(const SkIRect& deviceBounds)
+            : fDeviceBounds(deviceBounds), fChain(NULL) {
+        fPending.setEmpty();
+    }
+
+    void setChain(SkBounder* chain) { fChain = chain; }
+
+    void add(const SkIRect& r) {
+        SkIRect rr;
+        if (rr.intersect(fDeviceBounds, r)) {
+            fPending.join(rr);
+        }
+    }
+
+    const SkRegion& damage() {
+        if (!fPending.isEmpty()) {
+            fDamage.op(fPending, SkRegion::kUnion_Op);
+            fPending.setEmpty();
+        }
+        return fDamage;
+    }
+
+    void reset() {
+        fDamage.setEmpty();
+        fPending.setEmpty();
+    }
+
+protected:
+    virtual bool onIRect(const SkIRect& r) {
+        if (fChain && !fChain->onIRect(r)) {
+            return false;
+        }
+        this->addDrawn(r);
+        return true;
+    }
+
+    virtual bool onIRectGlyph(const SkIRect& r, const GlyphRec& rec) {
+        if (fChain && !fChain->onIRectGlyph(r, rec)) {
+            return false;
+        }
+        this->addDrawn(r);
+        return true;
+    }
+
+private:
+    void addDrawn(const SkIRect& r) {
+        // SkBounder's bounds can be a pixel short of an antialiased edge
+        SkIRect rr = r;
+        rr.inset(-1, -1);
+        this->add(rr);
+    }
+
+    SkIRect     fDeviceBounds;
+    SkIRect     fPending;
+    SkRegion    fDamage;
+    SkBounder*  fChain;
+};
+
+void SkDevice::setTrackDamage(bool track) {
+    if (!track) {
+        SkSafeUnref(fDamage);
+        fDamage = NULL;
+    } else if (NULL == fDamage) {
+        SkIRect bounds;
+        this->getBounds(&bounds);
+        fDamage = SkNEW_ARGS(SkDamageBounder, (bounds));
+    }
+}
+
+const SkRegion& SkDevice::getDamage() const {
+    return fDamage ? fDamage->damage() : SkRegion::GetEmptyRegion();
+}
+
+void SkDevice::resetDamage() {
+    if (fDamage) {
+        fDamage->reset();
+    }
+}
+
+void SkDevice::addDamage(const SkIRect& r) {
+    if (fDamage) {
+        fDamage->add(r);
+    }
+}
+
+SkBounder* SkDevice::getDamageBounder(SkBounder* chain) {
+    SkASSERT(fDamage);
+    // one draw's bounds are pending at a time
+    (void)fDamage->damage();
+    fDamage->setChain(chain);
+    return fDamage;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool SkDevice::readPixels(const SkIRect& srcRect, SkBitmap* bitmap) {
     const SkBitmap& src = this->accessBitmap(false);
 
@@ -185,6 +296,11 @@ void SkDevice::drawRect(const SkDraw& draw, const SkRect& r,
     draw.drawRect(r, paint);
 }
 
+void SkDevice::drawRects(const SkDraw& draw, const SkRect rects[],
+                         size_t count, const SkPaint& paint) {
+    draw.drawRects(rects, count, paint);
+}
+
 void SkDevice::drawPath(const SkDraw& draw, const SkPath& path,
                         const SkPaint& paint, const SkMatrix* prePathMatrix,
                         bool pathIsMutable) {
@@ -211,6 +327,12 @@ void SkDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
     draw.drawSprite(bitmap, x, y, paint);
 }
 
+void SkDevice::drawSprites(const SkDraw& draw, const SkBitmap& bitmap,
+                           const SkIPoint pts[], size_t count,
+                           const SkPaint& paint) {
+    draw.drawSprites(bitmap, pts, count, paint);
+}
+
 void SkDevice::drawText(const SkDraw& draw, const void* text, size_t len,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     draw.drawText((const char*)text, len, x, y, paint);
@@ -21,19 +21,25 @@
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkDevice.h"
+#include "SkEdgeBuilder.h"
+#include "SkGraphics.h"
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
 #include "SkRasterizer.h"
 #include "SkScan.h"
 #include "SkShader.h"
+#include "SkSpriteBlitter.h"
 #include "SkStroke.h"
 #include "SkTemplatesPriv.h"
 #include "SkTextFormatParams.h"
+#include "SkThread.h"
+#include "SkTLazy.h"
 #include "SkUtils.h"
 
 #include "SkAutoKern.h"
 #include "SkBitmapProcShader.h"
+#include "SkDrawArena.h"
 #include "SkDrawProcs.h"
 
 //#define TRACE_BITMAP_DRAWS
@@ -71,6 +77,7 @@ static SkPoint* rect_points(SkRect& r, int index) {
 
 class SkAutoBlitterChoose {
 public:
+    SkAutoBlitterChoose() : fBlitter(NULL) {}
     SkAutoBlitterChoose(const SkBitmap& device, const SkMatrix& matrix,
                         const SkPaint& paint) {
         fBlitter = SkBlitter::Choose(device, matrix, paint,
@@ -82,12 +89,24 @@ public:
     SkBlitter*  operator->() { return fBlitter; }
     SkBlitter*  get() const { return fBlitter; }
 
+    // for callers that only want a blitter once they know they'll draw
+    SkBlitter* choose(const SkBitmap& device, const SkMatrix& matrix,
+                      const SkPaint& paint) {
+        SkASSERT(NULL == fBlitter);
+        fBlitter = SkBlitter::Choose(device, matrix, paint,
+                                     fStorage, sizeof(fStorage));
+        return fBlitter;
+    }
+
 private:
     SkBlitter*  fBlitter;
     uint32_t    fStorage[kBlitterStorageLongCount];
 };
 
 SkAutoBlitterChoose::~SkAutoBlitterChoose() {
+    if (NULL == fBlitter) {
+        return;
+    }
     if ((void*)fBlitter == (void*)fStorage) {
         fBlitter->~SkBlitter();
     } else {
@@ -95,22 +114,25 @@ SkAutoBlitterChoose::~SkAutoBlitterChoose() {
     }
 }
 
+/*  We never change the caller's paint, even briefly, since other threads may
+    be drawing with it (e.g. the paints of an SkPicture). Instead these draw
+    with a copy, made only when the paint needs to change.
+ */
+
+// a copy of paint, with a bitmap shader for src
 class SkAutoBitmapShaderInstall {
 public:
-    SkAutoBitmapShaderInstall(const SkBitmap& src, const SkPaint* paint)
-            : fPaint((SkPaint*)paint) {
-        fPrevShader = paint->getShader();
-        SkSafeRef(fPrevShader);
-        fPaint->setShader(SkShader::CreateBitmapShader( src,
+    SkAutoBitmapShaderInstall(const SkBitmap& src, const SkPaint& paint)
+            : fPaint(paint) {
+        fPaint.setShader(SkShader::CreateBitmapShader( src,
                            SkShader::kClamp_TileMode, SkShader::kClamp_TileMode,
                            fStorage, sizeof(fStorage)));
     }
 
     ~SkAutoBitmapShaderInstall() {
-        SkShader* shader = fPaint->getShader();
+        SkShader* shader = fPaint.getShader();
 
-        fPaint->setShader(fPrevShader);
-        SkSafeUnref(fPrevShader);
+        fPaint.setShader(NULL);
 
         if ((void*)shader == (void*)fStorage) {
             shader->~SkShader();
@@ -119,31 +141,30 @@ public:
         }
     }
 
+    const SkPaint& paintWithShader() const { return fPaint; }
+
 private:
-    SkPaint*    fPaint;
-    SkShader*   fPrevShader;
+    SkPaint     fPaint;
     uint32_t    fStorage[kBlitterStorageLongCount];
 };
 
-class SkAutoPaintStyleRestore {
+// paint, or a copy of it if it doesn't already have style
+class SkAutoPaintStyle {
 public:
-    SkAutoPaintStyleRestore(const SkPaint& paint, SkPaint::Style style)
-            : fPaint((SkPaint&)paint) {
-        fStyle = paint.getStyle();  // record the old
-        fPaint.setStyle(style);     // change it to the specified style
+    SkAutoPaintStyle(const SkPaint& paint, SkPaint::Style style) {
+        fPaint = &paint;
+        if (paint.getStyle() != style) {
+            SkPaint* copy = fLazyPaint.set(paint);
+            copy->setStyle(style);
+            fPaint = copy;
+        }
     }
 
-    ~SkAutoPaintStyleRestore() {
-        fPaint.setStyle(fStyle);    // restore the old
-    }
+    const SkPaint& paint() const { return *fPaint; }
 
 private:
-    SkPaint&        fPaint;
-    SkPaint::Style  fStyle;
-
-    // illegal
-    SkAutoPaintStyleRestore(const SkAutoPaintStyleRestore&);
-    SkAutoPaintStyleRestore& operator=(const SkAutoPaintStyleRestore&);
+    SkTLazy<SkPaint>    fLazyPaint;
+    const SkPaint*      fPaint;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -609,13 +630,14 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
     } else {
         switch (mode) {
             case SkCanvas::kPoints_PointMode: {
-                // temporarily mark the paint as filling.
-                SkAutoPaintStyleRestore restore(paint, SkPaint::kFill_Style);
+                // draw each point as a filled circle or square
+                SkAutoPaintStyle    fillPaint(paint, SkPaint::kFill_Style);
+                const SkPaint&      pointPaint = fillPaint.paint();
 
-                SkScalar width = paint.getStrokeWidth();
+                SkScalar width = pointPaint.getStrokeWidth();
                 SkScalar radius = SkScalarHalf(width);
 
-                if (paint.getStrokeCap() == SkPaint::kRound_Cap) {
+                if (pointPaint.getStrokeCap() == SkPaint::kRound_Cap) {
                     SkPath      path;
                     SkMatrix    preMatrix;
 
@@ -625,10 +647,11 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
                         // pass true for the last point, since we can modify
                         // then path then
                         if (fDevice) {
-                            fDevice->drawPath(*this, path, paint, &preMatrix,
-                                              (count-1) == i);
+                            fDevice->drawPath(*this, path, pointPaint,
+                                              &preMatrix, (count-1) == i);
                         } else {
-                            this->drawPath(path, paint, &preMatrix, (count-1) == i);
+                            this->drawPath(path, pointPaint, &preMatrix,
+                                           (count-1) == i);
                         }
                     }
                 } else {
@@ -640,9 +663,9 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
                         r.fRight = r.fLeft + width;
                         r.fBottom = r.fTop + width;
                         if (fDevice) {
-                            fDevice->drawRect(*this, r, paint);
+                            fDevice->drawRect(*this, r, pointPaint);
                         } else {
-                            this->drawRect(r, paint);
+                            this->drawRect(r, pointPaint);
                         }
                     }
                 }
@@ -723,6 +746,14 @@ SkDraw::RectType SkDraw::ComputeRectType(const SkPaint& paint,
 }
 
 void SkDraw::drawRect(const SkRect& rect, const SkPaint& paint) const {
+    this->drawRects(&rect, 1, paint);
+}
+
+/*  Draws each rect as drawRect() would, but only works out how to draw them
+    (and chooses a blitter) once for the whole run.
+ */
+void SkDraw::drawRects(const SkRect rects[], size_t count,
+                       const SkPaint& paint) const {
     SkDEBUGCODE(this->validate();)
 
     // nothing to draw
@@ -741,70 +772,79 @@ void SkDraw::drawRect(const SkRect& rect, const SkPaint& paint) const {
 #endif
         
     if (kPath_RectType == rtype) {
-        SkPath  tmp;
-        tmp.addRect(rect);
-        tmp.setFillType(SkPath::kWinding_FillType);
-        this->drawPath(tmp, paint, NULL, true);
+        for (size_t i = 0; i < count; i++) {
+            SkPath  tmp;
+            tmp.addRect(rects[i]);
+            tmp.setFillType(SkPath::kWinding_FillType);
+            this->drawPath(tmp, paint, NULL, true);
+        }
         return;
     }
 
-    const SkMatrix& matrix = *fMatrix;
-    SkRect          devRect;
+    const SkMatrix&     matrix = *fMatrix;
+    SkAutoBlitterChoose blitterStorage;
+    SkBlitter*          blitter = NULL;
+    const SkRegion*     clip = fClip;
 
-    // transform rect into devRect
-    {
-        matrix.mapXY(rect.fLeft, rect.fTop, rect_points(devRect, 0));
-        matrix.mapXY(rect.fRight, rect.fBottom, rect_points(devRect, 1));
-        devRect.sort();
-    }
+    for (size_t i = 0; i < count; i++) {
+        const SkRect&   rect = rects[i];
+        SkRect          devRect;
 
-    if (fBounder && !fBounder->doRect(devRect, paint)) {
-        return;
-    }
-
-    // look for the quick exit, before we build a blitter
-    {
-        SkIRect ir;
-        devRect.roundOut(&ir);
-        if (paint.getStyle() != SkPaint::kFill_Style) {
-            // extra space for hairlines
-            ir.inset(-1, -1);
+        // transform rect into devRect
+        {
+            matrix.mapXY(rect.fLeft, rect.fTop, rect_points(devRect, 0));
+            matrix.mapXY(rect.fRight, rect.fBottom, rect_points(devRect, 1));
+            devRect.sort();
         }
-        if (fClip->quickReject(ir))
-            return;
-    }
 
-    SkAutoBlitterChoose blitterStorage(*fBitmap, matrix, paint);
-    SkBlitter*          blitter = blitterStorage.get();
-    const SkRegion*     clip = fClip;
+        if (fBounder && !fBounder->doRect(devRect, paint)) {
+            continue;
+        }
 
-    // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
-    // case we are also hairline (if we've gotten to here), which devolves to
-    // effectively just kFill
-    switch (rtype) {
-        case kFill_RectType:
-            if (paint.isAntiAlias()) {
-                SkScan::AntiFillRect(devRect, clip, blitter);
-            } else {
-                SkScan::FillRect(devRect, clip, blitter);
-            }
-            break;
-        case kStroke_RectType:
-            if (paint.isAntiAlias()) {
-                SkScan::AntiFrameRect(devRect, strokeSize, clip, blitter);
-            } else {
-                SkScan::FrameRect(devRect, strokeSize, clip, blitter);
-            }
-            break;
-        case kHair_RectType:
-            if (paint.isAntiAlias()) {
-                SkScan::AntiHairRect(devRect, clip, blitter);
-            } else {
-                SkScan::HairRect(devRect, clip, blitter);
+        // look for the quick exit, before we build a blitter
+        {
+            SkIRect ir;
+            devRect.roundOut(&ir);
+            if (paint.getStyle() != SkPaint::kFill_Style) {
+                // extra space for hairlines
+                ir.inset(-1, -1);
             }
-            break;
-        default:
-            SkASSERT(!"bad rtype");
+            if (fClip->quickReject(ir))
+                continue;
+        }
+
+        if (NULL == blitter) {
+            blitter = blitterStorage.choose(*fBitmap, matrix, paint);
+        }
+
+        // we want to "fill" if we are kFill or kStrokeAndFill, since in the
+        // latter case we are also hairline (if we've gotten to here), which
+        // devolves to effectively just kFill
+        switch (rtype) {
+            case kFill_RectType:
+                if (paint.isAntiAlias()) {
+                    SkScan::AntiFillRect(devRect, clip, blitter);
+                } else {
+                    SkScan::FillRect(devRect, clip, blitter);
+                }
+                break;
+            case kStroke_RectType:
+                if (paint.isAntiAlias()) {
+                    SkScan::AntiFrameRect(devRect, strokeSize, clip, blitter);
+                } else {
+                    SkScan::FrameRect(devRect, strokeSize, clip, blitter);
+                }
+                break;
+            case kHair_RectType:
+                if (paint.isAntiAlias()) {
+                    SkScan::AntiHairRect(devRect, clip, blitter);
+                } else {
+                    SkScan::HairRect(devRect, clip, blitter);
+                }
+                break;
+            default:
+                SkASSERT(!"bad rtype");
+        }
     }
 }
 
@@ -833,24 +873,6 @@ void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     blitter->blitMaskRegion(*mask, *fClip);
 }
 
-class SkAutoPaintRestoreColorStrokeWidth {
-public:
-    SkAutoPaintRestoreColorStrokeWidth(const SkPaint& paint) {
-        fPaint = (SkPaint*)&paint;
-        fColor = paint.getColor();
-        fWidth = paint.getStrokeWidth();
-    }
-    ~SkAutoPaintRestoreColorStrokeWidth() {
-        fPaint->setColor(fColor);
-        fPaint->setStrokeWidth(fWidth);
-    }
-
-private:
-    SkPaint*    fPaint;
-    SkColor     fColor;
-    SkScalar    fWidth;
-};
-
 static SkScalar fast_len(const SkVector& vec) {
     SkScalar x = SkScalarAbs(vec.fX);
     SkScalar y = SkScalarAbs(vec.fY);
@@ -880,13 +902,102 @@ static bool map_radius(const SkMatrix& matrix, SkScalar* value) {
     return false;
 }
 
-void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& paint,
+namespace {
+
+struct FillBandRec {
+    const SkPath*           fPath;
+    const SkRegion*         fClip;
+    const SkBitmap*         fDevice;
+    const SkMatrix*         fMatrix;
+    const SkPaint*          fPaint;
+    const SkEdgeBuilder*    fEdges;
+    int                     fTop;
+    int                     fBandHeight;
+};
+
+}
+
+static void fill_band_proc(void* context, int index) {
+    const FillBandRec* rec = (const FillBandRec*)context;
+    const int top = rec->fTop + index * rec->fBandHeight;
+    const int bottom = top + rec->fBandHeight;
+
+    SkAutoBlitterChoose blitter(*rec->fDevice, *rec->fMatrix, *rec->fPaint);
+    if (rec->fPaint->isAntiAlias()) {
+        SkScan::AntiFillPath(*rec->fPath, *rec->fClip, blitter.get(), top,
+                             bottom, *rec->fEdges);
+    } else {
+        SkScan::FillPath(*rec->fPath, *rec->fClip, blitter.get(), top, bottom,
+                         *rec->fEdges);
+    }
+}
+
+/*  Returns the number of bands (and threads) to fill a large, complex path
+    with (see SkGraphics::SetFillPathThreadCount), or 0 to fill it serially.
+    Each band writes its own rows through its own blitter, so we skip paints
+    whose blitters would share state (i.e. a shader's context).
+ */
+static int count_fill_bands(const SkPath& devPath, const SkRegion& clip,
+                            const SkPaint& paint) {
+    enum {
+        kMinBandPoints = 256,   // fewer than this is fast enough already
+        kMinBandHeight = 32
+    };
+
+    int count = SkGraphics::GetFillPathThreadCount();
+    if (count < 2 || devPath.isInverseFillType() ||
+            devPath.countPoints() < kMinBandPoints ||
+            paint.getShader() || paint.getMaskFilter()) {
+        return 0;
+    }
+
+    SkIRect ir;
+    devPath.getBounds().roundOut(&ir);
+    if (!ir.intersect(clip.getBounds())) {
+        return 0;
+    }
+    count = SkMin32(count, ir.height() / kMinBandHeight);
+    return count < 2 ? 0 : count;
+}
+
+// Builds the path's edges once, then fills count bands of it concurrently,
+// each band reading (copying) just the edges it crosses.
+static void fill_path_in_bands(const SkPath& devPath, const SkRegion& clip,
+                               const SkBitmap& device, const SkMatrix& matrix,
+                               const SkPaint& paint, int count) {
+    SkEdgeBuilder edges;
+    bool hasEdges = paint.isAntiAlias() ?
+                    SkScan::BuildAntiFillEdges(devPath, clip, &edges) :
+                    SkScan::BuildFillEdges(devPath, clip, &edges);
+    if (!hasEdges) {
+        return;
+    }
+
+    SkIRect ir;
+    devPath.getBounds().roundOut(&ir);
+    ir.intersect(clip.getBounds());
+
+    FillBandRec rec;
+    rec.fPath = &devPath;
+    rec.fClip = &clip;
+    rec.fDevice = &device;
+    rec.fMatrix = &matrix;
+    rec.fPaint = &paint;
+    rec.fEdges = &edges;
+    rec.fTop = ir.fTop;
+    rec.fBandHeight = (ir.height() + count - 1) / count;
+    // compute the (cached) convexity now, rather than racing to in each band
+    (void)devPath.getConvexity();
+    sk_parallel_for(fill_band_proc, &rec, count);
+}
+
+void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable) const {
     SkDEBUGCODE(this->validate();)
 
     // nothing to draw
     if (fClip->isEmpty() ||
-        (paint.getAlpha() == 0 && paint.getXfermode() == NULL)) {
+        (origPaint.getAlpha() == 0 && origPaint.getXfermode() == NULL)) {
         return;
     }
 
@@ -897,8 +1008,9 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& paint,
     const SkMatrix* matrix = fMatrix;
 
     if (prePathMatrix) {
-        if (paint.getPathEffect() || paint.getStyle() != SkPaint::kFill_Style ||
-                paint.getRasterizer()) {
+        if (origPaint.getPathEffect() ||
+                origPaint.getStyle() != SkPaint::kFill_Style ||
+                origPaint.getRasterizer()) {
             SkPath* result = pathPtr;
 
             if (!pathIsMutable) {
@@ -924,23 +1036,28 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& paint,
         should modulate the alpha by 1/2)
     */
 
-    SkAutoPaintRestoreColorStrokeWidth aprc(paint);
+    SkTLazy<SkPaint>    lazyPaint;
+    const SkPaint*      paintPtr = &origPaint;
 
     // can we approximate a thin (but not hairline) stroke with an alpha-modulated
     // hairline? Only if the matrix scales evenly in X and Y, and the device-width is
     // less than a pixel
-    if (paint.isAntiAlias() &&
-        paint.getStyle() == SkPaint::kStroke_Style && paint.getXfermode() == NULL) {
-        SkScalar width = paint.getStrokeWidth();
+    if (origPaint.isAntiAlias() &&
+        origPaint.getStyle() == SkPaint::kStroke_Style &&
+        origPaint.getXfermode() == NULL) {
+        SkScalar width = origPaint.getStrokeWidth();
         if (width > 0 && map_radius(*matrix, &width)) {
             int scale = (int)SkScalarMul(width, 256);
-            int alpha = paint.getAlpha() * scale >> 8;
+            int alpha = origPaint.getAlpha() * scale >> 8;
 
             // pretend to be a hairline, with a modulated alpha
-            ((SkPaint*)&paint)->setAlpha(alpha);
-            ((SkPaint*)&paint)->setStrokeWidth(0);
+            SkPaint* hairPaint = lazyPaint.set(origPaint);
+            hairPaint->setAlpha(alpha);
+            hairPaint->setStrokeWidth(0);
+            paintPtr = hairPaint;
         }
     }
+    const SkPaint& paint = *paintPtr;
 
     if (paint.getPathEffect() || paint.getStyle() != SkPaint::kFill_Style) {
         doFill = paint.getFillPath(*pathPtr, &tmpPath);
@@ -964,7 +1081,13 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& paint,
     // transform the path into device space
     pathPtr->transform(*matrix, devPathPtr);
 
-    SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, paint);
+    // banded fills choose a blitter for each band (and have no maskfilter)
+    const int bandCount = doFill ? count_fill_bands(*devPathPtr, *fClip, paint)
+                                 : 0;
+    SkAutoBlitterChoose blitter;
+    if (0 == bandCount) {
+        blitter.choose(*fBitmap, *fMatrix, paint);
+    }
 
     // how does filterPath() know to fill or hairline the path??? <mrr>
     if (paint.getMaskFilter() &&
@@ -977,7 +1100,10 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& paint,
         return;
     }
 
-    if (doFill) {
+    if (bandCount > 0) {
+        fill_path_in_bands(*devPathPtr, *fClip, *fBitmap, *fMatrix, paint,
+                           bandCount);
+    } else if (doFill) {
         if (paint.isAntiAlias()) {
             SkScan::AntiFillPath(*devPathPtr, *fClip, blitter.get());
         } else {
@@ -1058,7 +1184,7 @@ void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap,
         }
 
         // allocate (and clear) our temp buffer to hold the transformed bitmap
-        SkAutoMalloc    storage(size);
+        SkAutoDrawArenaAlloc    storage(size);
         mask.fImage = (uint8_t*)storage.get();
         memset(mask.fImage, 0, size);
 
@@ -1079,11 +1205,11 @@ void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap,
             // we manually build a shader and draw that into our new mask
             SkPaint tmpPaint;
             tmpPaint.setFlags(paint.getFlags());
-            SkAutoBitmapShaderInstall   install(bitmap, &tmpPaint);
+            SkAutoBitmapShaderInstall   install(bitmap, tmpPaint);
             SkRect rr;
             rr.set(0, 0, SkIntToScalar(bitmap.width()),
                    SkIntToScalar(bitmap.height()));
-            c.drawRect(rr, tmpPaint);
+            c.drawRect(rr, install.paintWithShader());
         }
         this->drawDevMask(mask, paint);
     }
@@ -1107,14 +1233,14 @@ static bool clipped_out(const SkMatrix& matrix, const SkRegion& clip,
 }
 
 void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
-                        const SkPaint& paint) const {
+                        const SkPaint& origPaint) const {
     SkDEBUGCODE(this->validate();)
 
     // nothing to draw
     if (fClip->isEmpty() ||
             bitmap.width() == 0 || bitmap.height() == 0 ||
             bitmap.getConfig() == SkBitmap::kNo_Config ||
-            (paint.getAlpha() == 0 && paint.getXfermode() == NULL)) {
+            (origPaint.getAlpha() == 0 && origPaint.getXfermode() == NULL)) {
         return;
     }
 
@@ -1125,7 +1251,8 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
     }
 #endif
 
-    SkAutoPaintStyleRestore restore(paint, SkPaint::kFill_Style);
+    SkAutoPaintStyle    fillPaint(origPaint, SkPaint::kFill_Style);
+    const SkPaint&      paint = fillPaint.paint();
 
     SkMatrix matrix;
     if (!matrix.setConcat(*fMatrix, prematrix)) {
@@ -1190,25 +1317,25 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
     if (bitmap.getConfig() == SkBitmap::kA8_Config) {
         draw.drawBitmapAsMask(bitmap, paint);
     } else {
-        SkAutoBitmapShaderInstall   install(bitmap, &paint);
+        SkAutoBitmapShaderInstall   install(bitmap, paint);
 
         SkRect  r;
         r.set(0, 0, SkIntToScalar(bitmap.width()),
               SkIntToScalar(bitmap.height()));
         // is this ok if paint has a rasterizer?
-        draw.drawRect(r, paint);
+        draw.drawRect(r, install.paintWithShader());
     }
 }
 
 void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y,
-                        const SkPaint& paint) const {
+                        const SkPaint& origPaint) const {
     SkDEBUGCODE(this->validate();)
 
     // nothing to draw
     if (fClip->isEmpty() ||
             bitmap.width() == 0 || bitmap.height() == 0 ||
             bitmap.getConfig() == SkBitmap::kNo_Config ||
-            (paint.getAlpha() == 0 && paint.getXfermode() == NULL)) {
+            (origPaint.getAlpha() == 0 && origPaint.getXfermode() == NULL)) {
         return;
     }
 
@@ -1219,7 +1346,8 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y,
         return; // nothing to draw
     }
 
-    SkAutoPaintStyleRestore restore(paint, SkPaint::kFill_Style);
+    SkAutoPaintStyle    fillPaint(origPaint, SkPaint::kFill_Style);
+    const SkPaint&      paint = fillPaint.paint();
 
     if (NULL == paint.getColorFilter()) {
         uint32_t    storage[kBlitterStorageLongCount];
@@ -1244,7 +1372,8 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y,
         }
     }
 
-    SkAutoBitmapShaderInstall   install(bitmap, &paint);
+    SkAutoBitmapShaderInstall   install(bitmap, paint);
+    const SkPaint&              shaderPaint = install.paintWithShader();
 
     SkMatrix        matrix;
     SkRect          r;
@@ -1254,14 +1383,71 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y,
 
     // tell the shader our offset
     matrix.setTranslate(r.fLeft, r.fTop);
-    paint.getShader()->setLocalMatrix(matrix);
+    shaderPaint.getShader()->setLocalMatrix(matrix);
 
     SkDraw draw(*this);
     matrix.reset();
     draw.fMatrix = &matrix;
     // call ourself with a rect
     // is this OK if paint has a rasterizer?
-    draw.drawRect(r, paint);
+    draw.drawRect(r, shaderPaint);
+}
+
+/*  Draws bitmap at each of the points, as drawSprite() would, but with one
+    sprite blitter that we just move from point to point.
+ */
+void SkDraw::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                         size_t count, const SkPaint& origPaint) const {
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (0 == count || fClip->isEmpty() ||
+            bitmap.width() == 0 || bitmap.height() == 0 ||
+            bitmap.getConfig() == SkBitmap::kNo_Config ||
+            (origPaint.getAlpha() == 0 && origPaint.getXfermode() == NULL)) {
+        return;
+    }
+
+    SkAutoPaintStyle    fillPaint(origPaint, SkPaint::kFill_Style);
+    const SkPaint&      paint = fillPaint.paint();
+
+    uint32_t            storage[kBlitterStorageLongCount];
+    SkSpriteBlitter*    blitter = NULL;
+    if (NULL == paint.getColorFilter()) {
+        blitter = (SkSpriteBlitter*)SkBlitter::ChooseSprite(*fBitmap, paint,
+                                                bitmap, pts[0].fX, pts[0].fY,
+                                                storage, sizeof(storage));
+    }
+    if (NULL == blitter) {
+        for (size_t i = 0; i < count; i++) {
+            this->drawSprite(bitmap, pts[i].fX, pts[i].fY, paint);
+        }
+        return;
+    }
+
+    SkAutoTPlacementDelete<SkBlitter> ad(blitter, storage);
+
+    for (size_t i = 0; i < count; i++) {
+        const int x = pts[i].fX;
+        const int y = pts[i].fY;
+        SkIRect   bounds;
+        bounds.set(x, y, x + bitmap.width(), y + bitmap.height());
+
+        if (fClip->quickReject(bounds) ||
+                (fBounder && !fBounder->doIRect(bounds))) {
+            continue;
+        }
+
+        blitter->setOrigin(x, y);
+
+        SkRegion::Cliperator iter(*fClip, bounds);
+        const SkIRect&       cr = iter.rect();
+
+        for (; !iter.done(); iter.next()) {
+            SkASSERT(!cr.isEmpty());
+            blitter->blitRect(cr.fLeft, cr.fTop, cr.width(), cr.height());
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1270,20 +1456,27 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y,
 #include "SkGlyphCache.h"
 #include "SkUtils.h"
 
-static void measure_text(SkGlyphCache* cache, SkDrawCacheProc glyphCacheProc,
+// how many glyphs drawText looks up at a time
+#define kDrawGlyphRun   64
+
+static void measure_text(SkGlyphCache* cache, const SkPaint& paint,
                 const char text[], size_t byteLength, SkVector* stopVector) {
     SkFixed     x = 0, y = 0;
     const char* stop = text + byteLength;
 
-    SkAutoKern  autokern;
+    SkAutoKern      autokern;
+    const SkGlyph*  glyphs[kDrawGlyphRun];
 
     while (text < stop) {
         // don't need x, y here, since all subpixel variants will have the
         // same advance
-        const SkGlyph& glyph = glyphCacheProc(cache, &text, 0, 0);
-
-        x += autokern.adjust(glyph) + glyph.fAdvanceX;
-        y += glyph.fAdvanceY;
+        int count = cache->getGlyphRun(paint.getTextEncoding(), &text, stop,
+                                       glyphs, kDrawGlyphRun, true);
+        for (int i = 0; i < count; i++) {
+            const SkGlyph& glyph = *glyphs[i];
+            x += autokern.adjust(glyph) + glyph.fAdvanceX;
+            y += glyph.fAdvanceY;
+        }
     }
     stopVector->set(SkFixedToScalar(x), SkFixedToScalar(y));
 
@@ -1597,7 +1790,7 @@ void SkDraw::drawText(const char text[], size_t byteLength,
     if (paint.getTextAlign() != SkPaint::kLeft_Align) {
         SkVector    stop;
 
-        measure_text(cache, glyphCacheProc, text, byteLength, &stop);
+        measure_text(cache, paint, text, byteLength, &stop);
 
         SkScalar    stopX = stop.fX;
         SkScalar    stopY = stop.fY;
@@ -1634,16 +1827,37 @@ void SkDraw::drawText(const char text[], size_t byteLength,
 	SkDraw1Glyph        d1g;
 	SkDraw1Glyph::Proc  proc = d1g.init(this, blitter.get(), cache);
 
-    while (text < stop) {
-        const SkGlyph& glyph  = glyphCacheProc(cache, &text, fx & fxMask, fy & fyMask);
+    if (!paint.isSubpixelText()) {
+        // the glyphs don't depend on their positions, so look up a run at a
+        // time rather than calling glyphCacheProc (and decoding) per glyph
+        const SkGlyph* glyphs[kDrawGlyphRun];
+        while (text < stop) {
+            int count = cache->getGlyphRun(paint.getTextEncoding(), &text, stop,
+                                           glyphs, kDrawGlyphRun, true);
+            for (int i = 0; i < count; i++) {
+                const SkGlyph& glyph = *glyphs[i];
 
-        fx += autokern.adjust(glyph);
+                fx += autokern.adjust(glyph);
 
-        if (glyph.fWidth) {
-			proc(d1g, fx, fy, glyph);
+                if (glyph.fWidth) {
+                    proc(d1g, fx, fy, glyph);
+                }
+                fx += glyph.fAdvanceX;
+                fy += glyph.fAdvanceY;
+            }
+        }
+    } else {
+        while (text < stop) {
+            const SkGlyph& glyph  = glyphCacheProc(cache, &text, fx & fxMask, fy & fyMask);
+
+            fx += autokern.adjust(glyph);
+
+            if (glyph.fWidth) {
+                proc(d1g, fx, fy, glyph);
+            }
+            fx += glyph.fAdvanceX;
+            fy += glyph.fAdvanceY;
         }
-        fx += glyph.fAdvanceX;
-        fy += glyph.fAdvanceY;
     }
 
     if (underlineWidth) {
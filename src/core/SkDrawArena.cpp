@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SkDrawArena.h"
+#include "SkThread.h"
+
+#define MIN_ARENA_SIZE  (16 * 1024)
+
+// keeps every allocation aligned for doubles and 64bit pointers
+#define ArenaAlign(x)   (((x) + 7) >> 3 << 3)
+
+namespace {
+
+struct Arena {
+    char*   fStorage;
+    size_t  fCapacity;
+    size_t  fUsed;
+    size_t  fDemand;    // bytes asked for since the arena was last empty
+    size_t  fWanted;    // the most that one draw has asked for
+    int     fLiveCount; // allocations (arena or heap) not yet freed
+
+    int     fAllocCount;
+    int     fHeapAllocCount;
+};
+
+}
+
+static void* create_arena() {
+    Arena* arena = SkNEW(Arena);
+    sk_bzero(arena, sizeof(Arena));
+    arena->fWanted = MIN_ARENA_SIZE;
+    return arena;
+}
+
+static void delete_arena(void* data) {
+    Arena* arena = static_cast<Arena*>(data);
+    sk_free(arena->fStorage);
+    SkDELETE(arena);
+}
+
+static Arena* get_arena() {
+    return static_cast<Arena*>(sk_thread_data(create_arena, delete_arena));
+}
+
+void* SkDrawArena::Alloc(size_t size) {
+    Arena* arena = get_arena();
+    arena->fAllocCount += 1;
+    size = ArenaAlign(size);
+
+    if (0 == arena->fLiveCount) {
+        arena->fUsed = 0;
+        arena->fDemand = 0;
+        if (arena->fWanted > arena->fCapacity) {
+            // grow while empty, so nothing has to move
+            sk_free(arena->fStorage);
+            arena->fCapacity = ArenaAlign(arena->fWanted);
+            arena->fStorage = (char*)sk_malloc_throw(arena->fCapacity);
+            arena->fHeapAllocCount += 1;
+        }
+    }
+
+    arena->fDemand += size;
+    arena->fLiveCount += 1;
+
+    size_t used = arena->fUsed + size;
+    if (used > arena->fCapacity) {
+        if (arena->fDemand > arena->fWanted) {
+            arena->fWanted = arena->fDemand;
+        }
+        arena->fHeapAllocCount += 1;
+        return sk_malloc_throw(size);
+    }
+
+    void* ptr = arena->fStorage + arena->fUsed;
+    arena->fUsed = used;
+    return ptr;
+}
+
+void SkDrawArena::Free(void* ptr) {
+    if (NULL == ptr) {
+        return;
+    }
+    Arena* arena = get_arena();
+    char* p = static_cast<char*>(ptr);
+    if (p < arena->fStorage || p >= arena->fStorage + arena->fCapacity) {
+        sk_free(ptr);
+    }
+    SkASSERT(arena->fLiveCount > 0);
+    arena->fLiveCount -= 1;
+}
+
+void SkDrawArena::GetAllocCounts(int* allocCount, int* heapAllocCount) {
+    Arena* arena = get_arena();
+    if (allocCount) {
+        *allocCount = arena->fAllocCount;
+    }
+    if (heapAllocCount) {
+        *heapAllocCount = arena->fHeapAllocCount;
+    }
+}
+
+void SkDrawArena::ResetAllocCounts() {
+    Arena* arena = get_arena();
+    arena->fAllocCount = 0;
+    arena->fHeapAllocCount = 0;
+}
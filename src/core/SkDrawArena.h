@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2011 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SkDrawArena_DEFINED
+#define SkDrawArena_DEFINED
+
+#include "SkTypes.h"
+
+/** Scratch memory for the duration of a draw, e.g. the edges of a path, the
+    span buffers of shader blitters and the runs of the antialiasing
+    supersamplers. Each thread has its own arena, which simply bumps a pointer
+    to allocate, and is emptied once everything allocated from it has been
+    freed (i.e. between draws). A request that doesn't fit comes from the heap
+    instead, and the arena grows to fit it before the next draw, so that
+    repeating a draw makes no heap allocations. The arena is freed when its
+    thread exits, or by sk_delete_thread_data() (which SkGraphics::Term()
+    calls for the main thread).
+*/
+class SkDrawArena {
+public:
+    /** Returns size bytes (8-byte aligned) for the calling thread */
+    static void* Alloc(size_t size);
+    /** Frees memory from Alloc(), on the thread that allocated it */
+    static void Free(void* ptr);
+
+    /** Counts the calls to Alloc() on the calling thread, and how many of
+        them (and of the arena's own growth) went to the heap.
+    */
+    static void GetAllocCounts(int* allocCount, int* heapAllocCount);
+    static void ResetAllocCounts();
+};
+
+/** Allocates from SkDrawArena, and frees it when it goes out of scope */
+class SkAutoDrawArenaAlloc : SkNoncopyable {
+public:
+    SkAutoDrawArenaAlloc(size_t size) : fPtr(SkDrawArena::Alloc(size)) {}
+    ~SkAutoDrawArenaAlloc() { SkDrawArena::Free(fPtr); }
+
+    void* get() const { return fPtr; }
+
+private:
+    void*   fPtr;
+};
+
+#endif
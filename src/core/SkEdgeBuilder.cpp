@@ -1,40 +1,101 @@
 #include "SkEdgeBuilder.h"
 #include "SkPath.h"
+#include "SkDrawArena.h"
 #include "SkEdge.h"
 #include "SkEdgeClipper.h"
+#include "SkFDot6.h"
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
+#include "SkThread.h"
 
-SkEdgeBuilder::SkEdgeBuilder() : fAlloc(16*1024) {}
+#define EDGE_BLOCK_SIZE     (4 * 1024)
+#define MIN_EDGE_RESERVE    32
 
-template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
-    return static_cast<T*>(alloc.allocThrow(sizeof(T)));
+// edges are bumped out of a chain of these, newest first
+struct SkEdgeBuilder::Block {
+    Block*  fNext;
+    char*   fFreePtr;
+    // edges follow
+};
+
+SkEdgeBuilder::SkEdgeBuilder() {
+    fBlocks = NULL;
+    fBlockFreeSize = 0;
+    fList = NULL;
+    fCount = 0;
+    fReserve = 0;
+    fIsSorted = false;
+    fPending = NULL;
+}
+
+void* SkEdgeBuilder::allocEdge(size_t size) {
+    size = (size + 7) & ~7;     // the edges hold pointers
+    if (NULL == fBlocks || size > fBlockFreeSize) {
+        size_t capacity = SkMax32(EDGE_BLOCK_SIZE, size);
+        Block* block = (Block*)SkDrawArena::Alloc(sizeof(Block) + capacity);
+        block->fNext = fBlocks;
+        block->fFreePtr = (char*)(block + 1);
+        fBlocks = block;
+        fBlockFreeSize = capacity;
+    }
+    void* ptr = fBlocks->fFreePtr;
+    fBlocks->fFreePtr += size;
+    fBlockFreeSize -= size;
+    return ptr;
+}
+
+SkEdge** SkEdgeBuilder::appendEdges(int count) {
+    if (fCount + count > fReserve) {
+        int reserve = SkMax32(SkMax32(fCount + count, fReserve * 2),
+                              MIN_EDGE_RESERVE);
+        SkEdge** list = (SkEdge**)SkDrawArena::Alloc(reserve * sizeof(SkEdge*));
+        memcpy(list, fList, fCount * sizeof(SkEdge*));
+        SkDrawArena::Free(fList);
+        fList = list;
+        fReserve = reserve;
+    }
+    SkEdge** edges = fList + fCount;
+    fCount += count;
+    return edges;
+}
+
+void SkEdgeBuilder::resetEdges() {
+    Block* block = fBlocks;
+    while (block) {
+        Block* next = block->fNext;
+        SkDrawArena::Free(block);
+        block = next;
+    }
+    fBlocks = NULL;
+    fBlockFreeSize = 0;
+    // keep fList, since we'll likely fill it again
+    fCount = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkEdgeBuilder::addLine(const SkPoint pts[]) {
-    SkEdge* edge = typedAllocThrow<SkEdge>(fAlloc);
+    SkEdge* edge = (SkEdge*)this->allocEdge(sizeof(SkEdge));
     if (edge->setLine(pts[0], pts[1], NULL, fShiftUp)) {
-        fList.push(edge);
+        this->pushEdge(edge);
     } else {
         // TODO: unallocate edge from storage...
     }
 }
 
 void SkEdgeBuilder::addQuad(const SkPoint pts[]) {
-    SkQuadraticEdge* edge = typedAllocThrow<SkQuadraticEdge>(fAlloc);
+    SkQuadraticEdge* edge = (SkQuadraticEdge*)this->allocEdge(sizeof(SkQuadraticEdge));
     if (edge->setQuadratic(pts, fShiftUp)) {
-        fList.push(edge);
+        this->pushEdge(edge);
     } else {
         // TODO: unallocate edge from storage...
     }
 }
 
 void SkEdgeBuilder::addCubic(const SkPoint pts[]) {
-    SkCubicEdge* edge = typedAllocThrow<SkCubicEdge>(fAlloc);
+    SkCubicEdge* edge = (SkCubicEdge*)this->allocEdge(sizeof(SkCubicEdge));
     if (edge->setCubic(pts, NULL, fShiftUp)) {
-        fList.push(edge);
+        this->pushEdge(edge);
     } else {
         // TODO: unallocate edge from storage...
     }
@@ -72,9 +133,9 @@ static void setShiftedClip(SkRect* dst, const SkIRect& src, int shift) {
 
 int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip,
                          int shiftUp) {
-    fAlloc.reset();
-    fList.reset();
+    this->resetEdges();
     fShiftUp = shiftUp;
+    fIsSorted = false;
 
     SkPath::Iter    iter(path, true);
     SkPoint         pts[4];
@@ -148,7 +209,324 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip,
             }
         }
     }
-    return fList.count();
+    return fCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Paths are matched on what their edges are built from: their verbs, and
+    their points converted to FDot6, relative to the first point. Moving every
+    point by a whole number of FDot6 units in x, and of rows (64 units) in y,
+    offsets the resulting edges exactly, so those are the only translations
+    we accept. Curves are chopped at their y-extrema before their edges are
+    built, so they are keyed on the chopped pieces: two curves whose chopped
+    points match (after conversion) build the same edges, even if their
+    original points would have chopped differently.
+ */
+
+enum {
+    kMinCachePoints = 32,               // smaller paths are cheap to rebuild
+    kMaxCacheBytes  = 2 * 1024 * 1024,  // total size of the cache
+    kCacheCount     = 4,
+    kSeenCount      = 8                 // recently seen (not cached) paths
+};
+
+struct SkEdgeCacheEntry {
+    uint32_t                fHash;  // independent of the path's translation
+    int                     fShiftUp;
+    uint32_t                fLastUsed;
+    SkTDArray<uint8_t>      fVerbs;
+    SkTDArray<SkFDot6>      fPts;   // x,y pairs
+    int                     fEdgeCount;
+    // sorted edges, packed one after the other (see edge_size())
+    SkTDArray<char>         fEdges;
+
+    size_t size() const {
+        return fVerbs.count() + fPts.count() * sizeof(SkFDot6) +
+               fEdges.count();
+    }
+};
+
+SkEdgeBuilder::~SkEdgeBuilder() {
+    this->resetEdges();
+    SkDrawArena::Free(fList);
+    delete fPending;
+}
+
+static SkMutex              gEdgeCacheMutex;
+static SkEdgeCacheEntry*    gEdgeCache[kCacheCount];
+static uint32_t             gEdgeCacheSeen[kSeenCount];
+static int                  gEdgeCacheSeenIndex;
+static uint32_t             gEdgeCacheClock;
+
+static inline SkFDot6 to_fdot6(SkScalar x, int shift) {
+#ifdef SK_SCALAR_IS_FLOAT
+    return int(x * float(1 << (shift + 6)));
+#else
+    return x >> (10 - shift);
+#endif
+}
+
+// appends the points to key as FDot6, folding them (relative to the first
+// point of the path) into hash
+static uint32_t append_pts(SkEdgeCacheEntry* key, uint32_t hash,
+                           const SkPoint pts[], int count, int shiftUp) {
+    SkFDot6* dst = key->fPts.append(count * 2);
+    for (int i = 0; i < count; i++) {
+        dst[0] = to_fdot6(pts[i].fX, shiftUp);
+        dst[1] = to_fdot6(pts[i].fY, shiftUp);
+        hash = hash * 31 + (dst[0] - key->fPts[0]);
+        hash = hash * 31 + (dst[1] - key->fPts[1]);
+        dst += 2;
+    }
+    return hash;
+}
+
+static void make_key(SkEdgeCacheEntry* key, const SkPath& path, int shiftUp) {
+    SkPath::Iter    iter(path, true);
+    SkPoint         pts[4];
+    SkPath::Verb    verb;
+    uint32_t        hash = shiftUp;
+
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        // the first point of a segment is the last point of the previous one,
+        // so each piece only adds the points after its first, and a verb
+        int pieces = 1;
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                hash = append_pts(key, hash, pts, 1, shiftUp);
+                break;
+            case SkPath::kLine_Verb:
+                hash = append_pts(key, hash, pts + 1, 1, shiftUp);
+                break;
+            case SkPath::kQuad_Verb: {
+                SkPoint monoX[5];
+                pieces = SkChopQuadAtYExtrema(pts, monoX) + 1;
+                for (int i = 0; i < pieces; i++) {
+                    hash = append_pts(key, hash, &monoX[i * 2 + 1], 2, shiftUp);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb: {
+                SkPoint monoY[10];
+                pieces = SkChopCubicAtYExtrema(pts, monoY) + 1;
+                for (int i = 0; i < pieces; i++) {
+                    hash = append_pts(key, hash, &monoY[i * 3 + 1], 3, shiftUp);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        for (int i = 0; i < pieces; i++) {
+            *key->fVerbs.append() = SkToU8(verb);
+            hash = hash * 31 + verb;
+        }
+    }
+    key->fHash = hash;
+    key->fShiftUp = shiftUp;
+}
+
+// returns true if key is entry offset by (dx, dy), which are valid offsets
+static bool match_key(const SkEdgeCacheEntry& entry,
+                      const SkEdgeCacheEntry& key, SkFDot6* dx, SkFDot6* dy) {
+    if (entry.fHash != key.fHash || entry.fShiftUp != key.fShiftUp ||
+            !(entry.fVerbs == key.fVerbs) ||
+            entry.fPts.count() != key.fPts.count()) {
+        return false;
+    }
+
+    const SkFDot6* src = entry.fPts.begin();
+    const SkFDot6* dst = key.fPts.begin();
+    const SkFDot6 ox = dst[0] - src[0];
+    const SkFDot6 oy = dst[1] - src[1];
+    if (oy & 63) {
+        return false;
+    }
+    for (int i = entry.fPts.count() >> 1; i > 0; --i) {
+        if (dst[0] - src[0] != ox || dst[1] - src[1] != oy) {
+            return false;
+        }
+        src += 2;
+        dst += 2;
+    }
+    *dx = ox;
+    *dy = oy;
+    return true;
+}
+
+// a curve with no segments left behaves (and is walked) just like a line
+static size_t edge_size(const SkEdge* edge) {
+    if (edge->fCurveCount > 0) {
+        return sizeof(SkQuadraticEdge);
+    } else if (edge->fCurveCount < 0) {
+        return sizeof(SkCubicEdge);
+    }
+    return sizeof(SkEdge);
+}
+
+int SkEdgeBuilder::copyBand(const SkEdgeBuilder& shared, int startY,
+                            int stopY) {
+    SkASSERT(shared.fIsSorted);
+
+    this->resetEdges();
+    fShiftUp = shared.fShiftUp;
+    fIsSorted = true;
+
+    const int count = shared.fCount;
+    for (int i = 0; i < count; i++) {
+        const SkEdge* src = shared.fList[i];
+        if (src->fFirstY >= stopY) {
+            break;  // so do all the ones after it
+        }
+        // a curve may go on below its current piece
+        if (0 == src->fCurveCount && src->fLastY < startY) {
+            continue;
+        }
+        size_t size = edge_size(src);
+        SkEdge* edge = (SkEdge*)this->allocEdge(size);
+        memcpy(edge, src, size);
+        this->pushEdge(edge);
+    }
+    return fCount;
+}
+
+int SkEdgeBuilder::buildCached(const SkPath& path, int shiftUp) {
+    if (path.countPoints() < kMinCachePoints) {
+        return this->build(path, NULL, shiftUp);
+    }
+
+    SkEdgeCacheEntry* key = new SkEdgeCacheEntry;
+    make_key(key, path, shiftUp);
+
+    SkAutoMutexAcquire  ac(gEdgeCacheMutex);
+
+    for (int i = 0; i < kCacheCount; i++) {
+        SkEdgeCacheEntry* entry = gEdgeCache[i];
+        SkFDot6 dx, dy;
+        if (NULL == entry || !match_key(*entry, *key, &dx, &dy)) {
+            continue;
+        }
+        entry->fLastUsed = ++gEdgeCacheClock;
+
+        this->resetEdges();
+        fShiftUp = shiftUp;
+        fIsSorted = true;
+
+        const SkFixed fx = SkFDot6ToFixed(dx);
+        const SkFixed fy = SkFDot6ToFixed(dy);
+        const int rows = dy >> 6;
+        const char* src = entry->fEdges.begin();
+        SkEdge** list = this->appendEdges(entry->fEdgeCount);
+        for (int j = 0; j < entry->fEdgeCount; j++) {
+            size_t size = edge_size((const SkEdge*)src);
+            SkEdge* edge = (SkEdge*)this->allocEdge(size);
+            memcpy(edge, src, size);
+            src += size;
+
+            edge->fX += fx;
+            edge->fFirstY += rows;
+            edge->fLastY += rows;
+            if (edge->fCurveCount > 0) {
+                SkQuadraticEdge* quad = (SkQuadraticEdge*)edge;
+                quad->fQx += fx;
+                quad->fQy += fy;
+                quad->fQLastX += fx;
+                quad->fQLastY += fy;
+            } else if (edge->fCurveCount < 0) {
+                SkCubicEdge* cubic = (SkCubicEdge*)edge;
+                cubic->fCx += fx;
+                cubic->fCy += fy;
+                cubic->fCLastX += fx;
+                cubic->fCLastY += fy;
+            }
+            list[j] = edge;
+        }
+        delete key;
+        return fCount;
+    }
+
+    // only cache paths the second time we see them
+    bool seen = false;
+    for (int i = 0; i < kSeenCount; i++) {
+        if (gEdgeCacheSeen[i] == key->fHash) {
+            seen = true;
+            break;
+        }
+    }
+    if (seen) {
+        delete fPending;
+        fPending = key;
+    } else {
+        gEdgeCacheSeen[gEdgeCacheSeenIndex] = key->fHash;
+        gEdgeCacheSeenIndex = (gEdgeCacheSeenIndex + 1) % kSeenCount;
+        delete key;
+    }
+    ac.release();
+
+    return this->build(path, NULL, shiftUp);
 }
 
+void SkEdgeBuilder::cacheSortedEdges() {
+    fIsSorted = true;
+
+    SkEdgeCacheEntry* entry = fPending;
+    if (NULL == entry) {
+        return;
+    }
+    fPending = NULL;
 
+    const int count = fCount;
+    size_t edgeBytes = 0;
+    for (int i = 0; i < count; i++) {
+        edgeBytes += edge_size(fList[i]);
+    }
+    if (edgeBytes > kMaxCacheBytes) {
+        delete entry;
+        return;
+    }
+
+    entry->fEdgeCount = count;
+    char* dst = entry->fEdges.append(edgeBytes);
+    for (int i = 0; i < count; i++) {
+        size_t size = edge_size(fList[i]);
+        memcpy(dst, fList[i], size);
+        dst += size;
+    }
+
+    const size_t size = entry->size();
+    if (size > kMaxCacheBytes) {
+        delete entry;
+        return;
+    }
+
+    SkAutoMutexAcquire  ac(gEdgeCacheMutex);
+
+    // evict the least recently used entries until the new one fits
+    for (;;) {
+        size_t total = size;
+        int empty = -1;
+        int lru = -1;
+        for (int i = 0; i < kCacheCount; i++) {
+            const SkEdgeCacheEntry* e = gEdgeCache[i];
+            if (NULL == e) {
+                empty = i;
+            } else {
+                total += e->size();
+                if (lru < 0 || e->fLastUsed < gEdgeCache[lru]->fLastUsed) {
+                    lru = i;
+                }
+            }
+        }
+        if (empty >= 0 && total <= kMaxCacheBytes) {
+            entry->fLastUsed = ++gEdgeCacheClock;
+            gEdgeCache[empty] = entry;
+            return;
+        }
+        SkASSERT(lru >= 0);
+        delete gEdgeCache[lru];
+        gEdgeCache[lru] = NULL;
+    }
+}
@@ -1,26 +1,64 @@
 #ifndef SkEdgeBuilder_DEFINED
 #define SkEdgeBuilder_DEFINED
 
-#include "SkChunkAlloc.h"
 #include "SkRect.h"
-#include "SkTDArray.h"
 
 struct SkEdge;
+struct SkEdgeCacheEntry;
 class SkEdgeClipper;
 class SkPath;
 
 class SkEdgeBuilder {
 public:
     SkEdgeBuilder();
+    ~SkEdgeBuilder();
     
     int build(const SkPath& path, const SkIRect* clip, int shiftUp);
 
-    SkEdge** edgeList() { return fList.begin(); }
+    /** Like build() with no clip, but first looks in a small global cache of
+        recently filled paths. If path is one of those, translated by whole
+        (shifted up) rows and FDot6 units, its cached edges are copied and
+        offset instead of being rebuilt, and they are already sorted.
+     */
+    int buildCached(const SkPath& path, int shiftUp);
+
+    /** Returns true if edgeList() is already sorted by y, then x */
+    bool isSorted() const { return fIsSorted; }
+
+    /** Call once edgeList() has been sorted (and before the edges are walked)
+        to offer them to the cache, and mark them sorted. Only paths that
+        buildCached() has seen recently are kept.
+     */
+    void cacheSortedEdges();
+
+    /** Copies the edges of shared, which must be sorted, that may cross the
+        (shifted up) rows [startY, stopY), so that one band of a path can be
+        walked without rebuilding its edges, while other bands walk their own
+        copies. The copies are sorted.
+     */
+    int copyBand(const SkEdgeBuilder& shared, int startY, int stopY);
+
+    SkEdge** edgeList() { return fList; }
 
 private:
-    SkChunkAlloc        fAlloc;
-    SkTDArray<SkEdge*>  fList;
+    struct Block;
+
+    // the edges, and the list of them, come from the calling thread's
+    // SkDrawArena, so a builder must be freed on the thread that built it
+    Block*      fBlocks;
+    size_t      fBlockFreeSize;
+    SkEdge**    fList;
+    int         fCount;
+    int         fReserve;
+
     int                 fShiftUp;
+    bool                fIsSorted;
+    SkEdgeCacheEntry*   fPending;   // key to cache once we've been sorted
+
+    void* allocEdge(size_t size);
+    SkEdge** appendEdges(int count);
+    void pushEdge(SkEdge* edge) { *this->appendEdges(1) = edge; }
+    void resetEdges();
 
     void addLine(const SkPoint pts[]);
     void addQuad(const SkPoint pts[]);
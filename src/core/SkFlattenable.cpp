@@ -41,6 +41,11 @@ void SkFlattenable::flatten(SkFlattenableWriteBuffer&)
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// With inlined factory names, a built-in factory is instead written (the first
+// time) as its ID with this bit set. No name is long enough to be mistaken
+// for it.
+#define FACTORY_ID_FLAG     (1 << 30)
+
 SkFlattenableReadBuffer::SkFlattenableReadBuffer() {
     fRCArray = NULL;
     fRCCount = 0;
@@ -51,6 +56,8 @@ SkFlattenableReadBuffer::SkFlattenableReadBuffer() {
     fFactoryTDArray = NULL;
     fFactoryArray = NULL;
     fFactoryCount = 0;
+
+    fSharePixels = false;
 }
 
 SkFlattenableReadBuffer::SkFlattenableReadBuffer(const void* data) :
@@ -64,6 +71,8 @@ SkFlattenableReadBuffer::SkFlattenableReadBuffer(const void* data) :
     fFactoryTDArray = NULL;
     fFactoryArray = NULL;
     fFactoryCount = 0;
+
+    fSharePixels = false;
 }
 
 SkFlattenableReadBuffer::SkFlattenableReadBuffer(const void* data, size_t size)
@@ -77,6 +86,8 @@ SkFlattenableReadBuffer::SkFlattenableReadBuffer(const void* data, size_t size)
     fFactoryTDArray = NULL;
     fFactoryArray = NULL;
     fFactoryCount = 0;
+
+    fSharePixels = false;
 }
 
 SkTypeface* SkFlattenableReadBuffer::readTypeface() {
@@ -124,6 +135,14 @@ SkFlattenable* SkFlattenableReadBuffer::readFlattenable() {
             index = -index; // we stored the negative of the index
             index -= 1;     // we stored the index-base-1
             factory = (*fFactoryTDArray)[index];
+        } else if (*peek & FACTORY_ID_FLAG) {
+            uint32_t id = this->readU32() & ~FACTORY_ID_FLAG;
+            factory = SkFlattenable::IDToFactory(id);
+            if (factory) {
+                SkASSERT(fFactoryTDArray->find(factory) < 0);
+                *fFactoryTDArray->append() = factory;
+            }
+            // as with names, an unknown ID is our failure, so fall through
         } else {
             const char* name = this->readString();
             factory = SkFlattenable::NameToFactory(name);
@@ -221,7 +240,7 @@ void SkFlattenableWriteBuffer::writeFlattenable(SkFlattenable* flattenable) {
      *  If we have a factoryset, then the first 32bits tell us...
      *       0: failure to write the flattenable
      *      <0: we store the negative of the (1-based) index
-     *      >0: the length of the name
+     *      >0: the length of the name, or a built-in's ID | FACTORY_ID_FLAG
      *  If we don't have a factoryset, then the first "ptr" is either the
      *  factory, or null for failure.
      *
@@ -251,9 +270,9 @@ void SkFlattenableWriteBuffer::writeFlattenable(SkFlattenable* flattenable) {
      *      does exactly this, by writing a table of names (matching the indices)
      *      up front in its serialized form.
      *  3.  names : Reuse fFactorySet to store indices, but only after we've
-     *      written the name the first time. SkGPipe uses this technique, as it
-     *      doesn't require the reader to be told to know the table of names
-     *      up front.
+     *      written the name (or built-in ID) the first time. SkGPipe uses this
+     *      technique, as it doesn't require the reader to be told to know the
+     *      table of names up front.
      */
     if (fFactorySet) {
         if (this->inlineFactoryNames()) {
@@ -263,12 +282,17 @@ void SkFlattenableWriteBuffer::writeFlattenable(SkFlattenable* flattenable) {
                 // the length of a string
                 this->write32(-index);
             } else {
-                const char* name = SkFlattenable::FactoryToName(factory);
-                if (NULL == name) {
-                    this->write32(0);
-                    return;
+                uint32_t id = SkFlattenable::FactoryToID(factory);
+                if (id) {
+                    this->write32(id | FACTORY_ID_FLAG);
+                } else {
+                    const char* name = SkFlattenable::FactoryToName(factory);
+                    if (NULL == name) {
+                        this->write32(0);
+                        return;
+                    }
+                    this->writeString(name);
                 }
-                this->writeString(name);
                 index = fFactorySet->add(factory);
             }
         } else {
@@ -315,14 +339,92 @@ void SkRefCntSet::decPtr(void* ptr) {
 ///////////////////////////////////////////////////////////////////////////////
 
 #define MAX_PAIR_COUNT  64
+// a power of 2, at least twice MAX_PAIR_COUNT so that probes stay short
+#define SLOT_COUNT      128
+
+/*  The built-in flattenables, in the order of their IDs (an ID is 1 + its
+    index here). IDs are written into pictures and pipes, so only append new
+    names to the end of this list; never reorder or remove them.
+ */
+static const char* gBuiltinNames[] = {
+    // core
+    "SkBitmapProcShader",
+    "SkComposePathEffect",
+    "SkSumPathEffect",
+    "SkStrokePathEffect",
+    "SkShape",
+    "SkProcCoeffXfermode",
+    "SkClearXfermode",
+    "SkSrcXfermode",
+    "SkDstInXfermode",
+    "SkDstOutXfermode",
+    // effects
+    "Linear_Gradient",
+    "Radial_Gradient",
+    "Sweep_Gradient",
+    "Two_Point_Radial_Gradient",
+    "Src_SkModeColorFilterReg",
+    "SrcOver_SkModeColorFilterReg",
+    "Proc_SkModeColorFilterReg",
+    "SkColorMatrixFilter",
+    "SkBlurMaskFilter",
+    "SkBlurDrawLooper",
+    "SkLayerDrawLooper",
+    "SkCornerPathEffect",
+    "SkDashPathEffect",
+    "SkDiscretePathEffect",
+    "SkAvoidXfermode",
+    "SkPixelXorXfermode",
+    "SkGroupShape",
+    "SkRectShape",
+};
 
 struct Pair {
     const char*             fName;
     SkFlattenable::Factory  fFactory;
+    uint32_t                fID;    // 0 if not a built-in
 };
 
 static int gCount;
 static Pair gPairs[MAX_PAIR_COUNT];
+// Hash tables (open addressed, linear probing) of 1 + the index of each pair,
+// by name and by factory. An empty slot holds 0.
+static uint8_t gNameSlots[SLOT_COUNT];
+static uint8_t gFactorySlots[SLOT_COUNT];
+// 1 + the index of the pair for each ID, or 0 if it has not been registered
+static uint8_t gIDToPair[SK_ARRAY_COUNT(gBuiltinNames) + 1];
+
+static uint32_t hash_name(const char name[]) {
+    uint32_t hash = 0;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 0x01000193;   // FNV prime
+    }
+    return hash ^ (hash >> 16);
+}
+
+static uint32_t hash_factory(SkFlattenable::Factory factory) {
+    uint32_t hash = (uint32_t)(uintptr_t)factory * 0x9E3779B1;
+    return hash ^ (hash >> 16);
+}
+
+static bool same_name(const Pair& a, const Pair& b) {
+    return !strcmp(a.fName, b.fName);
+}
+
+static bool same_factory(const Pair& a, const Pair& b) {
+    return a.fFactory == b.fFactory;
+}
+
+// A pair whose key was registered before takes over its slot, so that (as
+// with the ID table) the last registration of a name or factory wins.
+static void add_slot(uint8_t slots[], uint32_t hash, int index,
+                     bool (*sameKey)(const Pair&, const Pair&)) {
+    int i = hash & (SLOT_COUNT - 1);
+    while (slots[i] && !sameKey(gPairs[slots[i] - 1], gPairs[index])) {
+        i = (i + 1) & (SLOT_COUNT - 1);
+    }
+    slots[i] = SkToU8(index + 1);
+}
 
 void SkFlattenable::Register(const char name[], Factory factory) {
     SkASSERT(name);
@@ -336,31 +438,67 @@ void SkFlattenable::Register(const char name[], Factory factory) {
 
     SkASSERT(gCount < MAX_PAIR_COUNT);
 
+    // this only runs at startup, so a linear search for the ID is fine
+    uint32_t id = 0;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gBuiltinNames); i++) {
+        if (!strcmp(gBuiltinNames[i], name)) {
+            id = i + 1;
+            gIDToPair[id] = SkToU8(gCount + 1);
+            break;
+        }
+    }
+
     gPairs[gCount].fName = name;
     gPairs[gCount].fFactory = factory;
+    gPairs[gCount].fID = id;
+    add_slot(gNameSlots, hash_name(name), gCount, same_name);
+    add_slot(gFactorySlots, hash_factory(factory), gCount, same_factory);
     gCount += 1;
 }
 
 SkFlattenable::Factory SkFlattenable::NameToFactory(const char name[]) {
-    const Pair* pairs = gPairs;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (strcmp(pairs[i].fName, name) == 0) {
-            return pairs[i].fFactory;
+    int i = hash_name(name) & (SLOT_COUNT - 1);
+    int index;
+    while ((index = gNameSlots[i]) != 0) {
+        const Pair& pair = gPairs[index - 1];
+        if (strcmp(pair.fName, name) == 0) {
+            return pair.fFactory;
         }
+        i = (i + 1) & (SLOT_COUNT - 1);
     }
     return NULL;
 }
 
-const char* SkFlattenable::FactoryToName(Factory fact) {
-    const Pair* pairs = gPairs;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (pairs[i].fFactory == fact) {
-            return pairs[i].fName;
+static const Pair* find_factory(SkFlattenable::Factory fact) {
+    int i = hash_factory(fact) & (SLOT_COUNT - 1);
+    int index;
+    while ((index = gFactorySlots[i]) != 0) {
+        const Pair& pair = gPairs[index - 1];
+        if (pair.fFactory == fact) {
+            return &pair;
         }
+        i = (i + 1) & (SLOT_COUNT - 1);
     }
     return NULL;
 }
 
+const char* SkFlattenable::FactoryToName(Factory fact) {
+    const Pair* pair = find_factory(fact);
+    return pair ? pair->fName : NULL;
+}
+
+uint32_t SkFlattenable::FactoryToID(Factory fact) {
+    const Pair* pair = find_factory(fact);
+    return pair ? pair->fID : 0;
+}
+
+SkFlattenable::Factory SkFlattenable::IDToFactory(uint32_t id) {
+    if (0 == id || id >= SK_ARRAY_COUNT(gIDToPair) || 0 == gIDToPair[id]) {
+        return NULL;
+    }
+    return gPairs[gIDToPair[id] - 1].fFactory;
+}
+
 bool SkFlattenable::toDumpString(SkString* str) const {
     return false;
 }
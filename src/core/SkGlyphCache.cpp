@@ -19,6 +19,7 @@
 #include "SkFontHost.h"
 #include "SkPaint.h"
 #include "SkTemplates.h"
+#include "SkUtils.h"
 
 #define SPEW_PURGE_STATUS
 //#define USE_CACHE_HASH
@@ -113,6 +114,54 @@ uint16_t SkGlyphCache::unicharToGlyph(SkUnichar charCode) {
     }
 }
 
+template <typename T>
+void SkGlyphCache::charsToGlyphsT(const T chars[], int count,
+                                  uint16_t glyphs[]) {
+    VALIDATE();
+
+    /*  unicharToGlyph doesn't add misses to fCharToGlyphHash, so text that
+        hasn't been drawn yet asks the scaler for every character. Remember
+        the answers for this run in a small direct-mapped table instead.
+     */
+    enum {
+        kMemoBits   = 6,
+        kMemoCount  = 1 << kMemoBits,
+        kMemoMask   = kMemoCount - 1
+    };
+    uint32_t    memoChar[kMemoCount];
+    uint16_t    memoGlyph[kMemoCount];
+    memset(memoChar, 0xFF, sizeof(memoChar));
+
+    for (int i = 0; i < count; i++) {
+        unsigned c = chars[i];
+        uint32_t id = SkGlyph::MakeID(c);
+        const CharGlyphRec& rec = fCharToGlyphHash[ID2HashIndex(id)];
+
+        if (rec.fID == id) {
+            glyphs[i] = rec.fGlyph->getGlyphID();
+        } else {
+            unsigned index = c & kMemoMask;
+            if (memoChar[index] != c) {
+                memoChar[index] = c;
+                memoGlyph[index] = fScalerContext->charToGlyphID(c);
+            }
+            glyphs[i] = memoGlyph[index];
+        }
+    }
+}
+
+void SkGlyphCache::charsToGlyphs(const uint8_t chars[], int count,
+                                 uint16_t glyphs[]) {
+    SkASSERT(SkUTF8_CountASCII((const char*)chars, count) == (size_t)count);
+    this->charsToGlyphsT(chars, count, glyphs);
+}
+
+void SkGlyphCache::charsToGlyphs(const uint16_t chars[], int count,
+                                 uint16_t glyphs[]) {
+    SkASSERT(SkUTF16_CountBMP(chars, count) == count);
+    this->charsToGlyphsT(chars, count, glyphs);
+}
+
 SkUnichar SkGlyphCache::glyphToUnichar(uint16_t glyphID) {
     return fScalerContext->glyphIDToChar(glyphID);
 }
@@ -239,6 +288,82 @@ const SkGlyph& SkGlyphCache::getGlyphIDMetrics(uint16_t glyphID,
     return *glyph;
 }
 
+// the char hash hit from getUnicharAdvance/Metrics, inlined for runs
+inline const SkGlyph* SkGlyphCache::getCharGlyph(SkUnichar charCode,
+                                                 bool fullMetrics) {
+    uint32_t id = SkGlyph::MakeID(charCode);
+    const CharGlyphRec& rec = fCharToGlyphHash[ID2HashIndex(id)];
+
+    if (rec.fID == id && !(fullMetrics && rec.fGlyph->isJustAdvance())) {
+        return rec.fGlyph;
+    }
+    return fullMetrics ? &this->getUnicharMetrics(charCode) :
+                         &this->getUnicharAdvance(charCode);
+}
+
+int SkGlyphCache::getGlyphRun(SkPaint::TextEncoding encoding,
+                              const char** textPtr, const char* stop,
+                              const SkGlyph* glyphs[], int maxCount,
+                              bool fullMetrics) {
+    VALIDATE();
+    SkASSERT(textPtr && *textPtr <= stop && maxCount > 0);
+
+    const char* text = *textPtr;
+    int         n = 0;
+
+    switch (encoding) {
+        case SkPaint::kUTF8_TextEncoding:
+            while (n < maxCount && text < stop) {
+                size_t ascii = SkUTF8_CountASCII(text, SkMin32(stop - text,
+                                                               maxCount - n));
+                const uint8_t* chars = (const uint8_t*)text;
+                for (size_t i = 0; i < ascii; i++) {
+                    glyphs[n++] = this->getCharGlyph(chars[i], fullMetrics);
+                }
+                text += ascii;
+                while (n < maxCount && text < stop &&
+                       (*(const uint8_t*)text & 0x80)) {
+                    glyphs[n++] = this->getCharGlyph(SkUTF8_NextUnichar(&text),
+                                                     fullMetrics);
+                }
+            }
+            break;
+        case SkPaint::kUTF16_TextEncoding: {
+            const uint16_t* text16 = (const uint16_t*)text;
+            const uint16_t* stop16 = (const uint16_t*)stop;
+            while (n < maxCount && text16 < stop16) {
+                int bmp = SkUTF16_CountBMP(text16, SkMin32(stop16 - text16,
+                                                           maxCount - n));
+                for (int i = 0; i < bmp; i++) {
+                    glyphs[n++] = this->getCharGlyph(text16[i], fullMetrics);
+                }
+                text16 += bmp;
+                if (n < maxCount && text16 < stop16) {
+                    glyphs[n++] = this->getCharGlyph(
+                                SkUTF16_NextUnichar(&text16), fullMetrics);
+                }
+            }
+            text = (const char*)text16;
+            break;
+        }
+        case SkPaint::kGlyphID_TextEncoding: {
+            const uint16_t* text16 = (const uint16_t*)text;
+            int count = SkMin32(((const uint16_t*)stop) - text16, maxCount);
+            for (; n < count; n++) {
+                glyphs[n] = fullMetrics ? &this->getGlyphIDMetrics(text16[n]) :
+                                          &this->getGlyphIDAdvance(text16[n]);
+            }
+            text = (const char*)(text16 + n);
+            break;
+        }
+        default:
+            SkASSERT(!"unknown text encoding");
+            break;
+    }
+    *textPtr = text;
+    return n;
+}
+
 SkGlyph* SkGlyphCache::lookupMetrics(uint32_t id, MetricsType mtype) {
     SkGlyph* glyph;
 
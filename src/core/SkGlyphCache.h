@@ -72,6 +72,25 @@ public:
     */
     uint16_t unicharToGlyph(SkUnichar);
 
+    /** Return the glyphIDs for count characters that are each a whole
+        unichar: ASCII bytes, or UTF-16 values that are not surrogates (see
+        SkUTF8_CountASCII and SkUTF16_CountBMP). This matches calling
+        unicharToGlyph on each, except that the scaler is asked about each
+        distinct character at most once per call.
+    */
+    void charsToGlyphs(const uint8_t chars[], int count, uint16_t glyphs[]);
+    void charsToGlyphs(const uint16_t chars[], int count, uint16_t glyphs[]);
+
+    /** Look up the glyphs for the text in [*text, stop), stored in the
+        specified encoding, as the ...Advance (or, if fullMetrics is true, the
+        ...Metrics) calls would, without subpixel positioning. Stores at most
+        maxCount glyphs, advances *text past the characters they came from,
+        and returns how many were stored. ASCII and BMP runs are found in bulk
+        and need no decoding.
+    */
+    int getGlyphRun(SkPaint::TextEncoding, const char** text, const char* stop,
+                    const SkGlyph* glyphs[], int maxCount, bool fullMetrics);
+
     /** Map the glyph to its Unicode equivalent. Unmappable glyphs map to
         a character code of zero.
     */
@@ -199,6 +218,9 @@ private:
     };
 
     SkGlyph* lookupMetrics(uint32_t id, MetricsType);
+    inline const SkGlyph* getCharGlyph(SkUnichar, bool fullMetrics);
+    template <typename T>
+    void charsToGlyphsT(const T chars[], int count, uint16_t glyphs[]);
     static bool DetachProc(const SkGlyphCache*, void*) { return true; }
 
     void detach(SkGlyphCache** head) {
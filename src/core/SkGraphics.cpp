@@ -32,6 +32,7 @@
 #include "SkScalerContext.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkThread.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
 #include "SkUtils.h"
@@ -119,6 +120,8 @@ void SkGraphics::Init() {
 
 void SkGraphics::Term() {
     SkGraphics::SetFontCacheUsed(0);
+    // e.g. the main thread's SkDrawArena, which it never exits to free
+    sk_delete_thread_data();
     SkGlobals::Term();
 }
 
@@ -130,6 +133,26 @@ bool SkGraphics::SetFontCacheUsed(size_t usageInBytes) {
     return SkGlyphCache::SetCacheUsed(usageInBytes);
 }
 
+static int gFillPathThreadCount = 1;
+
+int SkGraphics::GetFillPathThreadCount() {
+    return gFillPathThreadCount;
+}
+
+void SkGraphics::SetFillPathThreadCount(int count) {
+    gFillPathThreadCount = SkMax32(count, 1);
+}
+
+#include "SkDrawArena.h"
+
+void SkGraphics::GetDrawAllocCounts(int* allocCount, int* heapAllocCount) {
+    SkDrawArena::GetAllocCounts(allocCount, heapAllocCount);
+}
+
+void SkGraphics::ResetDrawAllocCounts() {
+    SkDrawArena::ResetAllocCounts();
+}
+
 void SkGraphics::GetVersion(int32_t* major, int32_t* minor, int32_t* patch) {
     if (major) {
         *major = SKIA_VERSION_MAJOR;
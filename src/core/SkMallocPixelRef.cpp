@@ -11,11 +11,14 @@ SkMallocPixelRef::SkMallocPixelRef(void* storage, size_t size,
     fSize = size;
     fCTable = ctable;
     SkSafeRef(ctable);
+    fOwnsStorage = true;
 }
 
 SkMallocPixelRef::~SkMallocPixelRef() {
     SkSafeUnref(fCTable);
-    sk_free(fStorage);
+    if (fOwnsStorage) {
+        sk_free(fStorage);
+    }
 }
 
 void* SkMallocPixelRef::onLockPixels(SkColorTable** ct) {
@@ -43,8 +46,14 @@ void SkMallocPixelRef::flatten(SkFlattenableWriteBuffer& buffer) const {
 SkMallocPixelRef::SkMallocPixelRef(SkFlattenableReadBuffer& buffer)
         : INHERITED(buffer, NULL) {
     fSize = buffer.readU32();
-    fStorage = sk_malloc_throw(fSize);
-    buffer.read(fStorage, fSize);
+    fOwnsStorage = !buffer.sharePixels();
+    if (fOwnsStorage) {
+        fStorage = sk_malloc_throw(fSize);
+        buffer.read(fStorage, fSize);
+    } else {
+        // the buffer outlives us, so use its copy of the pixels
+        fStorage = const_cast<void*>(buffer.skip(fSize));
+    }
     if (buffer.readBool()) {
         fCTable = SkNEW_ARGS(SkColorTable, (buffer));
     } else {
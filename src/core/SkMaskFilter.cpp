@@ -16,6 +16,7 @@
 */
 
 #include "SkMaskFilter.h"
+#include "SkMaskFilterProcs.h"
 #include "SkBlitter.h"
 #include "SkBounder.h"
 #include "SkBuffer.h"
@@ -27,6 +28,25 @@ bool SkMaskFilter::filterMask(SkMask*, const SkMask&, const SkMatrix&,
     return false;
 }
 
+/*  As with SkColorFilter's span procs, the platform proc is looked up once,
+    and a racing thread at worst looks it up again.
+ */
+static bool gPlatformProcLookedUp;
+static bool gUsePlatformProcs = true;
+static SkMaskFilterProcs::Kernel33RowProc gKernel33RowProc;
+
+SkMaskFilterProcs::Kernel33RowProc SkMaskFilterProcs::GetKernel33RowProc() {
+    if (!gPlatformProcLookedUp) {
+        gKernel33RowProc = PlatformKernel33RowProc();
+        gPlatformProcLookedUp = true;
+    }
+    return gUsePlatformProcs ? gKernel33RowProc : NULL;
+}
+
+void SkMaskFilterProcs::SetUsePlatformProcs(bool use) {
+    gUsePlatformProcs = use;
+}
+
 bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                               const SkRegion& clip, SkBounder* bounder,
                               SkBlitter* blitter) {
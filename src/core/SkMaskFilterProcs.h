@@ -0,0 +1,46 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#ifndef SkMaskFilterProcs_DEFINED
+#define SkMaskFilterProcs_DEFINED
+
+#include "SkTypes.h"
+
+class SkMaskFilterProcs {
+public:
+    /** Row proc for SkKernel33MaskFilter, on platforms that have one (e.g.
+        SSE2). srcRows[] each hold count + 2 pixels, and dst[x] is the kernel
+        applied to the 3x3 pixels starting at srcRows[0..2][x], shifted right
+        by shift and pinned to 0..255, exactly as the portable code does.
+    */
+    typedef void (*Kernel33RowProc)(const uint8_t* const srcRows[3],
+                                    const int16_t kernel[9], int shift,
+                                    int count, uint8_t dst[]);
+
+    /** Return this platform's row proc, or NULL if the filter should use its
+        portable code (always, while SetUsePlatformProcs(false) is in effect,
+        so that benches and tests can compare the two).
+    */
+    static Kernel33RowProc GetKernel33RowProc();
+    static void SetUsePlatformProcs(bool);
+
+private:
+    /** Implemented in src/opts. */
+    static Kernel33RowProc PlatformKernel33RowProc();
+};
+
+#endif
@@ -1017,7 +1017,7 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
     }
 }
 
-const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
+const SkMatrix::MapPtsProc SkMatrix::gPortableMapPtsProcs[] = {
     SkMatrix::Identity_pts, SkMatrix::Trans_pts,
     SkMatrix::Scale_pts,    SkMatrix::ScaleTrans_pts,
     SkMatrix::Rot_pts,      SkMatrix::RotTrans_pts,
@@ -1029,6 +1029,31 @@ const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts
 };
 
+SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts,
+    SkMatrix::Stub_pts,     SkMatrix::Stub_pts
+};
+
+/*  Like sk_memset16, the table first points at this stub, which looks up the
+    platform procs (e.g. SSE2) once and replaces itself. Each entry is written
+    exactly once with its final value, so racing threads at worst both look up
+    the same procs.
+ */
+void SkMatrix::Stub_pts(const SkMatrix& m, SkPoint dst[],
+                        const SkPoint src[], int count) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gPortableMapPtsProcs); i++) {
+        MapPtsProc proc = PlatformMapPtsProc((TypeMask)i);
+        gMapPtsProcs[i] = proc ? proc : gPortableMapPtsProcs[i];
+    }
+    gMapPtsProcs[m.getType()](m, dst, src, count);
+}
+
 void SkMatrix::mapPoints(SkPoint dst[], const SkPoint src[], int count) const {
     SkASSERT((dst && src && count > 0) || count == 0);
     // no partial overlap
@@ -1043,14 +1068,12 @@ void SkMatrix::mapVectors(SkPoint dst[], const SkPoint src[], int count) const {
     if (this->hasPerspective()) {
         SkPoint origin;
 
-        MapXYProc proc = this->getMapXYProc();
-        proc(*this, 0, 0, &origin);
+        this->getMapXYProc()(*this, 0, 0, &origin);
 
+        // map them all at once (this may be vectorized), then subtract
+        this->mapPoints(dst, src, count);
         for (int i = count - 1; i >= 0; --i) {
-            SkPoint tmp;
-
-            proc(*this, src[i].fX, src[i].fY, &tmp);
-            dst[i].set(tmp.fX - origin.fX, tmp.fY - origin.fY);
+            dst[i] -= origin;
         }
     } else {
         SkMatrix tmp = *this;
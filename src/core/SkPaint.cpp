@@ -26,10 +26,12 @@
 #include "SkScalar.h"
 #include "SkScalerContext.h"
 #include "SkStroke.h"
+#include "SkTLazy.h"
 #include "SkTextFormatParams.h"
 #include "SkTypeface.h"
 #include "SkXfermode.h"
 #include "SkAutoKern.h"
+#include <new>
 
 #define SK_DefaultTextSize      SkIntToScalar(12)
 
@@ -418,14 +420,27 @@ int SkPaint::textToGlyphs(const void* textData, size_t byteLength,
     switch (this->getTextEncoding()) {
         case SkPaint::kUTF8_TextEncoding:
             while (text < stop) {
-                *gptr++ = cache->unicharToGlyph(SkUTF8_NextUnichar(&text));
+                // ascii runs are looked up in bulk, everything else decoded
+                size_t ascii = SkUTF8_CountASCII(text, stop - text);
+                cache->charsToGlyphs((const uint8_t*)text, ascii, gptr);
+                text += ascii;
+                gptr += ascii;
+                while (text < stop && (*(const uint8_t*)text & 0x80)) {
+                    *gptr++ = cache->unicharToGlyph(SkUTF8_NextUnichar(&text));
+                }
             }
             break;
         case SkPaint::kUTF16_TextEncoding: {
             const uint16_t* text16 = (const uint16_t*)text;
             const uint16_t* stop16 = (const uint16_t*)stop;
             while (text16 < stop16) {
-                *gptr++ = cache->unicharToGlyph(SkUTF16_NextUnichar(&text16));
+                int bmp = SkUTF16_CountBMP(text16, stop16 - text16);
+                cache->charsToGlyphs(text16, bmp, gptr);
+                text16 += bmp;
+                gptr += bmp;
+                if (text16 < stop16) {
+                    *gptr++ = cache->unicharToGlyph(SkUTF16_NextUnichar(&text16));
+                }
             }
             break;
         }
@@ -730,24 +745,36 @@ SkDrawCacheProc SkPaint::getDrawCacheProc() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class SkAutoRestorePaintTextSizeAndFrame {
+/*  Measuring wants a fill-style paint, at the canonical size for linear text.
+    Rather than poking those into a const paint (which other threads may be
+    reading), make a copy only when one of them actually differs.
+ */
+class SkCanonicalizePaint {
 public:
-    SkAutoRestorePaintTextSizeAndFrame(const SkPaint* paint)
-            : fPaint((SkPaint*)paint) {
-        fTextSize = paint->getTextSize();
-        fStyle = paint->getStyle();
-        fPaint->setStyle(SkPaint::kFill_Style);
+    SkCanonicalizePaint(const SkPaint& paint) : fPaint(&paint), fScale(0) {
+        if (paint.isLinearText() || SkPaint::kFill_Style != paint.getStyle()) {
+            SkPaint* p = fLazy.set(paint);
+            p->setStyle(SkPaint::kFill_Style);
+            if (p->isLinearText()) {
+                fScale = paint.getTextSize() / SkPaint::kCanonicalTextSizeForPaths;
+                p->setTextSize(SkIntToScalar(SkPaint::kCanonicalTextSizeForPaths));
+            }
+            fPaint = p;
+        }
     }
 
-    ~SkAutoRestorePaintTextSizeAndFrame() {
-        fPaint->setStyle(fStyle);
-        fPaint->setTextSize(fTextSize);
-    }
+    const SkPaint& getPaint() const { return *fPaint; }
+
+    /**
+     *  Returns 0 if the paint was unmodified, or the scale factor needed to get
+     *  back to the original textSize
+     */
+    SkScalar getScale() const { return fScale; }
 
 private:
-    SkPaint*        fPaint;
-    SkScalar        fTextSize;
-    SkPaint::Style  fStyle;
+    const SkPaint*   fPaint;
+    SkScalar         fScale;
+    SkTLazy<SkPaint> fLazy;
 };
 
 static void set_bounds(const SkGlyph& g, SkRect* bounds) {
@@ -792,55 +819,70 @@ SkScalar SkPaint::measure_text(SkGlyphCache* cache,
         return 0;
     }
 
-    SkMeasureCacheProc glyphCacheProc;
-    glyphCacheProc = this->getMeasureCacheProc(kForward_TextBufferDirection,
-                                               NULL != bounds);
+    // look the glyphs up a run at a time, rather than calling a measure
+    // proc (and decoding) per character
+    enum { kMeasureGlyphRun = 64 };
+    const SkGlyph*  glyphs[kMeasureGlyphRun];
+    TextEncoding    encoding = this->getTextEncoding();
+    bool            kern = this->isDevKernText();
+    bool            fullMetrics = NULL != bounds || kern;
 
-    int         n = 1;
     const char* stop = (const char*)text + byteLength;
-    const SkGlyph* g = &glyphCacheProc(cache, &text);
+    int         n = cache->getGlyphRun(encoding, &text, stop, glyphs,
+                                       kMeasureGlyphRun, fullMetrics);
+    const SkGlyph* g = glyphs[0];
     // our accumulated fixed-point advances might overflow 16.16, so we use
     // a 48.16 (64bit) accumulator, and then convert that to scalar at the
     // very end.
     Sk48Dot16 x = g->fAdvanceX;
+    int       total = n;
+    int       i = 1;
 
-    SkAutoKern  autokern;
-
-    if (NULL == bounds) {
-        if (this->isDevKernText()) {
-            int rsb;
-            for (; text < stop; n++) {
-                rsb = g->fRsbDelta;
-                g = &glyphCacheProc(cache, &text);
-                x += SkAutoKern_AdjustF(rsb, g->fLsbDelta) + g->fAdvanceX;
-            }
-        } else {
-            for (; text < stop; n++) {
-                x += glyphCacheProc(cache, &text).fAdvanceX;
-            }
-        }
-    } else {
+    if (bounds) {
         set_bounds(*g, bounds);
-        if (this->isDevKernText()) {
-            int rsb;
-            for (; text < stop; n++) {
-                rsb = g->fRsbDelta;
-                g = &glyphCacheProc(cache, &text);
-                x += SkAutoKern_AdjustF(rsb, g->fLsbDelta);
-                join_bounds(*g, bounds, x);
-                x += g->fAdvanceX;
+    }
+    for (;;) {
+        if (NULL == bounds) {
+            if (kern) {
+                for (; i < n; i++) {
+                    int rsb = g->fRsbDelta;
+                    g = glyphs[i];
+                    x += SkAutoKern_AdjustF(rsb, g->fLsbDelta) + g->fAdvanceX;
+                }
+            } else {
+                for (; i < n; i++) {
+                    x += glyphs[i]->fAdvanceX;
+                }
             }
         } else {
-            for (; text < stop; n++) {
-                g = &glyphCacheProc(cache, &text);
-                join_bounds(*g, bounds, x);
-                x += g->fAdvanceX;
+            if (kern) {
+                for (; i < n; i++) {
+                    int rsb = g->fRsbDelta;
+                    g = glyphs[i];
+                    x += SkAutoKern_AdjustF(rsb, g->fLsbDelta);
+                    join_bounds(*g, bounds, x);
+                    x += g->fAdvanceX;
+                }
+            } else {
+                for (; i < n; i++) {
+                    g = glyphs[i];
+                    join_bounds(*g, bounds, x);
+                    x += g->fAdvanceX;
+                }
             }
         }
+        if (text >= stop) {
+            break;
+        }
+        g = glyphs[n - 1];
+        n = cache->getGlyphRun(encoding, &text, stop, glyphs,
+                               kMeasureGlyphRun, fullMetrics);
+        total += n;
+        i = 0;
     }
     SkASSERT(text == stop);
 
-    *count = n;
+    *count = total;
     return Sk48Dot16ToScalar(x);
 }
 
@@ -849,14 +891,9 @@ SkScalar SkPaint::measureText(const void* textData, size_t length,
     const char* text = (const char*)textData;
     SkASSERT(text != NULL || length == 0);
 
-    SkScalar                            scale = 0;
-    SkAutoRestorePaintTextSizeAndFrame  restore(this);
-
-    if (this->isLinearText()) {
-        scale = fTextSize / kCanonicalTextSizeForPaths;
-        // this gets restored by restore
-        ((SkPaint*)this)->setTextSize(SkIntToScalar(kCanonicalTextSizeForPaths));
-    }
+    SkCanonicalizePaint canon(*this);
+    const SkPaint& paint = canon.getPaint();
+    SkScalar scale = canon.getScale();
 
     SkMatrix zoomMatrix, *zoomPtr = NULL;
     if (zoom) {
@@ -864,7 +901,7 @@ SkScalar SkPaint::measureText(const void* textData, size_t length,
         zoomPtr = &zoomMatrix;
     }
 
-    SkAutoGlyphCache    autoCache(*this, zoomPtr);
+    SkAutoGlyphCache    autoCache(paint, zoomPtr);
     SkGlyphCache*       cache = autoCache.getCache();
 
     SkScalar width = 0;
@@ -923,17 +960,15 @@ size_t SkPaint::breakText(const void* textD, size_t length, SkScalar maxWidth,
     SkASSERT(textD != NULL);
     const char* text = (const char*)textD;
 
-    SkScalar                            scale = 0;
-    SkAutoRestorePaintTextSizeAndFrame  restore(this);
+    SkCanonicalizePaint canon(*this);
+    const SkPaint& paint = canon.getPaint();
+    SkScalar scale = canon.getScale();
 
-    if (this->isLinearText()) {
-        scale = fTextSize / kCanonicalTextSizeForPaths;
+    if (scale) {
         maxWidth = SkScalarMulDiv(maxWidth, kCanonicalTextSizeForPaths, fTextSize);
-        // this gets restored by restore
-        ((SkPaint*)this)->setTextSize(SkIntToScalar(kCanonicalTextSizeForPaths));
     }
 
-    SkAutoGlyphCache    autoCache(*this, NULL);
+    SkAutoGlyphCache    autoCache(paint, NULL);
     SkGlyphCache*       cache = autoCache.getCache();
 
     SkMeasureCacheProc glyphCacheProc = this->getMeasureCacheProc(tbd, false);
@@ -995,14 +1030,9 @@ static void FontMetricsDescProc(const SkDescriptor* desc, void* context) {
 }
 
 SkScalar SkPaint::getFontMetrics(FontMetrics* metrics, SkScalar zoom) const {
-    SkScalar                            scale = 0;
-    SkAutoRestorePaintTextSizeAndFrame  restore(this);
-
-    if (this->isLinearText()) {
-        scale = fTextSize / kCanonicalTextSizeForPaths;
-        // this gets restored by restore
-        ((SkPaint*)this)->setTextSize(SkIntToScalar(kCanonicalTextSizeForPaths));
-    }
+    SkCanonicalizePaint canon(*this);
+    const SkPaint& paint = canon.getPaint();
+    SkScalar scale = canon.getScale();
 
     SkMatrix zoomMatrix, *zoomPtr = NULL;
     if (zoom) {
@@ -1020,7 +1050,7 @@ SkScalar SkPaint::getFontMetrics(FontMetrics* metrics, SkScalar zoom) const {
         metrics = &storage;
     }
 
-    this->descriptorProc(zoomPtr, FontMetricsDescProc, metrics);
+    paint.descriptorProc(zoomPtr, FontMetricsDescProc, metrics);
 
     if (scale) {
         metrics->fTop = SkScalarMul(metrics->fTop, scale);
@@ -1053,16 +1083,11 @@ int SkPaint::getTextWidths(const void* textData, size_t byteLength,
         return this->countText(textData, byteLength);
     }
 
-    SkAutoRestorePaintTextSizeAndFrame  restore(this);
-    SkScalar                            scale = 0;
-
-    if (this->isLinearText()) {
-        scale = fTextSize / kCanonicalTextSizeForPaths;
-        // this gets restored by restore
-        ((SkPaint*)this)->setTextSize(SkIntToScalar(kCanonicalTextSizeForPaths));
-    }
+    SkCanonicalizePaint canon(*this);
+    const SkPaint& paint = canon.getPaint();
+    SkScalar scale = canon.getScale();
 
-    SkAutoGlyphCache    autoCache(*this, NULL);
+    SkAutoGlyphCache    autoCache(paint, NULL);
     SkGlyphCache*       cache = autoCache.getCache();
     SkMeasureCacheProc  glyphCacheProc;
     glyphCacheProc = this->getMeasureCacheProc(kForward_TextBufferDirection,
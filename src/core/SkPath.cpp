@@ -19,6 +19,7 @@
 #include "SkReader32.h"
 #include "SkWriter32.h"
 #include "SkMath.h"
+#include "SkThread.h"
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -98,18 +99,12 @@ static void compute_pt_bounds(SkRect* bounds, const SkTDArray<SkPoint>& pts) {
 
 SkPath::SkPath() : fBoundsIsDirty(true), fFillType(kWinding_FillType) {
     fConvexity = kUnknown_Convexity;
-#ifdef ANDROID
-    fGenerationID = 0;
-#endif
+    this->newGenerationID();
 }
 
 SkPath::SkPath(const SkPath& src) {
     SkDEBUGCODE(src.validate();)
     *this = src;
-#ifdef ANDROID
-    // the assignment operator above increments the ID so correct for that here
-    fGenerationID--;
-#endif
 }
 
 SkPath::~SkPath() {
@@ -126,7 +121,8 @@ SkPath& SkPath::operator=(const SkPath& src) {
         fFillType       = src.fFillType;
         fBoundsIsDirty  = src.fBoundsIsDirty;
         fConvexity      = src.fConvexity;
-        GEN_ID_INC;
+        // same contents, so same ID
+        fGenerationID   = src.fGenerationID;
     }
     SkDEBUGCODE(this->validate();)
     return *this;
@@ -149,22 +145,35 @@ void SkPath::swap(SkPath& other) {
         SkTSwap<uint8_t>(fFillType, other.fFillType);
         SkTSwap<uint8_t>(fBoundsIsDirty, other.fBoundsIsDirty);
         SkTSwap<uint8_t>(fConvexity, other.fConvexity);
-        GEN_ID_INC;
+        SkTSwap<uint32_t>(fGenerationID, other.fGenerationID);
     }
 }
 
-#ifdef ANDROID
+static uint32_t next_path_generation_id() {
+    static int32_t  gPathGenerationID;
+    // do a loop in case our global wraps around, as we never want to
+    // return a 0
+    uint32_t genID;
+    do {
+        genID = sk_atomic_inc(&gPathGenerationID) + 1;
+    } while (0 == genID);
+    return genID;
+}
+
 uint32_t SkPath::getGenerationID() const {
     return fGenerationID;
 }
-#endif
+
+void SkPath::newGenerationID() {
+    fGenerationID = next_path_generation_id();
+}
 
 void SkPath::reset() {
     SkDEBUGCODE(this->validate();)
 
     fPts.reset();
     fVerbs.reset();
-    GEN_ID_INC;
+    this->newGenerationID();
     fBoundsIsDirty = true;
     fConvexity = kUnknown_Convexity;
 }
@@ -174,7 +183,7 @@ void SkPath::rewind() {
 
     fPts.rewind();
     fVerbs.rewind();
-    GEN_ID_INC;
+    this->newGenerationID();
     fBoundsIsDirty = true;
     fConvexity = kUnknown_Convexity;
 }
@@ -224,6 +233,12 @@ void SkPath::getLastPt(SkPoint* lastPt) const {
     }
 }
 
+#define DIRTY_AFTER_EDIT                \
+    do {                                \
+        fBoundsIsDirty = true;          \
+        fConvexity = kUnknown_Convexity;\
+    } while (0)
+
 void SkPath::setLastPt(SkScalar x, SkScalar y) {
     SkDEBUGCODE(this->validate();)
 
@@ -232,7 +247,8 @@ void SkPath::setLastPt(SkScalar x, SkScalar y) {
         this->moveTo(x, y);
     } else {
         fPts[count - 1].set(x, y);
-        GEN_ID_INC;
+        this->newGenerationID();
+        DIRTY_AFTER_EDIT;
     }
 }
 
@@ -247,19 +263,13 @@ void SkPath::computeBounds() const {
 void SkPath::setConvexity(Convexity c) {
     if (fConvexity != c) {
         fConvexity = c;
-        GEN_ID_INC;
+        this->newGenerationID();
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 //  Construction methods
 
-#define DIRTY_AFTER_EDIT                \
-    do {                                \
-        fBoundsIsDirty = true;          \
-        fConvexity = kUnknown_Convexity;\
-    } while (0)
-
 void SkPath::incReserve(U16CPU inc) {
     SkDEBUGCODE(this->validate();)
 
@@ -283,7 +293,7 @@ void SkPath::moveTo(SkScalar x, SkScalar y) {
     }
     pt->set(x, y);
 
-    GEN_ID_INC;
+    this->newGenerationID();
     DIRTY_AFTER_EDIT;
 }
 
@@ -303,7 +313,7 @@ void SkPath::lineTo(SkScalar x, SkScalar y) {
     fPts.append()->set(x, y);
     *fVerbs.append() = kLine_Verb;
 
-    GEN_ID_INC;
+    this->newGenerationID();
     DIRTY_AFTER_EDIT;
 }
 
@@ -326,7 +336,7 @@ void SkPath::quadTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2) {
     pts[1].set(x2, y2);
     *fVerbs.append() = kQuad_Verb;
 
-    GEN_ID_INC;
+    this->newGenerationID();
     DIRTY_AFTER_EDIT;
 }
 
@@ -350,7 +360,7 @@ void SkPath::cubicTo(SkScalar x1, SkScalar y1, SkScalar x2, SkScalar y2,
     pts[2].set(x3, y3);
     *fVerbs.append() = kCubic_Verb;
 
-    GEN_ID_INC;
+    this->newGenerationID();
     DIRTY_AFTER_EDIT;
 }
 
@@ -372,7 +382,7 @@ void SkPath::close() {
             case kQuad_Verb:
             case kCubic_Verb:
                 *fVerbs.append() = kClose_Verb;
-                GEN_ID_INC;
+                this->newGenerationID();
                 break;
             default:
                 // don't add a close if the prev wasn't a primitive
@@ -990,14 +1000,16 @@ void SkPath::transform(const SkMatrix& matrix, SkPath* dst) const {
             matrix.mapRect(&dst->fBounds, fBounds);
             dst->fBoundsIsDirty = false;
         } else {
-            GEN_ID_PTR_INC(dst);
             dst->fBoundsIsDirty = true;
         }
+        dst->newGenerationID();
 
         if (this != dst) {
             dst->fVerbs = fVerbs;
             dst->fPts.setCount(fPts.count());
             dst->fFillType = fFillType;
+            // an affine transform keeps a convex path convex (and vice versa)
+            dst->fConvexity = fConvexity;
         }
         matrix.mapPoints(dst->fPts.begin(), fPts.begin(), fPts.count());
         SkDEBUGCODE(dst->validate();)
@@ -1215,7 +1227,7 @@ void SkPath::unflatten(SkReader32& buffer) {
     buffer.read(fPts.begin(), sizeof(SkPoint) * fPts.count());
     buffer.read(fVerbs.begin(), fVerbs.count());
 
-    GEN_ID_INC;
+    this->newGenerationID();
     DIRTY_AFTER_EDIT;
 
     SkDEBUGCODE(this->validate();)
@@ -18,6 +18,7 @@
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkTSearch.h"
+#include "SkThread.h"
 
 // these must be 0,1,2 since they are in our 2-bit field
 enum {
@@ -152,6 +153,95 @@ SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
     return distance;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Flattening curves into segments is most of the cost of measuring a path,
+    and path effects (e.g. dashing) measure the same path every time it is
+    drawn. So we keep the segments of recently measured contours that have
+    curves, keyed on the path's generation ID (which changes whenever the path
+    is edited) and on where the contour starts.
+ */
+
+enum {
+    kMinCachePoints = 16,           // smaller paths are cheap to measure
+    kMaxCacheBytes  = 512 * 1024,   // total size of the cache
+    kCacheCount     = 16
+};
+
+struct SkMeasureCacheEntry {
+    uint32_t            fGenerationID;
+    int                 fFirstPtIndex;
+    bool                fForceClosed;
+    uint32_t            fLastUsed;
+    // what buildSegments() computed for the contour
+    SkScalar            fLength;
+    bool                fIsClosed;
+    int                 fNextPtIndex;
+    SkTDArray<char>     fSegments;  // raw Segment array
+};
+
+static SkMutex              gMeasureCacheMutex;
+static SkMeasureCacheEntry* gMeasureCache[kCacheCount];
+static uint32_t             gMeasureCacheClock;
+
+static size_t measure_cache_bytes() {
+    size_t total = 0;
+    for (int i = 0; i < kCacheCount; i++) {
+        if (gMeasureCache[i]) {
+            total += gMeasureCache[i]->fSegments.count();
+        }
+    }
+    return total;
+}
+
+static SkMeasureCacheEntry* find_measure_cache(uint32_t genID,
+                                               int firstPtIndex,
+                                               bool forceClosed) {
+    for (int i = 0; i < kCacheCount; i++) {
+        SkMeasureCacheEntry* entry = gMeasureCache[i];
+        if (entry && entry->fGenerationID == genID &&
+                entry->fFirstPtIndex == firstPtIndex &&
+                entry->fForceClosed == forceClosed) {
+            entry->fLastUsed = ++gMeasureCacheClock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// takes ownership of entry
+static void add_measure_cache(SkMeasureCacheEntry* entry) {
+    const size_t size = entry->fSegments.count();
+    if (size > kMaxCacheBytes) {
+        delete entry;
+        return;
+    }
+
+    SkAutoMutexAcquire  ac(gMeasureCacheMutex);
+
+    entry->fLastUsed = ++gMeasureCacheClock;
+    // evict the least recently used entries until the new one fits
+    for (;;) {
+        int empty = -1;
+        int lru = -1;
+        for (int i = 0; i < kCacheCount; i++) {
+            const SkMeasureCacheEntry* e = gMeasureCache[i];
+            if (NULL == e) {
+                empty = i;
+            } else if (lru < 0 || e->fLastUsed < gMeasureCache[lru]->fLastUsed) {
+                lru = i;
+            }
+        }
+        if (empty >= 0 && measure_cache_bytes() + size <= kMaxCacheBytes) {
+            gMeasureCache[empty] = entry;
+            return;
+        }
+        SkASSERT(lru >= 0);
+        delete gMeasureCache[lru];
+        gMeasureCache[lru] = NULL;
+    }
+}
+
 void SkPathMeasure::buildSegments() {
     SkPoint         pts[4];
     int             ptIndex = fFirstPtIndex;
@@ -159,6 +249,35 @@ void SkPathMeasure::buildSegments() {
     bool            isClosed = fForceClosed;
     bool            firstMoveTo = ptIndex < 0;
     Segment*        seg;
+    bool            hasCurves = false;
+    uint32_t        genID = 0;
+
+    if (fPath->countPoints() >= kMinCachePoints) {
+        genID = fPath->getGenerationID();
+
+        SkAutoMutexAcquire  ac(gMeasureCacheMutex);
+        const SkMeasureCacheEntry* entry = find_measure_cache(genID,
+                                                fFirstPtIndex, fForceClosed);
+        if (entry) {
+            fLength = entry->fLength;
+            fIsClosed = entry->fIsClosed;
+            fFirstPtIndex = entry->fNextPtIndex;
+            fSegments.setCount(entry->fSegments.count() / sizeof(Segment));
+            memcpy(fSegments.begin(), entry->fSegments.begin(),
+                   entry->fSegments.count());
+            ac.release();
+
+            // still step over the contour, so the next one starts in place
+            for (;;) {
+                SkPath::Verb verb = fIter.next(pts);
+                if (SkPath::kDone_Verb == verb ||
+                        (SkPath::kMove_Verb == verb && !firstMoveTo)) {
+                    return;
+                }
+                firstMoveTo = false;
+            }
+        }
+    }
 
     fSegments.reset();
     for (;;) {
@@ -190,12 +309,14 @@ void SkPathMeasure::buildSegments() {
                 distance = this->compute_quad_segs(pts, distance, 0,
                                                    kMaxTValue, ptIndex);
                 ptIndex += 2;
+                hasCurves = true;
                 break;
 
             case SkPath::kCubic_Verb:
                 distance = this->compute_cubic_segs(pts, distance, 0,
                                                     kMaxTValue, ptIndex);
                 ptIndex += 3;
+                hasCurves = true;
                 break;
 
             case SkPath::kClose_Verb:
@@ -207,6 +328,19 @@ void SkPathMeasure::buildSegments() {
         }
     }
 DONE:
+    if (genID && hasCurves) {
+        SkMeasureCacheEntry* entry = new SkMeasureCacheEntry;
+        entry->fGenerationID = genID;
+        entry->fFirstPtIndex = fFirstPtIndex;
+        entry->fForceClosed = fForceClosed;
+        entry->fLength = distance;
+        entry->fIsClosed = isClosed;
+        entry->fNextPtIndex = ptIndex + 1;
+        entry->fSegments.append(fSegments.count() * sizeof(Segment),
+                                (const char*)fSegments.begin());
+        add_measure_cache(entry);
+    }
+
     fLength = distance;
     fIsClosed = isClosed;
     fFirstPtIndex = ptIndex + 1;
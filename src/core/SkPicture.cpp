@@ -193,14 +193,36 @@ void SkPicture::draw(SkCanvas* surface) {
     }
 }
 
+void SkPicture::draw(SkCanvas* surface, const SkRegion& damage) {
+    if (damage.isEmpty()) {
+        return;
+    }
+    int saveCount = surface->save(SkCanvas::kClip_SaveFlag);
+    if (surface->clipRegion(damage)) {
+        this->draw(surface);
+    }
+    surface->restoreToCount(saveCount);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkStream.h"
 
-#define PICTURE_VERSION     1
-
 SkPicture::SkPicture(SkStream* stream) : SkRefCnt() {
-    if (stream->readU32() != PICTURE_VERSION) {
+    this->parse(stream, NULL);
+}
+
+SkPicture* SkPicture::CreateFromMemoryStream(SkMemoryStream* stream) {
+    SkPicture* picture = SkNEW(SkPicture);
+    // our chunks keep their alignment, but only if we start out aligned
+    bool aligned = 0 == ((intptr_t)stream->getAtPos() & 3);
+    picture->parse(stream, aligned ? stream : NULL);
+    return picture;
+}
+
+void SkPicture::parse(SkStream* stream, SkMemoryStream* memory) {
+    uint32_t version = stream->readU32();
+    if (version < PICTURE_VERSION_UNALIGNED || version > PICTURE_VERSION) {
         sk_throw();
     }
 
@@ -210,8 +232,15 @@ SkPicture::SkPicture(SkStream* stream) : SkRefCnt() {
     fRecord = NULL;
     fPlayback = NULL;
 
-    if (stream->readBool()) {
-        fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream));
+    bool hasPlayback;
+    if (PICTURE_VERSION_UNALIGNED == version) {
+        hasPlayback = stream->readBool();
+        memory = NULL;
+    } else {
+        hasPlayback = SkToBool(stream->readU32());
+    }
+    if (hasPlayback) {
+        fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream, version, memory));
     }
 }
 
@@ -226,15 +255,31 @@ void SkPicture::serialize(SkWStream* stream) const {
     stream->write32(fWidth);
     stream->write32(fHeight);
     if (playback) {
-        stream->writeBool(true);
+        stream->write32(true);
         playback->serialize(stream);
         // delete playback if it is a local version (i.e. cons'd up just now)
         if (playback != fPlayback) {
             SkDELETE(playback);
         }
     } else {
-        stream->writeBool(false);
+        stream->write32(false);
+    }
+}
+
+int SkPicture::getRecordedOpCount(int* removedCount) const {
+    if (fRecord) {
+        if (removedCount) {
+            *removedCount = fRecord->removedOpCount();
+        }
+        return fRecord->recordedOpCount();
+    }
+    if (fPlayback) {
+        return fPlayback->recordedOpCount(removedCount);
+    }
+    if (removedCount) {
+        *removedCount = 0;
     }
+    return 0;
 }
 
 void SkPicture::abortPlayback() {
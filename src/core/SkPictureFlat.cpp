@@ -11,10 +11,96 @@
 SkFlatData* SkFlatData::Alloc(SkChunkAlloc* heap, int32_t size, int index) {
     SkFlatData* result = (SkFlatData*) heap->allocThrow(size + sizeof(SkFlatData));
     result->fIndex = index;
+    result->fHash = 0;
     result->fAllocSize = size + sizeof(result->fAllocSize);
     return result;
 }
 
+void SkFlatData::computeHash() {
+    // the same bytes that Compare() looks at
+    const uint32_t* data = (const uint32_t*)&fAllocSize;
+    int count = fAllocSize >> 2;
+
+    uint32_t hash = 0;
+    for (int i = 0; i < count; i++) {
+        hash = (hash ^ data[i]) * 0x01000193;   // FNV prime
+        hash ^= hash >> 15;
+    }
+    const uint8_t* tail = (const uint8_t*)(data + count);
+    for (int i = count << 2; i < fAllocSize; i++) {
+        hash = (hash ^ *tail++) * 0x01000193;
+    }
+    fHash = hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkFlatDataTable::SkFlatDataTable() : fSlots(NULL), fCapacity(0), fCount(0) {}
+
+SkFlatDataTable::~SkFlatDataTable() {
+    sk_free(fSlots);
+}
+
+void SkFlatDataTable::reset() {
+    sk_free(fSlots);
+    fSlots = NULL;
+    fCapacity = fCount = 0;
+}
+
+const SkFlatData* SkFlatDataTable::find(const SkFlatData* flat) const {
+    if (0 == fCount) {
+        return NULL;
+    }
+    const int mask = fCapacity - 1;
+    int index = flat->hash() & mask;
+    const SkFlatData* slot;
+    while ((slot = fSlots[index]) != NULL) {
+        if (slot->hash() == flat->hash() && !SkFlatData::Compare(slot, flat)) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+void SkFlatDataTable::add(const SkFlatData* flat) {
+    SkASSERT(NULL == this->find(flat));
+
+    // keep the table at most half full, so that probes stay short
+    if ((fCount + 1) * 2 > fCapacity) {
+        this->grow();
+    }
+    const int mask = fCapacity - 1;
+    int index = flat->hash() & mask;
+    while (fSlots[index]) {
+        index = (index + 1) & mask;
+    }
+    fSlots[index] = flat;
+    fCount += 1;
+}
+
+void SkFlatDataTable::grow() {
+    const SkFlatData** oldSlots = fSlots;
+    int oldCapacity = fCapacity;
+
+    fCapacity = oldCapacity ? oldCapacity * 2 : 32;
+    size_t size = fCapacity * sizeof(const SkFlatData*);
+    fSlots = (const SkFlatData**)sk_malloc_throw(size);
+    sk_bzero(fSlots, size);
+
+    const int mask = fCapacity - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i]) {
+            int index = oldSlots[i]->hash() & mask;
+            while (fSlots[index]) {
+                index = (index + 1) & mask;
+            }
+            fSlots[index] = oldSlots[i];
+        }
+    }
+    sk_free(oldSlots);
+}
+
 SkFlatBitmap* SkFlatBitmap::Flatten(SkChunkAlloc* heap, const SkBitmap& bitmap,
                                     int index, SkRefCntSet* rec) {
     SkFlattenableWriteBuffer buffer(1024);
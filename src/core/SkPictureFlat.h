@@ -105,6 +105,10 @@ public:
     }
     
     int index() const { return fIndex; }
+
+    // computes (and remembers) a hash of the flattened data
+    void computeHash();
+    uint32_t hash() const { return fHash; }
     
 #ifdef SK_DEBUG_SIZE
     size_t size() const { return sizeof(fIndex) + fAllocSize; }
@@ -114,9 +118,36 @@ protected:
     static SkFlatData* Alloc(SkChunkAlloc* heap, int32_t size, int index);
     
     int fIndex;
+    uint32_t fHash;
+    // Compare() looks at this and the data that follows it
     int32_t fAllocSize;
 };
 
+/** Finds an SkFlatData by its flattened data, through a hash table of the
+    ones added so far. Each must have had computeHash() called. The table does
+    not own them.
+*/
+class SkFlatDataTable : SkNoncopyable {
+public:
+    SkFlatDataTable();
+    ~SkFlatDataTable();
+
+    int count() const { return fCount; }
+
+    // returns the entry with the same data as flat, or NULL
+    const SkFlatData* find(const SkFlatData* flat) const;
+    // flat's data must not already be in the table
+    void add(const SkFlatData* flat);
+    void reset();
+
+private:
+    const SkFlatData**  fSlots;     // NULL for an empty slot
+    int                 fCapacity;  // a power of 2
+    int                 fCount;
+
+    void grow();
+};
+
 class SkFlatBitmap : public SkFlatData {
 public:
     static SkFlatBitmap* Flatten(SkChunkAlloc*, const SkBitmap&, int index,
@@ -1,5 +1,6 @@
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
+#include "SkStream.h"
 #include "SkTypeface.h"
 #include <new>
 
@@ -53,6 +54,8 @@ SkPicturePlayback::SkPicturePlayback(const SkPictureRecord& record) {
     record.validate();
     const SkWriter32& writer = record.writeStream();
     init();
+    fRecordedOpCount = record.recordedOpCount();
+    fRemovedOpCount = record.removedOpCount();
     if (writer.size() == 0)
         return;
 
@@ -131,6 +134,8 @@ SkPicturePlayback::SkPicturePlayback(const SkPictureRecord& record) {
         }
     }
 
+    this->computeLazyState();
+
 #ifdef SK_DEBUG_SIZE
     int overall = fPlayback->size(&overallBytes);
     bitmaps = fPlayback->bitmaps(&bitmapBytes);
@@ -156,14 +161,22 @@ SkPicturePlayback::SkPicturePlayback(const SkPictureRecord& record) {
 SkPicturePlayback::SkPicturePlayback(const SkPicturePlayback& src) {
     this->init();
 
-    // copy the data from fReader
-    {
+    // copy the data from fReader, unless it lives in src's stream, which we
+    // then share (our copies of its bitmaps point into it too)
+    if (src.fStream) {
+        fStream = src.fStream;
+        fStream->ref();
+        fReader.setMemory(src.fReader.base(), src.fReader.size());
+    } else {
         size_t size = src.fReader.size();
         void* buffer = sk_malloc_throw(size);
         memcpy(buffer, src.fReader.base(), size);
         fReader.setMemory(buffer, size);
     }
 
+    fRecordedOpCount = src.fRecordedOpCount;
+    fRemovedOpCount = src.fRemovedOpCount;
+
     int i;
 
     fBitmapCount = src.fBitmapCount;
@@ -181,6 +194,7 @@ SkPicturePlayback::SkPicturePlayback(const SkPicturePlayback& src) {
     for (i = 0; i < fPaintCount; i++) {
         fPaints[i] = src.fPaints[i];
     }
+    fSerializeDraws = src.fSerializeDraws;
 
     fPathHeap = src.fPathHeap;
     SkSafeRef(fPathHeap);
@@ -210,10 +224,16 @@ void SkPicturePlayback::init() {
     fRegionCount = 0;
 
     fFactoryPlayback = NULL;
+    fStream = NULL;
+    fRecordedOpCount = fRemovedOpCount = 0;
+    fAbortCount = 0;
+    fSerializeDraws = false;
 }
 
 SkPicturePlayback::~SkPicturePlayback() {
-    sk_free((void*) fReader.base());
+    if (NULL == fStream) {
+        sk_free((void*) fReader.base());
+    }
 
     SkDELETE_ARRAY(fBitmaps);
     SkDELETE_ARRAY(fMatrices);
@@ -228,6 +248,9 @@ SkPicturePlayback::~SkPicturePlayback() {
     SkDELETE_ARRAY(fPictureRefs);
 
     SkDELETE(fFactoryPlayback);
+
+    // last, since our bitmaps may point into it
+    SkSafeUnref(fStream);
 }
 
 void SkPicturePlayback::dumpSize() const {
@@ -257,8 +280,6 @@ void SkPicturePlayback::dumpSize() const {
 #define PICT_PATH_TAG       SkSetFourByteTag('p', 't', 'h', ' ')
 #define PICT_REGION_TAG     SkSetFourByteTag('r', 'g', 'n', ' ')
 
-#include "SkStream.h"
-
 static void writeTagSize(SkFlattenableWriteBuffer& buffer, uint32_t tag,
                          uint32_t size) {
     buffer.write32(tag);
@@ -281,6 +302,13 @@ static void writeFactories(SkWStream* stream, const SkFactorySet& rec) {
     rec.copyToArray(array);
 
     for (int i = 0; i < count; i++) {
+        // built-ins are written by their ID; anything else is an ID of 0,
+        // followed by its name
+        uint32_t id = SkFlattenable::FactoryToID(array[i]);
+        stream->writePackedUInt(id);
+        if (id) {
+            continue;
+        }
         const char* name = SkFlattenable::FactoryToName(array[i]);
 //        SkDebugf("---- write factories [%d] %p <%s>\n", i, array[i], name);
         if (NULL == name || 0 == *name) {
@@ -354,8 +382,20 @@ void SkPicturePlayback::serialize(SkWStream* stream) const {
 
     // now we can write to the stream again
 
-    writeFactories(stream, factSet);
-    writeTypefaces(stream, typefaceSet);
+    // the factories and typefaces are padded to a multiple of 4 bytes, so that
+    // what follows them stays aligned
+    {
+        SkDynamicMemoryWStream refs;
+        writeFactories(&refs, factSet);
+        writeTypefaces(&refs, typefaceSet);
+        refs.padToAlign4();
+
+        size_t size = refs.getOffset();
+        SkAutoMalloc storage(size);
+        refs.copyTo(storage.get());
+        stream->write32(size);
+        stream->write(storage.get(), size);
+    }
 
     writeTagSize(stream, PICT_PICTURE_TAG, fPictureCount);
     for (i = 0; i < fPictureCount; i++) {
@@ -384,21 +424,35 @@ static int readTagSize(SkStream* stream, uint32_t expectedTag) {
     return stream->readU32();
 }
 
-SkPicturePlayback::SkPicturePlayback(SkStream* stream) {
-    this->init();
+// Returns the next size bytes of stream. If memory is not NULL (it is then
+// also the stream), they are used where they lie, else they are read into
+// storage.
+static const void* read_chunk(SkStream* stream, SkMemoryStream* memory,
+                              size_t size, SkAutoMalloc* storage) {
+    if (memory) {
+        const void* data = memory->getAtPos();
+        memory->skip(size);
+        return data;
+    }
+    void* data = storage->alloc(size);
+    stream->read(data, size);
+    return data;
+}
 
+void SkPicturePlayback::parseFactoriesAndTypefaces(SkStream* stream,
+                                                   uint32_t version) {
     int i;
 
-    {
-        size_t size = readTagSize(stream, PICT_READER_TAG);
-        void* storage = sk_malloc_throw(size);
-        stream->read(storage, size);
-        fReader.setMemory(storage, size);
-    }
-
     int factoryCount = readTagSize(stream, PICT_FACTORY_TAG);
     fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (factoryCount));
     for (i = 0; i < factoryCount; i++) {
+        if (version > PICTURE_VERSION_FACTORY_NAMES) {
+            uint32_t id = stream->readPackedUInt();
+            if (id) {
+                fFactoryPlayback->base()[i] = SkFlattenable::IDToFactory(id);
+                continue;
+            }
+        }
         SkString str;
         int len = stream->readPackedUInt();
         str.resize(len);
@@ -412,23 +466,55 @@ SkPicturePlayback::SkPicturePlayback(SkStream* stream) {
     for (i = 0; i < typefaceCount; i++) {
         fTFPlayback.set(i, SkTypeface::Deserialize(stream))->unref();
     }
+}
+
+SkPicturePlayback::SkPicturePlayback(SkStream* stream, uint32_t version,
+                                     SkMemoryStream* memory) {
+    this->init();
+
+    int i;
+
+    {
+        size_t size = readTagSize(stream, PICT_READER_TAG);
+        if (memory) {
+            fStream = memory;
+            fStream->ref();
+            fReader.setMemory(read_chunk(stream, memory, size, NULL), size);
+        } else {
+            void* storage = sk_malloc_throw(size);
+            stream->read(storage, size);
+            fReader.setMemory(storage, size);
+        }
+    }
+
+    if (PICTURE_VERSION_UNALIGNED == version) {
+        this->parseFactoriesAndTypefaces(stream, version);
+    } else {
+        size_t size = stream->readU32();
+        SkAutoMalloc storage;
+        SkMemoryStream refs(read_chunk(stream, memory, size, &storage), size);
+        this->parseFactoriesAndTypefaces(&refs, version);
+    }
 
     fPictureCount = readTagSize(stream, PICT_PICTURE_TAG);
     fPictureRefs = SkNEW_ARRAY(SkPicture*, fPictureCount);
     for (i = 0; i < fPictureCount; i++) {
-        fPictureRefs[i] = SkNEW_ARGS(SkPicture, (stream));
+        fPictureRefs[i] = SkNEW(SkPicture);
+        fPictureRefs[i]->parse(stream, memory);
     }
 
     /*
         Now read the arrays chunk, and parse using a read buffer
     */
     uint32_t size = readTagSize(stream, PICT_ARRAYS_TAG);
-    SkAutoMalloc storage(size);
-    stream->read(storage.get(), size);
+    SkAutoMalloc storage;
 
-    SkFlattenableReadBuffer buffer(storage.get(), size);
+    SkFlattenableReadBuffer buffer(read_chunk(stream, memory, size, &storage),
+                                   size);
     fFactoryPlayback->setupBuffer(buffer);
     fTFPlayback.setupBuffer(buffer);
+    // bitmaps can draw straight from memory, since we hold onto it
+    buffer.setSharePixels(NULL != memory);
 
     fBitmapCount = readTagSize(buffer, PICT_BITMAP_TAG);
     fBitmaps = SkNEW_ARRAY(SkBitmap, fBitmapCount);
@@ -460,6 +546,29 @@ SkPicturePlayback::SkPicturePlayback(SkStream* stream) {
         SkDEBUGCODE(uint32_t bytes =) fRegions[i].unflatten(buffer.skip(size));
         SkASSERT(size == bytes);
     }
+
+    this->computeLazyState();
+}
+
+void SkPicturePlayback::computeLazyState() {
+    int i;
+    for (i = 0; i < fMatrixCount; i++) {
+        (void)fMatrices[i].getType();
+    }
+    const int pathCount = fPathHeap ? fPathHeap->count() : 0;
+    for (i = 0; i < pathCount; i++) {
+        const SkPath& path = (*fPathHeap)[i];
+        (void)path.getBounds();
+        (void)path.getConvexity();
+    }
+    for (i = 0; i < fPictureCount; i++) {
+        fPictureRefs[i]->endRecording();
+    }
+    for (i = 0; i < fPaintCount; i++) {
+        if (fPaints[i].getShader() || fPaints[i].getLooper()) {
+            fSerializeDraws = true;
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -491,117 +600,120 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
     SkipClipRec skipRect, skipRegion, skipPath;
 #endif
 
-#ifdef ANDROID
-    SkAutoMutexAcquire autoMutex(fDrawMutex);
-#endif
+    if (fSerializeDraws) {
+        fDrawMutex.acquire();
+    }
+
+    // our own cursor, so other threads can draw from the same data
+    SkReader32 reader(fReader.base(), fReader.size());
+    const int32_t abortCount = fAbortCount;
 
     TextContainer text;
-    fReader.rewind();
 
-    while (!fReader.eof()) {
-        switch (fReader.readInt()) {
+    while (!reader.eof() && abortCount == fAbortCount) {
+        switch (reader.readInt()) {
             case CLIP_PATH: {
-                const SkPath& path = getPath();
-                SkRegion::Op op = (SkRegion::Op) getInt();
-                size_t offsetToRestore = getInt();
+                const SkPath& path = getPath(reader);
+                SkRegion::Op op = (SkRegion::Op) getInt(reader);
+                size_t offsetToRestore = getInt(reader);
                 // HACK (false) until I can handle op==kReplace
                 if (!canvas.clipPath(path, op)) {
 #ifdef SPEW_CLIP_SKIPPING
-                    skipPath.recordSkip(offsetToRestore - fReader.offset());
+                    skipPath.recordSkip(offsetToRestore - reader.offset());
 #endif
-                    fReader.setOffset(offsetToRestore);
+                    reader.setOffset(offsetToRestore);
                 }
             } break;
             case CLIP_REGION: {
-                const SkRegion& region = getRegion();
-                SkRegion::Op op = (SkRegion::Op) getInt();
-                size_t offsetToRestore = getInt();
+                const SkRegion& region = getRegion(reader);
+                SkRegion::Op op = (SkRegion::Op) getInt(reader);
+                size_t offsetToRestore = getInt(reader);
                 if (!canvas.clipRegion(region, op)) {
 #ifdef SPEW_CLIP_SKIPPING
-                    skipRegion.recordSkip(offsetToRestore - fReader.offset());
+                    skipRegion.recordSkip(offsetToRestore - reader.offset());
 #endif
-                    fReader.setOffset(offsetToRestore);
+                    reader.setOffset(offsetToRestore);
                 }
             } break;
             case CLIP_RECT: {
-                const SkRect* rect = fReader.skipRect();
-                SkRegion::Op op = (SkRegion::Op) getInt();
-                size_t offsetToRestore = getInt();
+                const SkRect* rect = reader.skipRect();
+                SkRegion::Op op = (SkRegion::Op) getInt(reader);
+                size_t offsetToRestore = getInt(reader);
                 if (!canvas.clipRect(*rect, op)) {
 #ifdef SPEW_CLIP_SKIPPING
-                    skipRect.recordSkip(offsetToRestore - fReader.offset());
+                    skipRect.recordSkip(offsetToRestore - reader.offset());
 #endif
-                    fReader.setOffset(offsetToRestore);
+                    reader.setOffset(offsetToRestore);
                 }
             } break;
             case CONCAT:
-                canvas.concat(*getMatrix());
+                canvas.concat(*getMatrix(reader));
                 break;
             case DRAW_BITMAP: {
-                const SkPaint* paint = getPaint();
-                const SkBitmap& bitmap = getBitmap();
-                const SkPoint* loc = fReader.skipPoint();
+                const SkPaint* paint = getPaint(reader);
+                SkBitmap bitmap(getBitmap(reader));
+                const SkPoint* loc = reader.skipPoint();
                 canvas.drawBitmap(bitmap, loc->fX, loc->fY, paint);
             } break;
             case DRAW_BITMAP_RECT: {
-                const SkPaint* paint = getPaint();
-                const SkBitmap& bitmap = getBitmap();
-                const SkIRect* src = this->getIRectPtr();   // may be null
-                const SkRect* dst = fReader.skipRect();     // required
+                const SkPaint* paint = getPaint(reader);
+                SkBitmap bitmap(getBitmap(reader));
+                const SkIRect* src = this->getIRectPtr(reader); // may be null
+                const SkRect* dst = reader.skipRect();          // required
                 canvas.drawBitmapRect(bitmap, src, *dst, paint);
             } break;
             case DRAW_BITMAP_MATRIX: {
-                const SkPaint* paint = getPaint();
-                const SkBitmap& bitmap = getBitmap();
-                const SkMatrix* matrix = getMatrix();
+                const SkPaint* paint = getPaint(reader);
+                SkBitmap bitmap(getBitmap(reader));
+                const SkMatrix* matrix = getMatrix(reader);
                 canvas.drawBitmapMatrix(bitmap, *matrix, paint);
             } break;
             case DRAW_CLEAR:
-                canvas.clear(getInt());
+                canvas.clear(getInt(reader));
                 break;
             case DRAW_DATA: {
-                size_t length = getInt();
-                canvas.drawData(fReader.skip(length), length);
+                size_t length = getInt(reader);
+                canvas.drawData(reader.skip(length), length);
                 // skip handles padding the read out to a multiple of 4
             } break;
             case DRAW_PAINT:
-                canvas.drawPaint(*getPaint());
+                canvas.drawPaint(*getPaint(reader));
                 break;
             case DRAW_PATH: {
-                const SkPaint& paint = *getPaint();
-                canvas.drawPath(getPath(), paint);
+                const SkPaint& paint = *getPaint(reader);
+                canvas.drawPath(getPath(reader), paint);
             } break;
             case DRAW_PICTURE:
-                canvas.drawPicture(getPicture());
+                canvas.drawPicture(getPicture(reader));
                 break;
             case DRAW_POINTS: {
-                const SkPaint& paint = *getPaint();
-                SkCanvas::PointMode mode = (SkCanvas::PointMode)getInt();
-                size_t count = getInt();
-                const SkPoint* pts = (const SkPoint*)fReader.skip(sizeof(SkPoint) * count);
+                const SkPaint& paint = *getPaint(reader);
+                SkCanvas::PointMode mode = (SkCanvas::PointMode)getInt(reader);
+                size_t count = getInt(reader);
+                const SkPoint* pts = (const SkPoint*)reader.skip(sizeof(SkPoint) * count);
                 canvas.drawPoints(mode, count, pts, paint);
             } break;
             case DRAW_POS_TEXT: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                size_t points = getInt();
-                const SkPoint* pos = (const SkPoint*)fReader.skip(points * sizeof(SkPoint));
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                size_t points = getInt(reader);
+                const SkPoint* pos = (const SkPoint*)reader.skip(points * sizeof(SkPoint));
                 canvas.drawPosText(text.text(), text.length(), pos, paint);
             } break;
             case DRAW_POS_TEXT_H: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                size_t xCount = getInt();
-                const SkScalar constY = getScalar();
-                const SkScalar* xpos = (const SkScalar*)fReader.skip(xCount * sizeof(SkScalar));
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                size_t xCount = getInt(reader);
+                const SkScalar constY = getScalar(reader);
+                const SkScalar* xpos = (const SkScalar*)reader.skip(xCount * sizeof(SkScalar));
                 canvas.drawPosTextH(text.text(), text.length(), xpos, constY,
                                     paint);
             } break;
             case DRAW_POS_TEXT_H_TOP_BOTTOM: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                size_t xCount = getInt();
-                const SkScalar* xpos = (const SkScalar*)fReader.skip((3 + xCount) * sizeof(SkScalar));
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                size_t xCount = getInt(reader);
+                const SkScalar* xpos = (const SkScalar*)reader.skip((3 + xCount) * sizeof(SkScalar));
                 const SkScalar top = *xpos++;
                 const SkScalar bottom = *xpos++;
                 const SkScalar constY = *xpos++;
@@ -611,27 +723,27 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                 }
             } break;
             case DRAW_RECT: {
-                const SkPaint& paint = *getPaint();
-                canvas.drawRect(*fReader.skipRect(), paint);
+                const SkPaint& paint = *getPaint(reader);
+                canvas.drawRect(*reader.skipRect(), paint);
             } break;
             case DRAW_SPRITE: {
-                const SkPaint* paint = getPaint();
-                const SkBitmap& bitmap = getBitmap();
-                int left = getInt();
-                int top = getInt();
+                const SkPaint* paint = getPaint(reader);
+                SkBitmap bitmap(getBitmap(reader));
+                int left = getInt(reader);
+                int top = getInt(reader);
                 canvas.drawSprite(bitmap, left, top, paint);
             } break;
             case DRAW_TEXT: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                SkScalar x = getScalar();
-                SkScalar y = getScalar();
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                SkScalar x = getScalar(reader);
+                SkScalar y = getScalar(reader);
                 canvas.drawText(text.text(), text.length(), x, y, paint);
             } break;
             case DRAW_TEXT_TOP_BOTTOM: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                const SkScalar* ptr = (const SkScalar*)fReader.skip(4 * sizeof(SkScalar));
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                const SkScalar* ptr = (const SkScalar*)reader.skip(4 * sizeof(SkScalar));
                 // ptr[0] == x
                 // ptr[1] == y
                 // ptr[2] == top
@@ -643,35 +755,35 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                 }
             } break;
             case DRAW_TEXT_ON_PATH: {
-                const SkPaint& paint = *getPaint();
-                getText(&text);
-                const SkPath& path = getPath();
-                const SkMatrix* matrix = getMatrix();
+                const SkPaint& paint = *getPaint(reader);
+                getText(reader, &text);
+                const SkPath& path = getPath(reader);
+                const SkMatrix* matrix = getMatrix(reader);
                 canvas.drawTextOnPath(text.text(), text.length(), path,
                                       matrix, paint);
             } break;
             case DRAW_VERTICES: {
-                const SkPaint& paint = *getPaint();
-                DrawVertexFlags flags = (DrawVertexFlags)getInt();
-                SkCanvas::VertexMode vmode = (SkCanvas::VertexMode)getInt();
-                int vCount = getInt();
-                const SkPoint* verts = (const SkPoint*)fReader.skip(
+                const SkPaint& paint = *getPaint(reader);
+                DrawVertexFlags flags = (DrawVertexFlags)getInt(reader);
+                SkCanvas::VertexMode vmode = (SkCanvas::VertexMode)getInt(reader);
+                int vCount = getInt(reader);
+                const SkPoint* verts = (const SkPoint*)reader.skip(
                                                     vCount * sizeof(SkPoint));
                 const SkPoint* texs = NULL;
                 const SkColor* colors = NULL;
                 const uint16_t* indices = NULL;
                 int iCount = 0;
                 if (flags & DRAW_VERTICES_HAS_TEXS) {
-                    texs = (const SkPoint*)fReader.skip(
+                    texs = (const SkPoint*)reader.skip(
                                                     vCount * sizeof(SkPoint));
                 }
                 if (flags & DRAW_VERTICES_HAS_COLORS) {
-                    colors = (const SkColor*)fReader.skip(
+                    colors = (const SkColor*)reader.skip(
                                                     vCount * sizeof(SkColor));
                 }
                 if (flags & DRAW_VERTICES_HAS_INDICES) {
-                    iCount = getInt();
-                    indices = (const uint16_t*)fReader.skip(
+                    iCount = getInt(reader);
+                    indices = (const uint16_t*)reader.skip(
                                                     iCount * sizeof(uint16_t));
                 }
                 canvas.drawVertices(vmode, vCount, verts, texs, colors, NULL,
@@ -681,32 +793,32 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                 canvas.restore();
                 break;
             case ROTATE:
-                canvas.rotate(getScalar());
+                canvas.rotate(getScalar(reader));
                 break;
             case SAVE:
-                canvas.save((SkCanvas::SaveFlags) getInt());
+                canvas.save((SkCanvas::SaveFlags) getInt(reader));
                 break;
             case SAVE_LAYER: {
-                const SkRect* boundsPtr = getRectPtr();
-                const SkPaint* paint = getPaint();
-                canvas.saveLayer(boundsPtr, paint, (SkCanvas::SaveFlags) getInt());
+                const SkRect* boundsPtr = getRectPtr(reader);
+                const SkPaint* paint = getPaint(reader);
+                canvas.saveLayer(boundsPtr, paint, (SkCanvas::SaveFlags) getInt(reader));
                 } break;
             case SCALE: {
-                SkScalar sx = getScalar();
-                SkScalar sy = getScalar();
+                SkScalar sx = getScalar(reader);
+                SkScalar sy = getScalar(reader);
                 canvas.scale(sx, sy);
             } break;
             case SET_MATRIX:
-                canvas.setMatrix(*getMatrix());
+                canvas.setMatrix(*getMatrix(reader));
                 break;
             case SKEW: {
-                SkScalar sx = getScalar();
-                SkScalar sy = getScalar();
+                SkScalar sx = getScalar(reader);
+                SkScalar sy = getScalar(reader);
                 canvas.skew(sx, sy);
             } break;
             case TRANSLATE: {
-                SkScalar dx = getScalar();
-                SkScalar dy = getScalar();
+                SkScalar dx = getScalar(reader);
+                SkScalar dy = getScalar(reader);
                 canvas.translate(dx, dy);
             } break;
             default:
@@ -718,15 +830,19 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
     {
         size_t size =  skipRect.fSize + skipPath.fSize + skipRegion.fSize;
         SkDebugf("--- Clip skips %d%% rect:%d path:%d rgn:%d\n",
-             size * 100 / fReader.offset(), skipRect.fCount, skipPath.fCount,
+             size * 100 / reader.offset(), skipRect.fCount, skipPath.fCount,
              skipRegion.fCount);
     }
 #endif
 //    this->dumpSize();
+
+    if (fSerializeDraws) {
+        fDrawMutex.release();
+    }
 }
 
 void SkPicturePlayback::abort() {
-    fReader.skip(fReader.size() - fReader.offset());
+    sk_atomic_inc(const_cast<int32_t*>(&fAbortCount));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1068,7 +1184,7 @@ int SkPicturePlayback::dumpDrawType(char* bufferPtr, char* buffer, DrawType draw
 
 int SkPicturePlayback::dumpInt(char* bufferPtr, char* buffer, char* name) {
     return snprintf(bufferPtr, DUMP_BUFFER_SIZE - (bufferPtr - buffer),
-        "%s:%d, ", name, getInt());
+        "%s:%d, ", name, getInt(fReader));
 }
 
 int SkPicturePlayback::dumpRect(char* bufferPtr, char* buffer, char* name) {
@@ -1119,12 +1235,12 @@ int SkPicturePlayback::dumpRectPtr(char* bufferPtr, char* buffer, char* name) {
 
 int SkPicturePlayback::dumpScalar(char* bufferPtr, char* buffer, char* name) {
     return snprintf(bufferPtr, DUMP_BUFFER_SIZE - (bufferPtr - buffer),
-        "%s:%d, ", name, getScalar());
+        "%s:%d, ", name, getScalar(fReader));
 }
 
 void SkPicturePlayback::dumpText(char** bufferPtrPtr, char* buffer) {
     char* bufferPtr = *bufferPtrPtr;
-    int length = getInt();
+    int length = getInt(fReader);
     bufferPtr += dumpDrawType(bufferPtr, buffer);
     fReadStream.skipToAlign4();
     char* text = (char*) fReadStream.getAtPos();
@@ -1183,12 +1299,12 @@ void SkPicturePlayback::dumpStream() {
         DUMP_DRAWTYPE(drawType);
         switch (drawType) {
             case CLIP_PATH: {
-                DUMP_PTR(SkPath, &getPath());
+                DUMP_PTR(SkPath, &getPath(fReader));
                 DUMP_INT(SkRegion::Op);
                 DUMP_INT(offsetToRestore);
                 } break;
             case CLIP_REGION: {
-                DUMP_PTR(SkRegion, &getRegion());
+                DUMP_PTR(SkRegion, &getRegion(fReader));
                 DUMP_INT(SkRegion::Op);
                 DUMP_INT(offsetToRestore);
             } break;
@@ -1198,42 +1314,42 @@ void SkPicturePlayback::dumpStream() {
                 DUMP_INT(offsetToRestore);
                 } break;
             case CONCAT:
-                DUMP_PTR(SkMatrix, getMatrix());
+                DUMP_PTR(SkMatrix, getMatrix(fReader));
                 break;
             case DRAW_BITMAP: {
-                DUMP_PTR(SkPaint, getPaint());
-                DUMP_PTR(SkBitmap, &getBitmap());
+                DUMP_PTR(SkPaint, getPaint(fReader));
+                DUMP_PTR(SkBitmap, &getBitmap(fReader));
                 DUMP_SCALAR(left);
                 DUMP_SCALAR(top);
                 } break;
             case DRAW_PAINT:
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 break;
             case DRAW_PATH: {
-                DUMP_PTR(SkPaint, getPaint());
-                DUMP_PTR(SkPath, &getPath());
+                DUMP_PTR(SkPaint, getPaint(fReader));
+                DUMP_PTR(SkPath, &getPath(fReader));
                 } break;
             case DRAW_PICTURE: {
-                DUMP_PTR(SkPicture, &getPicture());
+                DUMP_PTR(SkPicture, &getPicture(fReader));
                 } break;
             case DRAW_POINTS: {
-                DUMP_PTR(SkPaint, getPaint());
-                (void)getInt(); // PointMode
-                size_t count = getInt();
+                DUMP_PTR(SkPaint, getPaint(fReader));
+                (void)getInt(fReader); // PointMode
+                size_t count = getInt(fReader);
                 fReadStream.skipToAlign4();
                 DUMP_POINT_ARRAY(count);
                 } break;
             case DRAW_POS_TEXT: {
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_TEXT();
-                size_t points = getInt();
+                size_t points = getInt(fReader);
                 fReadStream.skipToAlign4();
                 DUMP_POINT_ARRAY(points);
                 } break;
             case DRAW_POS_TEXT_H: {
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_TEXT();
-                size_t points = getInt();
+                size_t points = getInt(fReader);
                 fReadStream.skipToAlign4();
                 DUMP_SCALAR(top);
                 DUMP_SCALAR(bottom);
@@ -1241,26 +1357,26 @@ void SkPicturePlayback::dumpStream() {
                 DUMP_POINT_ARRAY(points);
                 } break;
             case DRAW_RECT: {
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_RECT(rect);
                 } break;
             case DRAW_SPRITE: {
-                DUMP_PTR(SkPaint, getPaint());
-                DUMP_PTR(SkBitmap, &getBitmap());
+                DUMP_PTR(SkPaint, getPaint(fReader));
+                DUMP_PTR(SkBitmap, &getBitmap(fReader));
                 DUMP_SCALAR(left);
                 DUMP_SCALAR(top);
                 } break;
             case DRAW_TEXT: {
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_TEXT();
                 DUMP_SCALAR(x);
                 DUMP_SCALAR(y);
                 } break;
             case DRAW_TEXT_ON_PATH: {
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_TEXT();
-                DUMP_PTR(SkPath, &getPath());
-                DUMP_PTR(SkMatrix, getMatrix());
+                DUMP_PTR(SkPath, &getPath(fReader));
+                DUMP_PTR(SkMatrix, getMatrix(fReader));
                 } break;
             case RESTORE:
                 break;
@@ -1272,7 +1388,7 @@ void SkPicturePlayback::dumpStream() {
                 break;
             case SAVE_LAYER: {
                 DUMP_RECT_PTR(layer);
-                DUMP_PTR(SkPaint, getPaint());
+                DUMP_PTR(SkPaint, getPaint(fReader));
                 DUMP_INT(SkCanvas::SaveFlags);
                 } break;
             case SCALE: {
@@ -11,24 +11,38 @@
 #include "SkPathHeap.h"
 #include "SkRegion.h"
 #include "SkPictureFlat.h"
-
-#ifdef ANDROID
 #include "SkThread.h"
-#endif
 
+class SkMemoryStream;
 class SkPictureRecord;
 class SkStream;
 class SkWStream;
 
+// Version 1 of the picture format wrote a 1-byte flag in the picture's header,
+// so nothing after it was 4-byte aligned. Version 2 keeps every chunk aligned
+// (and a multiple of 4 bytes long), so a picture in memory can be played where
+// it lies. Version 3 writes built-in factories by their ID, not their name.
+#define PICTURE_VERSION_UNALIGNED       1
+#define PICTURE_VERSION_FACTORY_NAMES   2
+#define PICTURE_VERSION                 3
+
 class SkPicturePlayback {
 public:
     SkPicturePlayback();
     SkPicturePlayback(const SkPicturePlayback& src);
     explicit SkPicturePlayback(const SkPictureRecord& record);
-    explicit SkPicturePlayback(SkStream*);
+    /** Reads a playback of the given picture format version. If memory is
+        not NULL (it is then also the stream being read), the ops and the
+        bitmaps' pixels are used in place, and memory is reffed to keep them.
+    */
+    SkPicturePlayback(SkStream*, uint32_t version, SkMemoryStream* memory);
 
     virtual ~SkPicturePlayback();
 
+    /** Replays the recorded drawing onto canvas. Each call reads the recorded
+        data through its own cursor and never modifies it, so several threads
+        may draw the same playback at once (into different canvases).
+    */
     void draw(SkCanvas& canvas);
 
     void serialize(SkWStream*) const;
@@ -36,9 +50,18 @@ public:
     void dumpSize() const;
     
     // Can be called in the middle of playback (the draw() call). WIll abort the
-    // drawing and return from draw() after the "current" op code is done
+    // drawing and return from draw() after the "current" op code is done. If
+    // several threads are drawing, all of their draw() calls are aborted.
     void abort();
 
+    // see SkPicture::getRecordedOpCount()
+    int recordedOpCount(int* removedCount) const {
+        if (removedCount) {
+            *removedCount = fRemovedOpCount;
+        }
+        return fRecordedOpCount;
+    }
+
 private:
 
     class TextContainer {
@@ -49,17 +72,19 @@ private:
         const char* fText;
     };
 
-    const SkBitmap& getBitmap() {
-        int index = getInt();
+    // Locking a bitmap's pixels writes to it, so draw() only locks copies of
+    // our bitmaps (which share their pixels).
+    const SkBitmap& getBitmap(SkReader32& reader) {
+        int index = getInt(reader);
         SkASSERT(index > 0);
         return fBitmaps[index - 1];
     }
 
-    int getIndex() { return fReader.readInt(); }
-    int getInt() { return fReader.readInt(); }
+    int getIndex(SkReader32& reader) { return reader.readInt(); }
+    int getInt(SkReader32& reader) { return reader.readInt(); }
 
-    const SkMatrix* getMatrix() {
-        int index = getInt();
+    const SkMatrix* getMatrix(SkReader32& reader) {
+        int index = getInt(reader);
         if (index == 0) {
             return NULL;
         }
@@ -67,18 +92,18 @@ private:
         return &fMatrices[index - 1];
     }
 
-    const SkPath& getPath() {
-        return (*fPathHeap)[getInt() - 1];
+    const SkPath& getPath(SkReader32& reader) {
+        return (*fPathHeap)[getInt(reader) - 1];
     }
 
-    SkPicture& getPicture() {
-        int index = getInt();
+    SkPicture& getPicture(SkReader32& reader) {
+        int index = getInt(reader);
         SkASSERT(index > 0 && index <= fPictureCount);
         return *fPictureRefs[index - 1];
     }
     
-    const SkPaint* getPaint() {
-        int index = getInt();
+    const SkPaint* getPaint(SkReader32& reader) {
+        int index = getInt(reader);
         if (index == 0) {
             return NULL;
         }
@@ -86,36 +111,42 @@ private:
         return &fPaints[index - 1];
     }
 
-    const SkRect* getRectPtr() {
-        if (fReader.readBool()) {
-            return fReader.skipRect();
+    const SkRect* getRectPtr(SkReader32& reader) {
+        if (reader.readBool()) {
+            return reader.skipRect();
         } else {
             return NULL;
         }
     }
 
-    const SkIRect* getIRectPtr() {
-        if (fReader.readBool()) {
-            return (const SkIRect*)fReader.skip(sizeof(SkIRect));
+    const SkIRect* getIRectPtr(SkReader32& reader) {
+        if (reader.readBool()) {
+            return (const SkIRect*)reader.skip(sizeof(SkIRect));
         } else {
             return NULL;
         }
     }
 
-    const SkRegion& getRegion() {
-        int index = getInt();
+    const SkRegion& getRegion(SkReader32& reader) {
+        int index = getInt(reader);
         SkASSERT(index > 0);
         return fRegions[index - 1];
     }
 
-    SkScalar getScalar() { return fReader.readScalar(); }
+    SkScalar getScalar(SkReader32& reader) { return reader.readScalar(); }
 
-    void getText(TextContainer* text) {
-        size_t length = text->fByteLength = getInt();
-        text->fText = (const char*)fReader.skip(length);
+    void getText(SkReader32& reader, TextContainer* text) {
+        size_t length = text->fByteLength = getInt(reader);
+        text->fText = (const char*)reader.skip(length);
     }
 
     void init();
+    void parseFactoriesAndTypefaces(SkStream*, uint32_t version);
+
+    // Matrices and paths compute (and cache) some of their state when first
+    // asked for it. We ask for it up front, so that draw() only reads them.
+    // Also sets fSerializeDraws.
+    void computeLazyState();
 
 #ifdef SK_DEBUG_SIZE
 public:
@@ -159,7 +190,22 @@ private:
     int fPaintCount;
     SkRegion* fRegions;
     int fRegionCount;
+    // the recorded ops; draw() only reads them through its own SkReader32
     mutable SkFlattenableReadBuffer fReader;
+    // if not NULL, fReader (and our bitmaps' pixels) point into its memory
+    SkMemoryStream* fStream;
+    // copied from the SkPictureRecord we were made from
+    int fRecordedOpCount;
+    int fRemovedOpCount;
+    // bumped by abort(), so that each draw() in progress can notice. draw()
+    // only compares it against the value it started with, so it needs no
+    // ordering with our other fields: volatile just forces a fresh load per
+    // op, and a draw that sees the bump one op late is still aborted.
+    volatile int32_t fAbortCount;
+    // shaders and draw loopers keep per-draw state in themselves, so if any of
+    // our paints have one, we only draw on one thread at a time
+    bool fSerializeDraws;
+    SkMutex fDrawMutex;
 
     SkPicture** fPictureRefs;
     int fPictureCount;
@@ -167,9 +213,6 @@ private:
     SkRefCntPlayback fRCPlayback;
     SkTypefacePlayback fTFPlayback;
     SkFactoryPlayback*   fFactoryPlayback;
-#ifdef ANDROID
-    SkMutex fDrawMutex;
-#endif
 };
 
 #endif
@@ -1,5 +1,4 @@
 #include "SkPictureRecord.h"
-#include "SkTSearch.h"
 
 #define MIN_WRITER_SIZE 16384
 #define HEAP_BLOCK_SIZE 4096
@@ -16,6 +15,9 @@ SkPictureRecord::SkPictureRecord(uint32_t flags) :
     fRestoreOffsetStack.push(0);
 
     fPathHeap = NULL;   // lazy allocate
+
+    fOptimize = SkToBool(flags & SkPicture::kOptimizeOps_RecordingFlag);
+    this->resetOptimizer();
 }
 
 SkPictureRecord::~SkPictureRecord() {
@@ -24,7 +26,228 @@ SkPictureRecord::~SkPictureRecord() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static bool is_draw(DrawType type) {
+    return type >= DRAW_BITMAP && type <= DRAW_VERTICES;
+}
+
+static bool is_matrix_op(DrawType type) {
+    switch (type) {
+        case CONCAT:
+        case ROTATE:
+        case SCALE:
+        case SET_MATRIX:
+        case SKEW:
+        case TRANSLATE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// the draws that record an SkPaint (rather than an optional one) right after
+// their DrawType
+static bool has_paint(DrawType type) {
+    switch (type) {
+        case DRAW_PAINT:
+        case DRAW_PATH:
+        case DRAW_POINTS:
+        case DRAW_POS_TEXT:
+        case DRAW_POS_TEXT_H:
+        case DRAW_POS_TEXT_H_TOP_BOTTOM:
+        case DRAW_RECT:
+        case DRAW_TEXT:
+        case DRAW_TEXT_ON_PATH:
+        case DRAW_TEXT_TOP_BOTTOM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool has_no_effects(const SkPaint& paint) {
+    return NULL == paint.getShader() && NULL == paint.getXfermode() &&
+           NULL == paint.getColorFilter() && NULL == paint.getMaskFilter() &&
+           NULL == paint.getLooper() && NULL == paint.getRasterizer();
+}
+
+// Drawing with this paint into a transparent layer, and then drawing the layer
+// at full alpha, gives exactly what drawing directly does. (Folding any other
+// alpha into the paint would change the rounding of each blend.)
+static bool is_opaque(const SkPaint& paint) {
+    return 0xFF == paint.getAlpha() && !paint.isLCDRenderText() &&
+           has_no_effects(paint);
+}
+
+// a layer that is drawn back as src-over, so that if nothing was drawn into
+// it, it changes nothing
+static bool is_plain_layer(const SkPaint* paint, SkCanvas::SaveFlags flags) {
+    return (flags & SkCanvas::kHasAlphaLayer_SaveFlag) &&
+           (NULL == paint || has_no_effects(*paint));
+}
+
+// Filling two rects that share an edge draws their union, as long as nothing
+// blends the shared edge twice (antialiasing) or looks at the shape.
+static bool can_merge_rects(const SkPaint& paint) {
+    return SkPaint::kFill_Style == paint.getStyle() && !paint.isAntiAlias() &&
+           NULL == paint.getPathEffect() && NULL == paint.getMaskFilter() &&
+           NULL == paint.getLooper() && NULL == paint.getRasterizer();
+}
+
+static bool rects_abut(const SkRect& a, const SkRect& b) {
+    if (a.fTop == b.fTop && a.fBottom == b.fBottom) {
+        return a.fRight == b.fLeft || b.fRight == a.fLeft;
+    }
+    if (a.fLeft == b.fLeft && a.fRight == b.fRight) {
+        return a.fBottom == b.fTop || b.fBottom == a.fTop;
+    }
+    return false;
+}
+
+void SkPictureRecord::resetOptimizer() {
+    // the top level, which is never restored
+    fSaveStack.setCount(1);
+    sk_bzero(fSaveStack.begin(), sizeof(SaveRec));
+
+    fOpCount = fRemovedOpCount = 0;
+    fLastOpType = UNUSED;
+    fMatrixTailCount = 0;
+    fLastClipRectValid = false;
+    fLastPaintIsOpaque = false;
+}
+
+SkPictureRecord::SaveRec* SkPictureRecord::pushSaveRec(SaveFlags flags) {
+    SaveRec* rec = fSaveStack.append();
+    rec->fOffset = fWriter.size();
+    rec->fOpCount = fOpCount;
+    rec->fDrawCount = 0;
+    rec->fFlags = flags;
+    rec->fIsLayer = rec->fIsPlainLayer = rec->fIsNoOpLayer = false;
+    return rec;
+}
+
+// Returns true (and counts the op as removed) if we are optimizing, and the op
+// being recorded is a no-op.
+bool SkPictureRecord::dropNoOp(bool isNoOp) {
+    if (fOptimize && isNoOp) {
+        fRemovedOpCount += 1;
+        return true;
+    }
+    return false;
+}
+
+void SkPictureRecord::addDraw(DrawType drawType) {
+#ifdef SK_DEBUG_TRACE
+    SkDebugf("add %s\n", DrawTypeToString(drawType));
+#endif
+    if (!is_matrix_op(drawType)) {
+        fMatrixTailCount = 0;
+    } else if (0 == fMatrixTailCount++) {
+        fMatrixTailOffset = fWriter.size();
+    }
+    if (is_draw(drawType)) {
+        fSaveStack.top().fDrawCount += 1;
+    } else {
+        fLastClipRectValid = false;
+    }
+
+    fLastOpOffset = fWriter.size();
+    fLastOpType = drawType;
+    fOpCount += 1;
+    fWriter.writeInt(drawType);
+}
+
+// Drops the ops written since offset, at which point opCount ops had been.
+void SkPictureRecord::rewindToOffset(uint32_t offset, int opCount) {
+    fWriter.rewindToOffset(offset);
+    fRemovedOpCount += fOpCount - opCount;
+    fOpCount = opCount;
+
+    fLastOpType = UNUSED;
+    fMatrixTailCount = 0;
+    fLastClipRectValid = false;
+}
+
+// Matrix ops followed by a setMatrix, or by the restore of a save that saved
+// the matrix, cannot affect any drawing.
+bool SkPictureRecord::removeMatrixTail() {
+    if (!fOptimize || 0 == fMatrixTailCount) {
+        return false;
+    }
+    this->rewindToOffset(fMatrixTailOffset, fOpCount - fMatrixTailCount);
+    return true;
+}
+
+// Called by restore() with the popped rec. Returns true if the whole block,
+// restore included, could be removed (or folded into its single draw).
+bool SkPictureRecord::removeSaveBlock(const SaveRec& rec) {
+    if (!fOptimize) {
+        return false;
+    }
+    if (rec.fFlags & kMatrix_SaveFlag) {
+        this->removeMatrixTail();
+    }
+
+    if (0 == rec.fDrawCount) {
+        // a block that draws nothing changes nothing, unless its state changes
+        // outlive it
+        bool onlySave = fOpCount == rec.fOpCount + 1;
+        bool savedAll = kMatrixClip_SaveFlag ==
+                        (rec.fFlags & kMatrixClip_SaveFlag);
+        if ((onlySave || savedAll) && (!rec.fIsLayer || rec.fIsPlainLayer)) {
+            this->rewindToOffset(rec.fOffset, rec.fOpCount);
+            fRemovedOpCount += 1;   // the restore
+            return true;
+        }
+        return false;
+    }
+
+    if (rec.fIsNoOpLayer && fOpCount == rec.fOpCount + 2 &&
+            has_paint(fLastOpType) && fLastPaintIsOpaque) {
+        // move the draw down over the saveLayer
+        DrawType type = fLastOpType;
+        uint32_t size = fWriter.size() - fLastOpOffset;
+        SkAutoSTMalloc<32, uint32_t> storage(size >> 2);
+        uint32_t* op = storage.get();
+        for (uint32_t i = 0; i < size; i += 4) {
+            *op++ = *fWriter.peek32(fLastOpOffset + i);
+        }
+        this->rewindToOffset(rec.fOffset, rec.fOpCount);
+        fWriter.write(storage.get(), size);
+        fLastOpOffset = rec.fOffset;
+        fLastOpType = type;
+        // the draw is back, and the restore is gone
+        fOpCount += 1;
+        return true;
+    }
+    return false;
+}
+
+// If the last op drew a rect with the same paint, that abuts this one, grow it
+// to include this one. Only while the matrix keeps rects rects: otherwise the
+// union's edges are scan converted from other endpoints than the two rects'.
+bool SkPictureRecord::mergeDrawRect(const SkRect& rect, const SkPaint& paint) {
+    if (!fOptimize || DRAW_RECT != fLastOpType || rect.isEmpty() ||
+            !can_merge_rects(paint) || !this->getTotalMatrix().rectStaysRect()) {
+        return false;
+    }
+    uint32_t index = (uint32_t)find(fPaints, &paint);
+    if (index != *fWriter.peek32(fLastOpOffset + 4)) {
+        return false;
+    }
+    // the rect was reserved all at once, so is contiguous in the writer
+    SkRect* last = (SkRect*)fWriter.peek32(fLastOpOffset + 8);
+    if (last->isEmpty() || !rects_abut(*last, rect)) {
+        return false;
+    }
+    last->join(rect);
+    fRemovedOpCount += 1;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int SkPictureRecord::save(SaveFlags flags) {
+    this->pushSaveRec(flags);
     addDraw(SAVE);
     addInt(flags);
 
@@ -36,6 +259,12 @@ int SkPictureRecord::save(SaveFlags flags) {
 
 int SkPictureRecord::saveLayer(const SkRect* bounds, const SkPaint* paint,
                                SaveFlags flags) {
+    SaveRec* rec = this->pushSaveRec(flags);
+    rec->fIsLayer = true;
+    rec->fIsPlainLayer = is_plain_layer(paint, flags);
+    rec->fIsNoOpLayer = rec->fIsPlainLayer && NULL == bounds &&
+                        (NULL == paint || 0xFF == paint->getAlpha());
+
     addDraw(SAVE_LAYER);
     addRectPtr(bounds);
     addPaintPtr(paint);
@@ -59,6 +288,18 @@ void SkPictureRecord::restore() {
         return;
     }
 
+    if (fSaveStack.count() > 1) {
+        SaveRec rec;
+        fSaveStack.pop(&rec);
+        fSaveStack.top().fDrawCount += rec.fDrawCount;
+        if (this->removeSaveBlock(rec)) {
+            // there is no restore to patch the clip offsets to
+            fRestoreOffsetStack.pop();
+            validate();
+            return this->INHERITED::restore();
+        }
+    }
+
     // patch up the clip offsets
     uint32_t restoreOffset = (uint32_t)fWriter.size();
     uint32_t offset = fRestoreOffsetStack.top();
@@ -75,46 +316,57 @@ void SkPictureRecord::restore() {
 }
 
 bool SkPictureRecord::translate(SkScalar dx, SkScalar dy) {
-    addDraw(TRANSLATE);
-    addScalar(dx);
-    addScalar(dy);
+    if (!this->dropNoOp(0 == dx && 0 == dy)) {
+        addDraw(TRANSLATE);
+        addScalar(dx);
+        addScalar(dy);
+    }
     validate();
     return this->INHERITED::translate(dx, dy);
 }
 
 bool SkPictureRecord::scale(SkScalar sx, SkScalar sy) {
-    addDraw(SCALE);
-    addScalar(sx);
-    addScalar(sy);
+    if (!this->dropNoOp(SK_Scalar1 == sx && SK_Scalar1 == sy)) {
+        addDraw(SCALE);
+        addScalar(sx);
+        addScalar(sy);
+    }
     validate();
     return this->INHERITED::scale(sx, sy);
 }
 
 bool SkPictureRecord::rotate(SkScalar degrees) {
-    addDraw(ROTATE);
-    addScalar(degrees);
+    if (!this->dropNoOp(0 == degrees)) {
+        addDraw(ROTATE);
+        addScalar(degrees);
+    }
     validate();
     return this->INHERITED::rotate(degrees);
 }
 
 bool SkPictureRecord::skew(SkScalar sx, SkScalar sy) {
-    addDraw(SKEW);
-    addScalar(sx);
-    addScalar(sy);
+    if (!this->dropNoOp(0 == sx && 0 == sy)) {
+        addDraw(SKEW);
+        addScalar(sx);
+        addScalar(sy);
+    }
     validate();
     return this->INHERITED::skew(sx, sy);
 }
 
 bool SkPictureRecord::concat(const SkMatrix& matrix) {
     validate();
-    addDraw(CONCAT);
-    addMatrix(matrix);
+    if (!this->dropNoOp(matrix.isIdentity())) {
+        addDraw(CONCAT);
+        addMatrix(matrix);
+    }
     validate();
     return this->INHERITED::concat(matrix);
 }
 
 void SkPictureRecord::setMatrix(const SkMatrix& matrix) {
     validate();
+    this->removeMatrixTail();
     addDraw(SET_MATRIX);
     addMatrix(matrix);
     validate();
@@ -122,13 +374,21 @@ void SkPictureRecord::setMatrix(const SkMatrix& matrix) {
 }
 
 bool SkPictureRecord::clipRect(const SkRect& rect, SkRegion::Op op) {
-    addDraw(CLIP_RECT);
-    addRect(rect);
-    addInt(op);
-
-    size_t offset = fWriter.size();
-    addInt(fRestoreOffsetStack.top());
-    fRestoreOffsetStack.top() = offset;
+    bool intersect = SkRegion::kIntersect_Op == op;
+    // a rect that contains the one we last clipped to cannot shrink the clip
+    if (!this->dropNoOp(intersect && fLastClipRectValid &&
+                        rect.contains(fLastClipRect))) {
+        addDraw(CLIP_RECT);
+        addRect(rect);
+        addInt(op);
+
+        size_t offset = fWriter.size();
+        addInt(fRestoreOffsetStack.top());
+        fRestoreOffsetStack.top() = offset;
+
+        fLastClipRectValid = intersect;
+        fLastClipRect = rect;
+    }
 
     validate();
     return this->INHERITED::clipRect(rect, op);
@@ -188,12 +448,24 @@ void SkPictureRecord::drawPoints(PointMode mode, size_t count, const SkPoint pts
 }
 
 void SkPictureRecord::drawRect(const SkRect& rect, const SkPaint& paint) {
+    if (this->mergeDrawRect(rect, paint)) {
+        return;
+    }
     addDraw(DRAW_RECT);
     addPaint(paint);
     addRect(rect);
     validate();
 }
 
+// recorded as separate rects, so that playback can still be seen (and
+// aborted) rect by rect
+void SkPictureRecord::drawRects(const SkRect rects[], size_t count,
+                                const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawRect(rects[i], paint);
+    }
+}
+
 void SkPictureRecord::drawPath(const SkPath& path, const SkPaint& paint) {
     addDraw(DRAW_PATH);
     addPaint(paint);
@@ -240,6 +512,13 @@ void SkPictureRecord::drawSprite(const SkBitmap& bitmap, int left, int top,
     validate();
 }
 
+void SkPictureRecord::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                                  size_t count, const SkPaint* paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawSprite(bitmap, pts[i].fX, pts[i].fY, paint);
+    }
+}
+
 void SkPictureRecord::addFontMetricsTopBottom(const SkPaint& paint,
                                               SkScalar baselineY) {
     SkPaint::FontMetrics metrics;
@@ -418,11 +697,16 @@ void SkPictureRecord::reset() {
     fPaints.reset();
     fPictureRefs.unrefAll();
     fRegions.reset();
+    fBitmapTable.reset();
+    fMatrixTable.reset();
+    fPaintTable.reset();
+    fRegionTable.reset();
     fWriter.reset();
     fHeap.reset();
 
     fRestoreOffsetStack.setCount(1);
     fRestoreOffsetStack.top() = 0;
+    this->resetOptimizer();
 
     fRCSet.reset();
     fTFSet.reset();
@@ -445,6 +729,7 @@ void SkPictureRecord::addPaint(const SkPaint& paint) {
 }
 
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
+    fLastPaintIsOpaque = NULL != paint && is_opaque(*paint);
     addInt(find(fPaints, paint));
 }
 
@@ -526,33 +811,33 @@ void SkPictureRecord::addText(const void* text, size_t byteLength) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the index of flat's data, adding flat to the table and array if its
+// data is new, and giving it back to the heap if not.
+template <typename T>
+static int find_flat(SkChunkAlloc* heap, T* flat, SkFlatDataTable* table,
+                     SkTDArray<const T*>* array, int* nextIndex) {
+    flat->computeHash();
+    const SkFlatData* found = table->find(flat);
+    if (found) {
+        (void)heap->unalloc(flat);
+        return found->index();
+    }
+    table->add(flat);
+    *array->append() = flat;
+    return (*nextIndex)++;
+}
+
 int SkPictureRecord::find(SkTDArray<const SkFlatBitmap* >& bitmaps, const SkBitmap& bitmap) {
     SkFlatBitmap* flat = SkFlatBitmap::Flatten(&fHeap, bitmap, fBitmapIndex,
                                                &fRCSet);
-    int index = SkTSearch<SkFlatData>((const SkFlatData**) bitmaps.begin(),
-        bitmaps.count(), (SkFlatData*) flat, sizeof(flat), &SkFlatData::Compare);
-    if (index >= 0) {
-        (void)fHeap.unalloc(flat);
-        return bitmaps[index]->index();
-    }
-    index = ~index;
-    *bitmaps.insert(index) = flat;
-    return fBitmapIndex++;
+    return find_flat(&fHeap, flat, &fBitmapTable, &bitmaps, &fBitmapIndex);
 }
 
 int SkPictureRecord::find(SkTDArray<const SkFlatMatrix* >& matrices, const SkMatrix* matrix) {
     if (matrix == NULL)
         return 0;
     SkFlatMatrix* flat = SkFlatMatrix::Flatten(&fHeap, *matrix, fMatrixIndex);
-    int index = SkTSearch<SkFlatData>((const SkFlatData**) matrices.begin(),
-        matrices.count(), (SkFlatData*) flat, sizeof(flat), &SkFlatData::Compare);
-    if (index >= 0) {
-        (void)fHeap.unalloc(flat);
-        return matrices[index]->index();
-    }
-    index = ~index;
-    *matrices.insert(index) = flat;
-    return fMatrixIndex++;
+    return find_flat(&fHeap, flat, &fMatrixTable, &matrices, &fMatrixIndex);
 }
 
 int SkPictureRecord::find(SkTDArray<const SkFlatPaint* >& paints, const SkPaint* paint) {
@@ -562,29 +847,12 @@ int SkPictureRecord::find(SkTDArray<const SkFlatPaint* >& paints, const SkPaint*
 
     SkFlatPaint* flat = SkFlatPaint::Flatten(&fHeap, *paint, fPaintIndex,
                                              &fRCSet, &fTFSet);
-    int index = SkTSearch<SkFlatData>((const SkFlatData**) paints.begin(),
-        paints.count(), (SkFlatData*) flat, sizeof(flat), &SkFlatData::Compare);
-    if (index >= 0) {
-        (void)fHeap.unalloc(flat);
-        return paints[index]->index();
-    }
-
-    index = ~index;
-    *paints.insert(index) = flat;
-    return fPaintIndex++;
+    return find_flat(&fHeap, flat, &fPaintTable, &paints, &fPaintIndex);
 }
 
 int SkPictureRecord::find(SkTDArray<const SkFlatRegion* >& regions, const SkRegion& region) {
     SkFlatRegion* flat = SkFlatRegion::Flatten(&fHeap, region, fRegionIndex);
-    int index = SkTSearch<SkFlatData>((const SkFlatData**) regions.begin(),
-        regions.count(), (SkFlatData*) flat, sizeof(flat), &SkFlatData::Compare);
-    if (index >= 0) {
-        (void)fHeap.unalloc(flat);
-        return regions[index]->index();
-    }
-    index = ~index;
-    *regions.insert(index) = flat;
-    return fRegionIndex++;
+    return find_flat(&fHeap, flat, &fRegionTable, &regions, &fRegionIndex);
 }
 
 #ifdef SK_DEBUG_DUMP
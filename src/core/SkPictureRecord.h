@@ -32,6 +32,8 @@ public:
     virtual void drawPoints(PointMode, size_t count, const SkPoint pts[],
                             const SkPaint&);
     virtual void drawRect(const SkRect& rect, const SkPaint&);
+    virtual void drawRects(const SkRect rects[], size_t count,
+                           const SkPaint&);
     virtual void drawPath(const SkPath& path, const SkPaint&);
     virtual void drawBitmap(const SkBitmap&, SkScalar left, SkScalar top,
                             const SkPaint*);
@@ -41,6 +43,8 @@ public:
                                   const SkPaint*);
     virtual void drawSprite(const SkBitmap&, int left, int top,
                             const SkPaint*);
+    virtual void drawSprites(const SkBitmap&, const SkIPoint pts[],
+                             size_t count, const SkPaint*);
     virtual void drawText(const void* text, size_t byteLength, SkScalar x, 
                           SkScalar y, const SkPaint&);
     virtual void drawPosText(const void* text, size_t byteLength, 
@@ -82,15 +86,54 @@ public:
         return fWriter;
     }
 
+    // the number of canvas calls recorded, and how many of those
+    // kOptimizeOps_RecordingFlag dropped or merged
+    int recordedOpCount() const { return fOpCount + fRemovedOpCount; }
+    int removedOpCount() const { return fRemovedOpCount; }
+
 private:
     SkTDArray<uint32_t> fRestoreOffsetStack;
 
-    void addDraw(DrawType drawType) {
-#ifdef SK_DEBUG_TRACE
-        SkDebugf("add %s\n", DrawTypeToString(drawType));
-#endif
-        fWriter.writeInt(drawType);
-    }    
+    /*  What kOptimizeOps_RecordingFlag needs to know about each save level.
+        Offsets are into fWriter.
+     */
+    struct SaveRec {
+        uint32_t    fOffset;        // of the SAVE or SAVE_LAYER op
+        int         fOpCount;       // ops written before it
+        int         fDrawCount;     // draws since then (nested ones too)
+        uint32_t    fFlags;         // its SaveFlags
+        bool        fIsLayer;
+        // the layer composites as src-over, without a color filter etc.
+        bool        fIsPlainLayer;
+        // ... and with no bounds, at full alpha
+        bool        fIsNoOpLayer;
+    };
+    SkTDArray<SaveRec> fSaveStack;
+
+    bool        fOptimize;
+    int         fOpCount;           // ops in fWriter
+    int         fRemovedOpCount;
+    uint32_t    fLastOpOffset;      // the last op in fWriter,
+    DrawType    fLastOpType;        // or UNUSED if we don't know it
+    // if fMatrixTailCount > 0, fWriter ends with that many matrix ops,
+    // starting at fMatrixTailOffset
+    uint32_t    fMatrixTailOffset;
+    int         fMatrixTailCount;
+    // the last clip op was an intersecting CLIP_RECT of this rect, and the
+    // clip and matrix have not changed since
+    bool        fLastClipRectValid;
+    SkRect      fLastClipRect;
+    // describes the paint passed to the last addPaint()
+    bool        fLastPaintIsOpaque;
+
+    void resetOptimizer();
+    SaveRec* pushSaveRec(SaveFlags);
+    bool dropNoOp(bool isNoOp);
+    void addDraw(DrawType drawType);
+    void rewindToOffset(uint32_t offset, int opCount);
+    bool removeMatrixTail();
+    bool removeSaveBlock(const SaveRec&);
+    bool mergeDrawRect(const SkRect&, const SkPaint&);
     void addInt(int value) {
         fWriter.writeInt(value);
     }
@@ -164,6 +207,11 @@ private:
     SkTDArray<const SkFlatPaint* > fPaints;
     int fRegionIndex;
     SkTDArray<const SkFlatRegion* > fRegions;
+    // find the entries of the arrays above by their flattened data
+    SkFlatDataTable fBitmapTable;
+    SkFlatDataTable fMatrixTable;
+    SkFlatDataTable fPaintTable;
+    SkFlatDataTable fRegionTable;
     SkPathHeap* fPathHeap;  // reference counted
     SkWriter32 fWriter;
 
@@ -21,6 +21,8 @@
 #include "SkScan.h"
 #include "SkBlitter.h"
 
+class SkEdgeBuilder;
+
 class SkScanClipper {
 public:
     SkScanClipper(SkBlitter* blitter, const SkRegion* clip, const SkIRect& bounds);
@@ -35,10 +37,17 @@ private:
     const SkIRect*      fClipRect;
 };
 
-// clipRect == null means path is entirely inside the clip
+// clipRect == null means path is entirely inside the clip. If sharedEdges is
+// not null, the path's edges are copied from it (see sk_build_fill_edges)
+// rather than built, which only a band of a non-inverse fill may do.
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn);
+                  const SkRegion& clipRgn,
+                  const SkEdgeBuilder* sharedEdges = NULL);
+
+// builds and sorts the edges sk_fill_path would, returning their count
+int sk_build_fill_edges(const SkPath& path, const SkIRect* clipRect,
+                        int shiftEdgesUp, SkEdgeBuilder* builder);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
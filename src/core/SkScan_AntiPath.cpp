@@ -21,17 +21,22 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkDrawArena.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
 #define MASK    (SCALE - 1)
 
 /*
-    We have two techniques for capturing the output of the supersampler:
+    We have three techniques for capturing the output of the supersampler:
     - SUPERMASK, which records a large mask-bitmap
         this is often faster for small, complex objects
     - RLE, which records a rle-encoded scanline
         this is often faster for large objects with big spans
+    - TILED, which records coverage deltas in 32x32 tiles allocated on demand
+        this is meant for very large, sparse objects: each span costs the same
+        however long it is, and tiles without edges are never touched. It is
+        only used after SkScan::SetUseTiledAA(true)
 
     NEW_AA is a set of code-changes to try to make both paths produce identical
     results. Its not quite there yet, though the remaining differences may be
@@ -39,6 +44,7 @@
  */
 //#define FORCE_SUPERMASK
 //#define FORCE_RLE
+//#define FORCE_TILED
 //#define SK_SUPPORT_NEW_AA
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -92,7 +98,7 @@ public:
 
     virtual ~SuperBlitter() {
         this->flush();
-        sk_free(fRuns.fRuns);
+        SkDrawArena::Free(fRuns.fRuns);
     }
 
     void flush();
@@ -111,7 +117,7 @@ SuperBlitter::SuperBlitter(SkBlitter* realBlitter, const SkIRect& ir,
     const int width = fWidth;
 
     // extra one to store the zero at the end
-    fRuns.fRuns = (int16_t*)sk_malloc_throw((width + 1 + (width + 2)/2) * sizeof(int16_t));
+    fRuns.fRuns = (int16_t*)SkDrawArena::Alloc((width + 1 + (width + 2)/2) * sizeof(int16_t));
     fRuns.fAlpha = (uint8_t*)(fRuns.fRuns + width + 1);
     fRuns.reset(width);
 
@@ -407,6 +413,270 @@ void MaskSuperBlitter::blitH(int x, int y, int width) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// off until it shows a win on real content, see SkScan::SetUseTiledAA
+static bool gUseTiledAA;
+
+class TileSuperBlitter : public BaseSuperBlitter {
+public:
+    TileSuperBlitter(SkBlitter* realBlitter, const SkIRect& ir,
+                     const SkRegion& clip);
+    virtual ~TileSuperBlitter();
+
+    virtual void blitH(int x, int y, int width);
+
+    static bool CanHandleRect(const SkIRect& ir, const SkRegion& clip) {
+#ifdef FORCE_RLE
+        return false;
+#endif
+#ifdef FORCE_TILED
+        return true;
+#endif
+        if (!gUseTiledAA) {
+            return false;
+        }
+        SkIRect bounds = ir;
+        if (!bounds.intersect(clip.getBounds())) {
+            return false;
+        }
+        return bounds.width() >= kMIN_SIZE && bounds.height() >= kMIN_SIZE;
+    }
+
+private:
+    enum {
+        kTILE_SHIFT = 5,
+        kTILE_SIZE  = 1 << kTILE_SHIFT,
+        kTILE_MASK  = kTILE_SIZE - 1,
+        kMIN_SIZE   = 256   // smaller than this and the RLE blitter wins
+    };
+
+    /*  Coverage is recorded as deltas: a span of alpha a from x0 to x1 adds
+        a at x0 and subtracts it at x1, so every span costs a constant amount
+        of work however many tiles it crosses. Only the tiles holding a span
+        endpoint (i.e. those touched by an edge) get storage. On flush the
+        deltas are summed back up along each row, and the tiles in between
+        become single runs.
+     */
+    struct Tile {
+        // kTILE_SIZE x kTILE_SIZE deltas, allocated the first time this
+        // column of tiles is touched, and reused for the following rows
+        int16_t*    fDeltas;
+        // bit y is set once row y of fDeltas has been cleared and written to
+        uint32_t    fRows;
+    };
+
+    SkIRect     fBounds;    // ir intersected with the clip bounds
+    int         fTileCount;
+    int         fTileTop;   // device y of the current row of tiles
+    Tile*       fTiles;
+    int         fRowFirst[kTILE_SIZE];  // range of tiles touched in each row
+    int         fRowLast[kTILE_SIZE];
+    SkAlphaRuns fRuns;      // storage for rebuilding each row on flush
+
+    int tileWidth(int index) const {
+        return SkMin32(kTILE_SIZE, fBounds.width() - (index << kTILE_SHIFT));
+    }
+    void addDelta(int x, int y, int delta) {
+        if (x < fBounds.width()) {
+            Tile* tile = &fTiles[x >> kTILE_SHIFT];
+            if (!(tile->fRows & (1u << y))) {
+                this->touch(x >> kTILE_SHIFT, y);
+            }
+            tile->fDeltas[(y << kTILE_SHIFT) + (x & kTILE_MASK)] += delta;
+        }
+    }
+    void touch(int index, int y);
+    void flush();
+};
+
+TileSuperBlitter::TileSuperBlitter(SkBlitter* realBlitter, const SkIRect& ir,
+                                   const SkRegion& clip)
+        : BaseSuperBlitter(realBlitter, ir, clip) {
+    fBounds = ir;
+    if (!fBounds.intersect(clip.getBounds())) {
+        fBounds.setEmpty();
+    }
+    fTileCount = (fBounds.width() + kTILE_MASK) >> kTILE_SHIFT;
+    fTileTop = fBounds.fTop;
+
+    size_t size = fTileCount * sizeof(Tile);
+    fTiles = (Tile*)SkDrawArena::Alloc(size);
+    memset(fTiles, 0, size);
+    for (int y = 0; y < kTILE_SIZE; y++) {
+        fRowFirst[y] = fTileCount;
+        fRowLast[y] = -1;
+    }
+
+    // extra one to store the zero at the end
+    const int width = fBounds.width();
+    fRuns.fRuns = (int16_t*)SkDrawArena::Alloc((width + 1) * sizeof(int16_t) + width);
+    fRuns.fAlpha = (uint8_t*)(fRuns.fRuns + width + 1);
+}
+
+bool SkScan::SetUseTiledAA(bool use) {
+    bool prev = gUseTiledAA;
+    gUseTiledAA = use;
+    return prev;
+}
+
+bool SkScan::AntiFillPathBlitsMask(const SkIRect& ir) {
+    return MaskSuperBlitter::CanHandleRect(ir);
+}
+
+TileSuperBlitter::~TileSuperBlitter() {
+    this->flush();
+    for (int i = 0; i < fTileCount; i++) {
+        SkDrawArena::Free(fTiles[i].fDeltas);
+    }
+    SkDrawArena::Free(fTiles);
+    SkDrawArena::Free(fRuns.fRuns);
+}
+
+void TileSuperBlitter::touch(int index, int y) {
+    Tile* tile = &fTiles[index];
+    if (NULL == tile->fDeltas) {
+        tile->fDeltas = (int16_t*)SkDrawArena::Alloc(kTILE_SIZE * kTILE_SIZE *
+                                                     sizeof(int16_t));
+    }
+    memset(tile->fDeltas + (y << kTILE_SHIFT), 0, kTILE_SIZE * sizeof(int16_t));
+    tile->fRows |= 1u << y;
+
+    fRowFirst[y] = SkMin32(fRowFirst[y], index);
+    fRowLast[y] = SkMax32(fRowLast[y], index);
+}
+
+void TileSuperBlitter::blitH(int x, int y, int width) {
+    int iy = y >> SHIFT;
+    if (iy < fBounds.fTop || iy >= fBounds.fBottom) {
+        return;
+    }
+    if (iy >= fTileTop + kTILE_SIZE) {  // new row of tiles
+        this->flush();
+        fTileTop = fBounds.fTop + ((iy - fBounds.fTop) & ~kTILE_MASK);
+    }
+
+    x -= fBounds.fLeft << SHIFT;
+
+    // hack, until I figure out why my cubics (I think) go beyond the bounds
+    if (x < 0) {
+        width += x;
+        x = 0;
+    }
+    width = SkMin32(width, (fBounds.width() << SHIFT) - x);
+    if (width <= 0) {
+        return;
+    }
+
+    // same coverage math as SuperBlitter, so the two produce identical alpha
+    int start = x;
+    int stop = x + width;
+    int fb = start & SUPER_Mask;
+    int fe = stop & SUPER_Mask;
+    int n = (stop >> SHIFT) - (start >> SHIFT) - 1;
+
+    if (n < 0) {
+        fb = fe - fb;
+        n = 0;
+        fe = 0;
+    } else {
+        if (fb == 0) {
+            n += 1;
+        } else {
+            fb = (1 << SHIFT) - fb;
+        }
+    }
+
+    const int ty = iy - fTileTop;
+    const int maxValue = (1 << (8 - SHIFT)) - (((y & MASK) + 1) >> SHIFT);
+    int px = x >> SHIFT;
+
+    if (fb) {
+        int alpha = coverage_to_alpha(fb);
+        this->addDelta(px, ty, alpha);
+        this->addDelta(px + 1, ty, maxValue - alpha);
+        px += 1;
+    } else {
+        this->addDelta(px, ty, maxValue);
+    }
+    px += n;
+    if (fe) {
+        int alpha = coverage_to_alpha(fe);
+        this->addDelta(px, ty, alpha - maxValue);
+        this->addDelta(px + 1, ty, -alpha);
+    } else {
+        this->addDelta(px, ty, -maxValue);
+    }
+}
+
+void TileSuperBlitter::flush() {
+    const int height = SkMin32(kTILE_SIZE, fBounds.fBottom - fTileTop);
+
+    for (int y = 0; y < height; y++) {
+        const int first = fRowFirst[y];
+        const int last = fRowLast[y];
+        if (first > last) {
+            continue;
+        }
+
+        const int left = first << kTILE_SHIFT;
+        int16_t* runs = fRuns.fRuns + left;
+        uint8_t* aa = fRuns.fAlpha + left;
+        int16_t* run = runs;
+        int alpha = 0;
+        int sum = 0;
+
+        for (int i = first; i <= last; i++) {
+            const Tile& tile = fTiles[i];
+            const int width = this->tileWidth(i);
+
+            if (!(tile.fRows & (1u << y))) {
+                // a whole tile with no edges in it: extend the current run
+                continue;
+            }
+
+            const int16_t* deltas = tile.fDeltas + (y << kTILE_SHIFT);
+            int16_t* row = runs + ((i << kTILE_SHIFT) - left);
+            for (int j = 0; j < width; j++) {
+                if (deltas[j]) {
+                    sum += deltas[j];
+                    // the RLE blitter clamps 256 (from abutting spans) to 255
+                    int value = SkMin32(sum, 0xFF);
+                    if (value != alpha) {
+                        int16_t* next = row + j;
+                        if (next > run) {
+                            *run = SkToS16(next - run);
+                            aa[run - runs] = SkToU8(alpha);
+                            run = next;
+                        }
+                        alpha = value;
+                    }
+                }
+            }
+        }
+        if (alpha) {
+            // spans reaching the right edge drop their closing delta
+            int16_t* next = runs + (fBounds.width() - left);
+            *run = SkToS16(next - run);
+            aa[run - runs] = SkToU8(alpha);
+            run = next;
+        }
+
+        const int count = run - runs;
+        if (count > 0) {
+            runs[count] = 0;
+            fRealBlitter->blitAntiH(fBounds.fLeft + left, fTileTop + y, aa,
+                                    runs);
+        }
+        fRowFirst[y] = fTileCount;
+        fRowLast[y] = -1;
+    }
+
+    for (int i = 0; i < fTileCount; i++) {
+        fTiles[i].fRows = 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 /*  Returns non-zero if (value << shift) overflows a short, which would mean
     we could not shift it up and then convert to SkFixed.
     i.e. is x expressible as signed (16-shift) bits?
@@ -472,6 +742,10 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& clip,
         MaskSuperBlitter    superBlit(blitter, ir, clip);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
         sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, clip);
+    } else if (!path.isInverseFillType() &&
+               TileSuperBlitter::CanHandleRect(ir, clip)) {
+        TileSuperBlitter    superBlit(blitter, ir, clip);
+        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, clip);
     } else {
         SuperBlitter    superBlit(blitter, ir, clip);
         sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, clip);
@@ -481,3 +755,103 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& clip,
         sk_blit_below(blitter, ir, clip);
     }
 }
+
+bool SkScan::BuildAntiFillEdges(const SkPath& path, const SkRegion& clip,
+                                SkEdgeBuilder* edges) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect ir;
+    path.getBounds().roundOut(&ir);
+    if (clip.isEmpty() || ir.isEmpty()) {
+        return false;
+    }
+
+    if (overflows_short_shift(ir.fLeft, SHIFT) |
+            overflows_short_shift(ir.fRight, SHIFT) |
+            overflows_short_shift(ir.fTop, SHIFT) |
+            overflows_short_shift(ir.fBottom, SHIFT)) {
+        // AntiFillPath() will draw w/o antialiasing
+        return SkScan::BuildFillEdges(path, clip, edges);
+    }
+
+    if (!SkIRect::Intersects(clip.getBounds(), ir)) {
+        return false;
+    }
+
+    // we just want the clip rect that AntiFillPath() would build its edges with
+    SkScanClipper   clipper(NULL, &clip, ir);
+    const SkIRect*  clipRect = clipper.getClipRect();
+    SkIRect superRect, *superClipRect = NULL;
+
+    if (clipRect) {
+        superRect.set(  clipRect->fLeft << SHIFT, clipRect->fTop << SHIFT,
+                        clipRect->fRight << SHIFT, clipRect->fBottom << SHIFT);
+        superClipRect = &superRect;
+    }
+    return sk_build_fill_edges(path, superClipRect, SHIFT, edges) >= 2;
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRegion& clip,
+                          SkBlitter* blitter, int startY, int stopY,
+                          const SkEdgeBuilder& edges) {
+    SkASSERT(!path.isInverseFillType());
+
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    SkIRect ir;
+    path.getBounds().roundOut(&ir);
+    if (ir.isEmpty()) {
+        return;
+    }
+
+    if (overflows_short_shift(ir.fLeft, SHIFT) |
+            overflows_short_shift(ir.fRight, SHIFT) |
+            overflows_short_shift(ir.fTop, SHIFT) |
+            overflows_short_shift(ir.fBottom, SHIFT)) {
+        // can't supersample, so draw w/o antialiasing
+        SkScan::FillPath(path, clip, blitter, startY, stopY, edges);
+        return;
+    }
+
+    // clip against the whole path, as the complete fill (and the shared
+    // edges) do, and only supersample our band of it
+    SkScanClipper   clipper(blitter, &clip, ir);
+    const SkIRect*  clipRect = clipper.getClipRect();
+
+    blitter = clipper.getBlitter();
+    if (NULL == blitter) {
+        return;
+    }
+
+    SkIRect band = ir;
+    band.fTop = SkMax32(startY, ir.fTop);
+    band.fBottom = SkMin32(stopY, ir.fBottom);
+    if (band.isEmpty()) {
+        return;
+    }
+
+    SkIRect superRect, *superClipRect = NULL;
+
+    if (clipRect) {
+        superRect.set(  clipRect->fLeft << SHIFT, clipRect->fTop << SHIFT,
+                        clipRect->fRight << SHIFT, clipRect->fBottom << SHIFT);
+        superClipRect = &superRect;
+    }
+
+    // pick the same supersampler as the complete fill (they don't quite agree)
+    if (MaskSuperBlitter::CanHandleRect(ir)) {
+        MaskSuperBlitter    superBlit(blitter, band, clip);
+        sk_fill_path(path, superClipRect, &superBlit, band.fTop, band.fBottom,
+                     SHIFT, clip, &edges);
+    } else if (TileSuperBlitter::CanHandleRect(ir, clip)) {
+        TileSuperBlitter    superBlit(blitter, band, clip);
+        sk_fill_path(path, superClipRect, &superBlit, band.fTop, band.fBottom,
+                     SHIFT, clip, &edges);
+    } else {
+        SuperBlitter    superBlit(blitter, band, clip);
+        sk_fill_path(path, superClipRect, &superBlit, band.fTop, band.fBottom,
+                     SHIFT, clip, &edges);
+    }
+}
@@ -420,10 +420,8 @@ extern "C" {
     }
 }
 
-static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    qsort(list, count, sizeof(SkEdge*), edge_compare);
-
-    // now make the edges linked in sorted order
+static SkEdge* link_edges(SkEdge* list[], int count, SkEdge** last) {
+    // make the edges linked in (already) sorted order
     for (int i = 1; i < count; i++) {
         list[i - 1]->fNext = list[i];
         list[i]->fPrev = list[i - 1];
@@ -433,22 +431,232 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
     return list[0];
 }
 
-// clipRect may be null, even though we always have a clip. This indicates that
-// the path is contained in the clip, and so we can ignore it during the blit
-//
-// clipRect (if no null) has already been shifted up
-//
+static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
+    qsort(list, count, sizeof(SkEdge*), edge_compare);
+    return link_edges(list, count, last);
+}
+
+// Steps an edge that starts above y down to it, just as walk_edges would
+// have. Returns false if the edge ends above y.
+static bool advance_edge(SkEdge* edge, int y) {
+    while (edge->fLastY < y) {
+        int success;
+        if (edge->fCurveCount < 0) {
+            success = ((SkCubicEdge*)edge)->updateCubic();
+        } else if (edge->fCurveCount > 0) {
+            success = ((SkQuadraticEdge*)edge)->updateQuadratic();
+        } else {
+            success = 0;
+        }
+        if (!success) {
+            return false;
+        }
+        SkASSERT(edge->fFirstY <= y);
+    }
+    if (edge->fFirstY < y) {
+        edge->fX += edge->fDX * (y - edge->fFirstY);
+        edge->fFirstY = y;
+    }
+    return true;
+}
+
+// Fills that start below the path's top (i.e. one band of a larger fill)
+// begin with the edges that cross start_y, stepped down to it. Edges that are
+// entirely above start_y, or start at or below stop_y, are dropped. Clears
+// sorted if any edge had to be moved. Returns the new count.
+static int skip_to_band(SkEdge* list[], int count, int start_y, int stop_y,
+                        bool* sorted) {
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        SkEdge* edge = list[i];
+        if (edge->fFirstY >= stop_y) {
+            continue;
+        }
+        if (edge->fFirstY < start_y) {
+            if (!advance_edge(edge, start_y)) {
+                continue;
+            }
+            *sorted = false;
+        }
+        list[n++] = edge;
+    }
+    return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  A convex path crosses each row exactly twice, so instead of keeping a list
+    of active edges sorted by x, and walking it with a winding count, we just
+    step a left and a right edge, replacing each one with the next edge in y
+    order when it ends. Each row is blit from the smaller to the larger
+    (rounded) x, which is what walk_edges would have blit for the same edges.
+
+    A path's convexity may just be a caller's hint, so we check as we go that
+    no third edge starts while two are active (a closed path's two active
+    edges then always have opposite windings). If one does, or an edge ends
+    without another starting on the next row, walk_edges takes over from that
+    row, so a wrong hint costs speed, not correctness.
+ */
+
+// Returns the next edge if it starts on row y, or NULL if it starts below
+// (the tail edge starts below everything).
+static SkEdge* next_convex_edge(SkEdge** currE, int y) {
+    SkEdge* edge = *currE;
+    SkASSERT(edge->fFirstY >= y);
+    if (edge->fFirstY > y) {
+        return NULL;
+    }
+    *currE = edge->fNext;
+    return edge;
+}
+
+// Moves a curve edge that has ended on to its next piece. Returns false if
+// there is none (or the edge is a line).
+static bool update_convex_edge(SkEdge* edge) {
+    if (edge->fCurveCount < 0) {
+        return ((SkCubicEdge*)edge)->updateCubic() != 0;
+    } else if (edge->fCurveCount > 0) {
+        return ((SkQuadraticEdge*)edge)->updateQuadratic() != 0;
+    }
+    return false;
+}
+
+// Walks the edges with walk_edges from curr_y, where the edges left in the
+// list are the active ones (at least one of leftE and riteE), stepped down to
+// curr_y, followed by the ones that start on or below it.
+static void finish_convex_walk(SkEdge* prevHead, SkEdge* leftE, SkEdge* riteE,
+                               SkPath::FillType fillType, SkBlitter* blitter,
+                               int curr_y, int stop_y) {
+    if (leftE) {
+        leftE->fFirstY = curr_y;
+    }
+    if (riteE) {
+        riteE->fFirstY = curr_y;
+    }
+    if (prevHead->fNext->fFirstY == curr_y) {
+        insert_new_edges(prevHead->fNext, curr_y);
+    }
+    walk_edges(prevHead, fillType, blitter, curr_y, stop_y, NULL);
+}
+
+static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType fillType,
+                              SkBlitter* blitter, int stop_y,
+                              bool canBlitRect) {
+    validate_sort(prevHead->fNext);
+
+    SkEdge* currE = prevHead->fNext;
+    int     curr_y = currE->fFirstY;
+    SkEdge* leftE = next_convex_edge(&currE, curr_y);
+    SkEdge* riteE = next_convex_edge(&currE, curr_y);
+
+    for (;;) {
+        if (NULL == leftE || NULL == riteE || currE->fFirstY <= curr_y) {
+            // not convex after all, unless the edges have all ended
+            if (leftE || riteE || currE->fNext) {
+                finish_convex_walk(prevHead, leftE, riteE, fillType, blitter,
+                                   curr_y, stop_y);
+            }
+            return;
+        }
+
+        // stop before the next edge starts, so we can check it then
+        int     local_bot = SkMin32(SkMin32(leftE->fLastY, riteE->fLastY),
+                                    SkMin32(stop_y, currE->fFirstY) - 1);
+        SkFixed left = leftE->fX;
+        SkFixed dLeft = leftE->fDX;
+        SkFixed rite = riteE->fX;
+        SkFixed dRite = riteE->fDX;
+
+        if (canBlitRect && 0 == (dLeft | dRite)) {
+            int L = (left + SK_Fixed1/2) >> 16;
+            int R = (rite + SK_Fixed1/2) >> 16;
+            if (L > R) {
+                SkTSwap(L, R);
+            }
+            if (L < R) {
+                blitter->blitRect(L, curr_y, R - L, local_bot - curr_y + 1);
+            }
+            curr_y = local_bot + 1;
+        } else {
+            for (;;) {
+                int L = (left + SK_Fixed1/2) >> 16;
+                int R = (rite + SK_Fixed1/2) >> 16;
+                if (L > R) {
+                    SkTSwap(L, R);
+                }
+                if (L < R) {
+                    blitter->blitH(L, curr_y, R - L);
+                }
+                if (++curr_y > local_bot) {
+                    break;
+                }
+                left += dLeft;
+                rite += dRite;
+            }
+        }
+        if (curr_y >= stop_y) {
+            return;
+        }
+
+        // step each edge to curr_y, or replace it if it ended on local_bot
+        if (leftE->fLastY > local_bot) {
+            leftE->fX = left + dLeft;
+        } else if (!update_convex_edge(leftE)) {
+            remove_edge(leftE);
+            leftE = next_convex_edge(&currE, curr_y);
+        }
+        if (riteE->fLastY > local_bot) {
+            riteE->fX = rite + dRite;
+        } else if (!update_convex_edge(riteE)) {
+            remove_edge(riteE);
+            riteE = next_convex_edge(&currE, curr_y);
+        }
+    }
+}
+
+#ifdef USE_NEW_BUILDER
+int sk_build_fill_edges(const SkPath& path, const SkIRect* clipRect,
+                        int shiftEdgesUp, SkEdgeBuilder* builder) {
+    // only unclipped edges can be reused at another translation
+    int count = clipRect ? builder->build(path, clipRect, shiftEdgesUp) :
+                           builder->buildCached(path, shiftEdgesUp);
+    if (!builder->isSorted()) {
+        qsort(builder->edgeList(), count, sizeof(SkEdge*), edge_compare);
+        builder->cacheSortedEdges();
+    }
+    return count;
+}
+#endif
+
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitter,
                   int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn) {
+                  const SkRegion& clipRgn, const SkEdgeBuilder* sharedEdges) {
     SkASSERT(&path && blitter);
 
+    start_y <<= shiftEdgesUp;
+    stop_y <<= shiftEdgesUp;
+    if (clipRect && start_y < clipRect->fTop) {
+        start_y = clipRect->fTop;
+    }
+    if (clipRect && stop_y > clipRect->fBottom) {
+        stop_y = clipRect->fBottom;
+    }
+
 #ifdef USE_NEW_BUILDER
     SkEdgeBuilder   builder;
 
-    int count = builder.build(path, clipRect, shiftEdgesUp);
+    int count;
+    if (sharedEdges) {
+        SkASSERT(!path.isInverseFillType());
+        count = builder.copyBand(*sharedEdges, start_y, stop_y);
+    } else {
+        count = sk_build_fill_edges(path, clipRect, shiftEdgesUp, &builder);
+    }
     SkEdge**    list = builder.edgeList();
+    bool        sorted = true;
 #else
+    SkASSERT(NULL == sharedEdges);
+
     size_t  size;
     int     maxCount = cheap_worst_case_edge_count(path, &size);
 
@@ -467,6 +675,7 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
     int             count = build_edges(initialEdge, path, clipRect, list,
                                         shiftEdgesUp);
     SkASSERT(count <= maxCount);
+    bool            sorted = false;
 #endif
 
     if (count < 2) {
@@ -481,9 +690,18 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         return;
     }
 
+    if (!path.isInverseFillType()) {
+        // we may be just one band of the path's rows (see SkScan::FillPath)
+        count = skip_to_band(list, count, start_y, stop_y, &sorted);
+        if (count < 2 || start_y >= stop_y) {
+            return;
+        }
+    }
+
     SkEdge headEdge, tailEdge, *last;
     // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    SkEdge* edge = sorted ? link_edges(list, count, &last) :
+                            sort_edges(list, count, &last);
 
     headEdge.fPrev = NULL;
     headEdge.fNext = edge;
@@ -498,15 +716,6 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
 
     // now edge is the head of the sorted linklist
 
-    start_y <<= shiftEdgesUp;
-    stop_y <<= shiftEdgesUp;
-    if (clipRect && start_y < clipRect->fTop) {
-        start_y = clipRect->fTop;
-    }
-    if (clipRect && stop_y > clipRect->fBottom) {
-        stop_y = clipRect->fBottom;
-    }
-
     InverseBlitter  ib;
     PrePostProc     proc = NULL;
 
@@ -516,7 +725,14 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         proc = PrePostInverseBlitterProc;
     }
 
-    walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc);
+    // supersampled (antialiased) fills must not call blitRect
+    if (NULL == proc && path.isConvex()) {
+        walk_convex_edges(&headEdge, path.getFillType(), blitter, stop_y,
+                          0 == shiftEdgesUp);
+    } else {
+        walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y,
+                   proc);
+    }
 }
 
 void sk_blit_above(SkBlitter* blitter, const SkIRect& ir, const SkRegion& clip) {
@@ -611,6 +827,48 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& clip,
     }
 }
 
+bool SkScan::BuildFillEdges(const SkPath& path, const SkRegion& clip,
+                            SkEdgeBuilder* edges) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect ir;
+    path.getBounds().round(&ir);
+    if (clip.isEmpty() || ir.isEmpty() ||
+            !SkIRect::Intersects(clip.getBounds(), ir)) {
+        return false;
+    }
+
+    // we just want the clip rect that FillPath() would build its edges with
+    SkScanClipper   clipper(NULL, &clip, ir);
+    return sk_build_fill_edges(path, clipper.getClipRect(), 0, edges) >= 2;
+}
+
+void SkScan::FillPath(const SkPath& path, const SkRegion& clip,
+                      SkBlitter* blitter, int startY, int stopY,
+                      const SkEdgeBuilder& edges) {
+    SkASSERT(!path.isInverseFillType());
+
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    SkIRect ir;
+    path.getBounds().round(&ir);
+    if (ir.isEmpty()) {
+        return;
+    }
+
+    SkScanClipper   clipper(blitter, &clip, ir);
+
+    blitter = clipper.getBlitter();
+    startY = SkMax32(startY, ir.fTop);
+    stopY = SkMin32(stopY, ir.fBottom);
+    if (blitter && startY < stopY) {
+        sk_fill_path(path, clipper.getClipRect(), blitter, startY, stopY, 0,
+                     clip, &edges);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static int build_tri_edges(SkEdge edge[], const SkPoint pts[],
@@ -31,6 +31,14 @@ public:
     virtual void setup(const SkBitmap& device, int left, int top,
                        const SkPaint& paint);
 
+    /** Moves the source to (left, top) on the device, to draw it again (with
+        the same paint) without choosing another blitter.
+    */
+    void setOrigin(int left, int top) {
+        fLeft = left;
+        fTop = top;
+    }
+
     // overrides
 #ifdef SK_DEBUG
     virtual void    blitH(int x, int y, int width);
@@ -185,12 +185,48 @@ int SkUTF8_CountUnichars(const char utf8[], size_t byteLength) {
     const char* stop = utf8 + byteLength;
 
     while (utf8 < stop) {
-        utf8 += SkUTF8_LeadByteToCount(*(const uint8_t*)utf8);
-        count += 1;
+        size_t ascii = SkUTF8_CountASCII(utf8, stop - utf8);
+        utf8 += ascii;
+        count += ascii;
+        // step over multi-byte sequences until the next ascii byte
+        while (utf8 < stop && (*(const uint8_t*)utf8 & 0x80)) {
+            utf8 += SkUTF8_LeadByteToCount(*(const uint8_t*)utf8);
+            count += 1;
+        }
     }
     return count;
 }
 
+size_t SkUTF8_CountASCII_portable(const char utf8[], size_t byteLength) {
+    SkASSERT(NULL != utf8 || 0 == byteLength);
+
+    const uint8_t* p = (const uint8_t*)utf8;
+    const uint8_t* stop = p + byteLength;
+
+    // test a long at a time once we're aligned
+    while (p < stop && ((size_t)p & 3)) {
+        if (*p & 0x80) {
+            return p - (const uint8_t*)utf8;
+        }
+        p += 1;
+    }
+    while (stop - p >= 4 && !(*(const uint32_t*)p & 0x80808080)) {
+        p += 4;
+    }
+    while (p < stop && !(*p & 0x80)) {
+        p += 1;
+    }
+    return p - (const uint8_t*)utf8;
+}
+
+static size_t SkUTF8_CountASCII_stub(const char utf8[], size_t byteLength) {
+    SkUTF8CountASCIIProc proc = SkUTF8CountASCIIGetPlatformProc();
+    SkUTF8_CountASCII = proc ? proc : SkUTF8_CountASCII_portable;
+    return SkUTF8_CountASCII(utf8, byteLength);
+}
+
+SkUTF8CountASCIIProc SkUTF8_CountASCII = SkUTF8_CountASCII_stub;
+
 SkUnichar SkUTF8_ToUnichar(const char utf8[]) {
     SkASSERT(NULL != utf8);
 
@@ -311,18 +347,42 @@ int SkUTF16_CountUnichars(const uint16_t src[], int numberOf16BitValues) {
     const uint16_t* stop = src + numberOf16BitValues;
     int count = 0;
     while (src < stop) {
-        unsigned c = *src++;
-        SkASSERT(!SkUTF16_IsLowSurrogate(c));
-        if (SkUTF16_IsHighSurrogate(c)) {
-            SkASSERT(src < stop);
-            c = *src++;
-            SkASSERT(SkUTF16_IsLowSurrogate(c));
+        int bmp = SkUTF16_CountBMP(src, stop - src);
+        src += bmp;
+        count += bmp;
+        if (src < stop) {
+            unsigned c = *src++;
+            SkASSERT(!SkUTF16_IsLowSurrogate(c));
+            if (SkUTF16_IsHighSurrogate(c)) {
+                SkASSERT(src < stop);
+                c = *src++;
+                SkASSERT(SkUTF16_IsLowSurrogate(c));
+            }
+            count += 1;
         }
-        count += 1;
     }
     return count;
 }
 
+int SkUTF16_CountBMP_portable(const uint16_t src[], int numberOf16BitValues) {
+    SkASSERT(src || 0 == numberOf16BitValues);
+
+    int i = 0;
+    while (i < numberOf16BitValues && (src[i] & 0xF800) != 0xD800) {
+        i += 1;
+    }
+    return i;
+}
+
+static int SkUTF16_CountBMP_stub(const uint16_t src[],
+                                 int numberOf16BitValues) {
+    SkUTF16CountBMPProc proc = SkUTF16CountBMPGetPlatformProc();
+    SkUTF16_CountBMP = proc ? proc : SkUTF16_CountBMP_portable;
+    return SkUTF16_CountBMP(src, numberOf16BitValues);
+}
+
+SkUTF16CountBMPProc SkUTF16_CountBMP = SkUTF16_CountBMP_stub;
+
 SkUnichar SkUTF16_NextUnichar(const uint16_t** srcPtr) {
     SkASSERT(srcPtr && *srcPtr);
     
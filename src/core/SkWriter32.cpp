@@ -105,6 +105,35 @@ uint32_t* SkWriter32::peek32(size_t offset) {
     return block->peek32(offset);
 }
 
+void SkWriter32::rewindToOffset(size_t offset) {
+    SkASSERT(SkAlign4(offset) == offset);
+    SkASSERT(offset <= fSize);
+
+    fSize = offset;
+    if (fSingleBlock) {
+        return;
+    }
+
+    // find the block holding the new end, and free the ones after it
+    Block* block = fHead;
+    SkASSERT(NULL != block);
+    while (offset > block->fAllocated) {
+        offset -= block->fAllocated;
+        block = block->fNext;
+        SkASSERT(NULL != block);
+    }
+    block->fAllocated = offset;
+
+    Block* next = block->fNext;
+    while (next) {
+        Block* tmp = next->fNext;
+        sk_free(next);
+        next = tmp;
+    }
+    block->fNext = NULL;
+    fTail = block;
+}
+
 void SkWriter32::flatten(void* dst) const {
     if (fSingleBlock) {
         memcpy(dst, fSingleBlock, fSize);
@@ -16,6 +16,7 @@
 
 #include "SkBlitRow.h"
 #include "SkColorFilter.h"
+#include "SkColorFilterProcs.h"
 #include "SkColorPriv.h"
 #include "SkUtils.h"
 
@@ -308,6 +309,13 @@ public:
 
     virtual void filterSpan(const SkPMColor shader[], int count,
                             SkPMColor result[]) {
+        SkColorFilterProcs::LightingSpanProc proc =
+                SkColorFilterProcs::GetLightingSpanProc();
+        if (proc) {
+            proc(fMul, fAdd, true, shader, count, result);
+            return;
+        }
+
         unsigned scaleR = SkAlpha255To256(SkColorGetR(fMul));
         unsigned scaleG = SkAlpha255To256(SkColorGetG(fMul));
         unsigned scaleB = SkAlpha255To256(SkColorGetB(fMul));
@@ -363,6 +371,13 @@ public:
 
     virtual void filterSpan(const SkPMColor shader[], int count,
                             SkPMColor result[]) {
+        SkColorFilterProcs::LightingSpanProc proc =
+                SkColorFilterProcs::GetLightingSpanProc();
+        if (proc) {
+            proc(fMul, fAdd, true, shader, count, result);
+            return;
+        }
+
         unsigned addR = SkColorGetR(fAdd);
         unsigned addG = SkColorGetG(fAdd);
         unsigned addB = SkColorGetB(fAdd);
@@ -402,6 +417,13 @@ public:
 
     virtual void filterSpan(const SkPMColor shader[], int count,
                             SkPMColor result[]) {
+        SkColorFilterProcs::LightingSpanProc proc =
+                SkColorFilterProcs::GetLightingSpanProc();
+        if (proc) {
+            proc(fMul, fAdd, false, shader, count, result);
+            return;
+        }
+
         unsigned scaleR = SkAlpha255To256(SkColorGetR(fMul));
         unsigned scaleG = SkAlpha255To256(SkColorGetG(fMul));
         unsigned scaleB = SkAlpha255To256(SkColorGetB(fMul));
@@ -481,6 +503,13 @@ public:
 
     virtual void filterSpan(const SkPMColor shader[], int count,
                             SkPMColor result[]) {
+        SkColorFilterProcs::LightingSpanProc proc =
+                SkColorFilterProcs::GetLightingSpanProc();
+        if (proc) {
+            proc(fMul, fAdd, false, shader, count, result);
+            return;
+        }
+
         unsigned scaleR = SkAlpha255To256(SkColorGetR(fMul));
         unsigned scaleG = SkAlpha255To256(SkColorGetG(fMul));
         unsigned scaleB = SkAlpha255To256(SkColorGetB(fMul));
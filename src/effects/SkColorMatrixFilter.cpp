@@ -1,4 +1,5 @@
 #include "SkColorMatrixFilter.h"
+#include "SkColorFilterProcs.h"
 #include "SkColorMatrix.h"
 #include "SkColorPriv.h"
 #include "SkUnPreMultiply.h"
@@ -234,6 +235,14 @@ void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count,
         return;
     }
 
+    // the platform proc handles every case that needs one of our procs
+    SkColorFilterProcs::MatrixSpanProc spanProc =
+            SkColorFilterProcs::GetMatrixSpanProc();
+    if (spanProc) {
+        spanProc(state->fArray, state->fShift, src, count, dst);
+        return;
+    }
+
     const SkUnPreMultiply::Scale* table = SkUnPreMultiply::GetScaleTable();
 
     for (int i = 0; i < count; i++) {
@@ -288,6 +297,13 @@ void SkColorMatrixFilter::filterSpan16(const uint16_t src[], int count,
         return;
     }
 
+    SkColorFilterProcs::MatrixSpan16Proc spanProc =
+            SkColorFilterProcs::GetMatrixSpan16Proc();
+    if (spanProc) {
+        spanProc(state->fArray, state->fShift, src, count, dst);
+        return;
+    }
+
     for (int i = 0; i < count; i++) {
         uint16_t c = src[i];
 
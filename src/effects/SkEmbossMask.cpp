@@ -17,14 +17,6 @@
 
 #include "SkEmbossMask.h"
 
-static inline int nonzero_to_one(int x) {
-#if 0
-    return x != 0;
-#else
-    return ((unsigned)(x | -x)) >> 31;
-#endif
-}
-
 static inline int neq_to_one(int x, int max) {
 #if 0
     return x != max;
@@ -85,18 +77,71 @@ void SkEmbossMask_BuildTable() {
 
 #endif
 
+/*  Everything about a pixel's lighting but its neighbors is the same for the
+    whole mask, so it is gathered here, including the specular powers of every
+    hilite, which would otherwise be recomputed for each pixel.
+ */
+struct EmbossLight {
+    SkFixed fLx, fLy, fLzDotNz;
+    int     fLzDot8;
+    int     fAmbient;
+    uint8_t fSpecular[256];
+
+    EmbossLight(const SkEmbossMaskFilter::Light& light) {
+        fLx = SkScalarToFixed(light.fDirection[0]);
+        fLy = SkScalarToFixed(light.fDirection[1]);
+        SkFixed lz = SkScalarToFixed(light.fDirection[2]);
+        fLzDotNz = lz * kDelta;
+        fLzDot8 = lz >> 8;
+        fAmbient = light.fAmbient;
+
+        // specular is 4.4
+        // would really like to compute the fractional part of this too
+        for (int hilite = 0; hilite < 256; hilite++) {
+            int add = hilite;
+            for (int i = light.fSpecular >> 4; i > 0; --i) {
+                add = div255(add * hilite);
+            }
+            fSpecular[hilite] = SkToU8(add);
+        }
+    }
+
+    // nx and ny are the differences of the alpha values around the pixel
+    void light(int nx, int ny, uint8_t* multiply, uint8_t* additive) const {
+        SkFixed numer = fLx * nx + fLy * ny + fLzDotNz;
+        int     mul = fAmbient;
+        int     add = 0;
+
+        if (numer > 0) {  // preflight when numer/denom will be <= 0
+            // can use full numer, but then we need to call SkFixedMul, since
+            // numer is 24 bits, and our table is 12 bits
+
+            // SkFixed dot = SkFixedMul(numer, gTable[]) >> 8
+            SkFixed dot = (unsigned)(numer >> 4) * gInvSqrtTable[(SkAbs32(nx) >> 1 << 7) | (SkAbs32(ny) >> 1)] >> 20;
+            mul = SkFastMin32(mul + dot, 255);
+
+            // now for the reflection
+
+            //  R = 2 (Light * Normal) Normal - Light
+            //  hilite = R * Eye(0, 0, 1)
+
+            int hilite = (2 * dot - fLzDot8) * fLzDot8 >> 8;
+            if (hilite > 0) {
+                // pin hilite to 255, since our fast math is also a little sloppy
+                add = fSpecular[SkClampMax(hilite, 255)];
+            }
+        }
+        *multiply = SkToU8(mul);
+        *additive = SkToU8(add);
+    }
+};
+
 void SkEmbossMask::Emboss(SkMask* mask, const SkEmbossMaskFilter::Light& light) {
     SkASSERT(kDelta == kDeltaUsedToBuildTable);
 
     SkASSERT(mask->fFormat == SkMask::k3D_Format);
 
-    int     specular = light.fSpecular;
-    int     ambient = light.fAmbient;
-    SkFixed lx = SkScalarToFixed(light.fDirection[0]);
-    SkFixed ly = SkScalarToFixed(light.fDirection[1]);
-    SkFixed lz = SkScalarToFixed(light.fDirection[2]);
-    SkFixed lz_dot_nz = lz * kDelta;
-    int     lz_dot8 = lz >> 8;
+    const EmbossLight lighting(light);
 
     size_t      planeSize = mask->computeImageSize();
     uint8_t*    alpha = mask->fImage;
@@ -107,61 +152,32 @@ void SkEmbossMask::Emboss(SkMask* mask, const SkEmbossMaskFilter::Light& light)
     int maxy = mask->fBounds.height() - 1;
     int maxx = mask->fBounds.width() - 1;
 
+    if (maxx < 0) {
+        return;
+    }
+
     int prev_row = 0;
     for (int y = 0; y <= maxy; y++) {
         int next_row = neq_to_mask(y, maxy) & rowBytes;
+        const uint8_t* above = alpha - prev_row;
+        const uint8_t* below = alpha + next_row;
 
-        for (int x = 0; x <= maxx; x++) {
+        // the first and last pixels use themselves for their missing neighbor
+        if (alpha[0]) {
+            lighting.light(alpha[neq_to_one(0, maxx)] - alpha[0],
+                           below[0] - above[0], &multiply[0], &additive[0]);
+        }
+        for (int x = 1; x < maxx; x++) {
             if (alpha[x]) {
-                int nx = alpha[x + neq_to_one(x, maxx)] - alpha[x - nonzero_to_one(x)];
-                int ny = alpha[x + next_row] - alpha[x - prev_row];
-
-                SkFixed numer = lx * nx + ly * ny + lz_dot_nz;
-                int     mul = ambient;
-                int     add = 0;
-
-                if (numer > 0) {  // preflight when numer/denom will be <= 0
-#if 0
-                    int denom = SkSqrt32(nx * nx + ny * ny + kDelta*kDelta);
-                    SkFixed dot = numer / denom;
-                    dot >>= 8;  // now dot is 2^8 instead of 2^16
-#else
-                    // can use full numer, but then we need to call SkFixedMul, since
-                    // numer is 24 bits, and our table is 12 bits
-
-                    // SkFixed dot = SkFixedMul(numer, gTable[]) >> 8
-                    SkFixed dot = (unsigned)(numer >> 4) * gInvSqrtTable[(SkAbs32(nx) >> 1 << 7) | (SkAbs32(ny) >> 1)] >> 20;
-#endif
-                    mul = SkFastMin32(mul + dot, 255);
-
-                    // now for the reflection
-
-                    //  R = 2 (Light * Normal) Normal - Light
-                    //  hilite = R * Eye(0, 0, 1)
-
-                    int hilite = (2 * dot - lz_dot8) * lz_dot8 >> 8;
-                    if (hilite > 0) {
-                        // pin hilite to 255, since our fast math is also a little sloppy
-                        hilite = SkClampMax(hilite, 255);
-
-                        // specular is 4.4
-                        // would really like to compute the fractional part of this
-                        // and then possibly cache a 256 table for a given specular
-                        // value in the light, and just pass that in to this function.
-                        add = hilite;
-                        for (int i = specular >> 4; i > 0; --i) {
-                            add = div255(add * hilite);
-                        }
-                    }
-                }
-                multiply[x] = SkToU8(mul);
-                additive[x] = SkToU8(add);
-
-            //  multiply[x] = 0xFF;
-            //  additive[x] = 0;
-            //  ((uint8_t*)alpha)[x] = alpha[x] * multiply[x] >> 8;
+                lighting.light(alpha[x + 1] - alpha[x - 1], below[x] - above[x],
+                               &multiply[x], &additive[x]);
             }
         }
+        if (maxx > 0 && alpha[maxx]) {
+            lighting.light(alpha[maxx] - alpha[maxx - 1],
+                           below[maxx] - above[maxx],
+                           &multiply[maxx], &additive[maxx]);
+        }
         alpha += rowBytes;
         multiply += rowBytes;
         additive += rowBytes;
@@ -169,4 +185,3 @@ void SkEmbossMask::Emboss(SkMask* mask, const SkEmbossMaskFilter::Light& light)
     }
 }
 
-
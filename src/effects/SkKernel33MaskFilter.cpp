@@ -1,5 +1,6 @@
 #include "SkKernel33MaskFilter.h"
 #include "SkColorPriv.h"
+#include "SkMaskFilterProcs.h"
 
 SkMask::Format SkKernel33ProcMaskFilter::getFormat() {
     return SkMask::kA8_Format;
@@ -17,7 +18,10 @@ bool SkKernel33ProcMaskFilter::filterMask(SkMask* dst, const SkMask& src,
         return true;
     }
     
-    dst->fRowBytes = dst->fBounds.width();
+    // pad our rows like SkTableMaskFilter, so the blitters can read a long at
+    // a time
+    const int dstWidth = dst->fBounds.width();
+    dst->fRowBytes = SkAlign4(dstWidth);
     size_t size = dst->computeImageSize();
     if (0 == size) {
         return false;   // too big to allocate, abort
@@ -30,42 +34,67 @@ bool SkKernel33ProcMaskFilter::filterMask(SkMask* dst, const SkMask& src,
     const uint8_t* srcImage = src.fImage;
     uint8_t* dstImage = dst->fImage;
 
-    uint8_t* srcRows[3];
-    uint8_t storage[3][3];
-    
-    srcRows[0] = storage[0];
-    srcRows[1] = storage[1];
-    srcRows[2] = storage[2];
+    /*  Each source row is copied between two zeros on each side, so that the
+        pixels around every dst pixel can be read without testing for the edges:
+        dst pixel x (-1 <= x <= w) looks at storage[x + 1 .. x + 3].
+        Rows above and below the source are all zeros.
+     */
+    const int storageWidth = w + 4;
+    SkAutoMalloc storage(4 * storageWidth);
+    uint8_t* zeroRow = (uint8_t*)storage.get();
+    uint8_t* rowStorage[3] = {
+        zeroRow + storageWidth, zeroRow + 2 * storageWidth,
+        zeroRow + 3 * storageWidth
+    };
+    memset(zeroRow, 0, 4 * storageWidth);
 
     unsigned scale = fPercent256;
-    
+    uint8_t* srcRows[3];
+    // the rows around dst row -1 are source rows -2, -1 and 0
+    srcRows[0] = zeroRow;
+    srcRows[1] = zeroRow;
+    srcRows[2] = h > 0 ? rowStorage[0] : zeroRow;
+    if (h > 0) {
+        memcpy(rowStorage[0] + 2, srcImage, w);
+    }
+
     for (int y = -1; y <= h; y++) {
-        uint8_t* dstRow = dstImage;
-        for (int x = -1; x <= w; x++) {
-            memset(storage, 0, sizeof(storage));
-            uint8_t* storagePtr = &storage[0][0];
-
-            for (int ky = y - 1; ky <= y + 1; ky++) {
-                const uint8_t* srcRow = srcImage + ky * srcRB;  // may be out-of-range
-                for (int kx = x - 1; kx <= x + 1; kx++) {
-                    if ((unsigned)ky < (unsigned)h && (unsigned)kx < (unsigned)w) {
-                        *storagePtr = srcRow[kx];
-                    }
-                    storagePtr++;
-                }
-            }            
-            int value = this->computeValue(srcRows);
-            
-            if (scale < 256) {
-                value = SkAlphaBlend(value, srcRows[1][1], scale);
+        this->computeRow(srcRows, dstWidth, dstImage);
+
+        if (scale < 256) {
+            const uint8_t* center = srcRows[1] + 1;
+            for (int x = 0; x < dstWidth; x++) {
+                dstImage[x] = SkToU8(SkAlphaBlend(dstImage[x], center[x], scale));
             }
-            *dstRow++ = SkToU8(value);
         }
+        memset(dstImage + dstWidth, 0, dst->fRowBytes - dstWidth);
         dstImage += dst->fRowBytes;
+
+        // slide down a row, bringing in source row y + 2
+        int next = y + 2;
+        uint8_t* nextRow = zeroRow;
+        if (next < h) {
+            nextRow = rowStorage[next % 3];
+            memcpy(nextRow + 2, srcImage + next * srcRB, w);
+        }
+        srcRows[0] = srcRows[1];
+        srcRows[1] = srcRows[2];
+        srcRows[2] = nextRow;
     }
     return true;
 }
 
+void SkKernel33ProcMaskFilter::computeRow(uint8_t* const* srcRows, int count,
+                                          uint8_t dst[]) {
+    uint8_t* rows[3] = { srcRows[0], srcRows[1], srcRows[2] };
+    for (int x = 0; x < count; x++) {
+        dst[x] = this->computeValue(rows);
+        rows[0] += 1;
+        rows[1] += 1;
+        rows[2] += 1;
+    }
+}
+
 void SkKernel33ProcMaskFilter::flatten(SkFlattenableWriteBuffer& wb) {
     this->INHERITED::flatten(wb);
     wb.write32(fPercent256);
@@ -97,6 +126,47 @@ uint8_t SkKernel33MaskFilter::computeValue(uint8_t* const* srcRows) {
     return (uint8_t)value;
 }
 
+void SkKernel33MaskFilter::computeRow(uint8_t* const* srcRows, int count,
+                                      uint8_t dst[]) {
+    SkMaskFilterProcs::Kernel33RowProc proc =
+            SkMaskFilterProcs::GetKernel33RowProc();
+    if (proc && (unsigned)fShift < 32) {
+        int16_t kernel[9];
+        bool fits = true;
+        for (int i = 0; i < 9; i++) {
+            int k = fKernel[i / 3][i % 3];
+            kernel[i] = (int16_t)k;
+            fits &= (kernel[i] == k);
+        }
+        if (fits) {
+            proc(srcRows, kernel, fShift, count, dst);
+            return;
+        }
+    }
+
+    const uint8_t* r0 = srcRows[0];
+    const uint8_t* r1 = srcRows[1];
+    const uint8_t* r2 = srcRows[2];
+    const int k00 = fKernel[0][0], k01 = fKernel[0][1], k02 = fKernel[0][2];
+    const int k10 = fKernel[1][0], k11 = fKernel[1][1], k12 = fKernel[1][2];
+    const int k20 = fKernel[2][0], k21 = fKernel[2][1], k22 = fKernel[2][2];
+    const int shift = fShift;
+
+    for (int x = 0; x < count; x++) {
+        int value = k00 * r0[x] + k01 * r0[x + 1] + k02 * r0[x + 2] +
+                    k10 * r1[x] + k11 * r1[x + 1] + k12 * r1[x + 2] +
+                    k20 * r2[x] + k21 * r2[x + 1] + k22 * r2[x + 2];
+        value >>= shift;
+
+        if (value < 0) {
+            value = 0;
+        } else if (value > 255) {
+            value = 255;
+        }
+        dst[x] = (uint8_t)value;
+    }
+}
+
 void SkKernel33MaskFilter::flatten(SkFlattenableWriteBuffer& wb) {
     this->INHERITED::flatten(wb);
     wb.writeMul4(fKernel, 9 * sizeof(int));
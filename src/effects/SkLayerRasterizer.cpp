@@ -17,12 +17,16 @@
 
 #include "SkLayerRasterizer.h"
 #include "SkBuffer.h"
+#include "SkColorPriv.h"
 #include "SkDraw.h"
 #include "SkMask.h"
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRegion.h"
+#include "SkScan.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
 #include "SkXfermode.h"
 #include <new>
 
@@ -51,24 +55,132 @@ void SkLayerRasterizer::addLayer(const SkPaint& paint, SkScalar dx,
     rec->fOffset.set(dx, dy);
 }
 
-static bool compute_bounds(const SkDeque& layers, const SkPath& path,
+// Layers that differ only in their offset (by whole device pixels), alpha or
+// color rasterize to the same coverage, so each group of them renders one
+// mask that is then composited, shifted, once per layer.
+
+struct SkLayerRasterizer_Layer {
+    const SkLayerRasterizer_Rec* fRec;
+    const SkPath*   fPath;      // the fill path, or NULL if there's nothing to fill
+    int             fShare;     // the layer whose coverage we use, or -1 to draw ourselves
+    SkIPoint        fDelta;     // our device offset from the fShare layer
+};
+
+// Can this layer's coverage be rendered on its own and composited like a mask
+// filter's output would be, rather than drawn straight into the layers?
+static bool can_share_coverage(const SkPaint& paint, const SkMatrix& matrix) {
+    if (!paint.isAntiAlias() || paint.getShader() || paint.getXfermode() ||
+            paint.getRasterizer() || matrix.hasPerspective()) {
+        return false;
+    }
+    // k3D filters are drawn through a shader
+    if (paint.getMaskFilter() &&
+            paint.getMaskFilter()->getFormat() != SkMask::kA8_Format) {
+        return false;
+    }
+    // hairlines, and strokes thin enough for drawPath to turn into hairlines
+    if (SkPaint::kStroke_Style == paint.getStyle() &&
+            matrix.mapRadius(paint.getStrokeWidth()) < SK_Scalar1) {
+        return false;
+    }
+    return true;
+}
+
+static bool same_coverage(const SkPaint& a, const SkPaint& b) {
+    return a.getStyle() == b.getStyle() &&
+           a.getPathEffect() == b.getPathEffect() &&
+           a.getMaskFilter() == b.getMaskFilter() &&
+           (SkPaint::kFill_Style == a.getStyle() ||
+            (a.getStrokeWidth() == b.getStrokeWidth() &&
+             a.getStrokeMiter() == b.getStrokeMiter() &&
+             a.getStrokeCap() == b.getStrokeCap() &&
+             a.getStrokeJoin() == b.getStrokeJoin()));
+}
+
+static bool device_delta(const SkMatrix& matrix, const SkVector& from,
+                         const SkVector& to, SkIPoint* delta) {
+    SkVector v;
+    v.set(to.fX - from.fX, to.fY - from.fY);
+    matrix.mapVectors(&v, 1);
+    int dx = SkScalarRound(v.fX);
+    int dy = SkScalarRound(v.fY);
+    if (SkIntToScalar(dx) != v.fX || SkIntToScalar(dy) != v.fY) {
+        return false;
+    }
+    delta->set(dx, dy);
+    return true;
+}
+
+static int build_layers(const SkDeque& recs, const SkPath& path,
+                        const SkMatrix& matrix, SkLayerRasterizer_Layer layers[],
+                        SkPath fillPaths[]) {
+    SkDeque::F2BIter                iter(recs);
+    const SkLayerRasterizer_Rec*    rec;
+    bool                            canShare = !path.isInverseFillType();
+    int                             count = 0;
+
+    while ((rec = (const SkLayerRasterizer_Rec*)iter.next()) != NULL) {
+        SkLayerRasterizer_Layer& layer = layers[count];
+        const SkPaint& paint = rec->fPaint;
+
+        layer.fRec = rec;
+        layer.fShare = -1;
+        layer.fDelta.set(0, 0);
+        if (canShare && can_share_coverage(paint, matrix)) {
+            for (int i = 0; i < count; i++) {
+                if (layers[i].fShare == i &&
+                        same_coverage(layers[i].fRec->fPaint, paint) &&
+                        device_delta(matrix, layers[i].fRec->fOffset,
+                                     rec->fOffset, &layer.fDelta)) {
+                    layer.fShare = i;
+                    break;
+                }
+            }
+            if (layer.fShare < 0) {
+                layer.fShare = count;
+            }
+        }
+
+        if (layer.fShare >= 0 && layer.fShare < count) {
+            layer.fPath = layers[layer.fShare].fPath;
+        } else {
+            layer.fPath = &path;
+            if (paint.getPathEffect() || paint.getStyle() != SkPaint::kFill_Style) {
+                paint.getFillPath(path, &fillPaths[count]);
+                layer.fPath = &fillPaths[count];
+            }
+            if (layer.fPath->isEmpty()) {
+                layer.fPath = NULL;
+            }
+        }
+        count += 1;
+    }
+
+    // coverage no other layer shares is cheaper to draw straight into the dst
+    for (int i = 0; i < count; i++) {
+        if (layers[i].fShare == i) {
+            bool shared = false;
+            for (int j = i + 1; j < count && !shared; j++) {
+                shared = layers[j].fShare == i;
+            }
+            if (!shared) {
+                layers[i].fShare = -1;
+            }
+        }
+    }
+    return count;
+}
+
+static bool compute_bounds(const SkLayerRasterizer_Layer layers[], int count,
                            const SkMatrix& matrix,
                            const SkIRect* clipBounds, SkIRect* bounds) {
-    SkDeque::F2BIter        iter(layers);
-    SkLayerRasterizer_Rec*  rec;
-
     bounds->set(SK_MaxS32, SK_MaxS32, SK_MinS32, SK_MinS32);
 
-    while ((rec = (SkLayerRasterizer_Rec*)iter.next()) != NULL) {
-        const SkPaint&  paint = rec->fPaint;
-        SkPath          fillPath, devPath;
-        const SkPath*   p = &path;
+    for (int i = 0; i < count; i++) {
+        const SkLayerRasterizer_Rec* rec = layers[i].fRec;
+        SkPath devPath;
 
-        if (paint.getPathEffect() || paint.getStyle() != SkPaint::kFill_Style) {
-            paint.getFillPath(path, &fillPath);
-            p = &fillPath;
-        }
-        if (p->isEmpty()) {
+        if (NULL == layers[i].fPath) {
             continue;
         }
 
@@ -76,11 +188,11 @@ static bool compute_bounds(const SkDeque& layers, const SkPath& path,
         {
             SkMatrix m = matrix;
             m.preTranslate(rec->fOffset.fX, rec->fOffset.fY);
-            p->transform(m, &devPath);
+            layers[i].fPath->transform(m, &devPath);
         }
 
         SkMask  mask;
-        if (!SkDraw::DrawToMask(devPath, clipBounds, paint.getMaskFilter(),
+        if (!SkDraw::DrawToMask(devPath, clipBounds, rec->fPaint.getMaskFilter(),
                                 &matrix, &mask,
                                 SkMask::kJustComputeBounds_CreateMode)) {
             return false;
@@ -91,6 +203,116 @@ static bool compute_bounds(const SkDeque& layers, const SkPath& path,
     return true;
 }
 
+// Render the coverage of the layers that share layers[index]'s, clipped to
+// what any of them can see of dstBounds. Returns false if the layers have to
+// be drawn one by one instead. blitsMask says whether drawPath would have
+// blitted each of those layers as a mask, rather than through blitAntiH.
+static bool render_coverage(const SkLayerRasterizer_Layer layers[], int count,
+                            int index, const SkMatrix& matrix,
+                            const SkIRect& dstBounds, SkMask* coverage,
+                            bool* blitsMask) {
+    const SkLayerRasterizer_Rec* rec = layers[index].fRec;
+    SkMaskFilter* filter = rec->fPaint.getMaskFilter();
+    SkIRect clip;
+
+    clip.setEmpty();
+    for (int i = index; i < count; i++) {
+        if (layers[i].fShare == index) {
+            SkIRect r = dstBounds;
+            r.offset(-layers[i].fDelta.fX, -layers[i].fDelta.fY);
+            clip.join(r);
+        }
+    }
+
+    SkMatrix m = matrix;
+    m.preTranslate(rec->fOffset.fX, rec->fOffset.fY);
+    SkPath devPath;
+    layers[index].fPath->transform(m, &devPath);
+
+    SkIRect ir;
+    devPath.getBounds().roundOut(&ir);
+    *blitsMask = filter || SkScan::AntiFillPathBlitsMask(ir);
+
+    SkMask srcM;
+    if (!SkDraw::DrawToMask(devPath, &clip, filter, &m, &srcM,
+                            SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
+        return false;
+    }
+    if (NULL == filter) {
+        *coverage = srcM;
+        return true;
+    }
+
+    SkAutoMaskImage autoSrc(&srcM, false);
+    coverage->fImage = NULL;
+    if (!filter->filterMask(coverage, srcM, m, NULL)) {
+        return false;
+    }
+    if (SkMask::kA8_Format != coverage->fFormat) {
+        SkMask::FreeImage(coverage->fImage);
+        return false;
+    }
+    return true;
+}
+
+struct SkLayerRasterizer_Composite {
+    const SkMask*   fCoverage;
+    SkIRect         fBounds;    // where fCoverage lands in the dst, clipped to it
+    SkIPoint        fDelta;
+    unsigned        fAlpha;
+    bool            fBlitsMask;
+};
+
+// Same math as SkA8_Blitter::blitMask, or as its blitAntiH, which scales the
+// dst by 256 - sa rather than 256 - SkAlpha255To256(sa). Matching whichever
+// one drawPath would have used keeps our output exactly what it used to be.
+static void composite_row(uint8_t dst[], const uint8_t alpha[], int count,
+                          unsigned srcA, bool blitsMask) {
+    for (int i = 0; i < count; i++) {
+        unsigned aa = alpha[i];
+        if (0 == aa) {
+            continue;
+        }
+        if (255 == aa && 255 == srcA) {
+            dst[i] = 0xFF;
+            continue;
+        }
+        unsigned sa = SkAlphaMul(srcA, SkAlpha255To256(aa));
+        unsigned scale = blitsMask ? 256 - SkAlpha255To256(sa) : 256 - sa;
+        dst[i] = SkToU8(sa + SkAlphaMul(dst[i], scale));
+    }
+}
+
+// Blend every pending layer into the dst in a single pass over its rows,
+// keeping each row in cache while all of the layers touching it are applied.
+static void composite_layers(const SkMask& dst,
+                             const SkLayerRasterizer_Composite pending[],
+                             int count) {
+    if (0 == count) {
+        return;
+    }
+    SkIRect bounds = pending[0].fBounds;
+    for (int i = 1; i < count; i++) {
+        bounds.join(pending[i].fBounds);
+    }
+
+    for (int y = bounds.fTop; y < bounds.fBottom; y++) {
+        uint8_t* row = dst.fImage + (y - dst.fBounds.fTop) * dst.fRowBytes;
+        for (int i = 0; i < count; i++) {
+            const SkLayerRasterizer_Composite& c = pending[i];
+            if (y < c.fBounds.fTop || y >= c.fBounds.fBottom) {
+                continue;
+            }
+            const SkMask& src = *c.fCoverage;
+            const uint8_t* alpha = src.fImage +
+                        (y - c.fDelta.fY - src.fBounds.fTop) * src.fRowBytes +
+                        (c.fBounds.fLeft - c.fDelta.fX - src.fBounds.fLeft);
+            composite_row(row + c.fBounds.fLeft - dst.fBounds.fLeft, alpha,
+                          c.fBounds.width(), c.fAlpha, c.fBlitsMask);
+        }
+    }
+}
+
 bool SkLayerRasterizer::onRasterize(const SkPath& path, const SkMatrix& matrix,
                                     const SkIRect* clipBounds,
                                     SkMask* mask, SkMask::CreateMode mode) {
@@ -98,8 +320,15 @@ bool SkLayerRasterizer::onRasterize(const SkPath& path, const SkMatrix& matrix,
         return false;
     }
 
+    int count = fLayers.count();
+    SkAutoSTArray<8, SkLayerRasterizer_Layer> layerStorage(count);
+    SkAutoSTArray<8, SkPath> fillPaths(count);
+    SkLayerRasterizer_Layer* layers = layerStorage.get();
+
+    build_layers(fLayers, path, matrix, layers, fillPaths.get());
+
     if (SkMask::kJustRenderImage_CreateMode != mode) {
-        if (!compute_bounds(fLayers, path, matrix, clipBounds, &mask->fBounds))
+        if (!compute_bounds(layers, count, matrix, clipBounds, &mask->fBounds))
             return false;
     }
 
@@ -136,13 +365,60 @@ bool SkLayerRasterizer::onRasterize(const SkPath& path, const SkMatrix& matrix,
         // we set the matrixproc in the loop, as the matrix changes each time (potentially)
         draw.fBounder   = NULL;
 
-        SkDeque::F2BIter        iter(fLayers);
-        SkLayerRasterizer_Rec*  rec;
+        // coverage[i] is rendered the first time a layer sharing layer i's
+        // coverage is reached; a NULL fImage after that means it failed
+        SkAutoSTArray<8, SkMask> coverage(count);
+        SkAutoSTArray<8, bool> rendered(count);
+        SkAutoSTArray<8, bool> blitsMask(count);
+        SkTDArray<SkLayerRasterizer_Composite> pending;
+
+        for (int i = 0; i < count; i++) {
+            const SkLayerRasterizer_Layer& layer = layers[i];
+            const SkPaint& paint = layer.fRec->fPaint;
+            rendered[i] = false;
+            coverage[i].fImage = NULL;
+
+            if (NULL == layer.fPath ||
+                    (0 == paint.getAlpha() && NULL == paint.getXfermode())) {
+                continue;   // drawPath would draw nothing
+            }
+
+            int share = layer.fShare;
+            if (share >= 0 && !rendered[share]) {
+                rendered[share] = true;
+                if (!render_coverage(layers, count, share, matrix,
+                                     mask->fBounds, &coverage[share],
+                                     &blitsMask[share])) {
+                    coverage[share].fImage = NULL;
+                }
+            }
+
+            if (share >= 0 && coverage[share].fImage) {
+                SkLayerRasterizer_Composite* c = pending.append();
+                c->fCoverage = &coverage[share];
+                c->fBounds = coverage[share].fBounds;
+                c->fBounds.offset(layer.fDelta.fX, layer.fDelta.fY);
+                c->fDelta = layer.fDelta;
+                c->fAlpha = paint.getAlpha();
+                c->fBlitsMask = blitsMask[share];
+                if (!c->fBounds.intersect(mask->fBounds)) {
+                    pending.pop();
+                }
+            } else {
+                // layers must land in order, so catch up before drawing
+                composite_layers(*mask, pending.begin(), pending.count());
+                pending.reset();
+
+                drawMatrix = translatedMatrix;
+                drawMatrix.preTranslate(layer.fRec->fOffset.fX,
+                                        layer.fRec->fOffset.fY);
+                draw.drawPath(path, paint);
+            }
+        }
+        composite_layers(*mask, pending.begin(), pending.count());
 
-        while ((rec = (SkLayerRasterizer_Rec*)iter.next()) != NULL) {
-            drawMatrix = translatedMatrix;
-            drawMatrix.preTranslate(rec->fOffset.fX, rec->fOffset.fY);
-            draw.drawPath(path, rec->fPaint);
+        for (int i = 0; i < count; i++) {
+            SkMask::FreeImage(coverage[i].fImage);
         }
     }
     return true;
@@ -32,6 +32,35 @@ void SkTableMaskFilter::setTable(const uint8_t table[256]) {
     memcpy(fTable, table, 256);
 }
 
+/*  Masks are mostly runs of 0, which most tables leave alone, so when ours
+    does, those runs are skipped four pixels at a time. The rest are looked up
+    four at a time too.
+ */
+static void map_row(const uint8_t table[256], const uint8_t src[], int count,
+                    uint8_t dst[]) {
+    int x = 0;
+    const bool skipZeros = (0 == table[0]);
+    for (; x + 4 <= count; x += 4) {
+        uint32_t four;
+        memcpy(&four, src + x, 4);
+        if (skipZeros && 0 == four) {
+            memset(dst + x, 0, 4);
+        } else {
+            uint8_t a = table[src[x]];
+            uint8_t b = table[src[x + 1]];
+            uint8_t c = table[src[x + 2]];
+            uint8_t d = table[src[x + 3]];
+            dst[x] = a;
+            dst[x + 1] = b;
+            dst[x + 2] = c;
+            dst[x + 3] = d;
+        }
+    }
+    for (; x < count; x++) {
+        dst[x] = table[src[x]];
+    }
+}
+
 bool SkTableMaskFilter::filterMask(SkMask* dst, const SkMask& src,
                                  const SkMatrix&, SkIPoint* margin) {
     if (src.fFormat != SkMask::kA8_Format) {
@@ -53,9 +82,7 @@ bool SkTableMaskFilter::filterMask(SkMask* dst, const SkMask& src,
         int extraZeros = dst->fRowBytes - dstWidth;
         
         for (int y = dst->fBounds.height() - 1; y >= 0; --y) {
-            for (int x = dstWidth - 1; x >= 0; --x) {
-                dstP[x] = table[srcP[x]];
-            }
+            map_row(table, srcP, dstWidth, dstP);
             srcP += src.fRowBytes;
             // we can't just inc dstP by rowbytes, because if it has any
             // padding between its width and its rowbytes, we need to zero those
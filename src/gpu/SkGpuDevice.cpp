@@ -843,6 +843,13 @@ void SkGpuDevice::drawRect(const SkDraw& draw, const SkRect& rect,
     fContext->drawRect(grPaint, rect, doStroke ? width : -1);
 }
 
+void SkGpuDevice::drawRects(const SkDraw& draw, const SkRect rects[],
+                            size_t count, const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawRect(draw, rects[i], paint);
+    }
+}
+
 #include "SkMaskFilter.h"
 #include "SkBounder.h"
 
@@ -1242,6 +1249,14 @@ void SkGpuDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
                              GrRect::MakeWH(GR_Scalar1, GR_Scalar1));
 }
 
+void SkGpuDevice::drawSprites(const SkDraw& draw, const SkBitmap& bitmap,
+                              const SkIPoint pts[], size_t count,
+                              const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawSprite(draw, bitmap, pts[i].fX, pts[i].fY, paint);
+    }
+}
+
 void SkGpuDevice::drawDevice(const SkDraw& draw, SkDevice* dev,
                             int x, int y, const SkPaint& paint) {
     CHECK_SHOULD_DRAW(draw);
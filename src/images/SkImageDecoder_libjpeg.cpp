@@ -21,7 +21,9 @@
 #include "SkDither.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
+#include "SkThread.h"
 #include "SkUtils.h"
 
 #include <stdio.h>
@@ -163,7 +165,7 @@ bool SkJPEGImageDecoder::onDecode(SkStream* stream, SkBitmap* bm, Mode mode) {
 
     jpeg_decompress_struct  cinfo;
     skjpeg_error_mgr        sk_err;
-    skjpeg_source_mgr       sk_stream(stream, this);
+    skjpeg_source_mgr       sk_stream(stream, this, false);
 
     cinfo.err = jpeg_std_error(&sk_err);
     sk_err.error_exit = skjpeg_error_exit;
@@ -550,6 +552,215 @@ static WriteScanline ChooseWriter(const SkBitmap& bm) {
     }
 }
 
+/*  Compresses rows [top, bottom) of bm into stream as a complete JPEG. With
+    restartEachRow, a restart marker separates each row of MCUs, which lets
+    separately encoded bands be stitched into one image (see stitch_bands).
+ */
+static bool encode_rows(SkWStream* stream, const SkBitmap& bm,
+                        WriteScanline writer, const SkPMColor* colors,
+                        int quality, int top, int bottom, bool restartEachRow) {
+    jpeg_compress_struct    cinfo;
+    skjpeg_error_mgr        sk_err;
+    skjpeg_destination_mgr  sk_wstream(stream);
+
+    // allocate these before set call setjmp
+    SkAutoMalloc    oneRow;
+
+    cinfo.err = jpeg_std_error(&sk_err);
+    sk_err.error_exit = skjpeg_error_exit;
+    if (setjmp(sk_err.fJmpBuf)) {
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+
+    cinfo.dest = &sk_wstream;
+    cinfo.image_width = bm.width();
+    cinfo.image_height = bottom - top;
+    cinfo.input_components = 3;
+#ifdef WE_CONVERT_TO_YUV
+    cinfo.in_color_space = JCS_YCbCr;
+#else
+    cinfo.in_color_space = JCS_RGB;
+#endif
+    cinfo.input_gamma = 1;
+
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
+    cinfo.dct_method = JDCT_IFAST;
+    if (restartEachRow) {
+        cinfo.restart_in_rows = 1;
+    }
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    const int       width = bm.width();
+    uint8_t*        oneRowP = (uint8_t*)oneRow.alloc(width * 3);
+
+    const void*      srcRow = (const char*)bm.getPixels() + top * bm.rowBytes();
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
+
+        writer(oneRowP, srcRow, width, colors);
+        row_pointer[0] = oneRowP;
+        (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
+        srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
+    }
+
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    return true;
+}
+
+/*  Returns the offset of the entropy-coded data that follows the SOS segment,
+    or 0 if there isn't any. heightOffset is set to the offset of the frame
+    height in the SOF segment.
+ */
+static size_t find_scan_data(const uint8_t data[], size_t size,
+                             size_t* heightOffset) {
+    size_t offset = 2;  // skip SOI
+    while (offset + 4 <= size && 0xFF == data[offset]) {
+        const int marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (marker >= 0xC0 && marker <= 0xC2) {
+            *heightOffset = offset + 5;
+        }
+        offset += 2 + length;
+        if (0xDA == marker) {
+            return offset <= size ? offset : 0;
+        }
+    }
+    return 0;
+}
+
+static const uint8_t gEOI[] = { 0xFF, 0xD9 };
+
+namespace {
+
+struct JPEGBand {
+    uint8_t*    fData;          // a complete JPEG of this band's rows
+    size_t      fSize;
+    size_t      fScanStart;     // offset of the entropy-coded data
+    size_t      fHeightOffset;  // offset of the SOF segment's height
+    bool        fSuccess;
+};
+
+struct JPEGBandRec {
+    ~JPEGBandRec() {
+        for (int i = 0; i < fBands.count(); i++) {
+            sk_free(fBands[i].fData);
+        }
+    }
+
+    const SkBitmap*     fBitmap;
+    WriteScanline       fWriter;
+    const SkPMColor*    fColors;
+    int                 fQuality;
+    int                 fBandHeight;
+    SkTDArray<JPEGBand> fBands;
+};
+
+}
+
+static void encode_band_proc(void* context, int index) {
+    const JPEGBandRec* rec = (const JPEGBandRec*)context;
+    const int top = index * rec->fBandHeight;
+    const int bottom = SkMin32(top + rec->fBandHeight, rec->fBitmap->height());
+    JPEGBand* band = &rec->fBands[index];
+
+    SkDynamicMemoryWStream stream;
+    if (!encode_rows(&stream, *rec->fBitmap, rec->fWriter, rec->fColors,
+                     rec->fQuality, top, bottom, true)) {
+        return;
+    }
+    band->fSize = stream.getOffset();
+    band->fData = (uint8_t*)sk_malloc_throw(band->fSize);
+    stream.copyTo(band->fData);
+
+    band->fScanStart = find_scan_data(band->fData, band->fSize,
+                                      &band->fHeightOffset);
+    band->fSuccess = band->fScanStart > 0 && band->fHeightOffset > 0 &&
+            band->fScanStart + sizeof(gEOI) <= band->fSize &&
+            !memcmp(band->fData + band->fSize - sizeof(gEOI), gEOI,
+                    sizeof(gEOI));
+}
+
+/*  Encodes the image as bands of rows on up to threadCount threads (see
+    SkImageEncoder::setThreadCount), each a complete JPEG with a restart
+    interval of one row of MCUs. Returns false if the image should be encoded
+    serially instead, i.e. it is too small to split or a band failed.
+ */
+static bool encode_in_bands(JPEGBandRec* rec, const SkBitmap& bm,
+                            WriteScanline writer, const SkPMColor* colors,
+                            int quality, int threadCount) {
+    enum {
+        // the tallest MCU jpeg_set_defaults() gives us (2x2 chroma sampling)
+        kMCUHeight = 16
+    };
+
+    const int mcuRows = (bm.height() + kMCUHeight - 1) / kMCUHeight;
+    int count = SkMin32(threadCount, mcuRows);
+    if (count < 2) {
+        return false;
+    }
+
+    rec->fBitmap = &bm;
+    rec->fWriter = writer;
+    rec->fColors = colors;
+    rec->fQuality = quality;
+    rec->fBandHeight = (mcuRows + count - 1) / count * kMCUHeight;
+    count = (bm.height() + rec->fBandHeight - 1) / rec->fBandHeight;
+    memset(rec->fBands.append(count), 0, count * sizeof(JPEGBand));
+    sk_parallel_for(encode_band_proc, rec, count);
+
+    for (int i = 0; i < count; i++) {
+        if (!rec->fBands[i].fSuccess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*  Writes the bands as a single JPEG: the headers of the first (with the full
+    height), then each band's scan data, separated by restart markers. Every
+    band starts a new restart interval, so no DC prediction crosses a band,
+    but the markers' numbers must run on from one band to the next.
+ */
+static bool stitch_bands(SkWStream* stream, const SkBitmap& bm,
+                         const JPEGBandRec& rec) {
+    int restart = 0;
+    for (int i = 0; i < rec.fBands.count(); i++) {
+        const JPEGBand& band = rec.fBands[i];
+        uint8_t* data = band.fData;
+        const size_t end = band.fSize - sizeof(gEOI);
+
+        if (0 == i) {
+            data[band.fHeightOffset] = bm.height() >> 8;
+            data[band.fHeightOffset + 1] = bm.height() & 0xFF;
+        } else {
+            const uint8_t marker[] = { 0xFF, SkToU8(0xD0 + (restart++ & 7)) };
+            if (!stream->write(marker, sizeof(marker))) {
+                return false;
+            }
+        }
+
+        for (size_t j = band.fScanStart; j + 1 < end; j++) {
+            // stuffed 0xFF bytes are followed by 0, so can't be mistaken
+            if (0xFF == data[j] && (data[j + 1] & 0xF8) == 0xD0) {
+                data[j + 1] = 0xD0 + (restart++ & 7);
+                j += 1;
+            }
+        }
+
+        const size_t start = 0 == i ? 0 : band.fScanStart;
+        if (!stream->write(data + start, end - start)) {
+            return false;
+        }
+    }
+    return stream->write(gEOI, sizeof(gEOI));
+}
+
 class SkJPEGImageEncoder : public SkImageEncoder {
 protected:
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
@@ -567,57 +778,16 @@ protected:
             return false;
         }
 
-        jpeg_compress_struct    cinfo;
-        skjpeg_error_mgr        sk_err;
-        skjpeg_destination_mgr  sk_wstream(stream);
-
-        // allocate these before set call setjmp
-        SkAutoMalloc    oneRow;
         SkAutoLockColors ctLocker;
-
-        cinfo.err = jpeg_std_error(&sk_err);
-        sk_err.error_exit = skjpeg_error_exit;
-        if (setjmp(sk_err.fJmpBuf)) {
-            return false;
-        }
-        jpeg_create_compress(&cinfo);
-
-        cinfo.dest = &sk_wstream;
-        cinfo.image_width = bm.width();
-        cinfo.image_height = bm.height();
-        cinfo.input_components = 3;
-#ifdef WE_CONVERT_TO_YUV
-        cinfo.in_color_space = JCS_YCbCr;
-#else
-        cinfo.in_color_space = JCS_RGB;
-#endif
-        cinfo.input_gamma = 1;
-
-        jpeg_set_defaults(&cinfo);
-        jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
-        cinfo.dct_method = JDCT_IFAST;
-
-        jpeg_start_compress(&cinfo, TRUE);
-
-        const int       width = bm.width();
-        uint8_t*        oneRowP = (uint8_t*)oneRow.alloc(width * 3);
-
         const SkPMColor* colors = ctLocker.lockColors(bm);
-        const void*      srcRow = bm.getPixels();
-
-        while (cinfo.next_scanline < cinfo.image_height) {
-            JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
 
-            writer(oneRowP, srcRow, width, colors);
-            row_pointer[0] = oneRowP;
-            (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
-            srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
+        JPEGBandRec bands;
+        if (encode_in_bands(&bands, bm, writer, colors, quality,
+                            this->getThreadCount())) {
+            return stitch_bands(stream, bm, bands);
         }
-
-        jpeg_finish_compress(&cinfo);
-        jpeg_destroy_compress(&cinfo);
-
-        return true;
+        return encode_rows(stream, bm, writer, colors, quality, 0, bm.height(),
+                           false);
     }
 };
 
@@ -626,7 +796,7 @@ protected:
 #include "SkTRegistry.h"
 
 static SkImageDecoder* DFactory(SkStream* stream) {
-    static const char gHeader[] = { 0xFF, 0xD8, 0xFF };
+    static const uint8_t gHeader[] = { 0xFF, 0xD8, 0xFF };
     static const size_t HEADER_SIZE = sizeof(gHeader);
 
     char buffer[HEADER_SIZE];
@@ -23,11 +23,14 @@
 #include "SkMath.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
+#include "SkThread.h"
 #include "SkUtils.h"
 
 extern "C" {
 #include "png.h"
+#include "zlib.h"
 }
 
 class SkPNGImageDecoder : public SkImageDecoder {
@@ -707,6 +710,261 @@ static inline int pack_palette(SkColorTable* ctable,
     return num_trans;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+static inline int paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = SkAbs32(p - a);
+    int pb = SkAbs32(p - b);
+    int pc = SkAbs32(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// sum of the bytes taken as signed values, the cost libpng's filter heuristic
+// minimizes
+static int filter_cost(const uint8_t* SK_RESTRICT row, int rowBytes) {
+    int sum = 0;
+    for (int i = 0; i < rowBytes; i++) {
+        sum += row[i] < 128 ? row[i] : 256 - row[i];
+    }
+    return sum;
+}
+
+/*  Writes the filter type byte followed by the filtered row into dst, picking
+    the filter with the smallest cost. prev is the unfiltered previous row (all
+    zeros for the first row), and scratch holds 4 * rowBytes.
+ */
+static void filter_row(const uint8_t* SK_RESTRICT row,
+                       const uint8_t* SK_RESTRICT prev, int rowBytes, int bpp,
+                       uint8_t* SK_RESTRICT scratch, uint8_t* SK_RESTRICT dst) {
+    uint8_t* sub = scratch;
+    uint8_t* up = sub + rowBytes;
+    uint8_t* avg = up + rowBytes;
+    uint8_t* pae = avg + rowBytes;
+
+    for (int i = 0; i < rowBytes; i++) {
+        int a = i >= bpp ? row[i - bpp] : 0;
+        int b = prev[i];
+        int c = i >= bpp ? prev[i - bpp] : 0;
+        sub[i] = row[i] - a;
+        up[i] = row[i] - b;
+        avg[i] = row[i] - ((a + b) >> 1);
+        pae[i] = row[i] - paeth_predictor(a, b, c);
+    }
+
+    const uint8_t* best = row;
+    int bestType = PNG_FILTER_VALUE_NONE;
+    int bestCost = filter_cost(row, rowBytes);
+    const uint8_t* filtered[] = { sub, up, avg, pae };
+    for (int f = 0; f < 4; f++) {
+        int cost = filter_cost(filtered[f], rowBytes);
+        if (cost < bestCost) {
+            best = filtered[f];
+            bestType = PNG_FILTER_VALUE_SUB + f;
+            bestCost = cost;
+        }
+    }
+    dst[0] = bestType;
+    memcpy(dst + 1, best, rowBytes);
+}
+
+namespace {
+
+struct PNGBand {
+    uint8_t*    fData;      // this band's raw deflate data
+    size_t      fCapacity;
+    size_t      fSize;
+    uLong       fAdler;     // adler32 of this band's filtered rows
+    size_t      fLength;    // size of this band's filtered rows
+    bool        fSuccess;
+};
+
+struct PNGBandRec {
+    const SkBitmap*         fBitmap;
+    transform_scanline_proc fProc;
+    int                     fBytesPerPixel;
+    bool                    fFilter;    // false for palettes, as libpng does
+    int                     fBandHeight;
+    size_t                  fFilteredRowBytes;  // including the filter type
+    SkAutoMalloc            fFiltered;  // every filtered row of the image
+    SkAutoMalloc            fOutput;    // holds every band's fData
+    SkTDArray<PNGBand>      fBands;
+};
+
+}
+
+static void filter_band_proc(void* context, int index) {
+    const PNGBandRec* rec = (const PNGBandRec*)context;
+    const SkBitmap& bm = *rec->fBitmap;
+    const int top = index * rec->fBandHeight;
+    const int bottom = SkMin32(top + rec->fBandHeight, bm.height());
+    const int rowBytes = rec->fFilteredRowBytes - 1;
+
+    // the transform procs may write up to 4 bytes per pixel
+    const size_t storageRowBytes = bm.width() << 2;
+    SkAutoMalloc storage(2 * storageRowBytes + 4 * rowBytes);
+    uint8_t* prev = (uint8_t*)storage.get();
+    uint8_t* row = prev + storageRowBytes;
+    uint8_t* scratch = row + storageRowBytes;
+
+    const char* src = (const char*)bm.getPixels() + top * bm.rowBytes();
+    if (top > 0) {
+        rec->fProc(src - bm.rowBytes(), bm.width(), (char*)prev);
+    } else {
+        memset(prev, 0, rowBytes);
+    }
+
+    uint8_t* dst = (uint8_t*)rec->fFiltered.get() +
+                   top * rec->fFilteredRowBytes;
+    for (int y = top; y < bottom; y++) {
+        rec->fProc(src, bm.width(), (char*)row);
+        if (rec->fFilter) {
+            filter_row(row, prev, rowBytes, rec->fBytesPerPixel, scratch, dst);
+        } else {
+            dst[0] = PNG_FILTER_VALUE_NONE;
+            memcpy(dst + 1, row, rowBytes);
+        }
+        SkTSwap(prev, row);
+        src += bm.rowBytes();
+        dst += rec->fFilteredRowBytes;
+    }
+}
+
+static void deflate_band_proc(void* context, int index) {
+    enum {
+        kWindowBits = 15,
+        kMaxDictionarySize = 1 << kWindowBits
+    };
+
+    const PNGBandRec* rec = (const PNGBandRec*)context;
+    PNGBand* band = &rec->fBands[index];
+    const bool last = rec->fBands.count() - 1 == index;
+    const size_t offset = index * rec->fBandHeight * rec->fFilteredRowBytes;
+    uint8_t* src = (uint8_t*)rec->fFiltered.get() + offset;
+
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+    // a raw stream: write_bands() adds the zlib header and checksum
+    if (deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -kWindowBits,
+                     8, rec->fFilter ? Z_FILTERED : Z_DEFAULT_STRATEGY) != Z_OK) {
+        return;
+    }
+    // prime the window with the rows before us, so they can still be matched
+    if (offset > 0) {
+        size_t dictSize = offset < kMaxDictionarySize ? offset :
+                                                        kMaxDictionarySize;
+        deflateSetDictionary(&zstream, src - dictSize, dictSize);
+    }
+
+    zstream.next_in = src;
+    zstream.avail_in = band->fLength;
+    zstream.next_out = band->fData;
+    zstream.avail_out = band->fCapacity;
+
+    // all but the last band end byte-aligned (and unfinished), so the raw
+    // streams concatenate into one
+    int result = deflate(&zstream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    band->fSuccess = last ? Z_STREAM_END == result :
+            Z_OK == result && 0 == zstream.avail_in && zstream.avail_out > 0;
+    band->fSize = band->fCapacity - zstream.avail_out;
+    band->fAdler = adler32(adler32(0, NULL, 0), src, band->fLength);
+    deflateEnd(&zstream);
+}
+
+/*  Filters and deflates the image as bands of rows on up to threadCount threads
+    (see SkImageEncoder::setThreadCount). Returns false if the image should be
+    written serially instead, i.e. it is too small to split or a band failed.
+ */
+static bool compress_in_bands(PNGBandRec* rec, const SkBitmap& bm,
+                              transform_scanline_proc proc, int bytesPerPixel,
+                              bool filter, int threadCount) {
+    enum {
+        kMinBandHeight = 32
+    };
+
+    int count = SkMin32(threadCount, bm.height() / kMinBandHeight);
+    if (count < 2) {
+        return false;
+    }
+
+    rec->fBitmap = &bm;
+    rec->fProc = proc;
+    rec->fBytesPerPixel = bytesPerPixel;
+    rec->fFilter = filter;
+    rec->fBandHeight = (bm.height() + count - 1) / count;
+    rec->fFilteredRowBytes = bm.width() * bytesPerPixel + 1;
+    rec->fFiltered.alloc(rec->fFilteredRowBytes * bm.height());
+
+    count = (bm.height() + rec->fBandHeight - 1) / rec->fBandHeight;
+    size_t totalCapacity = 0;
+    for (int i = 0; i < count; i++) {
+        PNGBand* band = rec->fBands.append();
+        int rows = SkMin32(rec->fBandHeight, bm.height() - i * rec->fBandHeight);
+        band->fLength = rows * rec->fFilteredRowBytes;
+        // with room for the sync flush's empty stored block
+        band->fCapacity = compressBound(band->fLength) + 16;
+        band->fSuccess = false;
+        totalCapacity += band->fCapacity;
+    }
+    uint8_t* output = (uint8_t*)rec->fOutput.alloc(totalCapacity);
+    for (int i = 0; i < count; i++) {
+        rec->fBands[i].fData = output;
+        output += rec->fBands[i].fCapacity;
+    }
+
+    // each band's filters look at the row above it, and its deflate at the
+    // 32K of filtered rows before it, so filter everything first
+    sk_parallel_for(filter_band_proc, rec, count);
+    sk_parallel_for(deflate_band_proc, rec, count);
+
+    for (int i = 0; i < count; i++) {
+        if (!rec->fBands[i].fSuccess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes the bands as IDAT chunks that together hold one zlib stream, then IEND
+static void write_bands(png_structp png_ptr, const PNGBandRec& rec) {
+    // a 32K window and the default level, as libpng deflates with
+    static const png_byte gZlibHeader[] = { 0x78, 0x9C };
+
+    const int count = rec.fBands.count();
+    uLong adler = adler32(0, NULL, 0);
+    for (int i = 0; i < count; i++) {
+        adler = adler32_combine(adler, rec.fBands[i].fAdler,
+                                rec.fBands[i].fLength);
+    }
+    png_byte checksum[4];
+    png_save_uint_32(checksum, adler);
+
+    for (int i = 0; i < count; i++) {
+        const PNGBand& band = rec.fBands[i];
+        size_t size = band.fSize;
+        if (0 == i) {
+            size += sizeof(gZlibHeader);
+        }
+        if (count - 1 == i) {
+            size += sizeof(checksum);
+        }
+        png_write_chunk_start(png_ptr, (png_bytep)"IDAT", size);
+        if (0 == i) {
+            png_write_chunk_data(png_ptr, (png_bytep)gZlibHeader,
+                                 sizeof(gZlibHeader));
+        }
+        png_write_chunk_data(png_ptr, band.fData, band.fSize);
+        if (count - 1 == i) {
+            png_write_chunk_data(png_ptr, checksum, sizeof(checksum));
+        }
+        png_write_chunk_end(png_ptr);
+    }
+    png_write_chunk(png_ptr, (png_bytep)"IEND", NULL, 0);
+}
+
 class SkPNGImageEncoder : public SkImageEncoder {
 protected:
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality);
@@ -772,6 +1030,20 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap,
         bitDepth = computeBitDepth(ctable->count());
     }
 
+    transform_scanline_proc proc = choose_proc(config, hasAlpha);
+
+    // compress up front, so nothing is allocated after the setjmp below
+    PNGBandRec bands;
+    bool inBands = false;
+    if (8 == bitDepth) {
+        int bytesPerPixel = 1;
+        if (!(colorType & PNG_COLOR_MASK_PALETTE)) {
+            bytesPerPixel = (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+        }
+        inBands = compress_in_bands(&bands, bitmap, proc, bytesPerPixel,
+                                    1 != bytesPerPixel, this->getThreadCount());
+    }
+
     png_structp png_ptr;
     png_infop info_ptr;
 
@@ -826,20 +1098,23 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap,
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     png_write_info(png_ptr, info_ptr);
 
-    const char* srcImage = (const char*)bitmap.getPixels();
-    SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
-    char* storage = (char*)rowStorage.get();
-    transform_scanline_proc proc = choose_proc(config, hasAlpha);
+    if (inBands) {
+        write_bands(png_ptr, bands);
+    } else {
+        const char* srcImage = (const char*)bitmap.getPixels();
+        SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
+        char* storage = (char*)rowStorage.get();
+
+        for (int y = 0; y < bitmap.height(); y++) {
+            png_bytep row_ptr = (png_bytep)storage;
+            proc(srcImage, bitmap.width(), storage);
+            png_write_rows(png_ptr, &row_ptr, 1);
+            srcImage += bitmap.rowBytes();
+        }
 
-    for (int y = 0; y < bitmap.height(); y++) {
-        png_bytep row_ptr = (png_bytep)storage;
-        proc(srcImage, bitmap.width(), storage);
-        png_write_rows(png_ptr, &row_ptr, 1);
-        srcImage += bitmap.rowBytes();
+        png_write_end(png_ptr, info_ptr);
     }
 
-    png_write_end(png_ptr, info_ptr);
-
     /* clean up after the write, and free any memory allocated */
     png_destroy_write_struct(&png_ptr, &info_ptr);
     return true;
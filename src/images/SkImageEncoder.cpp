@@ -19,8 +19,14 @@
 #include "SkStream.h"
 #include "SkTemplates.h"
 
+SkImageEncoder::SkImageEncoder() : fThreadCount(1) {}
+
 SkImageEncoder::~SkImageEncoder() {}
 
+void SkImageEncoder::setThreadCount(int count) {
+    fThreadCount = SkMax32(count, 1);
+}
+
 bool SkImageEncoder::encodeStream(SkWStream* stream, const SkBitmap& bm,
                                   int quality) {
     quality = SkMin32(100, SkMax32(0, quality));
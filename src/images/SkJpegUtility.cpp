@@ -21,10 +21,15 @@ static void sk_init_source(j_decompress_ptr cinfo) {
     skjpeg_source_mgr*  src = (skjpeg_source_mgr*)cinfo->src;
     src->next_input_byte = (const JOCTET*)src->fBuffer;
     src->bytes_in_buffer = 0;
+#ifdef ANDROID
     src->current_offset = 0;
+#endif
     src->fStream->rewind();
 }
 
+// Android's libjpeg can seek in (and track its offset into) the source, for
+// tile-based decoding; stock libjpeg has no such fields
+#ifdef ANDROID
 static boolean sk_seek_input_data(j_decompress_ptr cinfo, long byte_offset) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*)cinfo->src;
 
@@ -40,6 +45,7 @@ static boolean sk_seek_input_data(j_decompress_ptr cinfo, long byte_offset) {
     src->bytes_in_buffer = 0;
     return TRUE;
 }
+#endif
 
 static boolean sk_fill_input_buffer(j_decompress_ptr cinfo) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*)cinfo->src;
@@ -53,7 +59,9 @@ static boolean sk_fill_input_buffer(j_decompress_ptr cinfo) {
         return FALSE;
     }
 
+#ifdef ANDROID
     src->current_offset += bytes;
+#endif
     src->next_input_byte = (const JOCTET*)src->fBuffer;
     src->bytes_in_buffer = bytes;
     return TRUE;
@@ -71,7 +79,9 @@ static void sk_skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
                 cinfo->err->error_exit((j_common_ptr)cinfo);
                 return;
             }
+#ifdef ANDROID
             src->current_offset += bytes;
+#endif
             bytesToSkip -= bytes;
         }
         src->next_input_byte = (const JOCTET*)src->fBuffer;
@@ -103,9 +113,11 @@ static void sk_term_source(j_decompress_ptr /*cinfo*/) {}
 static void skmem_init_source(j_decompress_ptr cinfo) {
     skjpeg_source_mgr*  src = (skjpeg_source_mgr*)cinfo->src;
     src->next_input_byte = (const JOCTET*)src->fMemoryBase;
-    src->start_input_byte = (const JOCTET*)src->fMemoryBase;
     src->bytes_in_buffer = src->fMemoryBaseSize;
+#ifdef ANDROID
+    src->start_input_byte = (const JOCTET*)src->fMemoryBase;
     src->current_offset = src->fMemoryBaseSize;
+#endif
 }
 
 static boolean skmem_fill_input_buffer(j_decompress_ptr cinfo) {
@@ -133,9 +145,6 @@ static void skmem_term_source(j_decompress_ptr /*cinfo*/) {}
 skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream, SkImageDecoder* decoder,
                                      bool ownStream) : fStream(stream) {
     fDecoder = decoder;
-    const void* baseAddr = stream->getMemoryBase();
-    size_t bufferSize = 4096;
-    size_t len;
     fMemoryBase = NULL;
     fUnrefStream = ownStream;
     fMemoryBaseSize = 0;
@@ -145,7 +154,9 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream, SkImageDecoder* decoder,
     skip_input_data = sk_skip_input_data;
     resync_to_restart = sk_resync_to_restart;
     term_source = sk_term_source;
+#ifdef ANDROID
     seek_input_data = sk_seek_input_data;
+#endif
 //    SkDebugf("**************** use memorybase %p %d\n", fMemoryBase, fMemoryBaseSize);
 }
 
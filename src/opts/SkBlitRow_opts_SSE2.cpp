@@ -489,3 +489,284 @@ void SkARGB32_BlitMask_SSE2(void* device, size_t dstRB,
         mask += maskOffset;
     } while (--height != 0);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  LCD masks, blended exactly as the portable procs in SkBlitRow_D32.cpp do,
+    four (ARGB32) or eight (RGB16) pixels at a time. A row's last pixels are
+    blended as one more block ending at its end, computed before the rest of
+    the row is stored, so pixels it overlaps get the same values twice. Rows
+    narrower than a block go through a copy padded with empty mask.
+ */
+
+// dst + ((src - dst) * mask >> 5), for masks of 0..32 in 16bit lanes
+static inline __m128i lcd_blend_32(__m128i dst, __m128i src, __m128i mask) {
+    __m128i diff = _mm_sub_epi16(src, dst);
+    return _mm_add_epi16(dst, _mm_srai_epi16(_mm_mullo_epi16(diff, mask), 5));
+}
+
+// dst + ((src - dst) * mask >> 8), for masks of 0..256 in 16bit lanes
+static inline __m128i lcd_blend_256(__m128i dst, __m128i src, __m128i mask) {
+    // the product needs 17 bits, so take the high half of (diff << 7) * (mask << 1)
+    __m128i diff = _mm_slli_epi16(_mm_sub_epi16(src, dst), 7);
+    return _mm_add_epi16(dst, _mm_mulhi_epi16(diff, _mm_slli_epi16(mask, 1)));
+}
+
+// mask * scale >> 8, where that fits in 16 bits
+static inline __m128i lcd_scale(__m128i mask, __m128i scale) {
+    return _mm_srli_epi16(_mm_mullo_epi16(mask, scale), 8);
+}
+
+static inline bool lcd_is_zero(__m128i mask) {
+    return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi32(mask, _mm_setzero_si128()));
+}
+
+struct LCDBlend {
+    __m128i fSrc;       // ARGB32: the color with alpha 0xFF, as 16bit channels
+    __m128i fSrcR;      // RGB16: the color in 565's bits
+    __m128i fSrcG;
+    __m128i fSrcB;
+    __m128i fScale;     // SkAlpha255To256 of the color's alpha
+    bool    fBlend;     // if it isn't 256
+
+    LCDBlend(SkColor color) {
+        fSrc = _mm_unpacklo_epi8(_mm_set1_epi32(SkPackARGB32(0xFF,
+                                            SkColorGetR(color),
+                                            SkColorGetG(color),
+                                            SkColorGetB(color))),
+                                 _mm_setzero_si128());
+        fSrcR = _mm_set1_epi16(SkR32ToR16(SkColorGetR(color)));
+        fSrcG = _mm_set1_epi16(SkG32ToG16(SkColorGetG(color)));
+        fSrcB = _mm_set1_epi16(SkB32ToB16(SkColorGetB(color)));
+        unsigned scale = SkAlpha255To256(SkColorGetA(color));
+        fScale = _mm_set1_epi16(scale);
+        fBlend = scale < 256;
+    }
+};
+
+static inline __m128i lcd16_d32_4(__m128i d, const uint16_t* mask,
+                                  const LCDBlend& blend) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i m = _mm_unpacklo_epi16(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask)), zero);
+    if (lcd_is_zero(m)) {
+        return d;
+    }
+
+    // 5bits each, upscaled to 0..32
+    __m128i c_31 = _mm_set1_epi32(31);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(m, SK_R16_SHIFT + SK_R16_BITS - 5), c_31);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(m, SK_G16_SHIFT + SK_G16_BITS - 5), c_31);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(m, SK_B16_SHIFT + SK_B16_BITS - 5), c_31);
+    r = _mm_add_epi32(r, _mm_srli_epi32(r, 4));
+    g = _mm_add_epi32(g, _mm_srli_epi32(g, 4));
+    b = _mm_add_epi32(b, _mm_srli_epi32(b, 4));
+    if (blend.fBlend) {
+        // the high halves of each 32bit lane stay 0
+        r = lcd_scale(r, blend.fScale);
+        g = lcd_scale(g, blend.fScale);
+        b = lcd_scale(b, blend.fScale);
+    }
+    __m128i a = _mm_max_epi16(_mm_max_epi16(r, g), b);
+    m = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(a, SK_A32_SHIFT),
+                                  _mm_slli_epi32(r, SK_R32_SHIFT)),
+                     _mm_or_si128(_mm_slli_epi32(g, SK_G32_SHIFT),
+                                  _mm_slli_epi32(b, SK_B32_SHIFT)));
+
+    __m128i lo = lcd_blend_32(_mm_unpacklo_epi8(d, zero), blend.fSrc,
+                              _mm_unpacklo_epi8(m, zero));
+    __m128i hi = lcd_blend_32(_mm_unpackhi_epi8(d, zero), blend.fSrc,
+                              _mm_unpackhi_epi8(m, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+
+static inline __m128i lcd32_d32_4(__m128i d, const uint32_t* mask,
+                                  const LCDBlend& blend) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    __m128i empty = _mm_cmpeq_epi32(m, zero);
+    if (0xFFFF == _mm_movemask_epi8(empty)) {
+        return d;
+    }
+
+    // alpha takes the largest coverage, before they're upscaled to 0..256
+    __m128i c_FF = _mm_set1_epi32(0xFF);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(m, SK_R32_SHIFT), c_FF);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(m, SK_G32_SHIFT), c_FF);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(m, SK_B32_SHIFT), c_FF);
+    __m128i a = _mm_max_epi16(_mm_max_epi16(r, g), b);
+    m = _mm_or_si128(_mm_andnot_si128(_mm_slli_epi32(c_FF, SK_A32_SHIFT), m),
+                     _mm_slli_epi32(a, SK_A32_SHIFT));
+
+    __m128i c_1 = _mm_set1_epi16(1);
+    __m128i mlo = _mm_add_epi16(_mm_unpacklo_epi8(m, zero), c_1);
+    __m128i mhi = _mm_add_epi16(_mm_unpackhi_epi8(m, zero), c_1);
+    if (blend.fBlend) {
+        mlo = lcd_scale(mlo, blend.fScale);
+        mhi = lcd_scale(mhi, blend.fScale);
+    }
+
+    __m128i lo = lcd_blend_256(_mm_unpacklo_epi8(d, zero), blend.fSrc, mlo);
+    __m128i hi = lcd_blend_256(_mm_unpackhi_epi8(d, zero), blend.fSrc, mhi);
+    __m128i result = _mm_packus_epi16(lo, hi);
+    // an empty mask leaves its pixel alone, although 0 upscales to 1
+    return _mm_or_si128(_mm_and_si128(empty, d), _mm_andnot_si128(empty, result));
+}
+
+// masks are 0..32
+static inline __m128i lcd_d16_8(__m128i d, __m128i mr, __m128i mg, __m128i mb,
+                                const LCDBlend& blend) {
+    if (blend.fBlend) {
+        mr = lcd_scale(mr, blend.fScale);
+        mg = lcd_scale(mg, blend.fScale);
+        mb = lcd_scale(mb, blend.fScale);
+    }
+    __m128i dr = _mm_and_si128(_mm_srli_epi16(d, SK_R16_SHIFT), _mm_set1_epi16(SK_R16_MASK));
+    __m128i dg = _mm_and_si128(_mm_srli_epi16(d, SK_G16_SHIFT), _mm_set1_epi16(SK_G16_MASK));
+    __m128i db = _mm_and_si128(_mm_srli_epi16(d, SK_B16_SHIFT), _mm_set1_epi16(SK_B16_MASK));
+    dr = lcd_blend_32(dr, blend.fSrcR, mr);
+    dg = lcd_blend_32(dg, blend.fSrcG, mg);
+    db = lcd_blend_32(db, blend.fSrcB, mb);
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(dr, SK_R16_SHIFT),
+                                     _mm_slli_epi16(dg, SK_G16_SHIFT)),
+                        _mm_slli_epi16(db, SK_B16_SHIFT));
+}
+
+static inline __m128i lcd16_d16_8(__m128i d, const uint16_t* mask,
+                                  const LCDBlend& blend) {
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    if (lcd_is_zero(m)) {
+        return d;
+    }
+
+    __m128i c_31 = _mm_set1_epi16(31);
+    __m128i r = _mm_and_si128(_mm_srli_epi16(m, SK_R16_SHIFT + SK_R16_BITS - 5), c_31);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(m, SK_G16_SHIFT + SK_G16_BITS - 5), c_31);
+    __m128i b = _mm_and_si128(_mm_srli_epi16(m, SK_B16_SHIFT + SK_B16_BITS - 5), c_31);
+    r = _mm_add_epi16(r, _mm_srli_epi16(r, 4));
+    g = _mm_add_epi16(g, _mm_srli_epi16(g, 4));
+    b = _mm_add_epi16(b, _mm_srli_epi16(b, 4));
+    return lcd_d16_8(d, r, g, b, blend);
+}
+
+static inline __m128i lcd32_d16_8(__m128i d, const uint32_t* mask,
+                                  const LCDBlend& blend) {
+    __m128i m0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    __m128i m1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + 4));
+    if (lcd_is_zero(_mm_or_si128(m0, m1))) {
+        return d;
+    }
+
+    // upscaled to 0..256, then down to 0..32
+    __m128i c_FF = _mm_set1_epi32(0xFF);
+    __m128i c_1 = _mm_set1_epi16(1);
+    __m128i r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(m0, SK_R32_SHIFT), c_FF),
+                                _mm_and_si128(_mm_srli_epi32(m1, SK_R32_SHIFT), c_FF));
+    __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(m0, SK_G32_SHIFT), c_FF),
+                                _mm_and_si128(_mm_srli_epi32(m1, SK_G32_SHIFT), c_FF));
+    __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(m0, SK_B32_SHIFT), c_FF),
+                                _mm_and_si128(_mm_srli_epi32(m1, SK_B32_SHIFT), c_FF));
+    r = _mm_srli_epi16(_mm_add_epi16(r, c_1), 3);
+    g = _mm_srli_epi16(_mm_add_epi16(g, c_1), 3);
+    b = _mm_srli_epi16(_mm_add_epi16(b, c_1), 3);
+    return lcd_d16_8(d, r, g, b, blend);
+}
+
+// The blits, as types for lcd_blit_rows.
+struct LCD16_D32 {
+    typedef SkPMColor Dst;
+    typedef uint16_t Mask;
+    enum { N = 4 };
+    static __m128i Blit(__m128i d, const Mask* mask, const LCDBlend& blend) {
+        return lcd16_d32_4(d, mask, blend);
+    }
+};
+
+struct LCD32_D32 {
+    typedef SkPMColor Dst;
+    typedef uint32_t Mask;
+    enum { N = 4 };
+    static __m128i Blit(__m128i d, const Mask* mask, const LCDBlend& blend) {
+        return lcd32_d32_4(d, mask, blend);
+    }
+};
+
+struct LCD16_D16 {
+    typedef uint16_t Dst;
+    typedef uint16_t Mask;
+    enum { N = 8 };
+    static __m128i Blit(__m128i d, const Mask* mask, const LCDBlend& blend) {
+        return lcd16_d16_8(d, mask, blend);
+    }
+};
+
+struct LCD32_D16 {
+    typedef uint16_t Dst;
+    typedef uint32_t Mask;
+    enum { N = 8 };
+    static __m128i Blit(__m128i d, const Mask* mask, const LCDBlend& blend) {
+        return lcd32_d16_8(d, mask, blend);
+    }
+};
+
+template <typename LCD>
+static void lcd_blit_rows(void* device, size_t dstRB, const uint8_t* mask,
+                          size_t maskRB, SkColor color, int width, int height) {
+    typedef typename LCD::Dst Dst;
+    typedef typename LCD::Mask Mask;
+    const int N = LCD::N;
+
+    LCDBlend blend(color);
+    Dst* dst = reinterpret_cast<Dst*>(device);
+    const Mask* src = reinterpret_cast<const Mask*>(mask);
+    do {
+        if (width >= N) {
+            __m128i* last = reinterpret_cast<__m128i*>(dst + width - N);
+            __m128i lastD = LCD::Blit(_mm_loadu_si128(last), src + width - N, blend);
+            for (int i = 0; i + N < width; i += N) {
+                __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+                _mm_storeu_si128(d, LCD::Blit(_mm_loadu_si128(d), src + i, blend));
+            }
+            _mm_storeu_si128(last, lastD);
+        } else {
+            Dst tmpDst[N];
+            Mask tmpMask[N];
+            memset(tmpMask, 0, sizeof(tmpMask));
+            memcpy(tmpDst, dst, width * sizeof(Dst));
+            memcpy(tmpMask, src, width * sizeof(Mask));
+            __m128i* d = reinterpret_cast<__m128i*>(tmpDst);
+            _mm_storeu_si128(d, LCD::Blit(_mm_loadu_si128(d), tmpMask, blend));
+            memcpy(dst, tmpDst, width * sizeof(Dst));
+        }
+        dst = (Dst*)((char*)dst + dstRB);
+        src = (const Mask*)((const char*)src + maskRB);
+    } while (--height != 0);
+}
+
+void SkARGB32_BlitLCD16_SSE2(void* device, size_t dstRB,
+                             SkBitmap::Config dstConfig, const uint8_t* mask,
+                             size_t maskRB, SkColor color,
+                             int width, int height) {
+    lcd_blit_rows<LCD16_D32>(device, dstRB, mask, maskRB, color, width, height);
+}
+
+void SkARGB32_BlitLCD32_SSE2(void* device, size_t dstRB,
+                             SkBitmap::Config dstConfig, const uint8_t* mask,
+                             size_t maskRB, SkColor color,
+                             int width, int height) {
+    lcd_blit_rows<LCD32_D32>(device, dstRB, mask, maskRB, color, width, height);
+}
+
+void SkRGB16_BlitLCD16_SSE2(void* device, size_t dstRB,
+                            SkBitmap::Config dstConfig, const uint8_t* mask,
+                            size_t maskRB, SkColor color,
+                            int width, int height) {
+    lcd_blit_rows<LCD16_D16>(device, dstRB, mask, maskRB, color, width, height);
+}
+
+void SkRGB16_BlitLCD32_SSE2(void* device, size_t dstRB,
+                            SkBitmap::Config dstConfig, const uint8_t* mask,
+                            size_t maskRB, SkColor color,
+                            int width, int height) {
+    lcd_blit_rows<LCD32_D16>(device, dstRB, mask, maskRB, color, width, height);
+}
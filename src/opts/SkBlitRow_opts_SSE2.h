@@ -32,3 +32,19 @@ void SkARGB32_BlitMask_SSE2(void* device, size_t dstRB,
                             SkBitmap::Config dstConfig, const uint8_t* mask,
                             size_t maskRB, SkColor color,
                             int width, int height);
+void SkARGB32_BlitLCD16_SSE2(void* device, size_t dstRB,
+                             SkBitmap::Config dstConfig, const uint8_t* mask,
+                             size_t maskRB, SkColor color,
+                             int width, int height);
+void SkARGB32_BlitLCD32_SSE2(void* device, size_t dstRB,
+                             SkBitmap::Config dstConfig, const uint8_t* mask,
+                             size_t maskRB, SkColor color,
+                             int width, int height);
+void SkRGB16_BlitLCD16_SSE2(void* device, size_t dstRB,
+                            SkBitmap::Config dstConfig, const uint8_t* mask,
+                            size_t maskRB, SkColor color,
+                            int width, int height);
+void SkRGB16_BlitLCD32_SSE2(void* device, size_t dstRB,
+                            SkBitmap::Config dstConfig, const uint8_t* mask,
+                            size_t maskRB, SkColor color,
+                            int width, int height);
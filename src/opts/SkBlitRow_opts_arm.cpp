@@ -1325,6 +1325,7 @@ SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
 
 
 SkBlitMask::Proc SkBlitMask::PlatformProcs(SkBitmap::Config dstConfig,
+                                           SkMask::Format maskFormat,
                                            SkColor color)
 {
    return NULL;
@@ -0,0 +1,223 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#include "SkColorFilter_opts_SSE2.h"
+#include "SkColorPriv.h"
+#include "SkUnPreMultiply.h"
+
+#include <emmintrin.h>
+
+/*  The color matrix is applied to one pixel per register. Its components are
+    spread into 16bit lanes in memory order (byte 0 first), and each output
+    component is the sum of two _mm_madd_epi16 products: one with the first
+    two input components, one with the last two.
+
+    The matrix values take up to 23 bits (see SkColorMatrixFilter::setup), so
+    each is split into a high part and a low 15 bits, which both fit in 16bit
+    lanes: m * x == ((hi * x) << 15) + lo * x. The sums are therefore the same
+    32bit values the portable procs compute, so after the shift and pinning
+    the answers match theirs exactly.
+ */
+
+// the byte (and so the 16bit lane) of each component in a pixel
+#define R32_LANE    (SK_R32_SHIFT >> 3)
+#define G32_LANE    (SK_G32_SHIFT >> 3)
+#define B32_LANE    (SK_B32_SHIFT >> 3)
+#define A32_LANE    (SK_A32_SHIFT >> 3)
+
+namespace {
+
+struct MatrixSSE2 {
+    __m128i fHi01, fLo01;   // terms for input lanes 0 and 1
+    __m128i fHi23, fLo23;   // terms for input lanes 2 and 3
+    __m128i fAdd;
+    __m128i fShift;
+
+    MatrixSSE2(const int32_t matrix[20], int shift) {
+        // which matrix row (and column) holds each lane's component
+        int index[4];
+        index[R32_LANE] = 0;
+        index[G32_LANE] = 1;
+        index[B32_LANE] = 2;
+        index[A32_LANE] = 3;
+
+        int16_t hi[2][8], lo[2][8];
+        int32_t add[4];
+        for (int out = 0; out < 4; out++) {
+            const int32_t* row = &matrix[index[out] * 5];
+            for (int in = 0; in < 4; in++) {
+                int32_t value = row[index[in]];
+                hi[in >> 1][out * 2 + (in & 1)] = (int16_t)(value >> 15);
+                lo[in >> 1][out * 2 + (in & 1)] = (int16_t)(value & 0x7FFF);
+            }
+            add[out] = row[4];
+        }
+        fHi01 = _mm_loadu_si128((const __m128i*)hi[0]);
+        fLo01 = _mm_loadu_si128((const __m128i*)lo[0]);
+        fHi23 = _mm_loadu_si128((const __m128i*)hi[1]);
+        fLo23 = _mm_loadu_si128((const __m128i*)lo[1]);
+        fAdd = _mm_loadu_si128((const __m128i*)add);
+        fShift = _mm_cvtsi32_si128(shift);
+    }
+
+    /*  c holds 8bit components, which need not be premultiplied. Returns the
+        results pinned to 0..255, in 16bit lanes.
+     */
+    __m128i apply(uint32_t c) const {
+        __m128i x = _mm_unpacklo_epi8(_mm_cvtsi32_si128(c),
+                                      _mm_setzero_si128());
+        __m128i x01 = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128i x23 = _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 1, 1, 1));
+
+        __m128i sum = _mm_add_epi32(_mm_madd_epi16(x01, fHi01),
+                                    _mm_madd_epi16(x23, fHi23));
+        sum = _mm_slli_epi32(sum, 15);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(x01, fLo01));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(x23, fLo23));
+        sum = _mm_add_epi32(sum, fAdd);
+        sum = _mm_sra_epi32(sum, fShift);
+
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_max_epi16(sum, _mm_setzero_si128());
+        return _mm_min_epi16(sum, _mm_set1_epi16(255));
+    }
+};
+
+}
+
+void ColorMatrix_SSE2(const int32_t matrix[20], int shift,
+                      const SkPMColor src[], int count, SkPMColor dst[]) {
+    const MatrixSSE2 m(matrix, shift);
+    const SkUnPreMultiply::Scale* table = SkUnPreMultiply::GetScaleTable();
+    // alpha itself is not scaled
+    const __m128i alphaLane = _mm_slli_epi64(_mm_cvtsi32_si128(0xFFFF),
+                                             A32_LANE * 16);
+    const __m128i alphaScale = _mm_slli_epi64(_mm_cvtsi32_si128(256),
+                                              A32_LANE * 16);
+
+    for (int i = 0; i < count; i++) {
+        SkPMColor c = src[i];
+        unsigned a = SkGetPackedA32(c);
+
+        // need our components to be un-premultiplied
+        if (255 != a) {
+            SkUnPreMultiply::Scale scale = table[a];
+            c = SkPackARGB32NoCheck(a,
+                    SkUnPreMultiply::ApplyScale(scale, SkGetPackedR32(c)),
+                    SkUnPreMultiply::ApplyScale(scale, SkGetPackedG32(c)),
+                    SkUnPreMultiply::ApplyScale(scale, SkGetPackedB32(c)));
+        }
+
+        __m128i result = m.apply(c);
+
+        // re-premultiply, by a scale of 256 (which changes nothing) if opaque
+        __m128i scale = _mm_shufflelo_epi16(result, _MM_SHUFFLE(A32_LANE, A32_LANE,
+                                                                A32_LANE, A32_LANE));
+        scale = _mm_add_epi16(scale, _mm_set1_epi16(1));
+        scale = _mm_or_si128(_mm_andnot_si128(alphaLane, scale), alphaScale);
+        result = _mm_srli_epi16(_mm_mullo_epi16(result, scale), 8);
+        dst[i] = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+    }
+}
+
+void ColorMatrix16_SSE2(const int32_t matrix[20], int shift,
+                        const uint16_t src[], int count, uint16_t dst[]) {
+    const MatrixSSE2 m(matrix, shift);
+
+    for (int i = 0; i < count; i++) {
+        uint16_t c = src[i];
+        // as the portable code, alpha goes in as 0
+        __m128i result = m.apply(SkPackARGB32NoCheck(0, SkPacked16ToR32(c),
+                                                     SkPacked16ToG32(c),
+                                                     SkPacked16ToB32(c)));
+        SkPMColor c32 = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+        dst[i] = SkPack888ToRGB16(SkGetPackedR32(c32), SkGetPackedG32(c32),
+                                  SkGetPackedB32(c32));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  The lighting filter works on four pixels at a time, two per register, in
+    16bit lanes. Each component is (c * scale >> 8) + (add * scaleA >> 8), as
+    in the portable filters, where alpha is given a scale of 256 and an add of
+    0, so that it comes through unchanged.
+ */
+
+static inline uint16_t lighting_scale(SkColor mul, int lane) {
+    if (R32_LANE == lane) {
+        return SkAlpha255To256(SkColorGetR(mul));
+    } else if (G32_LANE == lane) {
+        return SkAlpha255To256(SkColorGetG(mul));
+    } else if (B32_LANE == lane) {
+        return SkAlpha255To256(SkColorGetB(mul));
+    }
+    return 256;
+}
+
+static inline uint16_t lighting_add(SkColor add, int lane) {
+    if (R32_LANE == lane) {
+        return SkColorGetR(add);
+    } else if (G32_LANE == lane) {
+        return SkColorGetG(add);
+    } else if (B32_LANE == lane) {
+        return SkColorGetB(add);
+    }
+    return 0;
+}
+
+static inline __m128i lighting_pair(__m128i c, __m128i mul, __m128i add,
+                                    bool pin) {
+    // each pixel's alpha in all four of its lanes
+    __m128i a = _mm_shufflelo_epi16(c, _MM_SHUFFLE(A32_LANE, A32_LANE,
+                                                   A32_LANE, A32_LANE));
+    a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(A32_LANE, A32_LANE,
+                                           A32_LANE, A32_LANE));
+    __m128i scaleA = _mm_add_epi16(a, _mm_set1_epi16(1));
+
+    __m128i result = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(c, mul), 8),
+                                   _mm_srli_epi16(_mm_mullo_epi16(add, scaleA), 8));
+    if (pin) {
+        result = _mm_min_epi16(result, a);
+    }
+    return result;
+}
+
+void Lighting_SSE2(SkColor mul, SkColor add, bool pin,
+                   const SkPMColor src[], int count, SkPMColor dst[]) {
+    uint16_t mulLanes[8], addLanes[8];
+    for (int i = 0; i < 8; i++) {
+        mulLanes[i] = lighting_scale(mul, i & 3);
+        addLanes[i] = lighting_add(add, i & 3);
+    }
+    const __m128i mulv = _mm_loadu_si128((const __m128i*)mulLanes);
+    const __m128i addv = _mm_loadu_si128((const __m128i*)addLanes);
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = lighting_pair(_mm_unpacklo_epi8(c, zero), mulv, addv, pin);
+        __m128i hi = lighting_pair(_mm_unpackhi_epi8(c, zero), mulv, addv, pin);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    for (; i < count; i++) {
+        __m128i c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src[i]), zero);
+        c = lighting_pair(c, mulv, addv, pin);
+        dst[i] = _mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+    }
+}
@@ -0,0 +1,25 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#include "SkColorFilterProcs.h"
+
+void ColorMatrix_SSE2(const int32_t matrix[20], int shift,
+                      const SkPMColor src[], int count, SkPMColor dst[]);
+void ColorMatrix16_SSE2(const int32_t matrix[20], int shift,
+                        const uint16_t src[], int count, uint16_t dst[]);
+void Lighting_SSE2(SkColor mul, SkColor add, bool pin,
+                   const SkPMColor src[], int count, SkPMColor dst[]);
@@ -0,0 +1,100 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#include "SkMaskFilter_opts_SSE2.h"
+
+#include <emmintrin.h>
+
+/*  Eight pixels at a time: the nine taps are taken in pairs, interleaved with
+    the pixels they multiply, so that each _mm_madd_epi16 adds two of them into
+    32bit sums. These are the same sums as the portable code's, so shifting
+    them and pinning with saturating packs gives the same values.
+ */
+
+static inline __m128i load8(const uint8_t* src) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src),
+                             _mm_setzero_si128());
+}
+
+static inline __m128i pair_coeff(int k0, int k1) {
+    return _mm_set1_epi32((k1 << 16) | (k0 & 0xFFFF));
+}
+
+void Kernel33Row_SSE2(const uint8_t* const srcRows[3], const int16_t kernel[9],
+                      int shift, int count, uint8_t dst[]) {
+    const __m128i k01 = pair_coeff(kernel[0], kernel[1]);
+    const __m128i k23 = pair_coeff(kernel[2], kernel[3]);
+    const __m128i k45 = pair_coeff(kernel[4], kernel[5]);
+    const __m128i k67 = pair_coeff(kernel[6], kernel[7]);
+    const __m128i k8 = pair_coeff(kernel[8], 0);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sh = _mm_cvtsi32_si128(shift);
+
+    const uint8_t* r0 = srcRows[0];
+    const uint8_t* r1 = srcRows[1];
+    const uint8_t* r2 = srcRows[2];
+
+    int x = 0;
+    // each row is read up to x + 9, which is within its count + 2 pixels
+    for (; x + 8 <= count; x += 8) {
+        __m128i p[10];
+        p[0] = load8(r0 + x);
+        p[1] = load8(r0 + x + 1);
+        p[2] = load8(r0 + x + 2);
+        p[3] = load8(r1 + x);
+        p[4] = load8(r1 + x + 1);
+        p[5] = load8(r1 + x + 2);
+        p[6] = load8(r2 + x);
+        p[7] = load8(r2 + x + 1);
+        p[8] = load8(r2 + x + 2);
+        p[9] = zero;
+
+        const __m128i coeff[5] = { k01, k23, k45, k67, k8 };
+        __m128i lo = zero;
+        __m128i hi = zero;
+        for (int i = 0; i < 5; i++) {
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(
+                        _mm_unpacklo_epi16(p[2*i], p[2*i + 1]), coeff[i]));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(
+                        _mm_unpackhi_epi16(p[2*i], p[2*i + 1]), coeff[i]));
+        }
+        lo = _mm_sra_epi32(lo, sh);
+        hi = _mm_sra_epi32(hi, sh);
+
+        __m128i result = _mm_packs_epi32(lo, hi);
+        result = _mm_packus_epi16(result, result);
+        _mm_storel_epi64((__m128i*)(dst + x), result);
+    }
+
+    for (; x < count; x++) {
+        const uint8_t* rows[3] = { r0 + x, r1 + x, r2 + x };
+        int value = 0;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                value += kernel[i * 3 + j] * rows[i][j];
+            }
+        }
+        value >>= shift;
+
+        if (value < 0) {
+            value = 0;
+        } else if (value > 255) {
+            value = 255;
+        }
+        dst[x] = (uint8_t)value;
+    }
+}
@@ -0,0 +1,213 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License");
+ ** you may not use this file except in compliance with the License.
+ ** You may obtain a copy of the License at
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0
+ **
+ ** Unless required by applicable law or agreed to in writing, software
+ ** distributed under the License is distributed on an "AS IS" BASIS,
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ ** See the License for the specific language governing permissions and
+ ** limitations under the License.
+ */
+
+#include "SkMatrix_opts_SSE2.h"
+
+#include <emmintrin.h>
+
+#ifdef SK_SCALAR_IS_FLOAT
+
+/*  Each of these maps two points per iteration, holding them in one register
+    as x0 y0 x1 y1. The matrix terms are laid out to match (e.g. mx my mx my),
+    and the sums are grouped exactly as in the portable procs (see
+    core/SkMatrix.cpp), so that the results are identical, bit for bit.
+ */
+
+static inline __m128 load_pair(SkScalar a, SkScalar b) {
+    return _mm_setr_ps(a, b, a, b);
+}
+
+// x0 x0 x1 x1
+static inline __m128 splat_x(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+}
+
+// y0 y0 y1 y1
+static inline __m128 splat_y(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+void Trans_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count) {
+    SkASSERT(m.getType() == SkMatrix::kTranslate_Mask);
+
+    SkScalar tx = m[SkMatrix::kMTransX];
+    SkScalar ty = m[SkMatrix::kMTransY];
+    __m128 trans = load_pair(tx, ty);
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        _mm_storeu_ps(&dst->fX, _mm_add_ps(v, trans));
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        dst->fY = src->fY + ty;
+        dst->fX = src->fX + tx;
+    }
+}
+
+void Scale_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count) {
+    SkASSERT(m.getType() == SkMatrix::kScale_Mask);
+
+    SkScalar mx = m[SkMatrix::kMScaleX];
+    SkScalar my = m[SkMatrix::kMScaleY];
+    __m128 scale = load_pair(mx, my);
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        _mm_storeu_ps(&dst->fX, _mm_mul_ps(v, scale));
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        dst->fY = SkScalarMul(src->fY, my);
+        dst->fX = SkScalarMul(src->fX, mx);
+    }
+}
+
+void ScaleTrans_pts_SSE2(const SkMatrix& m, SkPoint dst[],
+                         const SkPoint src[], int count) {
+    SkASSERT(m.getType() == (SkMatrix::kScale_Mask |
+                             SkMatrix::kTranslate_Mask));
+
+    SkScalar mx = m[SkMatrix::kMScaleX];
+    SkScalar my = m[SkMatrix::kMScaleY];
+    SkScalar tx = m[SkMatrix::kMTransX];
+    SkScalar ty = m[SkMatrix::kMTransY];
+    __m128 scale = load_pair(mx, my);
+    __m128 trans = load_pair(tx, ty);
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        v = _mm_add_ps(_mm_mul_ps(v, scale), trans);
+        _mm_storeu_ps(&dst->fX, v);
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        dst->fY = SkScalarMulAdd(src->fY, my, ty);
+        dst->fX = SkScalarMulAdd(src->fX, mx, tx);
+    }
+}
+
+void Rot_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                  int count) {
+    SkASSERT((m.getType() & (SkMatrix::kPerspective_Mask |
+                             SkMatrix::kTranslate_Mask)) == 0);
+
+    SkScalar mx = m[SkMatrix::kMScaleX];
+    SkScalar my = m[SkMatrix::kMScaleY];
+    SkScalar kx = m[SkMatrix::kMSkewX];
+    SkScalar ky = m[SkMatrix::kMSkewY];
+    // dst.x = sx * mx + sy * kx, dst.y = sx * ky + sy * my
+    __m128 xterms = load_pair(mx, ky);
+    __m128 yterms = load_pair(kx, my);
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        v = _mm_add_ps(_mm_mul_ps(splat_x(v), xterms),
+                       _mm_mul_ps(splat_y(v), yterms));
+        _mm_storeu_ps(&dst->fX, v);
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        SkScalar sy = src->fY;
+        SkScalar sx = src->fX;
+        dst->fY = SkScalarMul(sx, ky) + SkScalarMul(sy, my);
+        dst->fX = SkScalarMul(sx, mx) + SkScalarMul(sy, kx);
+    }
+}
+
+void RotTrans_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                       int count) {
+    SkASSERT(!m.hasPerspective());
+
+    SkScalar mx = m[SkMatrix::kMScaleX];
+    SkScalar my = m[SkMatrix::kMScaleY];
+    SkScalar kx = m[SkMatrix::kMSkewX];
+    SkScalar ky = m[SkMatrix::kMSkewY];
+    SkScalar tx = m[SkMatrix::kMTransX];
+    SkScalar ty = m[SkMatrix::kMTransY];
+    __m128 xterms = load_pair(mx, ky);
+    __m128 yterms = load_pair(kx, my);
+    __m128 trans = load_pair(tx, ty);
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        __m128 ypart = _mm_add_ps(_mm_mul_ps(splat_y(v), yterms), trans);
+        v = _mm_add_ps(_mm_mul_ps(splat_x(v), xterms), ypart);
+        _mm_storeu_ps(&dst->fX, v);
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        SkScalar sy = src->fY;
+        SkScalar sx = src->fX;
+        dst->fY = SkScalarMul(sx, ky) + SkScalarMulAdd(sy, my, ty);
+        dst->fX = SkScalarMul(sx, mx) + SkScalarMulAdd(sy, kx, tx);
+    }
+}
+
+void Persp_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count) {
+    SkASSERT(m.hasPerspective());
+
+    SkScalar mx = m[SkMatrix::kMScaleX];
+    SkScalar my = m[SkMatrix::kMScaleY];
+    SkScalar kx = m[SkMatrix::kMSkewX];
+    SkScalar ky = m[SkMatrix::kMSkewY];
+    SkScalar tx = m[SkMatrix::kMTransX];
+    SkScalar ty = m[SkMatrix::kMTransY];
+    SkScalar p0 = m[SkMatrix::kMPersp0];
+    SkScalar p1 = m[SkMatrix::kMPersp1];
+    SkScalar p2 = m[SkMatrix::kMPersp2];
+    __m128 xterms = load_pair(mx, ky);
+    __m128 yterms = load_pair(kx, my);
+    __m128 trans = load_pair(tx, ty);
+    __m128 persp0 = _mm_set1_ps(p0);
+    __m128 persp1 = _mm_set1_ps(p1);
+    __m128 persp2 = _mm_set1_ps(p2);
+    __m128 one = _mm_set1_ps(SK_Scalar1);
+    __m128 zero = _mm_setzero_ps();
+    for (; count >= 2; count -= 2) {
+        __m128 v = _mm_loadu_ps(&src->fX);
+        __m128 x = splat_x(v);
+        __m128 y = splat_y(v);
+        __m128 xy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, xterms),
+                                          _mm_mul_ps(y, yterms)), trans);
+        // z0 z0 z1 z1
+        __m128 z = _mm_add_ps(_mm_mul_ps(x, persp0),
+                              _mm_add_ps(_mm_mul_ps(y, persp1), persp2));
+        // like the portable version, a zero z is left as zero
+        z = _mm_and_ps(_mm_cmpneq_ps(z, zero), _mm_div_ps(one, z));
+        _mm_storeu_ps(&dst->fX, _mm_mul_ps(xy, z));
+        src += 2;
+        dst += 2;
+    }
+    if (count > 0) {
+        SkScalar sy = src->fY;
+        SkScalar sx = src->fX;
+        SkScalar x = SkScalarMul(sx, mx) + SkScalarMul(sy, kx) + tx;
+        SkScalar y = SkScalarMul(sx, ky) + SkScalarMul(sy, my) + ty;
+        float z = SkScalarMul(sx, p0) + SkScalarMulAdd(sy, p1, p2);
+        if (z) {
+            z = SkScalarFastInvert(z);
+        }
+        dst->fY = SkScalarMul(y, z);
+        dst->fX = SkScalarMul(x, z);
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ **
+ ** Copyright 2011, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License"); 
+ ** you may not use this file except in compliance with the License. 
+ ** You may obtain a copy of the License at 
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0 
+ **
+ ** Unless required by applicable law or agreed to in writing, software 
+ ** distributed under the License is distributed on an "AS IS" BASIS, 
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+ ** See the License for the specific language governing permissions and 
+ ** limitations under the License.
+ */
+
+#include "SkMatrix.h"
+
+void Trans_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count);
+void Scale_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count);
+void ScaleTrans_pts_SSE2(const SkMatrix& m, SkPoint dst[],
+                         const SkPoint src[], int count);
+void Rot_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                  int count);
+void RotTrans_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                       int count);
+void Persp_pts_SSE2(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
+                    int count);
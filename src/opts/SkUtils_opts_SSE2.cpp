@@ -75,3 +75,47 @@ void sk_memset32_SSE2(uint32_t *dst, uint32_t value, int count)
         --count;
     }
 }
+
+size_t SkUTF8_CountASCII_SSE2(const char utf8[], size_t byteLength)
+{
+    SkASSERT(utf8 != NULL || byteLength == 0);
+
+    const char* p = utf8;
+    const char* stop = utf8 + byteLength;
+
+    // any byte with its high bit set ends the run; the scalar loop below
+    // finds which one
+    while (stop - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if (_mm_movemask_epi8(bytes)) {
+            break;
+        }
+        p += 16;
+    }
+    while (p < stop && !(*(const uint8_t*)p & 0x80)) {
+        p += 1;
+    }
+    return p - utf8;
+}
+
+int SkUTF16_CountBMP_SSE2(const uint16_t utf16[], int count)
+{
+    SkASSERT(utf16 != NULL || count == 0);
+
+    const __m128i mask = _mm_set1_epi16((short)0xF800);
+    const __m128i surrogate = _mm_set1_epi16((short)0xD800);
+    int i = 0;
+    while (count - i >= 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16 + i));
+        __m128i isSurrogate = _mm_cmpeq_epi16(_mm_and_si128(values, mask),
+                                              surrogate);
+        if (_mm_movemask_epi8(isSurrogate)) {
+            break;
+        }
+        i += 8;
+    }
+    while (i < count && (utf16[i] & 0xF800) != 0xD800) {
+        i += 1;
+    }
+    return i;
+}
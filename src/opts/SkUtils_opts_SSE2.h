@@ -19,3 +19,5 @@
  
 void sk_memset16_SSE2(uint16_t *dst, uint16_t value, int count);
 void sk_memset32_SSE2(uint32_t *dst, uint32_t value, int count);
+size_t SkUTF8_CountASCII_SSE2(const char utf8[], size_t byteLength);
+int SkUTF16_CountBMP_SSE2(const uint16_t utf16[], int count);
@@ -24,3 +24,11 @@ SkMemset16Proc SkMemset16GetPlatformProc() {
 SkMemset32Proc SkMemset32GetPlatformProc() {
     return NULL;
 }
+
+SkUTF8CountASCIIProc SkUTF8CountASCIIGetPlatformProc() {
+    return NULL;
+}
+
+SkUTF16CountBMPProc SkUTF16CountBMPGetPlatformProc() {
+    return NULL;
+}
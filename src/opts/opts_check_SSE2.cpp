@@ -17,6 +17,9 @@
 
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE2.h"
+#include "SkColorFilter_opts_SSE2.h"
+#include "SkMaskFilter_opts_SSE2.h"
+#include "SkMatrix_opts_SSE2.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkUtils.h"
 
@@ -107,6 +110,7 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 
 
 SkBlitMask::Proc SkBlitMask::PlatformProcs(SkBitmap::Config dstConfig,
+                                           SkMask::Format maskFormat,
                                            SkColor color)
 {
 
@@ -114,10 +118,23 @@ SkBlitMask::Proc SkBlitMask::PlatformProcs(SkBitmap::Config dstConfig,
     if (hasSSE2()) {
         switch (dstConfig) {
             case SkBitmap::kARGB_8888_Config:
+                if (SkMask::kLCD16_Format == maskFormat) {
+                    proc = SkARGB32_BlitLCD16_SSE2;
+                } else if (SkMask::kLCD32_Format == maskFormat) {
+                    proc = SkARGB32_BlitLCD32_SSE2;
                 // TODO: is our current SSE2 faster than the portable, even in
                 // the case of black or opaque? If so, no need for this check.
-                if ( SK_ColorBLACK != color && 0xFF != SkColorGetA(color))
+                } else if (SkMask::kA8_Format == maskFormat &&
+                           SK_ColorBLACK != color && 0xFF != SkColorGetA(color)) {
                     proc = SkARGB32_BlitMask_SSE2;
+                }
+                break;
+            case SkBitmap::kRGB_565_Config:
+                if (SkMask::kLCD16_Format == maskFormat) {
+                    proc = SkRGB16_BlitLCD16_SSE2;
+                } else if (SkMask::kLCD32_Format == maskFormat) {
+                    proc = SkRGB16_BlitLCD32_SSE2;
+                }
                 break;
             default:
                  break;
@@ -141,3 +158,75 @@ SkMemset32Proc SkMemset32GetPlatformProc() {
         return NULL;
     }
 }
+
+SkUTF8CountASCIIProc SkUTF8CountASCIIGetPlatformProc() {
+    if (hasSSE2()) {
+        return SkUTF8_CountASCII_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkUTF16CountBMPProc SkUTF16CountBMPGetPlatformProc() {
+    if (hasSSE2()) {
+        return SkUTF16_CountBMP_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkColorFilterProcs::MatrixSpanProc SkColorFilterProcs::PlatformMatrixSpanProc() {
+    if (hasSSE2()) {
+        return ColorMatrix_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkColorFilterProcs::MatrixSpan16Proc SkColorFilterProcs::PlatformMatrixSpan16Proc() {
+    if (hasSSE2()) {
+        return ColorMatrix16_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkColorFilterProcs::LightingSpanProc SkColorFilterProcs::PlatformLightingSpanProc() {
+    if (hasSSE2()) {
+        return Lighting_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkMaskFilterProcs::Kernel33RowProc SkMaskFilterProcs::PlatformKernel33RowProc() {
+    if (hasSSE2()) {
+        return Kernel33Row_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+#ifdef SK_SCALAR_IS_FLOAT
+static const SkMatrix::MapPtsProc platform_map_pts_procs[] = {
+    NULL,                   // Identity (memcpy)
+    Trans_pts_SSE2,
+    Scale_pts_SSE2,         ScaleTrans_pts_SSE2,
+    Rot_pts_SSE2,           RotTrans_pts_SSE2,
+    Rot_pts_SSE2,           RotTrans_pts_SSE2,
+    // repeat the persp proc 8 times
+    Persp_pts_SSE2,         Persp_pts_SSE2,
+    Persp_pts_SSE2,         Persp_pts_SSE2,
+    Persp_pts_SSE2,         Persp_pts_SSE2,
+    Persp_pts_SSE2,         Persp_pts_SSE2
+};
+#endif
+
+SkMatrix::MapPtsProc SkMatrix::PlatformMapPtsProc(TypeMask mask) {
+#ifdef SK_SCALAR_IS_FLOAT
+    if (hasSSE2()) {
+        return platform_map_pts_procs[mask];
+    }
+#endif
+    return NULL;
+}
@@ -22,6 +22,8 @@
  *    available in the core
  */
 
+#include "SkColorFilterProcs.h"
+#include "SkMaskFilterProcs.h"
 #include "SkUtils.h"
 
 extern "C" void memset16_neon(uint16_t dst[], uint16_t value, int count);
@@ -61,3 +63,27 @@ SkMemset32Proc SkMemset32GetPlatformProc() {
 #endif
     }
 }
+
+SkUTF8CountASCIIProc SkUTF8CountASCIIGetPlatformProc() {
+    return NULL;
+}
+
+SkUTF16CountBMPProc SkUTF16CountBMPGetPlatformProc() {
+    return NULL;
+}
+
+SkColorFilterProcs::MatrixSpanProc SkColorFilterProcs::PlatformMatrixSpanProc() {
+    return NULL;
+}
+
+SkColorFilterProcs::MatrixSpan16Proc SkColorFilterProcs::PlatformMatrixSpan16Proc() {
+    return NULL;
+}
+
+SkColorFilterProcs::LightingSpanProc SkColorFilterProcs::PlatformLightingSpanProc() {
+    return NULL;
+}
+
+SkMaskFilterProcs::Kernel33RowProc SkMaskFilterProcs::PlatformKernel33RowProc() {
+    return NULL;
+}
@@ -720,6 +720,13 @@ void SkPDFDevice::drawRect(const SkDraw& d, const SkRect& r,
                           &content.entry()->fContent);
 }
 
+void SkPDFDevice::drawRects(const SkDraw& d, const SkRect rects[],
+                            size_t count, const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawRect(d, rects[i], paint);
+    }
+}
+
 void SkPDFDevice::drawPath(const SkDraw& d, const SkPath& origPath,
                            const SkPaint& paint, const SkMatrix* prePathMatrix,
                            bool pathIsMutable) {
@@ -796,6 +803,14 @@ void SkPDFDevice::drawSprite(const SkDraw& d, const SkBitmap& bitmap,
     internalDrawBitmap(matrix, d.fClipStack, *d.fClip, bitmap, NULL, paint);
 }
 
+void SkPDFDevice::drawSprites(const SkDraw& d, const SkBitmap& bitmap,
+                              const SkIPoint pts[], size_t count,
+                              const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawSprite(d, bitmap, pts[i].fX, pts[i].fY, paint);
+    }
+}
+
 void SkPDFDevice::drawText(const SkDraw& d, const void* text, size_t len,
                            SkScalar x, SkScalar y, const SkPaint& paint) {
     SkPaint textPaint = calculate_text_paint(paint);
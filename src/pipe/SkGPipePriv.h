@@ -73,6 +73,7 @@ enum DrawOps {
 
     kDef_Typeface_DrawOp,
     kDef_Flattenable_DrawOp,
+    kDef_Bitmap_DrawOp,
 
     // these are signals to playback, not drawing verbs
     kDone_DrawOp,
@@ -89,6 +90,9 @@ enum DrawOps {
  *
  *  All Ops that take a SkPaint use their Data field to store the index to
  *  the paint (previously defined with kPaintOp_DrawOp).
+ *
+ *  Ops that draw a bitmap store its index (base-1, previously defined with
+ *  kDef_Bitmap_DrawOp) in their Data field; their paint is the current one.
  */
 
 #define DRAWOPS_OP_BITS     8
@@ -128,6 +132,13 @@ enum {
     kSaveLayer_HasBounds_DrawOpFlag = 1 << 0,
     kSaveLayer_HasPaint_DrawOpFlag = 1 << 1,
 };
+enum {
+    kDrawBitmap_HasPaint_DrawOpFlag     = 1 << 0,
+    kDrawBitmap_HasSrcRect_DrawOpFlag   = 1 << 1,
+};
+enum {
+    kDefBitmap_Shared_DrawOpFlag    = 1 << 0
+};
 enum {
     kClear_HasColor_DrawOpFlag  = 1 << 0
 };
@@ -100,7 +100,36 @@ public:
     void setTypeface(SkPaint* paint, unsigned id) {
         paint->setTypeface(id ? fTypefaces[id - 1] : NULL);
     }
-    
+
+    void setSharedMemory(SkGPipeSharedMemory* memory) {
+        fSharedMemory = memory;
+    }
+
+    void defBitmap(unsigned flags, int index) {
+        SkASSERT(index == fBitmaps.count() + 1);
+        SkBitmap* bitmap = SkNEW(SkBitmap);
+        if (flags & kDefBitmap_Shared_DrawOpFlag) {
+            // draw straight from the shared pixels, rather than copying them
+            uint32_t handle = fReader->readU32();
+            SkBitmap::Config config = (SkBitmap::Config)fReader->readU32();
+            int width = fReader->readInt();
+            int height = fReader->readInt();
+            bool isOpaque = fReader->readBool();
+            bitmap->setConfig(config, width, height);
+            bitmap->setIsOpaque(isOpaque);
+            if (fSharedMemory) {
+                bitmap->setPixels(fSharedMemory->lookup(handle));
+            }
+        } else {
+            bitmap->unflatten(*fReader);
+        }
+        *fBitmaps.append() = bitmap;
+    }
+    const SkBitmap& getBitmap(unsigned index) const {
+        SkASSERT(index > 0 && index <= (unsigned)fBitmaps.count());
+        return *fBitmaps[index - 1];
+    }
+
     SkFlattenableReadBuffer* fReader;
 
 private:
@@ -108,6 +137,8 @@ private:
     SkTDArray<SkFlattenable*> fFlatArray;
     SkTDArray<SkTypeface*>    fTypefaces;
     SkTDArray<SkFlattenable::Factory> fFactoryArray;
+    SkTDArray<SkBitmap*>      fBitmaps;
+    SkGPipeSharedMemory*      fSharedMemory;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -331,24 +362,46 @@ static void drawTextOnPath_rp(SkCanvas* canvas, SkReader32* reader, uint32_t op3
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static const SkPaint* bitmap_paint(uint32_t op32, SkGPipeState* state) {
+    if (DrawOp_unpackFlags(op32) & kDrawBitmap_HasPaint_DrawOpFlag) {
+        return &state->paint();
+    }
+    return NULL;
+}
+
 static void drawBitmap_rp(SkCanvas* canvas, SkReader32* reader, uint32_t op32,
                           SkGPipeState* state) {
-    UNIMPLEMENTED
+    const SkBitmap& bitmap = state->getBitmap(DrawOp_unpackData(op32));
+    SkScalar left = reader->readScalar();
+    SkScalar top = reader->readScalar();
+    canvas->drawBitmap(bitmap, left, top, bitmap_paint(op32, state));
 }
 
 static void drawBitmapMatrix_rp(SkCanvas* canvas, SkReader32* reader, uint32_t op32,
                                 SkGPipeState* state) {
-    UNIMPLEMENTED
+    const SkBitmap& bitmap = state->getBitmap(DrawOp_unpackData(op32));
+    SkMatrix matrix;
+    SkReadMatrix(reader, &matrix);
+    canvas->drawBitmapMatrix(bitmap, matrix, bitmap_paint(op32, state));
 }
 
 static void drawBitmapRect_rp(SkCanvas* canvas, SkReader32* reader, uint32_t op32,
                               SkGPipeState* state) {
-    UNIMPLEMENTED
+    const SkBitmap& bitmap = state->getBitmap(DrawOp_unpackData(op32));
+    const SkIRect* src = NULL;
+    if (DrawOp_unpackFlags(op32) & kDrawBitmap_HasSrcRect_DrawOpFlag) {
+        src = skip<SkIRect>(reader);
+    }
+    const SkRect* dst = skip<SkRect>(reader);
+    canvas->drawBitmapRect(bitmap, src, *dst, bitmap_paint(op32, state));
 }
 
 static void drawSprite_rp(SkCanvas* canvas, SkReader32* reader, uint32_t op32,
                           SkGPipeState* state) {
-    UNIMPLEMENTED
+    const SkBitmap& bitmap = state->getBitmap(DrawOp_unpackData(op32));
+    int left = reader->readInt();
+    int top = reader->readInt();
+    canvas->drawSprite(bitmap, left, top, bitmap_paint(op32, state));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -429,6 +482,11 @@ static void def_PaintFlat_rp(SkCanvas*, SkReader32*, uint32_t op32,
     state->defFlattenable(pf, index);
 }
 
+static void def_Bitmap_rp(SkCanvas*, SkReader32*, uint32_t op32,
+                          SkGPipeState* state) {
+    state->defBitmap(DrawOp_unpackFlags(op32), DrawOp_unpackData(op32));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static void skip_rp(SkCanvas*, SkReader32* reader, uint32_t op32, SkGPipeState*) {
@@ -474,17 +532,19 @@ static const ReadProc gReadTable[] = {
     paintOp_rp,
     def_Typeface_rp,
     def_PaintFlat_rp,
+    def_Bitmap_rp,
 
     done_rp
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SkGPipeState::SkGPipeState() {}
+SkGPipeState::SkGPipeState() : fSharedMemory(NULL) {}
 
 SkGPipeState::~SkGPipeState() {
     fTypefaces.safeUnrefAll();
     fFlatArray.safeUnrefAll();
+    fBitmaps.deleteAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -495,11 +555,17 @@ SkGPipeReader::SkGPipeReader(SkCanvas* target) {
     SkSafeRef(target);
     fCanvas = target;
     fState = NULL;
+    fSharedMemory = NULL;
 }
 
 SkGPipeReader::~SkGPipeReader() {
     SkSafeUnref(fCanvas);
     delete fState;
+    SkSafeUnref(fSharedMemory);
+}
+
+void SkGPipeReader::setSharedMemory(SkGPipeSharedMemory* memory) {
+    SkRefCnt_SafeAssign(fSharedMemory, memory);
 }
 
 SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
@@ -520,6 +586,7 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
     Status status = kEOF_Status;
 
     fState->setReader(&reader);
+    fState->setSharedMemory(fSharedMemory);
     while (!reader.eof()) {
         uint32_t op32 = reader.readU32();
         unsigned op = DrawOp_unpackOp(op32);
@@ -538,7 +605,8 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
         if (readAtom && 
             (table[op] != paintOp_rp &&
              table[op] != def_Typeface_rp &&
-             table[op] != def_PaintFlat_rp
+             table[op] != def_PaintFlat_rp &&
+             table[op] != def_Bitmap_rp
              )) {
                 status = kReadAtom_Status;
                 break;
@@ -79,7 +79,9 @@ static size_t writeTypeface(SkWriter32* writer, SkTypeface* typeface) {
 
 class SkGPipeCanvas : public SkCanvas {
 public:
-    SkGPipeCanvas(SkGPipeController*, SkWriter32*, SkFactorySet*);
+    SkGPipeCanvas(SkGPipeController*, SkWriter32*, SkFactorySet*,
+                  SkGPipeSharedMemory*,
+                  SkTDArray<SkGPipeWriter::SharedBitmap>*);
     virtual ~SkGPipeCanvas();
 
     void finish() {
@@ -108,6 +110,8 @@ public:
     virtual void drawPoints(PointMode, size_t count, const SkPoint pts[],
                             const SkPaint&);
     virtual void drawRect(const SkRect& rect, const SkPaint&);
+    virtual void drawRects(const SkRect rects[], size_t count,
+                           const SkPaint&);
     virtual void drawPath(const SkPath& path, const SkPaint&);
     virtual void drawBitmap(const SkBitmap&, SkScalar left, SkScalar top,
                             const SkPaint*);
@@ -117,6 +121,8 @@ public:
                                   const SkPaint*);
     virtual void drawSprite(const SkBitmap&, int left, int top,
                             const SkPaint*);
+    virtual void drawSprites(const SkBitmap&, const SkIPoint pts[],
+                             size_t count, const SkPaint*);
     virtual void drawText(const void* text, size_t byteLength, SkScalar x, 
                           SkScalar y, const SkPaint&);
     virtual void drawPosText(const void* text, size_t byteLength, 
@@ -146,6 +152,22 @@ private:
 
     uint32_t getTypefaceID(SkTypeface*);
 
+    // optional: if set, bitmap pixels are copied here rather than into the
+    // pipe, and fSharedBitmaps (owned by our writer) remembers where
+    SkGPipeSharedMemory* fSharedMemory;
+    SkTDArray<SkGPipeWriter::SharedBitmap>* fSharedBitmaps;
+
+    // the bitmaps defined so far, in the order of their indices
+    struct BitmapKey {
+        uint32_t    fGenerationID;
+        uint32_t    fPixelRefOffset;
+        int         fWidth;
+        int         fHeight;
+    };
+    SkTDArray<BitmapKey> fBitmaps;
+    int bitmapToIndex(const SkBitmap&);
+    uint32_t sharePixels(const SkBitmap&);
+
     inline void writeOp(DrawOps op, unsigned flags, unsigned data) {
         fWriter.write32(DrawOp_packOpFlagData(op, flags, data));
     }
@@ -237,9 +259,13 @@ int SkGPipeCanvas::flattenToIndex(SkFlattenable* obj, PaintFlats paintflat) {
 #define MIN_BLOCK_SIZE  (16 * 1024)
 
 SkGPipeCanvas::SkGPipeCanvas(SkGPipeController* controller,
-                             SkWriter32* writer, SkFactorySet* fset)
+                             SkWriter32* writer, SkFactorySet* fset,
+                             SkGPipeSharedMemory* sharedMemory,
+                       SkTDArray<SkGPipeWriter::SharedBitmap>* sharedBitmaps)
         : fWriter(*writer) {
     fFactorySet = fset;
+    fSharedMemory = sharedMemory;
+    fSharedBitmaps = sharedBitmaps;
     fController = controller;
     fDone = false;
     fBlockSize = 0; // need first block from controller
@@ -267,7 +293,9 @@ bool SkGPipeCanvas::needOpBytes(size_t needed) {
 
     needed += 4;  // size of DrawOp atom
     if (fWriter.size() + needed > fBlockSize) {
-        void* block = fController->requestBlock(MIN_BLOCK_SIZE, &fBlockSize);
+        // a bitmap's pixels may need more than the usual block
+        size_t request = SkMax32(MIN_BLOCK_SIZE, SkAlign4(needed));
+        void* block = fController->requestBlock(request, &fBlockSize);
         if (NULL == block) {
             fDone = true;
             return false;
@@ -294,6 +322,112 @@ uint32_t SkGPipeCanvas::getTypefaceID(SkTypeface* face) {
     return id;
 }
 
+static bool same_pixels(uint32_t genID, const SkBitmap& bitmap,
+                        uint32_t otherGenID, uint32_t otherOffset,
+                        int otherWidth, int otherHeight) {
+    return genID == otherGenID && bitmap.pixelRefOffset() == otherOffset &&
+           bitmap.width() == otherWidth && bitmap.height() == otherHeight;
+}
+
+// return the handle of the bitmap's pixels in fSharedMemory, copying them
+// there the first time, or 0 if they must go in the pipe instead
+uint32_t SkGPipeCanvas::sharePixels(const SkBitmap& bitmap) {
+    // a color table would still need to be copied into the pipe
+    if (NULL == fSharedMemory || bitmap.getColorTable()) {
+        return 0;
+    }
+
+    uint32_t genID = bitmap.getGenerationID();
+    for (int i = 0; i < fSharedBitmaps->count(); i++) {
+        const SkGPipeWriter::SharedBitmap& rec = (*fSharedBitmaps)[i];
+        if (same_pixels(genID, bitmap, rec.fGenerationID, rec.fPixelRefOffset,
+                        rec.fWidth, rec.fHeight)) {
+            return rec.fHandle;
+        }
+    }
+
+    // the reader computes the same (minimal) rowbytes
+    size_t rowBytes = SkBitmap::ComputeRowBytes(bitmap.config(),
+                                                bitmap.width());
+    uint32_t handle = 0;
+    char* dst = (char*)fSharedMemory->alloc(SkAlign4(rowBytes *
+                                                     bitmap.height()),
+                                            &handle);
+    if (NULL == dst) {
+        return 0;
+    }
+    SkASSERT(handle);
+
+    const char* src = (const char*)bitmap.getPixels();
+    for (int y = 0; y < bitmap.height(); y++) {
+        memcpy(dst, src, rowBytes);
+        dst += rowBytes;
+        src += bitmap.rowBytes();
+    }
+
+    SkGPipeWriter::SharedBitmap* rec = fSharedBitmaps->append();
+    rec->fGenerationID = genID;
+    rec->fPixelRefOffset = bitmap.pixelRefOffset();
+    rec->fWidth = bitmap.width();
+    rec->fHeight = bitmap.height();
+    rec->fHandle = handle;
+    return handle;
+}
+
+// return 0 if the bitmap has no pixels to draw, or its index-base-1
+int SkGPipeCanvas::bitmapToIndex(const SkBitmap& bitmap) {
+    SkAutoLockPixels alp(bitmap);
+    if (NULL == bitmap.getPixels()) {
+        return 0;
+    }
+
+    uint32_t genID = bitmap.getGenerationID();
+    for (int i = 0; i < fBitmaps.count(); i++) {
+        const BitmapKey& key = fBitmaps[i];
+        if (same_pixels(genID, bitmap, key.fGenerationID, key.fPixelRefOffset,
+                        key.fWidth, key.fHeight)) {
+            return i + 1;
+        }
+    }
+
+    BitmapKey* key = fBitmaps.append();
+    key->fGenerationID = genID;
+    key->fPixelRefOffset = bitmap.pixelRefOffset();
+    key->fWidth = bitmap.width();
+    key->fHeight = bitmap.height();
+    int index = fBitmaps.count();
+
+    uint32_t handle = this->sharePixels(bitmap);
+    if (handle) {
+        if (this->needOpBytes(5 * sizeof(uint32_t))) {
+            this->writeOp(kDef_Bitmap_DrawOp, kDefBitmap_Shared_DrawOpFlag,
+                          index);
+            fWriter.write32(handle);
+            fWriter.write32(bitmap.config());
+            fWriter.write32(bitmap.width());
+            fWriter.write32(bitmap.height());
+            fWriter.writeBool(bitmap.isOpaque());
+        }
+    } else {
+        // flatten a view of just the pixels, so they are always copied
+        SkBitmap pixels;
+        pixels.setConfig(bitmap.config(), bitmap.width(), bitmap.height(),
+                         bitmap.rowBytes());
+        pixels.setPixels(bitmap.getPixels(), bitmap.getColorTable());
+        pixels.setIsOpaque(bitmap.isOpaque());
+
+        SkFlattenableWriteBuffer buffer(1024);
+        buffer.setFlags(SkFlattenableWriteBuffer::kCrossProcess_Flag);
+        pixels.flatten(buffer);
+        size_t size = buffer.size();
+        if (this->needOpBytes(size)) {
+            this->writeOp(kDef_Bitmap_DrawOp, 0, index);
+            buffer.flatten(fWriter.reserve(size));
+        }
+    }
+    return index;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define NOTIFY_SETUP(canvas)    \
@@ -482,6 +616,13 @@ void SkGPipeCanvas::drawRect(const SkRect& rect, const SkPaint& paint) {
     }
 }
 
+void SkGPipeCanvas::drawRects(const SkRect rects[], size_t count,
+                              const SkPaint& paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawRect(rects[i], paint);
+    }
+}
+
 void SkGPipeCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     NOTIFY_SETUP(this);
     this->writePaint(paint);
@@ -491,24 +632,90 @@ void SkGPipeCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     }
 }
 
-void SkGPipeCanvas::drawBitmap(const SkBitmap&, SkScalar left, SkScalar top,
-                                   const SkPaint*) {
-    UNIMPLEMENTED
+void SkGPipeCanvas::drawBitmap(const SkBitmap& bitmap, SkScalar left,
+                               SkScalar top, const SkPaint* paint) {
+    NOTIFY_SETUP(this);
+    int index = this->bitmapToIndex(bitmap);
+    if (index) {
+        unsigned flags = 0;
+        if (paint) {
+            flags |= kDrawBitmap_HasPaint_DrawOpFlag;
+            this->writePaint(*paint);
+        }
+        if (this->needOpBytes(2 * sizeof(SkScalar))) {
+            this->writeOp(kDrawBitmap_DrawOp, flags, index);
+            fWriter.writeScalar(left);
+            fWriter.writeScalar(top);
+        }
+    }
 }
 
-void SkGPipeCanvas::drawBitmapRect(const SkBitmap&, const SkIRect* src,
-                                       const SkRect& dst, const SkPaint*) {
-    UNIMPLEMENTED
+void SkGPipeCanvas::drawBitmapRect(const SkBitmap& bitmap, const SkIRect* src,
+                                   const SkRect& dst, const SkPaint* paint) {
+    NOTIFY_SETUP(this);
+    int index = this->bitmapToIndex(bitmap);
+    if (index) {
+        unsigned flags = 0;
+        size_t size = sizeof(SkRect);
+        if (paint) {
+            flags |= kDrawBitmap_HasPaint_DrawOpFlag;
+            this->writePaint(*paint);
+        }
+        if (src) {
+            flags |= kDrawBitmap_HasSrcRect_DrawOpFlag;
+            size += sizeof(SkIRect);
+        }
+        if (this->needOpBytes(size)) {
+            this->writeOp(kDrawBitmapRect_DrawOp, flags, index);
+            if (src) {
+                fWriter.write(src, sizeof(SkIRect));
+            }
+            fWriter.writeRect(dst);
+        }
+    }
 }
 
-void SkGPipeCanvas::drawBitmapMatrix(const SkBitmap&, const SkMatrix&,
-                                         const SkPaint*) {
-    UNIMPLEMENTED
+void SkGPipeCanvas::drawBitmapMatrix(const SkBitmap& bitmap,
+                                     const SkMatrix& matrix,
+                                     const SkPaint* paint) {
+    NOTIFY_SETUP(this);
+    int index = this->bitmapToIndex(bitmap);
+    if (index) {
+        unsigned flags = 0;
+        if (paint) {
+            flags |= kDrawBitmap_HasPaint_DrawOpFlag;
+            this->writePaint(*paint);
+        }
+        if (this->needOpBytes(matrix.flatten(NULL))) {
+            this->writeOp(kDrawBitmapMatrix_DrawOp, flags, index);
+            SkWriteMatrix(&fWriter, matrix);
+        }
+    }
 }
 
-void SkGPipeCanvas::drawSprite(const SkBitmap&, int left, int top,
-                                   const SkPaint*) {
-    UNIMPLEMENTED
+void SkGPipeCanvas::drawSprite(const SkBitmap& bitmap, int left, int top,
+                               const SkPaint* paint) {
+    NOTIFY_SETUP(this);
+    int index = this->bitmapToIndex(bitmap);
+    if (index) {
+        unsigned flags = 0;
+        if (paint) {
+            flags |= kDrawBitmap_HasPaint_DrawOpFlag;
+            this->writePaint(*paint);
+        }
+        if (this->needOpBytes(2 * sizeof(int32_t))) {
+            this->writeOp(kDrawSprite_DrawOp, flags, index);
+            fWriter.write32(left);
+            fWriter.write32(top);
+        }
+    }
+}
+
+void SkGPipeCanvas::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                                size_t count, const SkPaint* paint) {
+    for (size_t i = 0; i < count; i++) {
+        this->drawSprite(bitmap, pts[i].fX, pts[i].fY, paint);
+    }
 }
 
 void SkGPipeCanvas::drawText(const void* text, size_t byteLength, SkScalar x, 
@@ -761,21 +968,30 @@ void SkGPipeCanvas::writePaint(const SkPaint& paint) {
 
 SkGPipeWriter::SkGPipeWriter() : fWriter(0) {
     fCanvas = NULL;
+    fSharedMemory = NULL;
 }
 
 SkGPipeWriter::~SkGPipeWriter() {
     this->endRecording();
     SkSafeUnref(fCanvas);
+    SkSafeUnref(fSharedMemory);
 }
 
 SkCanvas* SkGPipeWriter::startRecording(SkGPipeController* controller,
-                                        uint32_t flags) {
+                                        uint32_t flags,
+                                        SkGPipeSharedMemory* sharedMemory) {
     if (NULL == fCanvas) {
         fWriter.reset(NULL, 0);
         fFactorySet.reset();
+        if (sharedMemory != fSharedMemory) {
+            // our handles are only good for the memory they came from
+            fSharedBitmaps.reset();
+            SkRefCnt_SafeAssign(fSharedMemory, sharedMemory);
+        }
         fCanvas = SkNEW_ARGS(SkGPipeCanvas, (controller, &fWriter,
                                              (flags & kCrossProcess_Flag) ?
-                                             &fFactorySet : NULL));
+                                             &fFactorySet : NULL,
+                                             fSharedMemory, &fSharedBitmaps));
     }
     return fCanvas;
 }
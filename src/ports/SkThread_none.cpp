@@ -31,6 +31,59 @@ int32_t sk_atomic_dec(int32_t* addr)
     return value;
 }
 
+void sk_parallel_for(SkParallelProc proc, void* context, int count)
+{
+    for (int i = 0; i < count; i++) {
+        proc(context, i);
+    }
+}
+
+namespace {
+
+struct ThreadData {
+    SkThreadDataCreateProc  fCreateProc;
+    SkThreadDataDeleteProc  fDeleteProc;
+    void*                   fData;
+    ThreadData*             fNext;
+};
+
+}
+
+// with just the one thread, its data lives until sk_delete_thread_data()
+static ThreadData* gThreadData;
+
+void* sk_thread_data(SkThreadDataCreateProc createProc,
+                     SkThreadDataDeleteProc deleteProc)
+{
+    for (ThreadData* rec = gThreadData; rec; rec = rec->fNext) {
+        if (rec->fCreateProc == createProc) {
+            return rec->fData;
+        }
+    }
+
+    ThreadData* rec = SkNEW(ThreadData);
+    rec->fCreateProc = createProc;
+    rec->fDeleteProc = deleteProc;
+    rec->fData = createProc();
+    rec->fNext = gThreadData;
+    gThreadData = rec;
+    return rec->fData;
+}
+
+void sk_delete_thread_data()
+{
+    ThreadData* rec = gThreadData;
+    gThreadData = NULL;
+    while (rec) {
+        ThreadData* next = rec->fNext;
+        if (rec->fDeleteProc) {
+            rec->fDeleteProc(rec->fData);
+        }
+        SkDELETE(rec);
+        rec = next;
+    }
+}
+
 SkMutex::SkMutex(bool /* isGlobal */)
 {
 }
@@ -23,6 +23,178 @@ int32_t sk_atomic_dec(int32_t* addr)
     return value;
 }
 
+/*  sk_parallel_for runs its calls on a pool of worker threads, which are
+    started as they are first needed and then kept, waiting for the next job,
+    for the life of the process. There is one job at a time: a call made
+    while the pool is busy (from another thread, or from inside a job) runs
+    all of its calls on the calling thread.
+ */
+
+namespace {
+
+struct ParallelPool {
+    pthread_mutex_t fMutex;
+    pthread_cond_t  fWorkCond;  // signalled when a job is posted
+    pthread_cond_t  fDoneCond;  // signalled when a job's last call returns
+    int             fThreadCount;
+    bool            fBusy;
+    SkParallelProc  fProc;
+    void*           fContext;
+    int             fNext;      // next index to run
+    int             fCount;
+    int             fPending;   // calls that have not returned yet
+};
+
+}
+
+static ParallelPool gParallelPool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, 0, false, NULL, NULL, 0, 0, 0
+};
+
+// Runs the job's remaining calls, one index at a time. Called (and returns)
+// with the pool's mutex held.
+static void run_parallel_calls(ParallelPool* pool)
+{
+    while (pool->fNext < pool->fCount) {
+        int index = pool->fNext++;
+        pthread_mutex_unlock(&pool->fMutex);
+        pool->fProc(pool->fContext, index);
+        pthread_mutex_lock(&pool->fMutex);
+        if (0 == --pool->fPending) {
+            pthread_cond_signal(&pool->fDoneCond);
+        }
+    }
+}
+
+static void* parallel_thread_proc(void* data)
+{
+    ParallelPool* pool = static_cast<ParallelPool*>(data);
+
+    pthread_mutex_lock(&pool->fMutex);
+    for (;;) {
+        while (pool->fNext >= pool->fCount) {
+            pthread_cond_wait(&pool->fWorkCond, &pool->fMutex);
+        }
+        run_parallel_calls(pool);
+    }
+    return NULL;
+}
+
+void sk_parallel_for(SkParallelProc proc, void* context, int count)
+{
+    // more threads than this are unlikely to be cores
+    static const int kMaxThreadCount = 31;
+
+    if (count <= 0) {
+        return;
+    }
+
+    ParallelPool* pool = &gParallelPool;
+    pthread_mutex_lock(&pool->fMutex);
+    if (pool->fBusy || count < 2) {
+        pthread_mutex_unlock(&pool->fMutex);
+        for (int i = 0; i < count; i++) {
+            proc(context, i);
+        }
+        return;
+    }
+    pool->fBusy = true;
+
+    // if we fail to start a thread, the rest of the calls run on this one
+    int threadCount = SkMin32(count - 1, kMaxThreadCount);
+    while (pool->fThreadCount < threadCount) {
+        pthread_t thread;
+        if (0 != pthread_create(&thread, NULL, parallel_thread_proc, pool)) {
+            break;
+        }
+        pthread_detach(thread);
+        pool->fThreadCount += 1;
+    }
+
+    pool->fProc = proc;
+    pool->fContext = context;
+    pool->fNext = 0;
+    pool->fCount = count;
+    pool->fPending = count;
+    pthread_cond_broadcast(&pool->fWorkCond);
+
+    run_parallel_calls(pool);
+    while (pool->fPending > 0) {
+        pthread_cond_wait(&pool->fDoneCond, &pool->fMutex);
+    }
+
+    pool->fNext = pool->fCount = 0;
+    pool->fBusy = false;
+    pthread_mutex_unlock(&pool->fMutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// one thread's data for one createProc; each thread keeps a list of these
+struct ThreadData {
+    SkThreadDataCreateProc  fCreateProc;
+    SkThreadDataDeleteProc  fDeleteProc;
+    void*                   fData;
+    ThreadData*             fNext;
+};
+
+}
+
+static pthread_key_t gThreadDataKey;
+static pthread_once_t gThreadDataOnce = PTHREAD_ONCE_INIT;
+
+static void delete_thread_data(void* head)
+{
+    ThreadData* rec = static_cast<ThreadData*>(head);
+    while (rec) {
+        ThreadData* next = rec->fNext;
+        if (rec->fDeleteProc) {
+            rec->fDeleteProc(rec->fData);
+        }
+        SkDELETE(rec);
+        rec = next;
+    }
+}
+
+static void make_thread_data_key()
+{
+    (void)pthread_key_create(&gThreadDataKey, delete_thread_data);
+}
+
+void* sk_thread_data(SkThreadDataCreateProc createProc,
+                     SkThreadDataDeleteProc deleteProc)
+{
+    (void)pthread_once(&gThreadDataOnce, make_thread_data_key);
+
+    ThreadData* head = static_cast<ThreadData*>(
+                                        pthread_getspecific(gThreadDataKey));
+    for (ThreadData* rec = head; rec; rec = rec->fNext) {
+        if (rec->fCreateProc == createProc) {
+            return rec->fData;
+        }
+    }
+
+    ThreadData* rec = SkNEW(ThreadData);
+    rec->fCreateProc = createProc;
+    rec->fDeleteProc = deleteProc;
+    rec->fData = createProc();
+    rec->fNext = head;
+    (void)pthread_setspecific(gThreadDataKey, rec);
+    return rec->fData;
+}
+
+void sk_delete_thread_data()
+{
+    (void)pthread_once(&gThreadDataOnce, make_thread_data_key);
+
+    void* head = pthread_getspecific(gThreadDataKey);
+    (void)pthread_setspecific(gThreadDataKey, NULL);
+    delete_thread_data(head);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 static void print_pthread_error(int status)
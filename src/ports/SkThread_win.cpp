@@ -29,6 +29,167 @@ int32_t sk_atomic_dec(int32_t* addr)
     return InterlockedDecrement(reinterpret_cast<LONG*>(addr)) + 1;
 }
 
+namespace {
+
+// one thread's data for one createProc; each thread keeps a list of these
+struct ThreadData {
+    SkThreadDataCreateProc  fCreateProc;
+    SkThreadDataDeleteProc  fDeleteProc;
+    void*                   fData;
+    ThreadData*             fNext;
+};
+
+}
+
+static DWORD gThreadDataIndex = TlsAlloc();
+
+// Windows won't tell us when threads exit, so their data is only freed by
+// sk_delete_thread_data(); the threads sk_parallel_for starts are kept for the
+// life of the process anyway
+void* sk_thread_data(SkThreadDataCreateProc createProc,
+                     SkThreadDataDeleteProc deleteProc)
+{
+    ThreadData* head = static_cast<ThreadData*>(TlsGetValue(gThreadDataIndex));
+    for (ThreadData* rec = head; rec; rec = rec->fNext) {
+        if (rec->fCreateProc == createProc) {
+            return rec->fData;
+        }
+    }
+
+    ThreadData* rec = SkNEW(ThreadData);
+    rec->fCreateProc = createProc;
+    rec->fDeleteProc = deleteProc;
+    rec->fData = createProc();
+    rec->fNext = head;
+    TlsSetValue(gThreadDataIndex, rec);
+    return rec->fData;
+}
+
+void sk_delete_thread_data()
+{
+    ThreadData* rec = static_cast<ThreadData*>(TlsGetValue(gThreadDataIndex));
+    TlsSetValue(gThreadDataIndex, NULL);
+    while (rec) {
+        ThreadData* next = rec->fNext;
+        if (rec->fDeleteProc) {
+            rec->fDeleteProc(rec->fData);
+        }
+        SkDELETE(rec);
+        rec = next;
+    }
+}
+
+/*  sk_parallel_for runs its calls on a pool of worker threads, which are
+    started as they are first needed and then kept, waiting for the next job,
+    for the life of the process. There is one job at a time: a call made
+    while the pool is busy (from another thread, or from inside a job) runs
+    all of its calls on the calling thread.
+ */
+
+namespace {
+
+struct ParallelPool {
+    SkMutex         fMutex;
+    HANDLE          fWorkSemaphore; // released once per thread for each job
+    HANDLE          fDoneEvent;     // set when a job's last call returns
+    int             fThreadCount;
+    bool            fBusy;
+    SkParallelProc  fProc;
+    void*           fContext;
+    int             fNext;          // next index to run
+    int             fCount;
+    int             fPending;       // calls that have not returned yet
+};
+
+ParallelPool gParallelPool;
+
+// Runs the job's remaining calls, one index at a time. Called (and returns)
+// with the pool's mutex held.
+void run_parallel_calls(ParallelPool* pool)
+{
+    while (pool->fNext < pool->fCount) {
+        int index = pool->fNext++;
+        pool->fMutex.release();
+        pool->fProc(pool->fContext, index);
+        pool->fMutex.acquire();
+        if (0 == --pool->fPending) {
+            SetEvent(pool->fDoneEvent);
+        }
+    }
+}
+
+DWORD WINAPI parallel_thread_proc(LPVOID data)
+{
+    ParallelPool* pool = static_cast<ParallelPool*>(data);
+    for (;;) {
+        WaitForSingleObject(pool->fWorkSemaphore, INFINITE);
+        pool->fMutex.acquire();
+        run_parallel_calls(pool);
+        pool->fMutex.release();
+    }
+    return 0;
+}
+
+}
+
+void sk_parallel_for(SkParallelProc proc, void* context, int count)
+{
+    // more threads than this are unlikely to be cores
+    static const int kMaxThreadCount = 31;
+
+    if (count <= 0) {
+        return;
+    }
+
+    ParallelPool* pool = &gParallelPool;
+    pool->fMutex.acquire();
+    if (NULL == pool->fWorkSemaphore) {
+        pool->fWorkSemaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+        pool->fDoneEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    }
+    if (pool->fBusy || count < 2 ||
+            NULL == pool->fWorkSemaphore || NULL == pool->fDoneEvent) {
+        pool->fMutex.release();
+        for (int i = 0; i < count; i++) {
+            proc(context, i);
+        }
+        return;
+    }
+    pool->fBusy = true;
+
+    // if we fail to start a thread, the rest of the calls run on this one
+    int threadCount = SkMin32(count - 1, kMaxThreadCount);
+    while (pool->fThreadCount < threadCount) {
+        HANDLE thread = CreateThread(NULL, 0, parallel_thread_proc, pool, 0,
+                                     NULL);
+        if (NULL == thread) {
+            break;
+        }
+        CloseHandle(thread);
+        pool->fThreadCount += 1;
+    }
+
+    pool->fProc = proc;
+    pool->fContext = context;
+    pool->fNext = 0;
+    pool->fCount = count;
+    pool->fPending = count;
+    ResetEvent(pool->fDoneEvent);
+    ReleaseSemaphore(pool->fWorkSemaphore, SkMin32(threadCount,
+                                                   pool->fThreadCount), NULL);
+
+    run_parallel_calls(pool);
+    while (pool->fPending > 0) {
+        pool->fMutex.release();
+        WaitForSingleObject(pool->fDoneEvent, INFINITE);
+        pool->fMutex.acquire();
+    }
+
+    pool->fNext = pool->fCount = 0;
+    pool->fBusy = false;
+    pool->fMutex.release();
+}
+
 SkMutex::SkMutex(bool /* isGlobal */)
 {
     SK_COMPILE_ASSERT(sizeof(fStorage) > sizeof(CRITICAL_SECTION),
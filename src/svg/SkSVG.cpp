@@ -2,35 +2,153 @@
 **
 ** Copyright 2006, The Android Open Source Project
 **
-** Licensed under the Apache License, Version 2.0 (the "License"); 
-** you may not use this file except in compliance with the License. 
-** You may obtain a copy of the License at 
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
 **
-**     http://www.apache.org/licenses/LICENSE-2.0 
+**     http://www.apache.org/licenses/LICENSE-2.0
 **
-** Unless required by applicable law or agreed to in writing, software 
-** distributed under the License is distributed on an "AS IS" BASIS, 
-** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
-** See the License for the specific language governing permissions and 
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
 ** limitations under the License.
 */
 
 #include "SkSVG.h"
-#include 'SkSVGParser.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPicture.h"
+#include "SkSVGParser.h"
+#include "SkSVGRenderer.h"
+#include "SkSVGSVG.h"
+#include "SkStream.h"
+#include "SkThread.h"
 
-SkSVG::SkSVG() {
+namespace {
+
+struct CacheEntry {
+    uint32_t fHash;
+    SkData* fSource;    // compared on a hash match, so collisions can't alias
+    SkPicture* fPicture;
+};
+
+}
+
+static SkMutex gCacheMutex;
+static SkTDArray<CacheEntry> gCache;    // the most recently used is last
+static int gCacheCountLimit = 16;
+
+static uint32_t compute_hash(const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint32_t hash = (uint32_t) length;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash << 5) | (hash >> 27);
+        hash ^= bytes[i];
+    }
+    return hash;
+}
+
+static void purge_entries(int keepCount) {
+    int count = gCache.count() - keepCount;
+    if (count <= 0)
+        return;
+    for (int i = 0; i < count; i++) {
+        gCache[i].fSource->unref();
+        gCache[i].fPicture->unref();
+    }
+    gCache.remove(0, count);
+}
+
+static SkPicture* find_picture(uint32_t hash, const void* data, size_t length) {
+    SkAutoMutexAcquire ac(gCacheMutex);
+    for (int i = gCache.count() - 1; i >= 0; i--) {
+        CacheEntry& entry = gCache[i];
+        if (entry.fHash == hash && entry.fSource->size() == length &&
+                memcmp(entry.fSource->data(), data, length) == 0) {
+            CacheEntry found = entry;
+            gCache.remove(i);
+            *gCache.append() = found;
+            found.fPicture->ref();
+            return found.fPicture;
+        }
+    }
+    return NULL;
+}
+
+static void add_picture(uint32_t hash, const void* data, size_t length,
+                        SkPicture* picture) {
+    SkAutoMutexAcquire ac(gCacheMutex);
+    if (gCacheCountLimit <= 0)
+        return;
+    purge_entries(gCacheCountLimit - 1);
+    CacheEntry* entry = gCache.append();
+    entry->fHash = hash;
+    entry->fSource = SkData::NewWithCopy(data, length);
+    entry->fPicture = picture;
+    picture->ref();
 }
 
-SkSVG::~SkSVG() {
+static SkPicture* record_document(SkSVGParser& parser) {
+    const SkTDArray<SkSVGElement*>& children = parser.getChildren();
+    SkScalar width = 0, height = 0;
+    SkMatrix matrix;
+    matrix.reset();
+    if (children.count() > 0 && children[0]->getType() == SkSVGType_SVG)
+        ((SkSVGSVG*) children[0])->getViewport(&width, &height, &matrix);
+    SkPicture* picture = new SkPicture;
+    SkCanvas* canvas = picture->beginRecording(SkScalarCeil(width),
+                                               SkScalarCeil(height));
+    canvas->concat(matrix);
+    SkSVGRenderer renderer(parser, canvas);
+    renderer.renderDocument();
+    picture->endRecording();
+    return picture;
 }
 
-bool SkSVG::decodeStream(SkStream* stream);
-{
-    size_t size = stream->read(nil, 0);
-    SkAutoMalloc    storage(size);
-    char* data = (char*)storage.get();
+SkPicture* SkSVG::DecodeMemory(const void* data, size_t length,
+                               SkXMLParserError* error) {
+    uint32_t hash = compute_hash(data, length);
+    SkPicture* picture = find_picture(hash, data, length);
+    if (picture)
+        return picture;
+    SkSVGParser parser(error);
+    if (parser.parse((const char*) data, length) == false)
+        return NULL;
+    picture = record_document(parser);
+    add_picture(hash, data, length, picture);
+    return picture;
+}
+
+SkPicture* SkSVG::DecodeStream(SkStream* stream, SkXMLParserError* error) {
+    size_t size = stream->read(NULL, 0);
+    SkAutoMalloc storage(size);
+    char* data = (char*) storage.get();
     size_t actual = stream->read(data, size);
-    SkASSERT(size == actual);
-    SkSVGParser parser(*fMaker);
-    return parser.parse(data, actual, &fErrorCode, &fErrorLineNumber);
+    return DecodeMemory(data, actual, error);
+}
+
+SkPicture* SkSVG::DecodeFile(const char path[], SkXMLParserError* error) {
+    SkFILEStream stream(path);
+    if (stream.isValid() == false)
+        return NULL;
+    return DecodeStream(&stream, error);
+}
+
+int SkSVG::GetCacheCountLimit() {
+    SkAutoMutexAcquire ac(gCacheMutex);
+    return gCacheCountLimit;
+}
+
+int SkSVG::SetCacheCountLimit(int count) {
+    SkAutoMutexAcquire ac(gCacheMutex);
+    int prev = gCacheCountLimit;
+    gCacheCountLimit = SkMax32(count, 0);
+    purge_entries(gCacheCountLimit);
+    return prev;
+}
+
+void SkSVG::PurgeCache() {
+    SkAutoMutexAcquire ac(gCacheMutex);
+    purge_entries(0);
 }
@@ -17,6 +17,7 @@
 
 #include "SkSVGCircle.h"
 #include "SkSVGParser.h"
+#include "SkPath.h"
 #include "SkParse.h"
 #include <stdio.h>
 
@@ -51,3 +52,14 @@ void SkSVGCircle::translate(SkSVGParser& parser, bool defState) {
     parser._addAttribute("bottom", scratch);
     parser._endElement();
 }
+
+bool SkSVGCircle::getPath(SkPath* path) {
+    SkScalar cx = 0, cy = 0, r = 0;
+    SkParse::FindScalar(f_cx.c_str(), &cx);
+    SkParse::FindScalar(f_cy.c_str(), &cy);
+    SkParse::FindScalar(f_r.c_str(), &r);
+    if (r <= 0)
+        return false;
+    path->addCircle(cx, cy, r);
+    return true;
+}
@@ -27,6 +27,10 @@ bool SkSVGDefs::isNotDef() {
     return false;
 }
 
+void SkSVGDefs::render(SkSVGRenderer& ) {
+    // definitions are drawn only where they are used
+}
+
 void SkSVGDefs::translate(SkSVGParser& parser, bool defState) {
     INHERITED::translate(parser, defState);
 }
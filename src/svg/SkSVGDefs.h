@@ -24,6 +24,7 @@ class SkSVGDefs : public SkSVGGroup {
     DECLARE_SVG_INFO(Defs);
     virtual bool isDef();
     virtual bool isNotDef();
+    virtual void render(SkSVGRenderer& );
 private:
     typedef SkSVGGroup INHERITED;
 };
@@ -17,6 +17,8 @@
 
 #include "SkSVGElements.h"
 #include "SkSVGParser.h"
+#include "SkSVGRenderer.h"
+#include "SkPath.h"
 
 SkSVGBase::~SkSVGBase() {
 }
@@ -39,6 +41,10 @@ SkSVGElement* SkSVGElement::getGradient() {
     return NULL;
 }
 
+bool SkSVGElement::getPath(SkPath* ) {
+    return false;
+}
+
 bool SkSVGElement::isGroupParent() {
     SkSVGElement* parent = fParent;
     while (parent) {
@@ -76,6 +82,12 @@ bool SkSVGElement::onStartElement(SkSVGElement* child) {
     return false;
 }
 
+void SkSVGElement::render(SkSVGRenderer& renderer) {
+    SkPath path;
+    if (getPath(&path))
+        renderer.drawPath(path);
+}
+
 void SkSVGElement::translate(SkSVGParser& parser, bool) {
     if (f_id.size() > 0)
         SVG_ADD_ATTRIBUTE(id);
@@ -22,7 +22,9 @@
 #include "SkSVGTypes.h"
 #include "SkTDArray.h"
 
+class SkPath;
 class SkSVGParser;
+class SkSVGRenderer;
 
 #define DECLARE_SVG_INFO(_type) \
 public: \
@@ -57,6 +59,8 @@ public:
     SkSVGElement();
     virtual ~SkSVGElement();
     virtual SkSVGElement* getGradient();
+    // returns false if the element has no geometry of its own
+    virtual bool getPath(SkPath* path);
     virtual SkSVGTypes getType() const  = 0;
     virtual bool isDef();
     virtual bool isFlushable();
@@ -64,6 +68,8 @@ public:
     virtual bool isNotDef();
     virtual bool onEndElement(SkSVGParser& parser);
     virtual bool onStartElement(SkSVGElement* child);
+    // draws the element directly, instead of translating it to animator XML
+    virtual void render(SkSVGRenderer& renderer);
     void setIsDef();
 //  void setIsNotDef();
     virtual void translate(SkSVGParser& parser, bool defState);
@@ -17,6 +17,7 @@
 
 #include "SkSVGEllipse.h"
 #include "SkSVGParser.h"
+#include "SkPath.h"
 #include "SkParse.h"
 #include <stdio.h>
 
@@ -53,3 +54,17 @@ void SkSVGEllipse::translate(SkSVGParser& parser, bool defState) {
     parser._addAttribute("bottom", scratch);
     parser._endElement();
 }
+
+bool SkSVGEllipse::getPath(SkPath* path) {
+    SkScalar cx = 0, cy = 0, rx = 0, ry = 0;
+    SkParse::FindScalar(f_cx.c_str(), &cx);
+    SkParse::FindScalar(f_cy.c_str(), &cy);
+    SkParse::FindScalar(f_rx.c_str(), &rx);
+    SkParse::FindScalar(f_ry.c_str(), &ry);
+    if (rx <= 0 || ry <= 0)
+        return false;
+    SkRect oval;
+    oval.set(cx - rx, cy - ry, cx + rx, cy + ry);
+    path->addOval(oval);
+    return true;
+}
@@ -17,6 +17,8 @@
 
 #include "SkSVGGradient.h"
 #include "SkSVGParser.h"
+#include "SkParse.h"
+#include "SkShader.h"
 #include "SkSVGStop.h"
 
 SkSVGGradient::SkSVGGradient() {
@@ -34,6 +36,40 @@ bool SkSVGGradient::isNotDef() {
     return false;
 }
 
+int SkSVGGradient::getStops(SkTDArray<SkColor>* colors, SkTDArray<SkScalar>* offsets) {
+    SkScalar last = 0;
+    for (SkSVGElement** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++) {
+        if ((*ptr)->getType() != SkSVGType_Stop)
+            continue;
+        SkSVGStop* stop = (SkSVGStop*) *ptr;
+        SkScalar offset = 0;
+        const char* end = SkParse::FindScalar(stop->f_offset.c_str(), &offset);
+        if (end && *end == '%')
+            offset /= 100;
+        offset = SkScalarPin(offset, last, SK_Scalar1);
+        last = offset;
+        SkColor color = SK_ColorBLACK;
+        SkSVGPaint& paint = stop->fPaintState;
+        if (paint.f_stopColor.size() > 0)
+            SkParse::FindColor(paint.f_stopColor.c_str(), &color);
+        if (paint.f_stopOpacity.size() > 0) {
+            SkScalar opacity = SK_Scalar1;
+            SkParse::FindScalar(paint.f_stopOpacity.c_str(), &opacity);
+            opacity = SkScalarPin(opacity, 0, SK_Scalar1);
+            color = SkColorSetA(color, SkScalarRound(opacity * SkColorGetA(color)));
+        }
+        *colors->append() = color;
+        *offsets->append() = offset;
+    }
+    return colors->count();
+}
+
+void SkSVGGradient::setShaderMatrix(SkShader* shader, const SkString& transform) {
+    SkMatrix matrix;
+    if (transform.size() > 0 && SkSVGParser::ParseTransform(transform.c_str(), &matrix))
+        shader->setLocalMatrix(matrix);
+}
+
 void SkSVGGradient::translate(SkSVGParser& parser, bool defState) {
     INHERITED::translate(parser, defState);
     // !!! no support for 'objectBoundingBox' yet
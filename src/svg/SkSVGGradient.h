@@ -18,8 +18,11 @@
 #ifndef SkSVGGradient_DEFINED
 #define SkSVGGradient_DEFINED
 
+#include "SkColor.h"
 #include "SkSVGElements.h"
 
+class SkShader;
+
 class SkSVGGradient : public SkSVGElement {
 public:
     SkSVGGradient();
@@ -27,7 +30,11 @@ public:
     virtual bool isDef();
     virtual bool isNotDef();
     virtual void write(SkSVGParser& , SkString& color);
+    // returns the gradient's shader, or NULL if it can't be drawn
+    virtual SkShader* createShader() = 0;
 protected:
+    int getStops(SkTDArray<SkColor>* colors, SkTDArray<SkScalar>* offsets);
+    void setShaderMatrix(SkShader* shader, const SkString& transform);
     void translate(SkSVGParser& , bool defState);
     void translateGradientUnits(SkString& units);
 private:
@@ -17,6 +17,7 @@
 
 #include "SkSVGGroup.h"
 #include "SkSVGParser.h"
+#include "SkSVGRenderer.h"
 
 SkSVGGroup::SkSVGGroup() {
     fIsNotDef = false;
@@ -47,6 +48,11 @@ bool SkSVGGroup::isNotDef() {
     return fParent ? fParent->isNotDef() : false;
 }
 
+void SkSVGGroup::render(SkSVGRenderer& renderer) {
+    for (SkSVGElement** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++)
+        renderer.render(*ptr);
+}
+
 void SkSVGGroup::translate(SkSVGParser& parser, bool defState) {
     for (SkSVGElement** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++)
         parser.translate(*ptr, defState);
@@ -28,6 +28,7 @@ public:
     virtual bool isFlushable();
     virtual bool isGroup();
     virtual bool isNotDef();
+    virtual void render(SkSVGRenderer& );
     void translate(SkSVGParser& , bool defState);
 private:
     typedef SkSVGElement INHERITED;
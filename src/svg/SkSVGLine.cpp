@@ -17,6 +17,8 @@
 
 #include "SkSVGLine.h"
 #include "SkSVGParser.h"
+#include "SkParse.h"
+#include "SkPath.h"
 
 const SkSVGAttribute SkSVGLine::gAttributes[] = {
     SVG_ATTRIBUTE(x1),
@@ -36,3 +38,14 @@ void SkSVGLine::translate(SkSVGParser& parser, bool defState) {
     SVG_ADD_ATTRIBUTE(y2);
     parser._endElement();
 }
+
+bool SkSVGLine::getPath(SkPath* path) {
+    SkScalar x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    SkParse::FindScalar(f_x1.c_str(), &x1);
+    SkParse::FindScalar(f_y1.c_str(), &y1);
+    SkParse::FindScalar(f_x2.c_str(), &x2);
+    SkParse::FindScalar(f_y2.c_str(), &y2);
+    path->moveTo(x1, y1);
+    path->lineTo(x2, y2);
+    return true;
+}
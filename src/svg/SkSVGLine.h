@@ -22,6 +22,7 @@
 
 class SkSVGLine : public SkSVGElement {
     DECLARE_SVG_INFO(Line);
+    virtual bool getPath(SkPath* path);
 private:
     SkString f_x1;
     SkString f_x2;
@@ -17,6 +17,8 @@
 
 #include "SkSVGLinearGradient.h"
 #include "SkSVGParser.h"
+#include "SkGradientShader.h"
+#include "SkParse.h"
 
 const SkSVGAttribute SkSVGLinearGradient::gAttributes[] = {
     SVG_ATTRIBUTE(gradientTransform),
@@ -50,3 +52,22 @@ void SkSVGLinearGradient::translate(SkSVGParser& parser, bool defState) {
     INHERITED::translate(parser, defState);
     parser._endElement();
 }
+
+SkShader* SkSVGLinearGradient::createShader() {
+    SkTDArray<SkColor> colors;
+    SkTDArray<SkScalar> offsets;
+    if (getStops(&colors, &offsets) < 2)
+        return NULL;
+    SkPoint pts[2];
+    pts[0].set(0, 0);
+    pts[1].set(0, 0);
+    SkParse::FindScalar(f_x1.c_str(), &pts[0].fX);
+    SkParse::FindScalar(f_y1.c_str(), &pts[0].fY);
+    SkParse::FindScalar(f_x2.c_str(), &pts[1].fX);
+    SkParse::FindScalar(f_y2.c_str(), &pts[1].fY);
+    SkShader* shader = SkGradientShader::CreateLinear(pts, colors.begin(),
+        offsets.begin(), colors.count(), SkShader::kClamp_TileMode);
+    if (shader)
+        setShaderMatrix(shader, f_gradientTransform);
+    return shader;
+}
@@ -22,6 +22,7 @@
 
 class SkSVGLinearGradient : public SkSVGGradient {
     DECLARE_SVG_INFO(LinearGradient);
+    virtual SkShader* createShader();
 private:
     SkString f_gradientTransform;
     SkString f_gradientUnits;
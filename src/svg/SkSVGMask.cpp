@@ -36,6 +36,10 @@ bool SkSVGMask::isNotDef() {
     return false;
 }
 
+void SkSVGMask::render(SkSVGRenderer& ) {
+    // !!! masks are not drawn yet
+}
+
 void SkSVGMask::translate(SkSVGParser& parser, bool defState) {
     INHERITED::translate(parser, defState);
 }
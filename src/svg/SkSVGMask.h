@@ -24,6 +24,7 @@ class SkSVGMask : public SkSVGGroup {
     DECLARE_SVG_INFO(Mask);
     virtual bool isDef();
     virtual bool isNotDef();
+    virtual void render(SkSVGRenderer& );
 protected:
     SkString f_height;
     SkString f_maskUnits;
@@ -16,6 +16,7 @@
 */
 
 #include "SkSVGParser.h"
+#include "SkParse.h"
 #include "SkSVGCircle.h"
 #include "SkSVGClipPath.h"
 #include "SkSVGDefs.h"
@@ -63,6 +64,7 @@ SkSVGParser::SkSVGParser(SkXMLParserError* errHandler) :
 }
 
 SkSVGParser::~SkSVGParser() {
+    Delete(fChildren);
 }
 
 void SkSVGParser::Delete(SkTDArray<SkSVGElement*>& fChildren) {
@@ -90,7 +92,6 @@ int SkSVGParser::findAttribute(SkSVGBase* element, const char* attrValue,
     return -1;
 }
 
-#if 0
 const char* SkSVGParser::getFinal() {
     _startElement("screenplay");
     // generate defs
@@ -112,10 +113,11 @@ const char* SkSVGParser::getFinal() {
     _endElement(); // event
     _endElement(); // screenplay
     Delete(fChildren);
-    fStream.write("", 1);
-    return fStream.getStream();
+    fChildren.reset();
+    fFinal.resize(fStream.getOffset());
+    fStream.copyTo(fFinal.writable_str());
+    return fFinal.c_str();
 }
-#endif
 
 SkString& SkSVGParser::getPaintLast(SkSVGPaint::Field field) {
     SkSVGPaint* state = fHead;
@@ -160,7 +162,9 @@ bool SkSVGParser::onAddAttribute(const char name[], const char value[]) {
 bool SkSVGParser::onAddAttributeLen(const char name[], const char value[], size_t len) {
     if (fCurrElement == NULL)    // this signals we should ignore attributes for this element
         return true;
-    if (fCurrElement->fIsDef == false && fCurrElement->fIsNotDef == false)
+    // groups aren't known to be defs or not until their children are parsed
+    if (fCurrElement->fIsDef == false && fCurrElement->fIsNotDef == false &&
+            fCurrElement->isGroup() == false)
         return false; // also an ignored element
     size_t nameLen = strlen(name);
     int attrIndex = findAttribute(fCurrElement, name, nameLen, false);
@@ -361,6 +365,84 @@ undoLastComma:
         valCh[index] = ' ';
 }
 
+static const char* skip_transform_sep(const char* str) {
+    while (is_whitespace(*str) || *str == ',')
+        str++;
+    return str;
+}
+
+bool SkSVGParser::ParseTransform(const char str[], SkMatrix* matrix) {
+    static const char* gNames[] = {
+        "matrix", "translate", "scale", "rotate", "skewX", "skewY"
+    };
+    matrix->reset();
+    str = skip_transform_sep(str);
+    while (*str) {
+        size_t index;
+        size_t nameLen = 0;
+        for (index = 0; index < SK_ARRAY_COUNT(gNames); index++) {
+            nameLen = strlen(gNames[index]);
+            if (strncmp(str, gNames[index], nameLen) == 0)
+                break;
+        }
+        if (index == SK_ARRAY_COUNT(gNames))
+            return false;
+        str = skip_transform_sep(str + nameLen);
+        if (*str++ != '(')
+            return false;
+        SkScalar args[6];
+        int count = 0;
+        for (;;) {
+            str = skip_transform_sep(str);
+            if (*str == ')' || count == 6)
+                break;
+            str = SkParse::FindScalar(str, &args[count++]);
+            if (str == NULL)
+                return false;
+        }
+        if (*str++ != ')')
+            return false;
+        SkMatrix op;
+        switch (index) {
+            case 0: // matrix(a b c d e f)
+                if (count != 6)
+                    return false;
+                op.setAll(args[0], args[2], args[4], args[1], args[3], args[5],
+                    0, 0, SK_Scalar1);
+                break;
+            case 1: // translate(tx [ty])
+                if (count < 1 || count > 2)
+                    return false;
+                op.setTranslate(args[0], count > 1 ? args[1] : 0);
+                break;
+            case 2: // scale(sx [sy])
+                if (count < 1 || count > 2)
+                    return false;
+                op.setScale(args[0], count > 1 ? args[1] : args[0]);
+                break;
+            case 3: // rotate(angle [cx cy])
+                if (count == 1)
+                    op.setRotate(args[0]);
+                else if (count == 3)
+                    op.setRotate(args[0], args[1], args[2]);
+                else
+                    return false;
+                break;
+            default: // skewX(angle), skewY(angle)
+                if (count != 1)
+                    return false;
+                SkScalar skew = SkScalarTan(SkDegreesToRadians(args[0]));
+                if (index == 4)
+                    op.setSkew(skew, 0);
+                else
+                    op.setSkew(0, skew);
+        }
+        matrix->preConcat(op);
+        str = skip_transform_sep(str);
+    }
+    return true;
+}
+
 #define CASE_NEW(type) case SkSVGType_##type : created = new SkSVG##type(); break
 
 SkSVGElement* SkSVGParser::CreateElement(SkSVGTypes type, SkSVGElement* parent) {
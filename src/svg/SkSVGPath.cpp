@@ -17,6 +17,7 @@
 
 #include "SkSVGPath.h"
 #include "SkSVGParser.h"
+#include "SkParsePath.h"
 
 const SkSVGAttribute SkSVGPath::gAttributes[] = {
     SVG_ATTRIBUTE(d)
@@ -43,3 +44,7 @@ void SkSVGPath::translate(SkSVGParser& parser, bool defState) {
     SVG_ADD_ATTRIBUTE(d);
     parser._endElement();
 }
+
+bool SkSVGPath::getPath(SkPath* path) {
+    return SkParsePath::FromSVGString(f_d.c_str(), path);
+}
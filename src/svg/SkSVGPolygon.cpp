@@ -17,6 +17,7 @@
 
 #include "SkSVGPolygon.h"
 #include "SkSVGParser.h"
+#include "SkPath.h"
 
 const SkSVGAttribute SkSVGPolygon::gAttributes[] = {
     SVG_LITERAL_ATTRIBUTE(clip-rule, f_clipRule),
@@ -39,3 +40,10 @@ void SkSVGPolygon::translate(SkSVGParser& parser, bool defState) {
         parser._addAttribute("fillType", f_fillRule.equals("evenodd") ? "evenOdd" : "winding");
     parser._endElement();
 }
+
+bool SkSVGPolygon::getPath(SkPath* path) {
+    if (INHERITED::getPath(path) == false)
+        return false;
+    path->close();
+    return true;
+}
@@ -22,6 +22,7 @@
 
 class SkSVGPolygon : public SkSVGPolyline {
     DECLARE_SVG_INFO(Polygon);
+    virtual bool getPath(SkPath* path);
     virtual void addAttribute(SkSVGParser& , int attrIndex, 
         const char* attrValue, size_t attrLength);
 private:
@@ -17,6 +17,8 @@
 
 #include "SkSVGPolyline.h"
 #include "SkSVGParser.h"
+#include "SkParse.h"
+#include "SkPath.h"
 
 enum {
     kCliipRule,
@@ -32,10 +34,12 @@ const SkSVGAttribute SkSVGPolyline::gAttributes[] = {
 
 DEFINE_SVG_INFO(Polyline)
 
-void SkSVGPolyline::addAttribute(SkSVGParser& , int attrIndex, 
+void SkSVGPolyline::addAttribute(SkSVGParser& parser, int attrIndex, 
         const char* attrValue, size_t attrLength) {
-    if (attrIndex != kPoints)
+    if (attrIndex != kPoints) {
+        INHERITED::addAttribute(parser, attrIndex, attrValue, attrLength);
         return;
+    }
     f_points.set("[");
     f_points.append(attrValue, attrLength);
     SkSVGParser::ConvertToArray(f_points);
@@ -49,3 +53,25 @@ void SkSVGPolyline::translate(SkSVGParser& parser, bool defState) {
         parser._addAttribute("fillType", f_fillRule.equals("evenodd") ? "evenOdd" : "winding");
     parser._endElement();
 }
+
+bool SkSVGPolyline::getPath(SkPath* path) {
+    if (f_points.size() == 0)
+        return false;
+    const char* str = f_points.c_str() + 1;  // skip the '[' added by addAttribute
+    SkPoint pt;
+    bool first = true;
+    while ((str = SkParse::FindScalars(str, &pt.fX, 2)) != NULL) {
+        if (first)
+            path->moveTo(pt);
+        else
+            path->lineTo(pt);
+        first = false;
+        while (*str == ',' || *str == ' ')
+            str++;
+    }
+    if (first)
+        return false;
+    if (f_fillRule.equals("evenodd"))
+        path->setFillType(SkPath::kEvenOdd_FillType);
+    return true;
+}
@@ -23,6 +23,7 @@
 
 class SkSVGPolyline : public SkSVGElement {
     DECLARE_SVG_INFO(Polyline);
+    virtual bool getPath(SkPath* path);
     virtual void addAttribute(SkSVGParser& , int attrIndex, 
         const char* attrValue, size_t attrLength);
 protected:
@@ -17,6 +17,8 @@
 
 #include "SkSVGRadialGradient.h"
 #include "SkSVGParser.h"
+#include "SkGradientShader.h"
+#include "SkParse.h"
 
 const SkSVGAttribute SkSVGRadialGradient::gAttributes[] = {
     SVG_ATTRIBUTE(cx),
@@ -48,3 +50,24 @@ void SkSVGRadialGradient::translate(SkSVGParser& parser, bool defState) {
     INHERITED::translate(parser, defState);
     parser._endElement();
 }
+
+SkShader* SkSVGRadialGradient::createShader() {
+    SkTDArray<SkColor> colors;
+    SkTDArray<SkScalar> offsets;
+    if (getStops(&colors, &offsets) < 2)
+        return NULL;
+    SkPoint center;
+    center.set(0, 0);
+    SkScalar radius = 0;
+    SkParse::FindScalar(f_cx.c_str(), &center.fX);
+    SkParse::FindScalar(f_cy.c_str(), &center.fY);
+    SkParse::FindScalar(f_r.c_str(), &radius);
+    if (radius <= 0)
+        return NULL;
+    // !!! the focal point (fx, fy) is ignored, as it is when translating
+    SkShader* shader = SkGradientShader::CreateRadial(center, radius, colors.begin(),
+        offsets.begin(), colors.count(), SkShader::kClamp_TileMode);
+    if (shader)
+        setShaderMatrix(shader, f_gradientTransform);
+    return shader;
+}
@@ -22,6 +22,7 @@
 
 class SkSVGRadialGradient : public SkSVGGradient {
     DECLARE_SVG_INFO(RadialGradient);
+    virtual SkShader* createShader();
 protected:
     SkString f_cx;
     SkString f_cy;
@@ -17,6 +17,8 @@
 
 #include "SkSVGRect.h"
 #include "SkSVGParser.h"
+#include "SkParse.h"
+#include "SkPath.h"
 
 const SkSVGAttribute SkSVGRect::gAttributes[] = {
     SVG_ATTRIBUTE(height),
@@ -41,3 +43,15 @@ void SkSVGRect::translate(SkSVGParser& parser, bool defState) {
     SVG_ADD_ATTRIBUTE(height);
     parser._endElement();
 }
+
+bool SkSVGRect::getPath(SkPath* path) {
+    SkScalar x = 0, y = 0, width = 0, height = 0;
+    SkParse::FindScalar(f_x.c_str(), &x);
+    SkParse::FindScalar(f_y.c_str(), &y);
+    SkParse::FindScalar(f_width.c_str(), &width);
+    SkParse::FindScalar(f_height.c_str(), &height);
+    if (width <= 0 || height <= 0)
+        return false;
+    path->addRect(x, y, x + width, y + height);
+    return true;
+}
@@ -22,6 +22,7 @@
 
 class SkSVGRect : public SkSVGElement {
     DECLARE_SVG_INFO(Rect);
+    virtual bool getPath(SkPath* path);
     SkSVGRect();
 private:
     SkString f_height;
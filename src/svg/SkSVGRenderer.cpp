@@ -0,0 +1,241 @@
+/* libs/graphics/svg/SkSVGRenderer.cpp
+**
+** Copyright 2011, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include "SkSVGRenderer.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkPaint.h"
+#include "SkParse.h"
+#include "SkPath.h"
+#include "SkSVGElements.h"
+#include "SkSVGGradient.h"
+#include "SkSVGParser.h"
+#include "SkSVGUse.h"
+#include "SkShader.h"
+#include "SkTypeface.h"
+
+SkSVGRenderer::SkSVGRenderer(SkSVGParser& parser, SkCanvas* canvas)
+        : fParser(parser), fCanvas(canvas), fHead(NULL) {
+    fEmptyPaint.f_fill.set("black");
+    fEmptyPaint.f_stroke.set("none");
+    fEmptyPaint.f_strokeMiterlimit.set("4");
+    fEmptyPaint.f_strokeWidth.set("1");
+    fEmptyPaint.f_opacity.set("1");
+}
+
+void SkSVGRenderer::renderDocument() {
+    const SkTDArray<SkSVGElement*>& children = fParser.getChildren();
+    SkSVGElement** ptr = children.begin();
+    SkSVGElement** end = children.end();
+    // the svg element's children are parsed as top level elements, after it
+    bool hasRoot = ptr < end && (*ptr)->getType() == SkSVGType_SVG;
+    if (hasRoot)
+        SkSVGPaint::Push(&fHead, &(*ptr++)->fPaintState);
+    while (ptr < end)
+        render(*ptr++);
+    if (hasRoot)
+        SkSVGPaint::Pop(&fHead);
+}
+
+void SkSVGRenderer::render(SkSVGElement* element) {
+    SkSVGPaint* state = &element->fPaintState;
+    // an element that (through 'use') contains itself is drawn once
+    for (SkSVGPaint* walking = fHead; walking != NULL; walking = walking->fNext) {
+        if (walking == state)
+            return;
+    }
+    SkSVGPaint::Push(&fHead, state);
+    int saveCount = fCanvas->save();
+    if (state->f_transform.size() > 0) {
+        SkMatrix matrix;
+        if (SkSVGParser::ParseTransform(state->f_transform.c_str(), &matrix))
+            fCanvas->concat(matrix);
+    }
+    if (state->f_clipPath.size() > 0)
+        clipToPath(state->f_clipPath);
+    element->render(*this);
+    fCanvas->restoreToCount(saveCount);
+    SkSVGPaint::Pop(&fHead);
+}
+
+void SkSVGRenderer::drawPath(const SkPath& path) {
+    SkPaint paint;
+    if (setupPaint(SkSVGPaint::kFill, &paint)) {
+        if (path.getFillType() == SkPath::kWinding_FillType &&
+                getPaintLast(SkSVGPaint::kFillRule).equals("evenodd")) {
+            SkPath evenOdd(path);
+            evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+            fCanvas->drawPath(evenOdd, paint);
+        } else
+            fCanvas->drawPath(path, paint);
+    }
+    SkPaint strokePaint;
+    if (setupPaint(SkSVGPaint::kStroke, &strokePaint)) {
+        setupStroke(&strokePaint);
+        fCanvas->drawPath(path, strokePaint);
+    }
+}
+
+static SkTypeface* create_typeface(const SkString& family) {
+    // use the first family in the list, without its quotes
+    const char* start = family.c_str();
+    const char* end = strchr(start, ',');
+    if (end == NULL)
+        end = start + family.size();
+    while (start < end && (*start == ' ' || *start == '\'' || *start == '"'))
+        start++;
+    while (end > start && (end[-1] == ' ' || end[-1] == '\'' || end[-1] == '"'))
+        end--;
+    SkString name(start, end - start);
+    return SkTypeface::CreateFromName(name.c_str(), SkTypeface::kNormal);
+}
+
+void SkSVGRenderer::drawText(const SkString& text, SkScalar x, SkScalar y) {
+    SkPaint paint;
+    const SkString& fontSize = getPaintLast(SkSVGPaint::kFontSize);
+    if (fontSize.size() > 0) {
+        SkScalar textSize;
+        if (SkParse::FindScalar(fontSize.c_str(), &textSize) && textSize > 0)
+            paint.setTextSize(textSize);
+    }
+    const SkString& fontFamily = getPaintLast(SkSVGPaint::kFontFamily);
+    if (fontFamily.size() > 0)
+        SkSafeUnref(paint.setTypeface(create_typeface(fontFamily)));
+    SkPaint strokePaint(paint);
+    if (setupPaint(SkSVGPaint::kFill, &paint))
+        fCanvas->drawText(text.c_str(), text.size(), x, y, paint);
+    if (setupPaint(SkSVGPaint::kStroke, &strokePaint)) {
+        setupStroke(&strokePaint);
+        fCanvas->drawText(text.c_str(), text.size(), x, y, strokePaint);
+    }
+}
+
+SkSVGElement* SkSVGRenderer::findReference(const SkString& ref) {
+    const char* start = strchr(ref.c_str(), '#');
+    if (start == NULL)
+        return NULL;
+    start++;
+    size_t len = strlen(start);
+    if (len > 0 && start[len - 1] == ')')
+        len--;
+    SkSVGElement* found;
+    if (fParser.getIDs().find(start, len, &found) == false)
+        return NULL;
+    return found;
+}
+
+const SkString& SkSVGRenderer::getPaintLast(SkSVGPaint::Field field) const {
+    for (SkSVGPaint* walking = fHead; walking != NULL; walking = walking->fNext) {
+        SkString* attr = (*walking)[field];
+        if (attr->size() > 0)
+            return *attr;
+    }
+    return *const_cast<SkSVGPaint&>(fEmptyPaint)[field];
+}
+
+bool SkSVGRenderer::setupPaint(SkSVGPaint::Field field, SkPaint* paint) {
+    const SkString& value = getPaintLast(field);
+    if (value.size() == 0 || value.equals("none"))
+        return false;
+    if (strncmp(value.c_str(), "url(", 4) == 0) {
+        SkSVGElement* found = findReference(value);
+        SkSVGElement* gradient = found ? found->getGradient() : NULL;
+        if (gradient == NULL)
+            return false;
+        SkShader* shader = ((SkSVGGradient*) gradient)->createShader();
+        if (shader == NULL)
+            return false;
+        paint->setShader(shader)->unref();
+    } else {
+        SkColor color = SK_ColorBLACK;
+        if (SkParse::FindColor(value.c_str(), &color) == NULL)
+            return false;
+        paint->setColor(color);
+    }
+    SkScalar opacity = SK_Scalar1;
+    SkParse::FindScalar(getPaintLast(SkSVGPaint::kOpacity).c_str(), &opacity);
+    opacity = SkScalarPin(opacity, 0, SK_Scalar1);
+    if (opacity < SK_Scalar1)
+        paint->setAlpha(SkScalarRound(opacity * paint->getAlpha()));
+    paint->setAntiAlias(true);
+    return true;
+}
+
+void SkSVGRenderer::setupStroke(SkPaint* paint) {
+    paint->setStyle(SkPaint::kStroke_Style);
+    SkScalar width = SK_Scalar1;
+    SkParse::FindScalar(getPaintLast(SkSVGPaint::kStroke_Width).c_str(), &width);
+    paint->setStrokeWidth(width);
+    SkScalar miter = SK_Scalar1 * 4;
+    SkParse::FindScalar(getPaintLast(SkSVGPaint::kStroke_Miterlimit).c_str(), &miter);
+    paint->setStrokeMiter(miter);
+    const SkString& cap = getPaintLast(SkSVGPaint::kStroke_Linecap);
+    if (cap.equals("round"))
+        paint->setStrokeCap(SkPaint::kRound_Cap);
+    else if (cap.equals("square"))
+        paint->setStrokeCap(SkPaint::kSquare_Cap);
+    const SkString& join = getPaintLast(SkSVGPaint::kStroke_Linejoin);
+    if (join.equals("round"))
+        paint->setStrokeJoin(SkPaint::kRound_Join);
+    else if (join.equals("bevel"))
+        paint->setStrokeJoin(SkPaint::kBevel_Join);
+    const SkString& dashes = getPaintLast(SkSVGPaint::kStroke_Dasharray);
+    if (dashes.size() > 0 && dashes.equals("none") == false) {
+        SkTDArray<SkScalar> intervals;
+        const char* str = dashes.c_str();
+        SkScalar interval;
+        while ((str = SkParse::FindScalar(str, &interval)) != NULL) {
+            *intervals.append() = interval;
+            while (*str == ',' || *str == ' ')
+                str++;
+        }
+        // an odd list is repeated to make it even
+        int count = intervals.count();
+        if (count & 1) {
+            intervals.append(count);
+            memcpy(intervals.begin() + count, intervals.begin(), count * sizeof(SkScalar));
+        }
+        if (intervals.count() >= 2) {
+            paint->setPathEffect(new SkDashPathEffect(intervals.begin(),
+                intervals.count(), 0))->unref();
+        }
+    }
+}
+
+void SkSVGRenderer::clipToPath(const SkString& ref) {
+    SkSVGElement* clip = findReference(ref);
+    if (clip == NULL || clip->getType() != SkSVGType_ClipPath)
+        return;
+    SkPath clipPath;
+    for (SkSVGElement** ptr = clip->fChildren.begin(); ptr < clip->fChildren.end(); ptr++) {
+        SkSVGElement* child = *ptr;
+        if (child->getType() == SkSVGType_Use) {
+            child = findReference(((SkSVGUse*) child)->f_xlink_href);
+            if (child == NULL)
+                continue;
+        }
+        SkPath path;
+        if (child->getPath(&path) == false)
+            continue;
+        const SkString& transform = child->fPaintState.f_transform;
+        SkMatrix matrix;
+        if (transform.size() > 0 && SkSVGParser::ParseTransform(transform.c_str(), &matrix))
+            path.transform(matrix);
+        clipPath.addPath(path);
+    }
+    fCanvas->clipPath(clipPath);
+}
@@ -0,0 +1,62 @@
+/* libs/graphics/svg/SkSVGRenderer.h
+**
+** Copyright 2011, The Android Open Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef SkSVGRenderer_DEFINED
+#define SkSVGRenderer_DEFINED
+
+#include "SkSVGPaintState.h"
+
+class SkCanvas;
+class SkPaint;
+class SkPath;
+class SkSVGElement;
+class SkSVGParser;
+
+/** Draws a parsed SVG element tree into a canvas (usually one recording an
+    SkPicture), building the paths, paints and shaders straight from the
+    elements, instead of translating them into animator XML.
+*/
+class SkSVGRenderer {
+public:
+    SkSVGRenderer(SkSVGParser& , SkCanvas* );
+
+    /** Draws all of the parser's top level elements. */
+    void renderDocument();
+    /** Draws element with the paint state and transform it inherits from the
+        elements currently being drawn.
+    */
+    void render(SkSVGElement* element);
+
+    void drawPath(const SkPath& path);
+    void drawText(const SkString& text, SkScalar x, SkScalar y);
+    // returns the element named by "#id" or "url(#id)", or NULL
+    SkSVGElement* findReference(const SkString& ref);
+    SkCanvas* getCanvas() const { return fCanvas; }
+    SkSVGParser& getParser() const { return fParser; }
+private:
+    const SkString& getPaintLast(SkSVGPaint::Field field) const;
+    bool setupPaint(SkSVGPaint::Field field, SkPaint* paint);
+    void setupStroke(SkPaint* paint);
+    void clipToPath(const SkString& ref);
+
+    SkSVGParser& fParser;
+    SkCanvas* fCanvas;
+    SkSVGPaint* fHead;
+    SkSVGPaint fEmptyPaint;
+};
+
+#endif // SkSVGRenderer_DEFINED
@@ -37,6 +37,33 @@ const SkSVGAttribute SkSVGSVG::gAttributes[] = {
 DEFINE_SVG_INFO(SVG)
 
 
+void SkSVGSVG::getViewport(SkScalar* width, SkScalar* height, SkMatrix* matrix) {
+    SkScalar viewBox[4];
+    bool hasViewBox = SkParse::FindScalars(f_viewBox.c_str(), viewBox, 4) != NULL &&
+        viewBox[2] > 0 && viewBox[3] > 0;
+    *width = *height = 0;
+    const char* wSuffix = SkParse::FindScalar(f_width.c_str(), width);
+    if (wSuffix && strcmp(wSuffix, "pt") == 0)
+        *width = SkScalarMulDiv(*width, SK_Scalar1 * 72, SK_Scalar1 * 96);
+    const char* hSuffix = SkParse::FindScalar(f_height.c_str(), height);
+    if (hSuffix && strcmp(hSuffix, "pt") == 0)
+        *height = SkScalarMulDiv(*height, SK_Scalar1 * 72, SK_Scalar1 * 96);
+    matrix->reset();
+    if (hasViewBox == false)
+        return;
+    if (wSuffix == NULL || *width <= 0)
+        *width = viewBox[2];
+    if (hSuffix == NULL || *height <= 0)
+        *height = viewBox[3];
+    // preserveAspectRatio="xMidYMid meet", the default
+    SkScalar scale = SkMinScalar(SkScalarDiv(*width, viewBox[2]),
+        SkScalarDiv(*height, viewBox[3]));
+    matrix->setTranslate(-viewBox[0], -viewBox[1]);
+    matrix->postScale(scale, scale);
+    matrix->postTranslate(SkScalarHalf(*width - SkScalarMul(viewBox[2], scale)),
+        SkScalarHalf(*height - SkScalarMul(viewBox[3], scale)));
+}
+
 bool SkSVGSVG::isFlushable() {
     return false;
 }
@@ -18,10 +18,13 @@
 #ifndef SkSVGSVG_DEFINED
 #define SkSVGSVG_DEFINED
 
+#include "SkMatrix.h"
 #include "SkSVGElements.h"
 
 class SkSVGSVG : public SkSVGElement {
     DECLARE_SVG_INFO(SVG);
+    // sets the document size, and the matrix that maps the viewBox onto it
+    void getViewport(SkScalar* width, SkScalar* height, SkMatrix* matrix);
     virtual bool isFlushable();
 private:
     SkString f_enable_background;
@@ -17,6 +17,8 @@
 
 #include "SkSVGText.h"
 #include "SkSVGParser.h"
+#include "SkSVGRenderer.h"
+#include "SkParse.h"
 
 const SkSVGAttribute SkSVGText::gAttributes[] = {
     SVG_ATTRIBUTE(x),
@@ -34,6 +36,16 @@ void SkSVGText::translate(SkSVGParser& parser, bool defState) {
     parser._endElement();
 }
 
+void SkSVGText::render(SkSVGRenderer& renderer) {
+    if (f_text.size() > 0) {
+        SkScalar x = 0, y = 0;
+        SkParse::FindScalar(f_x.c_str(), &x);
+        SkParse::FindScalar(f_y.c_str(), &y);
+        renderer.drawText(f_text, x, y);
+    }
+    for (SkSVGElement** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++)
+        renderer.render(*ptr);
+}
 
 const SkSVGAttribute SkSVGTspan::gAttributes[] = {
     SVG_ATTRIBUTE(x),
@@ -22,6 +22,7 @@
 
 class SkSVGText : public SkSVGElement {
     DECLARE_SVG_INFO(Text);
+    virtual void render(SkSVGRenderer& );
 protected:
     SkString f_x;
     SkString f_y;
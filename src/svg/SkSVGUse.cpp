@@ -17,6 +17,9 @@
 
 #include "SkSVGUse.h"
 #include "SkSVGParser.h"
+#include "SkSVGRenderer.h"
+#include "SkCanvas.h"
+#include "SkParse.h"
 
 const SkSVGAttribute SkSVGUse::gAttributes[] = {
     SVG_ATTRIBUTE(height),
@@ -36,3 +39,14 @@ void SkSVGUse::translate(SkSVGParser& parser, bool defState) {
     parser._addAttributeLen("use", start, strlen(start) - 1);
     parser._endElement();   // clip
 }
+
+void SkSVGUse::render(SkSVGRenderer& renderer) {
+    SkSVGElement* ref = renderer.findReference(f_xlink_href);
+    if (ref == NULL)
+        return;
+    SkScalar x = 0, y = 0;
+    SkParse::FindScalar(f_x.c_str(), &x);
+    SkParse::FindScalar(f_y.c_str(), &y);
+    renderer.getCanvas()->translate(x, y);
+    renderer.render(ref);
+}
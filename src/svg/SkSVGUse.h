@@ -22,6 +22,7 @@
 
 class SkSVGUse : public SkSVGElement {
     DECLARE_SVG_INFO(Use);
+    virtual void render(SkSVGRenderer& );
 protected:
     SkString f_height;
     SkString f_width;
@@ -31,6 +32,7 @@ protected:
 private:
     typedef SkSVGElement INHERITED;
     friend class SkSVGClipPath;
+    friend class SkSVGRenderer;
 };
 
 #endif // SkSVGUse_DEFINED
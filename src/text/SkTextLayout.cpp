@@ -1,4 +1,5 @@
 #include "SkTextLayout.h"
+#include "SkTextBox.h"
 
 SkTextStyle::SkTextStyle() {
     fPaint.setAntiAlias(true);
@@ -19,7 +20,6 @@ SkTextLayout::SkTextLayout() {
 
 SkTextLayout::~SkTextLayout() {
     fDefaultStyle->unref();
-    fLines.deleteAll();
 }
 
 void SkTextLayout::setText(const char text[], size_t length) {
@@ -29,7 +29,6 @@ void SkTextLayout::setText(const char text[], size_t length) {
 
 void SkTextLayout::setBounds(const SkRect& bounds) {
     fBounds = bounds;
-    // if width changed, inval cache
 }
 
 SkTextStyle* SkTextLayout::setDefaultStyle(SkTextStyle* style) {
@@ -39,34 +38,38 @@ SkTextStyle* SkTextLayout::setDefaultStyle(SkTextStyle* style) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-struct SkTextLayout::GlyphRun {
-    GlyphRun();
-    ~GlyphRun();
-
-    SkPoint*    fLocs;
-    uint16_t*   fGlyphIDs;
-    int         fCount;
-};
-
-SkTextLayout::GlyphRun::GlyphRun() : fLocs(NULL), fGlyphIDs(NULL), fCount(0) {}
-
-SkTextLayout::GlyphRun::~GlyphRun() {
-    delete[] fLocs;
-    delete[] fGlyphIDs;
-}
-
-struct SkTextLayout::Line {
-    Line() {}
-    ~Line();
-
-    SkScalar                fBaselineY;
-    SkTDArray<GlyphRun*>    fRuns;
-};
-
-SkTextLayout::Line::~Line() {
-    fRuns.deleteAll();
-}
-
 void SkTextLayout::draw(SkCanvas* canvas) {
+    SkScalar width = fBounds.width();
+    if (fText.count() == 0 || width <= 0) {
+        return;
+    }
+
+    const SkPaint& paint = fDefaultStyle->paint();
+    SkTextLines* lines = SkTextLines::Find(fText.begin(), fText.count(), paint,
+                                           width);
+    SkAutoUnref aur(lines);
+
+    SkScalar x;
+    switch (paint.getTextAlign()) {
+        case SkPaint::kLeft_Align:
+            x = fBounds.fLeft;
+            break;
+        case SkPaint::kCenter_Align:
+            x = fBounds.centerX();
+            break;
+        default:
+            x = fBounds.fRight;
+            break;
+    }
+
+    SkPaint::FontMetrics metrics;
+    SkScalar spacing = paint.getFontMetrics(&metrics);
+    SkScalar y = fBounds.fTop - metrics.fAscent;
+    for (int i = 0; i < lines->countLines(); i++) {
+        if (y + metrics.fAscent >= fBounds.fBottom) {
+            break;
+        }
+        lines->drawLine(canvas, i, x, y, paint);
+        y += spacing;
+    }
 }
-
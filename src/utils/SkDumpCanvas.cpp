@@ -266,6 +266,11 @@ void SkDumpCanvas::drawRect(const SkRect& rect, const SkPaint& paint) {
     this->dump(kDrawRect_Verb, &paint, "drawRect(%s)", str.c_str());
 }
 
+void SkDumpCanvas::drawRects(const SkRect rects[], size_t count,
+                             const SkPaint& paint) {
+    this->dump(kDrawRect_Verb, &paint, "drawRects(%d)", count);
+}
+
 void SkDumpCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     SkString str;
     toString(path, &str);
@@ -315,6 +320,14 @@ void SkDumpCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
                x, y);
 }
 
+void SkDumpCanvas::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                               size_t count, const SkPaint* paint) {
+    SkString str;
+    toString(bitmap, &str);
+    this->dump(kDrawBitmap_Verb, paint, "drawSprites(%s, %d)", str.c_str(),
+               count);
+}
+
 void SkDumpCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
                              SkScalar y, const SkPaint& paint) {
     SkString str;
@@ -168,6 +168,14 @@ void SkNWayCanvas::drawRect(const SkRect& rect, const SkPaint& paint) {
     }
 }
 
+void SkNWayCanvas::drawRects(const SkRect rects[], size_t count,
+                             const SkPaint& paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawRects(rects, count, paint);
+    }
+}
+
 void SkNWayCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     Iter iter(fList);
     while (iter.next()) {
@@ -207,6 +215,14 @@ void SkNWayCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
     }
 }
 
+void SkNWayCanvas::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                               size_t count, const SkPaint* paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawSprites(bitmap, pts, count, paint);
+    }
+}
+
 void SkNWayCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
                             SkScalar y, const SkPaint& paint) {
     Iter iter(fList);
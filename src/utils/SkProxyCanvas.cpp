@@ -76,6 +76,11 @@ void SkProxyCanvas::drawRect(const SkRect& rect, const SkPaint& paint) {
     fProxy->drawRect(rect, paint);
 }
 
+void SkProxyCanvas::drawRects(const SkRect rects[], size_t count,
+                              const SkPaint& paint) {
+    fProxy->drawRects(rects, count, paint);
+}
+
 void SkProxyCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
     fProxy->drawPath(path, paint);
 }
@@ -100,6 +105,11 @@ void SkProxyCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
     fProxy->drawSprite(bitmap, x, y, paint);
 }
 
+void SkProxyCanvas::drawSprites(const SkBitmap& bitmap, const SkIPoint pts[],
+                                size_t count, const SkPaint* paint) {
+    fProxy->drawSprites(bitmap, pts, count, paint);
+}
+
 void SkProxyCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
                              SkScalar y, const SkPaint& paint) {
     fProxy->drawText(text, byteLength, x, y, paint);
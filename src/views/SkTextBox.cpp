@@ -20,72 +20,348 @@
 #include "SkUtils.h"
 #include "SkAutoKern.h"
 
-static inline int is_ws(int c)
+int SkTextLineBreaker::CountLines(const char text[], size_t len, const SkPaint& paint, SkScalar width)
 {
-    return !((c - 1) >> 5);
+    if (width <= 0)
+        return 0;
+
+    SkTextLines*    lines = SkTextLines::Find(text, len, paint, width);
+    int             count = lines->countLines();
+    lines->unref();
+    return count;
 }
 
-static size_t linebreak(const char text[], const char stop[], const SkPaint& paint, SkScalar margin)
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SkDescriptor.h"
+#include "SkThread.h"
+
+#ifndef SK_DEFAULT_TEXT_LINES_CACHE_LIMIT
+    #define SK_DEFAULT_TEXT_LINES_CACHE_LIMIT   (128 * 1024)
+#endif
+
+static SkMutex      gTextLinesMutex;
+static SkTextLines* gTextLinesHead;
+static SkTextLines* gTextLinesTail;
+static size_t       gTextLinesUsed;
+static size_t       gTextLinesBudget = SK_DEFAULT_TEXT_LINES_CACHE_LIMIT;
+
+static uint32_t compute_hash(const char text[], size_t len, const SkDescriptor& desc,
+                             SkScalar width)
 {
-    const char* start = text;
+    uint32_t hash = desc.getChecksum() ^ SkScalarToFixed(width);
+    for (size_t i = 0; i < len; i++)
+        hash = (hash << 5) - hash + (uint8_t)text[i];
+    return hash;
+}
 
-    SkAutoGlyphCache    ac(paint, NULL);
-    SkGlyphCache*       cache = ac.getCache();
-    SkFixed             w = 0;
-    SkFixed             limit = SkScalarToFixed(margin);
-    SkAutoKern          autokern;
+SkTextLines::SkTextLines() : fDesc(NULL), fStorage(NULL), fPrev(NULL), fNext(NULL)
+{
+}
 
-    const char* word_start = text;
-    int         prevWS = true;
+SkTextLines::~SkTextLines()
+{
+    if (fDesc)
+        SkDescriptor::Free(fDesc);
+    sk_free(fStorage);
+}
+
+bool SkTextLines::matches(const char text[], size_t len, const SkDescriptor& desc,
+                          SkScalar width) const
+{
+    return fLen == len && fWidth == width && fDesc->equals(desc) &&
+           !memcmp(fText, text, len);
+}
 
-    while (text < stop)
+namespace {
+
+struct Metrics {
+    int         fTextOffset;
+    uint16_t    fGlyphID;
+    int8_t      fLsbDelta, fRsbDelta;
+    SkFixed     fAdvance;
+    bool        fIsWS;
+};
+
+}
+
+static inline int is_ws(int c)
+{
+    return !((c - 1) >> 5);
+}
+
+/*  Returns the index of the glyph that starts the next line. This breaks
+    where the original character based linebreak did: after the whitespace
+    that overflows the margin, or before the word that does.
+*/
+static int linebreak(const Metrics metrics[], int start, int stop, SkFixed limit)
+{
+    SkFixed     w = 0;
+    int         prevRsbDelta = 0;
+    int         wordStart = start;
+    bool        prevWS = true;
+    int         index = start;
+
+    while (index < stop)
     {
-        const char* prevText = text;
-        SkUnichar   uni = SkUTF8_NextUnichar(&text);
-        int         currWS = is_ws(uni);
-        const SkGlyph&  glyph = cache->getUnicharMetrics(uni);
+        int             curr = index++;
+        const Metrics&  m = metrics[curr];
 
-        if (!currWS && prevWS)
-            word_start = prevText;
-        prevWS = currWS;
+        if (!m.fIsWS && prevWS)
+            wordStart = curr;
+        prevWS = m.fIsWS;
 
-        w += autokern.adjust(glyph) + glyph.fAdvanceX;
+        w += SkAutoKern_AdjustF(prevRsbDelta, m.fLsbDelta) + m.fAdvance;
+        prevRsbDelta = m.fRsbDelta;
         if (w > limit)
         {
-            if (currWS) // eat the rest of the whitespace
+            if (m.fIsWS)    // eat the rest of the whitespace
             {
-                while (text < stop && is_ws(SkUTF8_ToUnichar(text)))
-                    text += SkUTF8_CountUTF8Bytes(text);
+                while (index < stop && metrics[index].fIsWS)
+                    index += 1;
             }
             else    // backup until a whitespace (or 1 char)
             {
-                if (word_start == start)
+                if (wordStart == start)
                 {
-                    if (prevText > start)
-                        text = prevText;
+                    if (curr > start)
+                        index = curr;
                 }
                 else
-                    text = word_start;
+                    index = wordStart;
             }
             break;
         }
     }
-    return text - start;
+    return index;
 }
 
-int SkTextLineBreaker::CountLines(const char text[], size_t len, const SkPaint& paint, SkScalar width)
+void SkTextLines::layout(SkGlyphCache* cache, SkScalar width)
 {
-    const char* stop = text + len;
-    int         count = 0;
+    // look up each character once: its glyph, advance and kerning deltas
+    int count = SkUTF8_CountUnichars(fText, fLen);
+    SkAutoSTMalloc<128, Metrics> storage(count + 1);
+    Metrics* metrics = storage.get();
+    const char* text = fText;
+    for (int i = 0; i < count; i++)
+    {
+        metrics[i].fTextOffset = text - fText;
+        SkUnichar       uni = SkUTF8_NextUnichar(&text);
+        const SkGlyph&  glyph = cache->getUnicharMetrics(uni);
+        metrics[i].fGlyphID = glyph.getGlyphID();
+        metrics[i].fLsbDelta = glyph.fLsbDelta;
+        metrics[i].fRsbDelta = glyph.fRsbDelta;
+        metrics[i].fAdvance = glyph.fAdvanceX;
+        metrics[i].fIsWS = is_ws(uni) != 0;
+    }
+    metrics[count].fTextOffset = fLen;
 
+    SkTDArray<Line> lines;
     if (width > 0)
     {
+        SkFixed limit = SkScalarToFixed(width);
+        int     start = 0;
         do {
-            count += 1;
-            text += linebreak(text, stop, paint, width);
-        } while (text < stop);
+            Line* line = lines.append();
+            line->fStart = start;
+            start = linebreak(metrics, start, count, limit);
+            line->fCount = start - line->fStart;
+            line->fTextStart = metrics[line->fStart].fTextOffset;
+            line->fTextLength = metrics[start].fTextOffset - line->fTextStart;
+        } while (start < count);
     }
-    return count;
+
+    // text, then lines, then offsets, then glyphs, so everything stays aligned
+    size_t textSize = SkAlign4(fLen);
+    size_t size = textSize + lines.count() * sizeof(Line) +
+                  count * (sizeof(SkFixed) + sizeof(uint16_t));
+    char* block = (char*)sk_malloc_throw(size);
+    memcpy(block, fText, fLen);
+    Line* dstLines = (Line*)(block + textSize);
+    SkFixed* offsets = (SkFixed*)(dstLines + lines.count());
+    uint16_t* glyphs = (uint16_t*)(offsets + count);
+
+    // positions accumulate the way drawText does, restarting the kerning on each line
+    for (int i = 0; i < lines.count(); i++)
+    {
+        Line&   line = lines[i];
+        SkFixed x = 0;
+        int     prevRsbDelta = 0;
+        for (int j = line.fStart; j < line.fStart + line.fCount; j++)
+        {
+            x += SkAutoKern_AdjustF(prevRsbDelta, metrics[j].fLsbDelta);
+            prevRsbDelta = metrics[j].fRsbDelta;
+            offsets[j] = x;
+            glyphs[j] = metrics[j].fGlyphID;
+            x += metrics[j].fAdvance;
+        }
+        line.fWidth = x;
+    }
+    memcpy(dstLines, lines.begin(), lines.count() * sizeof(Line));
+
+    fStorage = block;
+    fText = block;
+    fLines = dstLines;
+    fLineCount = lines.count();
+    fOffsets = offsets;
+    fGlyphs = glyphs;
+    fSize = sizeof(SkTextLines) + fDesc->getLength() + size;
+}
+
+SkTextLines* SkTextLines::Find(const char text[], size_t len, const SkPaint& paint, SkScalar width)
+{
+    SkASSERT(text || len == 0);
+
+    SkAutoGlyphCache    ac(paint, NULL);
+    SkGlyphCache*       cache = ac.getCache();
+    const SkDescriptor& desc = cache->getDescriptor();
+    uint32_t            hash = compute_hash(text, len, desc, width);
+
+    {
+        SkAutoMutexAcquire  lock(gTextLinesMutex);
+        for (SkTextLines* lines = gTextLinesHead; lines; lines = lines->fNext)
+        {
+            if (lines->fHash == hash && lines->matches(text, len, desc, width))
+            {
+                if (lines != gTextLinesHead)    // move to the front
+                {
+                    lines->fPrev->fNext = lines->fNext;
+                    if (lines->fNext)
+                        lines->fNext->fPrev = lines->fPrev;
+                    else
+                        gTextLinesTail = lines->fPrev;
+                    lines->fPrev = NULL;
+                    lines->fNext = gTextLinesHead;
+                    gTextLinesHead->fPrev = lines;
+                    gTextLinesHead = lines;
+                }
+                lines->ref();
+                return lines;
+            }
+        }
+    }
+
+    SkTextLines* lines = new SkTextLines;
+    lines->fDesc = desc.copy();
+    lines->fText = text;
+    lines->fLen = len;
+    lines->fWidth = width;
+    lines->fHash = hash;
+    lines->layout(cache, width);
+
+    SkAutoMutexAcquire  lock(gTextLinesMutex);
+    if (lines->fSize <= gTextLinesBudget)
+    {
+        lines->ref();   // owned by the cache
+        lines->fNext = gTextLinesHead;
+        if (gTextLinesHead)
+            gTextLinesHead->fPrev = lines;
+        else
+            gTextLinesTail = lines;
+        gTextLinesHead = lines;
+        gTextLinesUsed += lines->fSize;
+        while (gTextLinesUsed > gTextLinesBudget)
+            DetachTail();
+    }
+    return lines;
+}
+
+// call with gTextLinesMutex held
+void SkTextLines::DetachTail()
+{
+    SkTextLines* tail = gTextLinesTail;
+    SkASSERT(tail);
+    gTextLinesTail = tail->fPrev;
+    if (gTextLinesTail)
+        gTextLinesTail->fNext = NULL;
+    else
+        gTextLinesHead = NULL;
+    tail->fPrev = NULL;
+    gTextLinesUsed -= tail->fSize;
+    tail->unref();
+}
+
+size_t SkTextLines::GetCacheBudget()
+{
+    SkAutoMutexAcquire  lock(gTextLinesMutex);
+    return gTextLinesBudget;
+}
+
+size_t SkTextLines::SetCacheBudget(size_t bytes)
+{
+    SkAutoMutexAcquire  lock(gTextLinesMutex);
+    size_t prev = gTextLinesBudget;
+    gTextLinesBudget = bytes;
+    while (gTextLinesUsed > gTextLinesBudget)
+        DetachTail();
+    return prev;
+}
+
+void SkTextLines::PurgeCache()
+{
+    SkAutoMutexAcquire  lock(gTextLinesMutex);
+    while (gTextLinesTail)
+        DetachTail();
+}
+
+SkScalar SkTextLines::getLineWidth(int index) const
+{
+    SkASSERT((unsigned)index < (unsigned)fLineCount);
+    return SkFixedToScalar(fLines[index].fWidth);
+}
+
+const char* SkTextLines::getLineText(int index, size_t* length) const
+{
+    SkASSERT((unsigned)index < (unsigned)fLineCount);
+    SkASSERT(length);
+    *length = fLines[index].fTextLength;
+    return fText + fLines[index].fTextStart;
+}
+
+void SkTextLines::drawLine(SkCanvas* canvas, int index, SkScalar x, SkScalar y,
+                           const SkPaint& paint) const
+{
+    SkASSERT((unsigned)index < (unsigned)fLineCount);
+    const Line& line = fLines[index];
+    if (line.fCount == 0)
+        return;
+
+    SkPaint glyphPaint(paint);
+    glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    const uint16_t* glyphs = fGlyphs + line.fStart;
+    size_t          byteLength = line.fCount * sizeof(uint16_t);
+
+    // Only drawText decorates its text. And our offsets come from an unscaled
+    // glyph cache, so they only match where drawText would put the glyphs if
+    // the canvas just translates.
+    if ((paint.getFlags() & (SkPaint::kUnderlineText_Flag | SkPaint::kStrikeThruText_Flag)) ||
+            (canvas->getTotalMatrix().getType() & ~SkMatrix::kTranslate_Mask))
+    {
+        canvas->drawText(glyphs, byteLength, x, y, glyphPaint);
+        return;
+    }
+
+    SkScalar width = SkFixedToScalar(line.fWidth);
+    switch (paint.getTextAlign()) {
+    case SkPaint::kCenter_Align:
+        x -= SkScalarHalf(width);
+        break;
+    case SkPaint::kRight_Align:
+        x -= width;
+        break;
+    default:
+        break;
+    }
+    glyphPaint.setTextAlign(SkPaint::kLeft_Align);
+
+    SkAutoSTMalloc<64, SkScalar> storage(line.fCount);
+    SkScalar*       xpos = storage.get();
+    const SkFixed*  offsets = fOffsets + line.fStart;
+    SkFixed         fx = SkScalarToFixed(x);
+    for (int i = 0; i < line.fCount; i++)
+        xpos[i] = SkFixedToScalar(fx + offsets[i]);
+    canvas->drawPosTextH(glyphs, byteLength, xpos, y, glyphPaint);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -152,8 +428,6 @@ void SkTextBox::draw(SkCanvas* canvas, const char text[], size_t len, const SkPa
     if (marginWidth <= 0 || len == 0)
         return;
 
-    const char* textStop = text + len;
-
     SkScalar                x, y, scaledSpacing, height, fontHeight;
     SkPaint::FontMetrics    metrics;
 
@@ -174,13 +448,17 @@ void SkTextBox::draw(SkCanvas* canvas, const char text[], size_t len, const SkPa
     scaledSpacing = SkScalarMul(fontHeight, fSpacingMul) + fSpacingAdd;
     height = fBox.height();
 
+    // the lines are only broken and converted to glyphs the first time
+    SkTextLines*    lines = SkTextLines::Find(text, len, paint, marginWidth);
+    SkAutoUnref     aur(lines);
+    int             count = lines->countLines();
+
     //  compute Y position for first line
     {
         SkScalar textHeight = fontHeight;
 
         if (fMode == kLineBreak_Mode && fSpacingAlign != kStart_SpacingAlign)
         {
-            int count = SkTextLineBreaker::CountLines(text, textStop - text, paint, marginWidth);
             SkASSERT(count > 0);
             textHeight += scaledSpacing * (count - 1);
         }
@@ -200,18 +478,16 @@ void SkTextBox::draw(SkCanvas* canvas, const char text[], size_t len, const SkPa
         y += fBox.fTop - metrics.fAscent;
     }
 
-    for (;;)
+    for (int i = 0;;)
     {
-        len = linebreak(text, textStop, paint, marginWidth);
         if (y + metrics.fDescent + metrics.fLeading > 0)
-            canvas->drawText(text, len, x, y, paint);
-        text += len;
-        if (text >= textStop)
+            lines->drawLine(canvas, i, x, y, paint);
+        if (++i >= count)
             break;
         y += scaledSpacing;
         if (y + metrics.fAscent >= height)
             break;
-    } 
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
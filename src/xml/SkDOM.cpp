@@ -16,6 +16,7 @@
 */
 
 #include "SkDOM.h"
+#include "SkStream.h"
 
 /////////////////////////////////////////////////////////////////////////
 
@@ -47,14 +48,21 @@ bool SkXMLParser::parse(const SkDOM& dom, const SkDOMNode* node)
 /////////////////////////////////////////////////////////////////////////
 
 struct SkDOMAttr {
-    const char* fName;
     const char* fValue;
+    SkDOM::Atom fName;
+    uint32_t    fLength;
 };
 
+/*  Nodes with more than kMaxLinearAttrs attributes are followed (after their
+    attributes) by an open addressed table of attribute indices + 1, hashed on
+    the attribute's atom, so that looking up an attribute by atom doesn't scan.
+*/
+#define kMaxLinearAttrs 8
+
 struct SkDOMNode {
-    const char* fName;
     SkDOMNode*  fFirstChild;
     SkDOMNode*  fNextSibling;
+    SkDOM::Atom fName;
     uint16_t    fAttrCount;
     uint8_t     fType;
     uint8_t     fPad;
@@ -67,11 +75,30 @@ struct SkDOMNode {
     {
         return (SkDOMAttr*)(this + 1);
     }
+    const uint16_t* index() const
+    {
+        return (const uint16_t*)(this->attrs() + fAttrCount);
+    }
+    uint16_t* index()
+    {
+        return (uint16_t*)(this->attrs() + fAttrCount);
+    }
+
+    static int IndexSize(int attrCount)
+    {
+        if (attrCount <= kMaxLinearAttrs)
+            return 0;
+        int size = 32;
+        while (size < (attrCount << 1))
+            size <<= 1;
+        return size;
+    }
 };
 
 /////////////////////////////////////////////////////////////////////////
 
 #define kMinChunkSize   512
+#define kMinAtomTableSize   64
 
 SkDOM::SkDOM() : fAlloc(kMinChunkSize), fRoot(NULL)
 {
@@ -81,6 +108,115 @@ SkDOM::~SkDOM()
 {
 }
 
+void SkDOM::reset()
+{
+    fAlloc.reset();
+    fRoot = NULL;
+    fAtoms.reset();
+    fAtomTable.reset();
+}
+
+void SkDOM::reserve(size_t docLength)
+{
+    // a tree takes about as much memory as its document; start with one block
+    // that size rather than a long chain of minimum sized ones
+    if (docLength > kMinChunkSize)
+        fAlloc.unalloc(fAlloc.alloc(docLength, SkChunkAlloc::kReturnNil_AllocFailType));
+}
+
+static uint32_t hash_name(const char name[], size_t len)
+{
+    uint32_t hash = 0;
+    for (size_t i = 0; i < len; i++)
+        hash = hash * 31 + (uint8_t)name[i];
+    return hash;
+}
+
+SkDOM::Atom SkDOM::findAtom(const char name[], size_t len, uint32_t hash) const
+{
+    int mask = fAtomTable.count() - 1;
+    if (mask < 0)
+        return kNoAtom;
+
+    int index = hash & mask;
+    Atom atom;
+    while ((atom = fAtomTable[index]) != kNoAtom)
+    {
+        const AtomRec& rec = fAtoms[atom];
+        if (rec.fHash == hash && rec.fLength == len && !memcmp(rec.fName, name, len))
+            break;
+        index = (index + 1) & mask;
+    }
+    return atom;
+}
+
+SkDOM::Atom SkDOM::addAtom(const char name[], size_t len)
+{
+    uint32_t hash = hash_name(name, len);
+    Atom atom = this->findAtom(name, len, hash);
+    if (atom != kNoAtom)
+        return atom;
+
+    // keep the table at most half full
+    if (fAtoms.count() << 1 >= fAtomTable.count())
+    {
+        int size = SkMax32(fAtomTable.count() << 1, kMinAtomTableSize);
+        fAtomTable.setCount(size);
+        memset(fAtomTable.begin(), 0xFF, size * sizeof(Atom));  // kNoAtom
+        for (int i = 0; i < fAtoms.count(); i++)
+        {
+            int index = fAtoms[i].fHash & (size - 1);
+            while (fAtomTable[index] != kNoAtom)
+                index = (index + 1) & (size - 1);
+            fAtomTable[index] = i;
+        }
+    }
+
+    AtomRec* rec = fAtoms.append();
+    char* str = (char*)fAlloc.alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
+    memcpy(str, name, len);
+    str[len] = 0;
+    rec->fName = str;
+    rec->fLength = SkToU32(len);
+    rec->fHash = hash;
+
+    atom = fAtoms.count() - 1;
+    int mask = fAtomTable.count() - 1;
+    int index = hash & mask;
+    while (fAtomTable[index] != kNoAtom)
+        index = (index + 1) & mask;
+    fAtomTable[index] = atom;
+    return atom;
+}
+
+SkDOM::Atom SkDOM::findAtom(const char name[]) const
+{
+    SkASSERT(name);
+    size_t len = strlen(name);
+    return this->findAtom(name, len, hash_name(name, len));
+}
+
+const char* SkDOM::getAtomName(Atom atom) const
+{
+    SkASSERT((unsigned)atom < (unsigned)fAtoms.count());
+    return fAtoms[atom].fName;
+}
+
+SkDOM::Atom SkDOM::getNameAtom(const Node* node) const
+{
+    SkASSERT(node);
+    return node->fName;
+}
+
+SkDOM::Atom SkDOM::getAttrAtom(const Node* node, const Attr* attr) const
+{
+    SkASSERT(node);
+    SkASSERT(attr);
+    return attr->fName;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
 const SkDOM::Node* SkDOM::getRootNode() const
 {
     return fRoot;
@@ -93,8 +229,9 @@ const SkDOM::Node* SkDOM::getFirstChild(const Node* node, const char name[]) con
 
     if (name)
     {
+        Atom atom = this->findAtom(name);
         for (; child != NULL; child = child->fNextSibling)
-            if (!strcmp(name, child->fName))
+            if (child->fName == atom)
                 break;
     }
     return child;
@@ -106,8 +243,9 @@ const SkDOM::Node* SkDOM::getNextSibling(const Node* node, const char name[]) co
     const Node* sibling = node->fNextSibling;
     if (name)
     {
+        Atom atom = this->findAtom(name);
         for (; sibling != NULL; sibling = sibling->fNextSibling)
-            if (!strcmp(name, sibling->fName))
+            if (sibling->fName == atom)
                 break;
     }
     return sibling;
@@ -122,24 +260,59 @@ SkDOM::Type SkDOM::getType(const Node* node) const
 const char* SkDOM::getName(const Node* node) const
 {
     SkASSERT(node);
-    return node->fName;
+    return this->getAtomName(node->fName);
 }
 
-const char* SkDOM::findAttr(const Node* node, const char name[]) const
+const SkDOM::Attr* SkDOM::findAttrRec(const Node* node, Atom atom) const
 {
     SkASSERT(node);
-    const Attr* attr = node->attrs();
-    const Attr* stop = attr + node->fAttrCount;
+    if (atom == kNoAtom)
+        return NULL;
 
-    while (attr < stop)
+    const Attr* attrs = node->attrs();
+    int mask = Node::IndexSize(node->fAttrCount) - 1;
+    if (mask < 0)
     {
-        if (!strcmp(attr->fName, name))
-            return attr->fValue;
-        attr += 1;
+        const Attr* stop = attrs + node->fAttrCount;
+        for (const Attr* attr = attrs; attr < stop; attr++)
+            if (attr->fName == atom)
+                return attr;
+        return NULL;
+    }
+
+    const uint16_t* index = node->index();
+    int slot = atom & mask;
+    int found;
+    while ((found = index[slot]) != 0)
+    {
+        if (attrs[found - 1].fName == atom)
+            return &attrs[found - 1];
+        slot = (slot + 1) & mask;
     }
     return NULL;
 }
 
+const char* SkDOM::findAttr(const Node* node, const char name[]) const
+{
+    return this->findAttr(node, this->findAtom(name));
+}
+
+const char* SkDOM::findAttr(const Node* node, Atom name) const
+{
+    const Attr* attr = this->findAttrRec(node, name);
+    return attr ? attr->fValue : NULL;
+}
+
+const char* SkDOM::findAttr(const Node* node, Atom name, size_t* length) const
+{
+    SkASSERT(length);
+    const Attr* attr = this->findAttrRec(node, name);
+    if (attr == NULL)
+        return NULL;
+    *length = attr->fLength;
+    return attr->fValue;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 
 const SkDOM::Attr* SkDOM::getFirstAttr(const Node* node) const
@@ -159,7 +332,7 @@ const char* SkDOM::getAttrName(const Node* node, const Attr* attr) const
 {
     SkASSERT(node);
     SkASSERT(attr);
-    return attr->fName;
+    return this->getAtomName(attr->fName);
 }
 
 const char* SkDOM::getAttrValue(const Node* node, const Attr* attr) const
@@ -171,7 +344,7 @@ const char* SkDOM::getAttrValue(const Node* node, const Attr* attr) const
 
 /////////////////////////////////////////////////////////////////////////////////////
 
-SkDOM::AttrIter::AttrIter(const SkDOM&, const SkDOM::Node* node)
+SkDOM::AttrIter::AttrIter(const SkDOM& dom, const SkDOM::Node* node) : fDOM(dom)
 {
     SkASSERT(node);
     fAttr = node->attrs();
@@ -184,7 +357,7 @@ const char* SkDOM::AttrIter::next(const char** value)
 
     if (fAttr < fStop)
     {
-        name = fAttr->fName;
+        name = fDOM.getAtomName(fAttr->fName);
         if (value)
             *value = fAttr->fValue;
         fAttr += 1;
@@ -195,34 +368,68 @@ const char* SkDOM::AttrIter::next(const char** value)
 //////////////////////////////////////////////////////////////////////////////
 
 #include "SkXMLParser.h"
-#include "SkTDArray.h"
 
-static char* dupstr(SkChunkAlloc* chunk, const char src[])
-{
-    SkASSERT(chunk && src);
-    size_t  len = strlen(src);
-    char*   dst = (char*)chunk->alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
-    memcpy(dst, src, len + 1);
-    return dst;
-}
-
-class SkDOMParser : public SkXMLParser {
-    bool fNeedToFlush;
+/*  Builds the tree from element and attribute events, whether they come from
+    SkXMLParser (SkDOMParser) or from scanning a document in place.
+*/
+class SkDOMBuilder {
 public:
-    SkDOMParser(SkChunkAlloc* chunk) : SkXMLParser(&fParserError), fAlloc(chunk)
+    SkDOMBuilder(SkDOM* dom) : fDOM(dom)
     {
         fRoot = NULL;
         fLevel = 0;
         fNeedToFlush = true;
     }
     SkDOM::Node* getRoot() const { return fRoot; }
-    SkXMLParserError fParserError;
-protected:
+
+    void startElement(SkDOM::Atom name)
+    {
+        if (fLevel > 0 && fNeedToFlush)
+            this->flushAttributes();
+        fNeedToFlush = true;
+        fElemName = name;
+        ++fLevel;
+    }
+    void addAttribute(SkDOM::Atom name, const char value[], size_t length)
+    {
+        SkDOM::Attr* attr = fAttrs.append();
+        attr->fName = name;
+        attr->fValue = value;
+        attr->fLength = SkToU32(length);
+    }
+    void endElement()
+    {
+        --fLevel;
+        if (fNeedToFlush)
+            this->flushAttributes();
+        fNeedToFlush = false;
+
+        SkDOM::Node* parent;
+
+        fParentStack.pop(&parent);
+
+        SkDOM::Node* child = parent->fFirstChild;
+        SkDOM::Node* prev = NULL;
+        while (child)
+        {
+            SkDOM::Node* next = child->fNextSibling;
+            child->fNextSibling = prev;
+            prev = child;
+            child = next;
+        }
+        parent->fFirstChild = prev;
+    }
+    int attrCount() const { return fAttrs.count(); }
+
+private:
     void flushAttributes()
     {
         int attrCount = fAttrs.count();
+        int indexSize = SkDOM::Node::IndexSize(attrCount);
 
-        SkDOM::Node* node = (SkDOM::Node*)fAlloc->alloc(sizeof(SkDOM::Node) + attrCount * sizeof(SkDOM::Attr),
+        SkDOM::Node* node = (SkDOM::Node*)fDOM->fAlloc.alloc(sizeof(SkDOM::Node) +
+                                                        attrCount * sizeof(SkDOM::Attr) +
+                                                        indexSize * sizeof(uint16_t),
                                                         SkChunkAlloc::kThrow_AllocFailType);
 
         node->fName = fElemName;
@@ -235,7 +442,7 @@ protected:
             node->fNextSibling = NULL;
             fRoot = node;
         }
-        else    // this adds siblings in reverse order. gets corrected in onEndElement()
+        else    // this adds siblings in reverse order. gets corrected in endElement()
         {
             SkDOM::Node* parent = fParentStack.top();
             SkASSERT(fRoot && parent);
@@ -247,69 +454,433 @@ protected:
         memcpy(node->attrs(), fAttrs.begin(), attrCount * sizeof(SkDOM::Attr));
         fAttrs.reset();
 
+        if (indexSize)
+        {
+            uint16_t* index = node->index();
+            memset(index, 0, indexSize * sizeof(uint16_t));
+            for (int i = 0; i < attrCount; i++)
+            {
+                int slot = node->attrs()[i].fName & (indexSize - 1);
+                while (index[slot])
+                    slot = (slot + 1) & (indexSize - 1);
+                index[slot] = SkToU16(i + 1);
+            }
+        }
+    }
+
+    SkDOM*                  fDOM;
+    SkTDArray<SkDOM::Node*> fParentStack;
+    SkDOM::Node*            fRoot;
+
+    // state needed for flushAttributes()
+    SkTDArray<SkDOM::Attr>  fAttrs;
+    SkDOM::Atom             fElemName;
+    int                     fLevel;
+    bool                    fNeedToFlush;
+};
+
+static char* dupstr(SkChunkAlloc* chunk, const char src[], size_t len)
+{
+    SkASSERT(chunk && src);
+    char*   dst = (char*)chunk->alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
+    memcpy(dst, src, len + 1);
+    return dst;
+}
+
+class SkDOMParser : public SkXMLParser {
+public:
+    SkDOMParser(SkDOM* dom) : SkXMLParser(&fParserError), fDOM(dom), fBuilder(dom)
+    {
     }
+    SkDOM::Node* getRoot() const { return fBuilder.getRoot(); }
+    SkXMLParserError fParserError;
+protected:
     virtual bool onStartElement(const char elem[])
     {
-        if (fLevel > 0 && fNeedToFlush)
-            this->flushAttributes();
-        fNeedToFlush = true;
-        fElemName = dupstr(fAlloc, elem);
-        ++fLevel;
+        fBuilder.startElement(fDOM->addAtom(elem, strlen(elem)));
         return false;
     }
     virtual bool onAddAttribute(const char name[], const char value[])
     {
-        SkDOM::Attr* attr = fAttrs.append();
-        attr->fName = dupstr(fAlloc, name);
-        attr->fValue = dupstr(fAlloc, value);
+        size_t len = strlen(value);
+        fBuilder.addAttribute(fDOM->addAtom(name, strlen(name)),
+                              dupstr(&fDOM->fAlloc, value, len), len);
         return false;
     }
     virtual bool onEndElement(const char elem[])
     {
-        --fLevel;
-        if (fNeedToFlush)
-            this->flushAttributes();
-        fNeedToFlush = false;
+        fBuilder.endElement();
+        return false;
+    }
+private:
+    SkDOM*          fDOM;
+    SkDOMBuilder    fBuilder;
+};
 
-        SkDOM::Node* parent;
+const SkDOM::Node* SkDOM::build(const char doc[], size_t len)
+{
+    this->reset();
+    this->reserve(len);
+    SkDOMParser parser(this);
+    if (!parser.parse(doc, len))
+    {
+        SkDEBUGCODE(SkDebugf("xml parse error, line %d\n", parser.fParserError.getLineNumber());)
+        this->reset();
+        return NULL;
+    }
+    fRoot = parser.getRoot();
+    return fRoot;
+}
 
-        fParentStack.pop(&parent);
+//////////////////////////////////////////////////////////////////////////////
 
-        SkDOM::Node* child = parent->fFirstChild;
-        SkDOM::Node* prev = NULL;
-        while (child)
+#include "SkUtils.h"
+
+/*  Scans a document without copying it: names are interned as they are seen.
+    If the DOM owns the document (storage is non-null), attribute values are
+    zero-terminated in place, over their closing quotes. Otherwise, and for
+    values holding entity or character references (or tabs and newlines,
+    which XML normalizes to spaces), the value is copied into the DOM. Either
+    way every value is a C string once the tree is built, so reading the tree
+    never has to write to it. Text, comments, processing instructions and the
+    doctype are skipped.
+*/
+class SkDOMScanner {
+public:
+    SkDOMScanner(SkDOM* dom, const char doc[], size_t len, char storage[])
+        : fDOM(dom), fBuilder(dom), fStorage(storage), fStart(doc), fCurr(doc),
+          fStop(doc + len)
+    {
+        SkASSERT(storage == NULL || storage == doc);
+    }
+    SkDOM::Node* getRoot() const { return fBuilder.getRoot(); }
+    int getLineNumber() const
+    {
+        int line = 1;
+        for (const char* p = fStart; p < fCurr; p++)
+            line += *p == '\n';
+        return line;
+    }
+    bool scan();
+
+private:
+    static bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    static bool IsNameChar(char c)
+    {
+        return !IsSpace(c) && c != '/' && c != '>' && c != '<' && c != '=' &&
+               c != '\'' && c != '"' && c != 0;
+    }
+
+    bool startsWith(const char str[]) const
+    {
+        size_t len = strlen(str);
+        return (size_t)(fStop - fCurr) >= len && !memcmp(fCurr, str, len);
+    }
+    bool skipPast(const char str[])
+    {
+        size_t len = strlen(str);
+        for (; fCurr + len <= fStop; fCurr++)
         {
-            SkDOM::Node* next = child->fNextSibling;
-            child->fNextSibling = prev;
-            prev = child;
-            child = next;
+            if (!memcmp(fCurr, str, len))
+            {
+                fCurr += len;
+                return true;
+            }
         }
-        parent->fFirstChild = prev;
         return false;
     }
-private:
-    SkTDArray<SkDOM::Node*> fParentStack;
-    SkChunkAlloc*   fAlloc;
-    SkDOM::Node*    fRoot;
+    void skipSpace()
+    {
+        while (fCurr < fStop && IsSpace(*fCurr))
+            fCurr++;
+    }
+    const char* scanName()
+    {
+        const char* name = fCurr;
+        while (fCurr < fStop && IsNameChar(*fCurr))
+            fCurr++;
+        return fCurr > name ? name : NULL;
+    }
 
-    // state needed for flushAttributes()
-    SkTDArray<SkDOM::Attr>  fAttrs;
-    char*                   fElemName;
-    int                     fLevel;
+    bool skipDoctype();
+    bool scanStartTag();
+    bool scanEndTag();
+    bool scanAttribute();
+    const char* decode(const char value[], size_t* len);
+
+    SkDOM*              fDOM;
+    SkDOMBuilder        fBuilder;
+    SkTDArray<SkDOM::Atom> fOpen;   // names of the elements we're inside
+    char*               fStorage;   // the writable document, if the DOM owns it
+    const char*         fStart;
+    const char*         fCurr;
+    const char*         fStop;
 };
 
-const SkDOM::Node* SkDOM::build(const char doc[], size_t len)
+bool SkDOMScanner::scan()
 {
-    fAlloc.reset();
-    SkDOMParser parser(&fAlloc);
-    if (!parser.parse(doc, len))
+    // skip a UTF-8 byte order mark
+    if (this->startsWith("\xEF\xBB\xBF"))
+        fCurr += 3;
+
+    bool done = false;
+    while (fCurr < fStop)
     {
-        SkDEBUGCODE(SkDebugf("xml parse error, line %d\n", parser.fParserError.getLineNumber());)
-        fRoot = NULL;
-        fAlloc.reset();
+        if (*fCurr != '<')
+        {
+            // text only belongs inside the root element
+            if (fOpen.count() == 0 && !IsSpace(*fCurr))
+                return false;
+            fCurr++;
+            continue;
+        }
+        bool success;
+        if (this->startsWith("<!--"))
+            success = this->skipPast("-->");
+        else if (this->startsWith("<![CDATA["))
+            success = fOpen.count() > 0 && this->skipPast("]]>");
+        else if (this->startsWith("<!"))
+            success = !done && this->skipDoctype();
+        else if (this->startsWith("<?"))
+            success = this->skipPast("?>");
+        else if (this->startsWith("</"))
+        {
+            success = this->scanEndTag();
+            done = fOpen.count() == 0;
+        }
+        else
+        {
+            success = !done && this->scanStartTag();
+            done = fOpen.count() == 0;
+        }
+        if (!success)
+            return false;
+    }
+    return done;
+}
+
+bool SkDOMScanner::skipDoctype()
+{
+    int depth = 0;  // the internal subset may contain '>'
+    for (fCurr += 2; fCurr < fStop; fCurr++)
+    {
+        if (*fCurr == '[')
+            depth += 1;
+        else if (*fCurr == ']')
+            depth -= 1;
+        else if (*fCurr == '>' && depth <= 0)
+        {
+            fCurr++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SkDOMScanner::scanStartTag()
+{
+    fCurr++;    // '<'
+    const char* name = this->scanName();
+    if (name == NULL)
+        return false;
+    SkDOM::Atom atom = fDOM->addAtom(name, fCurr - name);
+    fBuilder.startElement(atom);
+    for (;;)
+    {
+        this->skipSpace();
+        if (fCurr >= fStop)
+            return false;
+        if (*fCurr == '>')
+        {
+            fCurr++;
+            *fOpen.append() = atom;
+            return true;
+        }
+        if (*fCurr == '/')
+        {
+            if (++fCurr >= fStop || *fCurr != '>')
+                return false;
+            fCurr++;
+            fBuilder.endElement();
+            return true;
+        }
+        if (!this->scanAttribute())
+            return false;
+    }
+}
+
+bool SkDOMScanner::scanEndTag()
+{
+    fCurr += 2; // "</"
+    const char* name = this->scanName();
+    if (name == NULL || fOpen.count() == 0)
+        return false;
+    SkDOM::Atom atom;
+    fOpen.pop(&atom);
+    const char* expected = fDOM->getAtomName(atom);
+    if (strlen(expected) != (size_t)(fCurr - name) || memcmp(expected, name, fCurr - name))
+        return false;
+    this->skipSpace();
+    if (fCurr >= fStop || *fCurr != '>')
+        return false;
+    fCurr++;
+    fBuilder.endElement();
+    return true;
+}
+
+bool SkDOMScanner::scanAttribute()
+{
+    const char* name = this->scanName();
+    if (name == NULL)
+        return false;
+    size_t nameLen = fCurr - name;
+    this->skipSpace();
+    if (fCurr >= fStop || *fCurr != '=')
+        return false;
+    fCurr++;
+    this->skipSpace();
+    if (fCurr >= fStop || (*fCurr != '"' && *fCurr != '\''))
+        return false;
+    const char* value = fCurr + 1;
+    const char* end = (const char*)memchr(value, *fCurr, fStop - value);
+    if (end == NULL || fBuilder.attrCount() >= 0xFFFF)
+        return false;
+    fCurr = end + 1;
+
+    size_t len = end - value;
+    bool plain = true;
+    for (const char* p = value; p < end; p++)
+    {
+        if (*p == '&' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '<')
+        {
+            if ((value = this->decode(value, &len)) == NULL)
+                return false;
+            plain = false;
+            break;
+        }
+    }
+    if (plain && fStorage)
+        fStorage[end - fStart] = 0;     // we've scanned past the quote
+    else if (plain)
+    {
+        char* str = (char*)fDOM->fAlloc.alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
+        memcpy(str, value, len);
+        str[len] = 0;
+        value = str;
+    }
+    fBuilder.addAttribute(fDOM->addAtom(name, nameLen), value, len);
+    return true;
+}
+
+const char* SkDOMScanner::decode(const char value[], size_t* len)
+{
+    const char* stop = value + *len;
+    // the decoded value is never longer than the original: even a character
+    // reference is at least as long as the UTF-8 it stands for
+    char* dst = (char*)fDOM->fAlloc.alloc(*len + 1, SkChunkAlloc::kThrow_AllocFailType);
+    char* start = dst;
+    while (value < stop)
+    {
+        char c = *value++;
+        if (c == '<')
+            return NULL;
+        if (c == '\t' || c == '\n' || c == '\r')
+        {
+            // a \r\n pair is a single line break
+            if (c == '\r' && value < stop && *value == '\n')
+                value++;
+            *dst++ = ' ';
+            continue;
+        }
+        if (c != '&')
+        {
+            *dst++ = c;
+            continue;
+        }
+        const char* semi = (const char*)memchr(value, ';', stop - value);
+        if (semi == NULL)
+            return NULL;
+        size_t refLen = semi - value;
+        if (refLen > 1 && value[0] == '#')
+        {
+            int32_t uni = 0;
+            const char* digit = value + 1;
+            bool hex = *digit == 'x';
+            if (hex)
+                digit++;
+            if (digit == semi)
+                return NULL;
+            for (; digit < semi; digit++)
+            {
+                int n = *digit >= '0' && *digit <= '9' ? *digit - '0' :
+                        hex && *digit >= 'a' && *digit <= 'f' ? *digit - 'a' + 10 :
+                        hex && *digit >= 'A' && *digit <= 'F' ? *digit - 'A' + 10 : -1;
+                if (n < 0 || uni > 0x10FFFF)
+                    return NULL;
+                uni = uni * (hex ? 16 : 10) + n;
+            }
+            if (uni == 0 || uni > 0x10FFFF)
+                return NULL;
+            dst += SkUTF8_FromUnichar(uni, dst);
+        }
+        else
+        {
+            static const struct {
+                const char* fName;
+                char        fChar;
+            } gEntities[] = {
+                { "amp", '&' }, { "apos", '\'' }, { "gt", '>' }, { "lt", '<' }, { "quot", '"' }
+            };
+            size_t i;
+            for (i = 0; i < SK_ARRAY_COUNT(gEntities); i++)
+            {
+                if (strlen(gEntities[i].fName) == refLen &&
+                        !memcmp(gEntities[i].fName, value, refLen))
+                {
+                    *dst++ = gEntities[i].fChar;
+                    break;
+                }
+            }
+            if (i == SK_ARRAY_COUNT(gEntities))
+                return NULL;
+        }
+        value = semi + 1;
+    }
+    *dst = 0;
+    *len = dst - start;
+    return start;
+}
+
+const SkDOM::Node* SkDOM::build(SkStream& stream)
+{
+    this->reset();
+
+    size_t len = stream.getLength();
+    const char* doc = (const char*)stream.getMemoryBase();
+    char* storage = NULL;
+    if (doc == NULL)
+    {
+        storage = (char*)fAlloc.alloc(len, SkChunkAlloc::kThrow_AllocFailType);
+        if (!stream.rewind() || stream.read(storage, len) != len)
+        {
+            this->reset();
+            return NULL;
+        }
+        doc = storage;
+    }
+    this->reserve(len);
+
+    SkDOMScanner scanner(this, doc, len, storage);
+    if (!scanner.scan())
+    {
+        SkDEBUGCODE(SkDebugf("xml parse error, line %d\n", scanner.getLineNumber());)
+        this->reset();
         return NULL;
     }
-    fRoot = parser.getRoot();
+    fRoot = scanner.getRoot();
     return fRoot;
 }
 
@@ -320,7 +891,7 @@ static void walk_dom(const SkDOM& dom, const SkDOM::Node* node, SkXMLParser* par
     const char* elem = dom.getName(node);
 
     parser->startElement(elem);
-    
+
     SkDOM::AttrIter iter(dom, node);
     const char*     name;
     const char*     value;
@@ -339,8 +910,8 @@ static void walk_dom(const SkDOM& dom, const SkDOM::Node* node, SkXMLParser* par
 
 const SkDOM::Node* SkDOM::copy(const SkDOM& dom, const SkDOM::Node* node)
 {
-    fAlloc.reset();
-    SkDOMParser parser(&fAlloc);
+    this->reset();
+    SkDOMParser parser(this);
 
     walk_dom(dom, node, &parser);
 
@@ -450,10 +1021,11 @@ void SkDOM::dump(const Node* node, int level) const
         tab(level);
         SkDebugf("<%s", this->getName(node));
 
-        const Attr* attr = node->attrs();
-        const Attr* stop = attr + node->fAttrCount;
-        for (; attr < stop; attr++)
-            SkDebugf(" %s=\"%s\"", attr->fName, attr->fValue);
+        AttrIter    iter(*this, node);
+        const char* name;
+        const char* value;
+        while ((name = iter.next(&value)) != NULL)
+            SkDebugf(" %s=\"%s\"", name, value);
 
         const Node* child = this->getFirstChild(node);
         if (child)
@@ -465,7 +1037,7 @@ void SkDOM::dump(const Node* node, int level) const
                 child = this->getNextSibling(child);
             }
             tab(level);
-            SkDebugf("</%s>\n", node->fName);
+            SkDebugf("</%s>\n", this->getName(node));
         }
         else
             SkDebugf("/>\n");
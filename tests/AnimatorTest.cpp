@@ -0,0 +1,103 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkAnimator.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkString.h"
+
+enum {
+    kRectCount  = 12,
+    kFrameCount = 24,
+    kSize       = 100
+};
+
+// rects moved by animate formulas, and shown or hidden by group conditions
+static void make_screenplay(SkString* xml) {
+    xml->set("<screenplay>\n<float id='phase' value='0.25' />\n"
+             "<int id='limit' value='30' />\n");
+    for (int i = 0; i < kRectCount; i++) {
+        xml->appendf("<rect id='r%d' left='%d' top='%d' right='%d' bottom='%d' />\n",
+                     i, i * 3, i * 7, i * 3 + 10, i * 7 + 10);
+        xml->appendf("<group id='g%d' condition='r%d.top %% 3 &lt; 2 &amp;&amp; "
+                     "!(phase &gt; 0.7) || r%d.left &gt;= limit / 2'>",
+                     i, i, i);
+        xml->appendf("<add use='r%d' /></group>\n", i);
+        xml->appendf("<apply scope='g%d'>\n", i);
+        xml->appendf("<animate target='r%d' field='left' dur='100000' ", i);
+        xml->appendf("formula='(phase * 40 + r%d.top / 2 + (r%d.right - r%d.left) * 0.5) %% limit' />\n",
+                     i, i, i);
+        xml->appendf("<animate target='r%d' field='bottom' dur='100000' ", i);
+        xml->appendf("formula='r%d.top + 10 + (phase &gt; 0.2 ? limit / 3 : -1.5)' />\n", i);
+        xml->append("</apply>\n");
+    }
+    xml->append("</screenplay>");
+}
+
+struct Frames {
+    SkBitmap    fBitmaps[kFrameCount];
+    SkScalar    fLefts[kFrameCount][kRectCount];
+    SkScalar    fBottoms[kFrameCount][kRectCount];
+};
+
+static bool draw_frames(bool compile, Frames* frames) {
+    SkString xml;
+    make_screenplay(&xml);
+    SkAnimator animator;
+    animator.setCompileScripts(compile);
+    if (!animator.decodeMemory(xml.c_str(), xml.size())) {
+        return false;
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int f = 0; f < kFrameCount; f++) {
+        SkBitmap& bm = frames->fBitmaps[f];
+        bm.setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+        bm.allocPixels();
+        bm.eraseColor(0);
+        SkCanvas canvas(bm);
+
+        animator.setScalar("phase", "value", SkIntToScalar(f % 10) / 10);
+        animator.draw(&canvas, &paint, f * 10);
+
+        for (int i = 0; i < kRectCount; i++) {
+            SkString id;
+            id.printf("r%d", i);
+            frames->fLefts[f][i] = animator.getScalar(id.c_str(), "left");
+            frames->fBottoms[f][i] = animator.getScalar(id.c_str(), "bottom");
+        }
+    }
+    return true;
+}
+
+static void TestAnimator(skiatest::Reporter* reporter) {
+    // SkOperand keeps scalars and pointers in the same slot, and members are
+    // copied through it as 32-bit values, so the animator needs 32-bit hosts
+    if (sizeof(void*) != sizeof(SkScalar)) {
+        return;
+    }
+
+    Frames* interpreted = new Frames;
+    Frames* compiled = new Frames;
+    REPORTER_ASSERT(reporter, draw_frames(false, interpreted));
+    REPORTER_ASSERT(reporter, draw_frames(true, compiled));
+
+    // the compiled scripts must give exactly the interpreter's results
+    for (int f = 0; f < kFrameCount; f++) {
+        REPORTER_ASSERT(reporter,
+                        skiatest::SamePixels(interpreted->fBitmaps[f],
+                                             compiled->fBitmaps[f]));
+        for (int i = 0; i < kRectCount; i++) {
+            REPORTER_ASSERT(reporter, interpreted->fLefts[f][i] ==
+                                      compiled->fLefts[f][i]);
+            REPORTER_ASSERT(reporter, interpreted->fBottoms[f][i] ==
+                                      compiled->fBottoms[f][i]);
+        }
+    }
+    delete interpreted;
+    delete compiled;
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Animator", AnimatorTestClass, TestAnimator)
@@ -1,8 +1,11 @@
 #include "Test.h"
 #include "SkBitmap.h"
+#include "SkBlitRow.h"
+#include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 
 static inline const char* boolStr(bool value) {
@@ -260,9 +263,255 @@ static void test_diagonal(skiatest::Reporter* reporter) {
     }
 }
 
+// Mask blits (e.g. glyphs) must leave the dst alone where the mask is 0, and
+// match a solid fill of an opaque color where it is 0xFF.
+static void test_mask_00_FF(skiatest::Reporter* reporter) {
+    static const int W = 16;
+    static const int H = 4;
+    static const SkBitmap::Config gConfigs[] = {
+        SkBitmap::kARGB_8888_Config,
+        SkBitmap::kRGB_565_Config,
+    };
+    static const SkColor gColors[] = {
+        SK_ColorBLACK, SK_ColorBLUE, 0x80336699, SK_ColorWHITE
+    };
+
+    SkBitmap mask;
+    mask.setConfig(SkBitmap::kA8_Config, W, H);
+    mask.allocPixels();
+    mask.eraseColor(0);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            static const uint8_t gCoverage[] = { 0, 0xFF, 0x80, 0, 0xFF, 1, 0xFE };
+            *mask.getAddr8(x, y) = gCoverage[(x * 3 + y) % SK_ARRAY_COUNT(gCoverage)];
+        }
+    }
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gConfigs); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gColors); j++) {
+            SkPaint paint;
+            paint.setColor(gColors[j]);
+
+            SkBitmap masked, filled, orig;
+            SkBitmap* bms[] = { &masked, &filled, &orig };
+            for (size_t k = 0; k < SK_ARRAY_COUNT(bms); k++) {
+                bms[k]->setConfig(gConfigs[i], W, H);
+                bms[k]->allocPixels();
+                bms[k]->eraseColor(0xFF884422);
+            }
+            SkCanvas(masked).drawBitmap(mask, 0, 0, &paint);
+            SkCanvas(filled).drawPaint(paint);
+            bool opaque = 0xFF == SkColorGetA(gColors[j]);
+
+            bool ok = true;
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    const SkBitmap* expected;
+                    switch (*mask.getAddr8(x, y)) {
+                        case 0:     expected = &orig; break;
+                        case 0xFF:  expected = opaque ? &filled : NULL; break;
+                        default:    expected = NULL; break;
+                    }
+                    if (NULL == expected) {
+                        continue;
+                    }
+                    if (SkBitmap::kARGB_8888_Config == gConfigs[i]) {
+                        ok &= *masked.getAddr32(x, y) == *expected->getAddr32(x, y);
+                    } else {
+                        ok &= *masked.getAddr16(x, y) == *expected->getAddr16(x, y);
+                    }
+                }
+            }
+            if (!ok) {
+                SkString str;
+                str.printf("mask blit config:%s color:%08X",
+                           gConfigName[gConfigs[i]], gColors[j]);
+                reporter->reportFailed(str);
+            }
+        }
+    }
+}
+
+static int lcd_blend(int src, int dst, int coverage, int shift) {
+    return dst + ((src - dst) * coverage >> shift);
+}
+
+// What every LCD proc must compute for pixel i: each channel moves toward the
+// color by its own coverage, scaled by the color's alpha, and 8888's alpha
+// toward 0xFF by the largest of them. An empty mask leaves the pixel alone.
+static void lcd_reference(SkBitmap::Config config, SkMask::Format format,
+                          SkColor color, const void* mask, void* dst, int i) {
+    int cov[3];
+    int shift;
+    if (SkMask::kLCD16_Format == format) {
+        uint16_t m = ((const uint16_t*)mask)[i];
+        if (0 == m) {
+            return;
+        }
+        cov[0] = SkGetPackedR16(m);
+        cov[1] = SkGetPackedG16(m) >> 1;
+        cov[2] = SkGetPackedB16(m);
+        for (int k = 0; k < 3; k++) {
+            cov[k] += cov[k] >> 4;
+        }
+        shift = 5;
+    } else {
+        uint32_t m = ((const uint32_t*)mask)[i];
+        if (0 == m) {
+            return;
+        }
+        cov[0] = SkAlpha255To256(SkGetPackedR32(m));
+        cov[1] = SkAlpha255To256(SkGetPackedG32(m));
+        cov[2] = SkAlpha255To256(SkGetPackedB32(m));
+        shift = 8;
+        if (SkBitmap::kRGB_565_Config == config) {
+            for (int k = 0; k < 3; k++) {
+                cov[k] >>= 3;
+            }
+            shift = 5;
+        }
+    }
+    int scale = SkAlpha255To256(SkColorGetA(color));
+    for (int k = 0; k < 3; k++) {
+        cov[k] = cov[k] * scale >> 8;
+    }
+
+    if (SkBitmap::kARGB_8888_Config == config) {
+        SkPMColor* d = (SkPMColor*)dst + i;
+        int maxCov = SkMax32(SkMax32(cov[0], cov[1]), cov[2]);
+        *d = SkPackARGB32(lcd_blend(0xFF, SkGetPackedA32(*d), maxCov, shift),
+                          lcd_blend(SkColorGetR(color), SkGetPackedR32(*d), cov[0], shift),
+                          lcd_blend(SkColorGetG(color), SkGetPackedG32(*d), cov[1], shift),
+                          lcd_blend(SkColorGetB(color), SkGetPackedB32(*d), cov[2], shift));
+    } else {
+        uint16_t* d = (uint16_t*)dst + i;
+        *d = SkPackRGB16(lcd_blend(SkR32ToR16(SkColorGetR(color)), SkGetPackedR16(*d), cov[0], 5),
+                         lcd_blend(SkG32ToG16(SkColorGetG(color)), SkGetPackedG16(*d), cov[1], 5),
+                         lcd_blend(SkB32ToB16(SkColorGetB(color)), SkGetPackedB16(*d), cov[2], 5));
+    }
+}
+
+// LCD masks blitted by the factory's proc, the platform's, and the blitters,
+// all against lcd_reference. The odd width leaves the platform procs a tail.
+static void test_lcd_masks(skiatest::Reporter* reporter) {
+    static const int W = 19;
+    static const int H = 3;
+    static const SkBitmap::Config gConfigs[] = {
+        SkBitmap::kARGB_8888_Config,
+        SkBitmap::kRGB_565_Config,
+    };
+    static const SkMask::Format gFormats[] = {
+        SkMask::kLCD16_Format,
+        SkMask::kLCD32_Format,
+    };
+    static const SkColor gColors[] = {
+        SK_ColorBLACK, 0xFF3366CC, 0x80336699, 0x01FFFFFF
+    };
+
+    SkRandom rand;
+    uint32_t maskStorage[W * H];
+    SkBitmap orig, expected, actual;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gConfigs); i++) {
+        SkBitmap::Config config = gConfigs[i];
+        SkBitmap* bms[] = { &orig, &expected, &actual };
+        for (size_t k = 0; k < SK_ARRAY_COUNT(bms); k++) {
+            bms[k]->setConfig(config, W, H);
+            bms[k]->allocPixels();
+        }
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (SkBitmap::kARGB_8888_Config == config) {
+                    // premultiplied, so the blends can pack it
+                    unsigned a = rand.nextU() & 0xFF;
+                    *orig.getAddr32(x, y) = SkPackARGB32(a, rand.nextU() % (a + 1),
+                                                         rand.nextU() % (a + 1),
+                                                         rand.nextU() % (a + 1));
+                } else {
+                    *orig.getAddr16(x, y) = (uint16_t)rand.nextU();
+                }
+            }
+        }
+
+        for (size_t f = 0; f < SK_ARRAY_COUNT(gFormats); f++) {
+            SkMask mask;
+            mask.fImage = (uint8_t*)maskStorage;
+            mask.fBounds.set(0, 0, W, H);
+            mask.fFormat = gFormats[f];
+            mask.fRowBytes = SkMask::kLCD16_Format == mask.fFormat ?
+                             W * sizeof(uint16_t) : W * sizeof(uint32_t);
+            // some empty and some full coverage, as glyphs have
+            for (int n = 0; n < W * H; n++) {
+                uint32_t m;
+                switch (rand.nextU() & 7) {
+                    case 0: case 1: m = 0; break;
+                    case 2: m = 0xFFFFFFFF; break;
+                    default: m = rand.nextU(); break;
+                }
+                if (SkMask::kLCD16_Format == mask.fFormat) {
+                    ((uint16_t*)maskStorage)[n] = (uint16_t)m;
+                } else {
+                    maskStorage[n] = m;
+                }
+            }
+
+            for (size_t c = 0; c < SK_ARRAY_COUNT(gColors) * 2; c++) {
+                SkColor color = gColors[c >> 1];
+                // and a width narrower than the platform procs' blocks
+                int width = (c & 1) ? 3 : W;
+                orig.copyTo(&expected, config);
+                for (int y = 0; y < H; y++) {
+                    for (int x = 0; x < width; x++) {
+                        lcd_reference(config, mask.fFormat, color,
+                                      mask.fImage + y * mask.fRowBytes,
+                                      expected.getAddr(0, y), x);
+                    }
+                }
+
+                SkBlitMask::Proc procs[] = {
+                    SkBlitMask::Factory(config, mask.fFormat, color),
+                    SkBlitMask::PlatformProcs(config, mask.fFormat, color)
+                };
+                REPORTER_ASSERT(reporter, procs[0]);
+                for (size_t p = 0; p < SK_ARRAY_COUNT(procs); p++) {
+                    if (NULL == procs[p]) {
+                        continue;
+                    }
+                    orig.copyTo(&actual, config);
+                    procs[p](actual.getPixels(), actual.rowBytes(), config,
+                             mask.fImage, mask.fRowBytes, color, width, H);
+                    if (memcmp(actual.getPixels(), expected.getPixels(),
+                               expected.getSize())) {
+                        SkString str;
+                        str.printf("%s LCD proc config:%s format:%d color:%08X width:%d",
+                                   p ? "platform" : "factory",
+                                   gConfigName[config], mask.fFormat, color, width);
+                        reporter->reportFailed(str);
+                    }
+                }
+
+                SkPaint paint;
+                paint.setColor(color);
+                orig.copyTo(&actual, config);
+                SkBlitter* blitter = SkBlitter::Choose(actual, SkMatrix::I(), paint);
+                blitter->blitMask(mask, SkIRect::MakeWH(width, H));
+                delete blitter;
+                if (memcmp(actual.getPixels(), expected.getPixels(),
+                           expected.getSize())) {
+                    SkString str;
+                    str.printf("LCD blitter config:%s format:%d color:%08X width:%d",
+                               gConfigName[config], mask.fFormat, color, width);
+                    reporter->reportFailed(str);
+                }
+            }
+        }
+    }
+}
+
 static void TestBlitRow(skiatest::Reporter* reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
+    test_mask_00_FF(reporter);
+    test_lcd_masks(reporter);
 }
 
 #include "TestClassDef.h"
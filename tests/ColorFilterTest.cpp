@@ -1,6 +1,9 @@
 #include "Test.h"
 #include "SkColor.h"
 #include "SkColorFilter.h"
+#include "SkColorFilterProcs.h"
+#include "SkColorMatrixFilter.h"
+#include "SkColorPriv.h"
 #include "SkRandom.h"
 #include "SkXfermode.h"
 
@@ -89,5 +92,135 @@ static void test_asColorMode(skiatest::Reporter* reporter) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// odd, so that the platform procs get a tail to handle
+#define SPAN_COUNT  259
+
+static void make_colors(SkPMColor colors[], uint16_t colors16[]) {
+    SkRandom rand;
+    for (int i = 0; i < SPAN_COUNT; i++) {
+        unsigned a = rand.nextU() & 0xFF;
+        // some of each of the special cases
+        if (i % 7 == 0) {
+            a = 0xFF;
+        } else if (i % 11 == 0) {
+            a = 0;
+        }
+        colors[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF,
+                                      rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+        colors16[i] = rand.nextU() & 0xFFFF;
+    }
+}
+
+// the platform procs (if any) must match the portable code exactly
+static void test_platform_procs(skiatest::Reporter* reporter,
+                                SkColorFilter* cf, const SkPMColor colors[],
+                                const uint16_t colors16[]) {
+    SkAutoUnref aur(cf);
+    SkPMColor expected[SPAN_COUNT], actual[SPAN_COUNT];
+    uint16_t expected16[SPAN_COUNT], actual16[SPAN_COUNT];
+    bool has16 = SkToBool(cf->getFlags() & SkColorFilter::kHasFilter16_Flag);
+
+    SkColorFilterProcs::SetUsePlatformProcs(false);
+    cf->filterSpan(colors, SPAN_COUNT, expected);
+    if (has16) {
+        cf->filterSpan16(colors16, SPAN_COUNT, expected16);
+    }
+
+    SkColorFilterProcs::SetUsePlatformProcs(true);
+    cf->filterSpan(colors, SPAN_COUNT, actual);
+    REPORTER_ASSERT(reporter, !memcmp(expected, actual, sizeof(actual)));
+    if (has16) {
+        cf->filterSpan16(colors16, SPAN_COUNT, actual16);
+        REPORTER_ASSERT(reporter, !memcmp(expected16, actual16,
+                                          sizeof(actual16)));
+    }
+
+    // in place
+    memcpy(actual, colors, sizeof(actual));
+    cf->filterSpan(actual, SPAN_COUNT, actual);
+    REPORTER_ASSERT(reporter, !memcmp(expected, actual, sizeof(actual)));
+}
+
+static void test_colormatrix(skiatest::Reporter* reporter,
+                             const SkPMColor colors[],
+                             const uint16_t colors16[]) {
+    SkColorMatrix cm;
+
+    cm.setSaturation(0);                                    // affine
+    test_platform_procs(reporter, new SkColorMatrixFilter(cm), colors, colors16);
+    cm.setScale(SkFloatToScalar(0.5f), SkFloatToScalar(1.25f),
+                SkFloatToScalar(2));                        // scale
+    test_platform_procs(reporter, new SkColorMatrixFilter(cm), colors, colors16);
+    cm.setRGB2YUV();
+    test_platform_procs(reporter, new SkColorMatrixFilter(cm), colors, colors16);
+
+    SkScalar array[20];
+    for (int i = 0; i < 20; i++) {
+        array[i] = (i % 6) ? 0 : SK_Scalar1;
+    }
+    array[4] = SkIntToScalar(40);                           // add
+    array[9] = SkIntToScalar(-20);
+    test_platform_procs(reporter, new SkColorMatrixFilter(array), colors, colors16);
+
+    array[3] = SK_Scalar1 / 2;                              // uses alpha
+    test_platform_procs(reporter, new SkColorMatrixFilter(array), colors, colors16);
+
+    array[18] = SK_Scalar1 / 3;                             // changes alpha
+    array[19] = SkIntToScalar(17);
+    test_platform_procs(reporter, new SkColorMatrixFilter(array), colors, colors16);
+
+    // large enough that the matrix is stored with less than 16 bits of fraction
+    array[0] = SkIntToScalar(-300);
+    array[7] = SkIntToScalar(200);
+    array[14] = SkIntToScalar(-1000);
+    test_platform_procs(reporter, new SkColorMatrixFilter(array), colors, colors16);
+
+    SkRandom rand;
+    for (int n = 0; n < 20; n++) {
+        for (int i = 0; i < 20; i++) {
+            array[i] = rand.nextSScalar1() * 2;
+            if (4 == i % 5) {
+                array[i] *= 255;
+            }
+        }
+        test_platform_procs(reporter, new SkColorMatrixFilter(array), colors, colors16);
+    }
+}
+
+static void test_lighting(skiatest::Reporter* reporter,
+                          const SkPMColor colors[],
+                          const uint16_t colors16[]) {
+    static const SkColor gMulAdd[] = {
+        0xFFFFFF, 0x204080,     // just add
+        0x80C0FF, 0x000000,     // just mul
+        0x404040, 0x000000,     // single mul
+        0x406080, 0x402010,     // no pin
+        0xC0E0FF, 0x80FF40,     // general
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gMulAdd); i += 2) {
+        test_platform_procs(reporter,
+                    SkColorFilter::CreateLightingFilter(gMulAdd[i], gMulAdd[i + 1]),
+                    colors, colors16);
+    }
+    SkRandom rand;
+    for (int n = 0; n < 20; n++) {
+        test_platform_procs(reporter,
+                    SkColorFilter::CreateLightingFilter(rand.nextU(), rand.nextU()),
+                    colors, colors16);
+    }
+}
+
+static void TestColorFilter(skiatest::Reporter* reporter) {
+    test_asColorMode(reporter);
+
+    SkPMColor colors[SPAN_COUNT];
+    uint16_t colors16[SPAN_COUNT];
+    make_colors(colors, colors16);
+    test_colormatrix(reporter, colors, colors16);
+    test_lighting(reporter, colors, colors16);
+}
+
 #include "TestClassDef.h"
-DEFINE_TESTCLASS("ColorFilter", ColorFilterTestClass, test_asColorMode)
+DEFINE_TESTCLASS("ColorFilter", ColorFilterTestClass, TestColorFilter)
@@ -0,0 +1,168 @@
+#include "Test.h"
+#include "SkDOM.h"
+#include "SkStream.h"
+
+static const char gDoc[] =
+    "<?xml version='1.0'?>\n"
+    "<!-- a comment <with> markup -->\n"
+    "<!DOCTYPE root [ <!ENTITY e 'x'> ]>\n"
+    "<root a='1' b=\"two words\">\n"
+        "<elem1 c='3' />\n"
+        "text, which is skipped <![CDATA[ <elem9/> ]]>\n"
+        "<elem2 d='&lt;&amp;&gt; &#65;&#x42;' e='tab\there' />\n"
+        "<elem3 f='5'>"
+            "<subelem1/>"
+            "<subelem2 g='6' h='7' i='8' j='9' k='10' l='11' m='12' n='13' o='14' p='15'/>"
+        "</elem3>\n"
+        "<elem1 c='4'></elem1>\n"
+    "</root>\n"
+    ;
+
+// a stream that isn't backed by memory, so its document is copied
+class NoMemoryStream : public SkMemoryStream {
+public:
+    NoMemoryStream(const void* data, size_t length) : SkMemoryStream(data, length) {}
+    virtual const void* getMemoryBase() { return NULL; }
+};
+
+static void test_tree(skiatest::Reporter* reporter, const SkDOM& dom) {
+    const SkDOM::Node* root = dom.getRootNode();
+    REPORTER_ASSERT(reporter, root);
+    if (NULL == root) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, !strcmp(dom.getName(root), "root"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(root, "a"), "1"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(root, "b"), "two words"));
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(root, "c"));
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(root, "unknown"));
+
+    REPORTER_ASSERT(reporter, 4 == dom.countChildren(root));
+    REPORTER_ASSERT(reporter, 2 == dom.countChildren(root, "elem1"));
+    REPORTER_ASSERT(reporter, 0 == dom.countChildren(root, "subelem1"));
+    REPORTER_ASSERT(reporter, 0 == dom.countChildren(root, "elem9"));
+
+    const SkDOM::Node* elem1 = dom.getFirstChild(root, "elem1");
+    int32_t value;
+    REPORTER_ASSERT(reporter, dom.findS32(elem1, "c", &value) && 3 == value);
+    elem1 = dom.getNextSibling(elem1, "elem1");
+    REPORTER_ASSERT(reporter, dom.findS32(elem1, "c", &value) && 4 == value);
+    REPORTER_ASSERT(reporter, NULL == dom.getFirstChild(elem1));
+
+    const SkDOM::Node* elem2 = dom.getFirstChild(root, "elem2");
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(elem2, "d"), "<&> AB"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(elem2, "e"), "tab here"));
+
+    // names are shared by every element and attribute that uses them
+    SkDOM::Atom c = dom.findAtom("c");
+    REPORTER_ASSERT(reporter, SkDOM::kNoAtom != c);
+    REPORTER_ASSERT(reporter, SkDOM::kNoAtom == dom.findAtom("unknown"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.getAtomName(c), "c"));
+    REPORTER_ASSERT(reporter, dom.getNameAtom(elem1) ==
+                              dom.getNameAtom(dom.getFirstChild(root)));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(elem1, c), "4"));
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(elem1, dom.findAtom("a")));
+
+    // enough attributes to be found through the node's index
+    const SkDOM::Node* sub2 = dom.getFirstChild(dom.getFirstChild(root, "elem3"), "subelem2");
+    static const char* gNames[] = { "g", "h", "i", "j", "k", "l", "m", "n", "o", "p" };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gNames); i++) {
+        REPORTER_ASSERT(reporter, dom.findS32(sub2, gNames[i], &value) &&
+                                  (int32_t)i + 6 == value);
+    }
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(sub2, "a"));
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(sub2, "f"));
+
+    // attributes are iterated in document order
+    SkDOM::AttrIter iter(dom, sub2);
+    const char* name;
+    const char* attrValue;
+    size_t count = 0;
+    while ((name = iter.next(&attrValue)) != NULL) {
+        REPORTER_ASSERT(reporter, count < SK_ARRAY_COUNT(gNames) &&
+                                  !strcmp(name, gNames[count]));
+        count += 1;
+    }
+    REPORTER_ASSERT(reporter, SK_ARRAY_COUNT(gNames) == count);
+}
+
+static void test_build(skiatest::Reporter* reporter) {
+    SkDOM dom;
+    REPORTER_ASSERT(reporter, dom.build(gDoc, sizeof(gDoc) - 1));
+    test_tree(reporter, dom);
+
+    // the tree doesn't hang on to a stream it scanned in place
+    SkMemoryStream* stream = new SkMemoryStream(gDoc, sizeof(gDoc) - 1);
+    REPORTER_ASSERT(reporter, dom.build(*stream));
+    REPORTER_ASSERT(reporter, 1 == stream->getRefCnt());
+    stream->unref();
+    test_tree(reporter, dom);
+
+    NoMemoryStream copied(gDoc, sizeof(gDoc) - 1);
+    REPORTER_ASSERT(reporter, dom.build(copied));
+    REPORTER_ASSERT(reporter, 1 == copied.getRefCnt());
+    test_tree(reporter, dom);
+
+    SkDOM copy;
+    REPORTER_ASSERT(reporter, copy.copy(dom, dom.getRootNode()));
+    test_tree(reporter, copy);
+}
+
+static void test_values(skiatest::Reporter* reporter, SkStream* stream) {
+    SkDOM dom;
+    const SkDOM::Node* root = dom.build(*stream);
+    REPORTER_ASSERT(reporter, root);
+    if (NULL == root) {
+        return;
+    }
+    // the values are C strings, out of the stream's memory, before anyone
+    // asks for one; reading them doesn't move them
+    size_t length;
+    const char* value = dom.findAttr(root, dom.findAtom("b"), &length);
+    REPORTER_ASSERT(reporter, value < gDoc || value >= gDoc + sizeof(gDoc));
+    REPORTER_ASSERT(reporter, 9 == length && !strcmp(value, "two words"));
+    REPORTER_ASSERT(reporter, value == dom.findAttr(root, "b"));
+    REPORTER_ASSERT(reporter, value == dom.findAttr(root, dom.findAtom("b"), &length));
+
+    const SkDOM::Node* elem2 = dom.getFirstChild(root, "elem2");
+    value = dom.findAttr(elem2, dom.findAtom("d"), &length);
+    REPORTER_ASSERT(reporter, 6 == length && !strcmp(value, "<&> AB"));
+    REPORTER_ASSERT(reporter, value == dom.findAttr(elem2, "d"));
+}
+
+static void test_errors(skiatest::Reporter* reporter) {
+    static const char* gBad[] = {
+        "",
+        "text",
+        "<root>",
+        "<root></other>",
+        "<root/><second/>",
+        "<root a='1></root>",
+        "<root a=1/>",
+        "<root a='&unknown;'/>",
+        "<root a='&#;'/>",
+        "<root a='<'/>",
+        "<root/>text",
+    };
+    SkDOM dom;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gBad); i++) {
+        SkMemoryStream stream(gBad[i], strlen(gBad[i]));
+        REPORTER_ASSERT(reporter, NULL == dom.build(stream));
+        REPORTER_ASSERT(reporter, NULL == dom.getRootNode());
+    }
+    SkMemoryStream stream("\xEF\xBB\xBF<root/>\n", 11);
+    SkDOM bom;
+    REPORTER_ASSERT(reporter, bom.build(stream));
+}
+
+static void TestDOM(skiatest::Reporter* reporter) {
+    test_build(reporter);
+    SkMemoryStream stream(gDoc, sizeof(gDoc) - 1);
+    test_values(reporter, &stream);
+    NoMemoryStream copied(gDoc, sizeof(gDoc) - 1);
+    test_values(reporter, &copied);
+    test_errors(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DOM", DOMTestClass, TestDOM)
@@ -0,0 +1,157 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkBounder.h"
+#include "SkCanvas.h"
+#include "SkDevice.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkRegion.h"
+
+static const int kSize = 100;
+
+// true if every pixel that differs between a and b is in damage
+static bool damage_covers(const SkBitmap& a, const SkBitmap& b,
+                          const SkRegion& damage) {
+    SkAutoLockPixels alp0(a);
+    SkAutoLockPixels alp1(b);
+    for (int y = 0; y < kSize; y++) {
+        for (int x = 0; x < kSize; x++) {
+            if (*a.getAddr32(x, y) != *b.getAddr32(x, y) &&
+                    !damage.contains(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void draw_scene(SkCanvas* canvas, int frame) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(SkIntToScalar(30), SkIntToScalar(30),
+                       SkIntToScalar(20) + SK_Scalar1 / 3, paint);
+    paint.setColor(SK_ColorRED);
+    SkRect r;
+    r.set(SkIntToScalar(60 + frame), SkIntToScalar(60) + SK_Scalar1 / 2,
+          SkIntToScalar(75 + frame), SkIntToScalar(70));
+    canvas->drawRect(r, paint);
+    canvas->drawLine(SkIntToScalar(10), SkIntToScalar(90),
+                     SkIntToScalar(40), SkIntToScalar(82), paint);
+}
+
+namespace {
+
+// refuses every draw
+class RejectBounder : public SkBounder {
+protected:
+    virtual bool onIRect(const SkIRect&) { return false; }
+};
+
+}
+
+static void test_tracking(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, kSize, kSize);
+    SkCanvas canvas(bm);
+    SkDevice* device = canvas.getDevice();
+    REPORTER_ASSERT(reporter, !device->isTrackingDamage());
+    REPORTER_ASSERT(reporter, device->getDamage().isEmpty());
+
+    device->setTrackDamage(true);
+    draw_scene(&canvas, 0);
+    const SkRegion& damage = device->getDamage();
+    SkBitmap empty;
+    skiatest::MakeBitmap(&empty, kSize, kSize);
+    REPORTER_ASSERT(reporter, damage_covers(bm, empty, damage));
+    REPORTER_ASSERT(reporter, !damage.contains(95, 5));
+
+    // moving the rect damages just around it
+    SkBitmap prev;
+    bm.copyTo(&prev, SkBitmap::kARGB_8888_Config);
+    device->resetDamage();
+    REPORTER_ASSERT(reporter, device->getDamage().isEmpty());
+    SkRect r;
+    r.set(SkIntToScalar(58), SkIntToScalar(58), SkIntToScalar(80),
+          SkIntToScalar(72));
+    canvas.save();
+    canvas.clipRect(r);
+    canvas.drawColor(0, SkXfermode::kClear_Mode);
+    draw_scene(&canvas, 3);
+    canvas.restore();
+    REPORTER_ASSERT(reporter, damage_covers(bm, prev, device->getDamage()));
+    REPORTER_ASSERT(reporter, !device->getDamage().contains(30, 30));
+    REPORTER_ASSERT(reporter, !device->getDamage().contains(10, 85));
+
+    // drawing through a layer damages where the layer is drawn back
+    device->resetDamage();
+    bm.copyTo(&prev, SkBitmap::kARGB_8888_Config);
+    r.set(SkIntToScalar(5), SkIntToScalar(5), SkIntToScalar(40),
+          SkIntToScalar(40));
+    canvas.saveLayerAlpha(&r, 0x80);
+    draw_scene(&canvas, 0);
+    canvas.restore();
+    REPORTER_ASSERT(reporter, damage_covers(bm, prev, device->getDamage()));
+    REPORTER_ASSERT(reporter, !device->getDamage().contains(70, 65));
+
+    // draws that the canvas' bounder refuses do no damage
+    device->resetDamage();
+    canvas.setBounder(new RejectBounder)->unref();
+    draw_scene(&canvas, 5);
+    REPORTER_ASSERT(reporter, device->getDamage().isEmpty());
+    canvas.setBounder(NULL);
+
+    device->setTrackDamage(false);
+    draw_scene(&canvas, 5);
+    REPORTER_ASSERT(reporter, device->getDamage().isEmpty());
+}
+
+static void test_picture_damage(skiatest::Reporter* reporter) {
+    SkPicture picture;
+    draw_scene(picture.beginRecording(kSize, kSize), 7);
+    picture.endRecording();
+
+    SkBitmap full;
+    skiatest::MakeBitmap(&full, kSize, kSize);
+    SkCanvas fullCanvas(full);
+    fullCanvas.drawColor(SK_ColorWHITE);
+    picture.draw(&fullCanvas);
+
+    // the last frame, as the compositor still has it
+    SkBitmap partial;
+    skiatest::MakeBitmap(&partial, kSize, kSize);
+    SkCanvas partialCanvas(partial);
+    partialCanvas.drawColor(SK_ColorWHITE);
+    draw_scene(&partialCanvas, 0);
+
+    // only the moved rect changed between the frames
+    SkRegion damage;
+    damage.setRect(55, 55, 90, 75);
+    partialCanvas.save();
+    partialCanvas.clipRegion(damage);
+    partialCanvas.drawColor(SK_ColorWHITE);
+    partialCanvas.restore();
+    picture.draw(&partialCanvas, damage);
+    REPORTER_ASSERT(reporter, skiatest::SamePixels(full, partial));
+
+    // nothing is drawn outside the damage
+    SkBitmap blank;
+    skiatest::MakeBitmap(&blank, kSize, kSize);
+    SkCanvas blankCanvas(blank);
+    blankCanvas.drawColor(SK_ColorWHITE);
+    damage.setRect(0, 0, 20, 20);
+    picture.draw(&blankCanvas, damage);
+    SkAutoLockPixels alp(blank);
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == *blank.getAddr32(70, 65));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE != *blank.getAddr32(19, 19));
+    REPORTER_ASSERT(reporter, 1 == blankCanvas.getSaveCount());
+}
+
+static void TestDamage(skiatest::Reporter* reporter) {
+    test_tracking(reporter);
+    test_picture_damage(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Damage", DamageTestClass, TestDamage)
@@ -0,0 +1,91 @@
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkThread.h"
+
+static void draw_frame(SkCanvas* canvas, const SkPath& path) {
+    SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(300), SkIntToScalar(200) } };
+    SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkShader* shader = SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                    SkShader::kClamp_TileMode);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setShader(shader)->unref();
+    canvas->drawPath(path, paint);
+
+    // large enough for the tiled supersampler
+    paint.setShader(NULL);
+    canvas->drawCircle(SkIntToScalar(150), SkIntToScalar(100),
+                       SkIntToScalar(90), paint);
+
+    SkRect r;
+    r.set(SkIntToScalar(10), SkIntToScalar(10), SkIntToScalar(50),
+          SkIntToScalar(40));
+    paint.setAntiAlias(false);
+    canvas->drawRect(r, paint);
+}
+
+static void TestDrawArena(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, 300, 200);
+    bm.allocPixels();
+    bm.eraseColor(0);
+    SkCanvas canvas(bm);
+
+    SkPath path;
+    path.moveTo(SkIntToScalar(5), SkIntToScalar(5));
+    path.quadTo(SkIntToScalar(290), SkIntToScalar(20), SkIntToScalar(250),
+                SkIntToScalar(190));
+    path.lineTo(SkIntToScalar(20), SkIntToScalar(150));
+    path.close();
+
+    // start from a new arena, whatever has been drawn on this thread before
+    sk_delete_thread_data();
+
+    // the first frame sizes the arena
+    draw_frame(&canvas, path);
+    draw_frame(&canvas, path);
+
+    int allocCount, heapAllocCount;
+    SkGraphics::ResetDrawAllocCounts();
+    draw_frame(&canvas, path);
+    SkGraphics::GetDrawAllocCounts(&allocCount, &heapAllocCount);
+    REPORTER_ASSERT(reporter, allocCount > 0);
+    REPORTER_ASSERT(reporter, 0 == heapAllocCount);
+
+    // a much wider device asks for more than the arena holds, until it grows
+    SkBitmap wide;
+    wide.setConfig(SkBitmap::kARGB_8888_Config, 8000, 200);
+    wide.allocPixels();
+    SkCanvas wideCanvas(wide);
+    SkGraphics::ResetDrawAllocCounts();
+    draw_frame(&wideCanvas, path);
+    SkGraphics::GetDrawAllocCounts(NULL, &heapAllocCount);
+    REPORTER_ASSERT(reporter, heapAllocCount > 0);
+
+    draw_frame(&wideCanvas, path);
+    SkGraphics::ResetDrawAllocCounts();
+    draw_frame(&wideCanvas, path);
+    SkGraphics::GetDrawAllocCounts(NULL, &heapAllocCount);
+    REPORTER_ASSERT(reporter, 0 == heapAllocCount);
+
+    // freeing the thread's arena starts it over
+    sk_delete_thread_data();
+    SkGraphics::ResetDrawAllocCounts();
+    draw_frame(&canvas, path);
+    SkGraphics::GetDrawAllocCounts(NULL, &heapAllocCount);
+    REPORTER_ASSERT(reporter, heapAllocCount > 0);
+
+    draw_frame(&canvas, path);
+    SkGraphics::ResetDrawAllocCounts();
+    draw_frame(&canvas, path);
+    SkGraphics::GetDrawAllocCounts(NULL, &heapAllocCount);
+    REPORTER_ASSERT(reporter, 0 == heapAllocCount);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DrawArena", DrawArenaTestClass, TestDrawArena)
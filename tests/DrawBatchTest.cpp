@@ -0,0 +1,112 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+
+static const int kSize = 100;
+
+// sets up the same clip and (offset) layer on both canvases
+static void setup_canvas(SkCanvas* canvas, bool layer) {
+    SkRect r;
+    r.set(SkIntToScalar(5), SkIntToScalar(3), SkIntToScalar(90),
+          SkIntToScalar(95));
+    canvas->clipRect(r);
+    if (layer) {
+        r.set(SkIntToScalar(20), SkIntToScalar(10), SkIntToScalar(80),
+              SkIntToScalar(70));
+        canvas->saveLayer(&r, NULL);
+    }
+}
+
+static void test_rects(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkRect rects[40];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(rects); i++) {
+        SkScalar x = SkScalarMul(rand.nextUScalar1(), SkIntToScalar(kSize));
+        SkScalar y = SkScalarMul(rand.nextUScalar1(), SkIntToScalar(kSize));
+        rects[i].set(x, y, x + SkScalarMul(rand.nextUScalar1(), 12 * SK_Scalar1),
+                     y + SkScalarMul(rand.nextUScalar1(), 12 * SK_Scalar1));
+    }
+
+    static const SkPaint::Style gStyles[] = {
+        SkPaint::kFill_Style, SkPaint::kStroke_Style, SkPaint::kStroke_Style
+    };
+    for (int layer = 0; layer <= 1; layer++) {
+        for (int aa = 0; aa <= 1; aa++) {
+            for (size_t s = 0; s < SK_ARRAY_COUNT(gStyles); s++) {
+                SkPaint paint;
+                paint.setAntiAlias(SkToBool(aa));
+                paint.setStyle(gStyles[s]);
+                paint.setStrokeWidth(SkIntToScalar(s == 2 ? 3 : 0));
+                paint.setColor(0xC0336699);
+
+                SkBitmap single, batch;
+                skiatest::MakeBitmap(&single, kSize, kSize);
+                skiatest::MakeBitmap(&batch, kSize, kSize);
+                SkCanvas singleCanvas(single), batchCanvas(batch);
+                setup_canvas(&singleCanvas, SkToBool(layer));
+                setup_canvas(&batchCanvas, SkToBool(layer));
+
+                for (size_t i = 0; i < SK_ARRAY_COUNT(rects); i++) {
+                    singleCanvas.drawRect(rects[i], paint);
+                }
+                batchCanvas.drawRects(rects, SK_ARRAY_COUNT(rects), paint);
+                singleCanvas.restoreToCount(1);
+                batchCanvas.restoreToCount(1);
+
+                REPORTER_ASSERT(reporter, skiatest::SamePixels(single, batch));
+            }
+        }
+    }
+}
+
+static void test_sprites(skiatest::Reporter* reporter) {
+    SkBitmap sprite;
+    skiatest::MakeBitmap(&sprite, 7, 5);
+    for (int y = 0; y < sprite.height(); y++) {
+        for (int x = 0; x < sprite.width(); x++) {
+            *sprite.getAddr32(x, y) = SkPackARGB32(0x80 + x * 16, x * 16,
+                                                   y * 32, 0x40);
+        }
+    }
+
+    SkRandom rand;
+    SkIPoint pts[30];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(pts); i++) {
+        pts[i].set(rand.nextU() % kSize - 3, rand.nextU() % kSize - 2);
+    }
+
+    for (int layer = 0; layer <= 1; layer++) {
+        for (int alpha = 0; alpha <= 1; alpha++) {
+            SkPaint paint;
+            paint.setAlpha(alpha ? 0x80 : 0xFF);
+
+            SkBitmap single, batch;
+            skiatest::MakeBitmap(&single, kSize, kSize);
+            skiatest::MakeBitmap(&batch, kSize, kSize);
+            SkCanvas singleCanvas(single), batchCanvas(batch);
+            setup_canvas(&singleCanvas, SkToBool(layer));
+            setup_canvas(&batchCanvas, SkToBool(layer));
+
+            for (size_t i = 0; i < SK_ARRAY_COUNT(pts); i++) {
+                singleCanvas.drawSprite(sprite, pts[i].fX, pts[i].fY, &paint);
+            }
+            batchCanvas.drawSprites(sprite, pts, SK_ARRAY_COUNT(pts), &paint);
+            singleCanvas.restoreToCount(1);
+            batchCanvas.restoreToCount(1);
+
+            REPORTER_ASSERT(reporter, skiatest::SamePixels(single, batch));
+        }
+    }
+}
+
+static void TestDrawBatch(skiatest::Reporter* reporter) {
+    test_rects(reporter);
+    test_sprites(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DrawBatch", DrawBatchTestClass, TestDrawBatch)
@@ -15,10 +15,18 @@
  */
 
 #include "Test.h"
+#include "TestBitmap.h"
 #include "SkRegion.h"
 #include "SkPath.h"
 #include "SkScan.h"
 #include "SkBlitter.h"
+#include "SkEdge.h"
+#include "SkEdgeBuilder.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
 
 namespace {
 
@@ -56,5 +64,285 @@ static void TestFillPathInverse(skiatest::Reporter* reporter) {
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
 
+// With tiling turned on, a large antialiased fill goes through the tiled
+// supersampler, while each of its (disjoint, medium sized) pieces drawn alone
+// goes through the RLE one. Since the pieces never share a pixel, both must
+// agree exactly.
+static void TestAntiFillPathTiled(skiatest::Reporter* reporter) {
+  const int cell = 200;
+  const int size = 3 * cell;
+  SkRandom rand;
+  SkPath all, pieces[9];
+
+  for (int i = 0; i < 9; i++) {
+    SkScalar x = SkIntToScalar((i % 3) * cell + 10);
+    SkScalar y = SkIntToScalar((i / 3) * cell + 10);
+    SkPath& piece = pieces[i];
+    if (i & 1) {
+      // big enough to have fully covered 32x32 tiles
+      piece.addCircle(x + 90, y + 90, SkIntToScalar(85) + SK_Scalar1/2);
+    } else {
+      piece.moveTo(x, y);
+      for (int j = 0; j < 30; j++) {
+        piece.lineTo(x + SkScalarMul(rand.nextUScalar1(), SkIntToScalar(180)),
+                     y + SkScalarMul(rand.nextUScalar1(), SkIntToScalar(180)));
+      }
+      piece.close();
+    }
+    all.addPath(piece);
+  }
+
+  SkBitmap tiled, rle;
+  skiatest::MakeBitmap(&tiled, size, size);
+  skiatest::MakeBitmap(&rle, size, size);
+
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  bool useTiled = SkScan::SetUseTiledAA(true);
+  SkCanvas(tiled).drawPath(all, paint);
+  SkCanvas canvas(rle);
+  for (int i = 0; i < 9; i++) {
+    canvas.drawPath(pieces[i], paint);
+  }
+  SkScan::SetUseTiledAA(useTiled);
+
+  REPORTER_ASSERT(reporter, skiatest::SamePixels(tiled, rle));
+}
+
+extern "C" {
+  static int compare_edges(const void* a, const void* b) {
+    const SkEdge* edgea = *(const SkEdge**)a;
+    const SkEdge* edgeb = *(const SkEdge**)b;
+    if (edgea->fFirstY != edgeb->fFirstY) {
+      return edgea->fFirstY < edgeb->fFirstY ? -1 : 1;
+    }
+    if (edgea->fX != edgeb->fX) {
+      return edgea->fX < edgeb->fX ? -1 : 1;
+    }
+    if (edgea->fDX != edgeb->fDX) {
+      return edgea->fDX < edgeb->fDX ? -1 : 1;
+    }
+    return edgea->fLastY - edgeb->fLastY;
+  }
+}
+
+static bool same_edge(const SkEdge* a, const SkEdge* b) {
+  if (a->fX != b->fX || a->fDX != b->fDX || a->fFirstY != b->fFirstY ||
+      a->fLastY != b->fLastY || a->fWinding != b->fWinding ||
+      a->fCurveCount != b->fCurveCount) {
+    return false;
+  }
+  if (a->fCurveCount > 0) {
+    const SkQuadraticEdge* qa = (const SkQuadraticEdge*)a;
+    const SkQuadraticEdge* qb = (const SkQuadraticEdge*)b;
+    return qa->fQx == qb->fQx && qa->fQy == qb->fQy &&
+           qa->fQDx == qb->fQDx && qa->fQDy == qb->fQDy &&
+           qa->fQLastX == qb->fQLastX && qa->fQLastY == qb->fQLastY;
+  }
+  return true;
+}
+
+// Filling the same path twice caches its sorted edges, which must then be
+// reused (offset) for a translated copy, matching freshly built edges.
+static void TestEdgeCache(skiatest::Reporter* reporter) {
+  SkRandom rand;
+  SkPath path;
+  path.moveTo(SkIntToScalar(20), SkIntToScalar(20));
+  for (int i = 0; i < 40; i++) {
+    SkScalar x = SkIntToScalar(rand.nextU() % 200) + SK_Scalar1 / 8;
+    SkScalar y = SkIntToScalar(rand.nextU() % 200) + SK_Scalar1 / 2;
+    if (i & 1) {
+      path.quadTo(x, y, y, x);
+    } else {
+      path.lineTo(x, y);
+    }
+  }
+  path.close();
+
+  SkPath moved;
+  path.offset(SkIntToScalar(37), SkIntToScalar(-11), &moved);
+
+  for (int shift = 0; shift <= 2; shift += 2) {
+    for (int i = 0; i < 2; i++) {
+      SkEdgeBuilder builder;
+      int count = builder.buildCached(path, shift);
+      if (!builder.isSorted()) {
+        qsort(builder.edgeList(), count, sizeof(SkEdge*), compare_edges);
+        builder.cacheSortedEdges();
+      }
+    }
+
+    SkEdgeBuilder cached, fresh;
+    int count = cached.buildCached(moved, shift);
+    REPORTER_ASSERT(reporter, cached.isSorted());
+    REPORTER_ASSERT(reporter, fresh.build(moved, NULL, shift) == count);
+
+    SkEdge** list = fresh.edgeList();
+    qsort(list, count, sizeof(SkEdge*), compare_edges);
+    for (int i = 0; i < count; i++) {
+      REPORTER_ASSERT(reporter, same_edge(cached.edgeList()[i], list[i]));
+    }
+  }
+}
+
+// Filling a large path as concurrent bands of rows must match a serial fill,
+// with and without antialiasing, and whether or not the clip cuts the path.
+static void TestFillPathBanded(skiatest::Reporter* reporter) {
+  const int size = 400;
+  SkRandom rand;
+  SkPath path;
+  path.moveTo(SkIntToScalar(size / 2), 0);
+  for (int i = 0; i < 300; i++) {
+    SkScalar x = SkScalarMul(rand.nextUScalar1(), SkIntToScalar(size));
+    SkScalar y = SkScalarMul(rand.nextUScalar1(), SkIntToScalar(size));
+    if (i % 3) {
+      path.lineTo(x, y);
+    } else {
+      path.quadTo(y, x, x, y);
+    }
+  }
+  path.close();
+
+  for (int aa = 0; aa <= 1; aa++) {
+    for (int clip = 0; clip <= 1; clip++) {
+      SkPaint paint;
+      paint.setAntiAlias(SkToBool(aa));
+      paint.setColor(0xFF336699);
+
+      SkBitmap serial, banded;
+      skiatest::MakeBitmap(&serial, size, size);
+      skiatest::MakeBitmap(&banded, size, size);
+      SkCanvas serialCanvas(serial), bandedCanvas(banded);
+      if (clip) {
+        SkRect r;
+        r.set(SkIntToScalar(30), SkIntToScalar(41), SkIntToScalar(350),
+              SkIntToScalar(387));
+        serialCanvas.clipRect(r);
+        bandedCanvas.clipRect(r);
+      }
+
+      serialCanvas.drawPath(path, paint);
+      SkGraphics::SetFillPathThreadCount(4);
+      bandedCanvas.drawPath(path, paint);
+      SkGraphics::SetFillPathThreadCount(1);
+
+      REPORTER_ASSERT(reporter, skiatest::SamePixels(serial, banded));
+    }
+  }
+}
+
+// Returns true if filling a and b draws the same pixels
+static bool fills_match(const SkPath& a, const SkPath& b, int size, bool aa,
+                        bool clip) {
+  SkPaint paint;
+  paint.setAntiAlias(aa);
+
+  SkBitmap bmA, bmB;
+  skiatest::MakeBitmap(&bmA, size, size);
+  skiatest::MakeBitmap(&bmB, size, size);
+  SkCanvas canvasA(bmA), canvasB(bmB);
+  if (clip) {
+    SkRect cr;
+    cr.set(SkIntToScalar(25), SkIntToScalar(15), SkIntToScalar(95),
+           SkIntToScalar(80));
+    canvasA.clipRect(cr);
+    canvasB.clipRect(cr);
+  }
+  canvasA.drawPath(a, paint);
+  canvasB.drawPath(b, paint);
+
+  return skiatest::SamePixels(bmA, bmB);
+}
+
+// Convex paths are filled by a walker that steps just two edges; they must
+// draw exactly what the general walker does when the path is marked concave.
+static void TestFillPathConvex(skiatest::Reporter* reporter) {
+  const int size = 120;
+  SkPath paths[4];
+  SkRect r;
+  r.set(SkIntToScalar(10) + SK_Scalar1/3, SkIntToScalar(7),
+        SkIntToScalar(101), SkIntToScalar(90) + SK_Scalar1/4);
+  paths[0].addRect(r);
+  paths[1].addOval(r);
+  paths[2].addRoundRect(r, SkIntToScalar(20), SkIntToScalar(12));
+  paths[3].moveTo(SkIntToScalar(60), SkIntToScalar(3));
+  paths[3].lineTo(SkIntToScalar(110), SkIntToScalar(50) + SK_Scalar1/2);
+  paths[3].cubicTo(SkIntToScalar(100), SkIntToScalar(90),
+                   SkIntToScalar(40), SkIntToScalar(115),
+                   SkIntToScalar(20), SkIntToScalar(70));
+  paths[3].close();
+
+  for (int i = 0; i < 4; i++) {
+    SkPath concave(paths[i]);
+    concave.setConvexity(SkPath::kConcave_Convexity);
+    REPORTER_ASSERT(reporter, paths[i].isConvex());
+
+    for (int aa = 0; aa <= 1; aa++) {
+      for (int clip = 0; clip <= 1; clip++) {
+        REPORTER_ASSERT(reporter, fills_match(paths[i], concave, size,
+                                              SkToBool(aa), SkToBool(clip)));
+      }
+    }
+  }
+}
+
+// A caller may wrongly mark a concave path as convex; it must still draw
+// what it would without the hint.
+static void TestFillPathWrongConvexHint(skiatest::Reporter* reporter) {
+  const int size = 120;
+  SkPath paths[4];
+  SkRect r;
+  // a star, which crosses itself
+  paths[0].moveTo(SkIntToScalar(60), SkIntToScalar(5));
+  paths[0].lineTo(SkIntToScalar(95), SkIntToScalar(110));
+  paths[0].lineTo(SkIntToScalar(5), SkIntToScalar(40));
+  paths[0].lineTo(SkIntToScalar(115), SkIntToScalar(40));
+  paths[0].lineTo(SkIntToScalar(25), SkIntToScalar(110));
+  paths[0].close();
+  // an L, whose notch starts a third edge
+  paths[1].moveTo(SkIntToScalar(10), SkIntToScalar(10));
+  paths[1].lineTo(SkIntToScalar(40), SkIntToScalar(10));
+  paths[1].lineTo(SkIntToScalar(40), SkIntToScalar(60) + SK_Scalar1/2);
+  paths[1].lineTo(SkIntToScalar(100), SkIntToScalar(60) + SK_Scalar1/2);
+  paths[1].quadTo(SkIntToScalar(110), SkIntToScalar(90),
+                  SkIntToScalar(100), SkIntToScalar(100));
+  paths[1].lineTo(SkIntToScalar(10), SkIntToScalar(100));
+  paths[1].close();
+  // two shapes, one below the other
+  r.set(SkIntToScalar(20), SkIntToScalar(10), SkIntToScalar(90),
+        SkIntToScalar(40));
+  paths[2].addRect(r);
+  r.offset(SkIntToScalar(10), SkIntToScalar(50));
+  paths[2].addOval(r);
+  // a ring
+  r.set(SkIntToScalar(10), SkIntToScalar(10), SkIntToScalar(110),
+        SkIntToScalar(100));
+  paths[3].addOval(r);
+  r.inset(SkIntToScalar(30), SkIntToScalar(25));
+  paths[3].addOval(r, SkPath::kCCW_Direction);
+
+  for (int i = 0; i < 4; i++) {
+    SkPath convex(paths[i]);
+    convex.setConvexity(SkPath::kConvex_Convexity);
+    REPORTER_ASSERT(reporter, !paths[i].isConvex());
+
+    for (int aa = 0; aa <= 1; aa++) {
+      for (int clip = 0; clip <= 1; clip++) {
+        REPORTER_ASSERT(reporter, fills_match(paths[i], convex, size,
+                                              SkToBool(aa), SkToBool(clip)));
+      }
+    }
+  }
+}
+
+static void TestFillPath(skiatest::Reporter* reporter) {
+  TestFillPathInverse(reporter);
+  TestAntiFillPathTiled(reporter);
+  TestEdgeCache(reporter);
+  TestFillPathBanded(reporter);
+  TestFillPathConvex(reporter);
+  TestFillPathWrongConvexHint(reporter);
+}
+
 #include "TestClassDef.h"
-DEFINE_TESTCLASS("FillPath", FillPathTestClass, TestFillPathInverse)
+DEFINE_TESTCLASS("FillPath", FillPathTestClass, TestFillPath)
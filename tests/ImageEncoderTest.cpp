@@ -0,0 +1,95 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+
+// smooth enough to compress, noisy enough that the filters disagree
+static void make_bitmap(SkBitmap* bm, SkBitmap::Config config, int width,
+                        int height) {
+    SkBitmap src;
+    src.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+    src.allocPixels();
+    SkRandom rand;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned a = 0x80 + (x & 0x7F);
+            unsigned r = (x * 255 / width) & rand.nextU();
+            *src.getAddr32(x, y) = SkPackARGB32(a, SkMin32(r, a),
+                                                SkMin32(y & 0xFF, a), a >> 1);
+        }
+    }
+    src.copyTo(bm, config);
+}
+
+static size_t encode(SkImageEncoder::Type type, const SkBitmap& bm,
+                     int threadCount, SkDynamicMemoryWStream* stream) {
+    SkImageEncoder* encoder = SkImageEncoder::Create(type);
+    encoder->setThreadCount(threadCount);
+    bool success = encoder->encodeStream(stream, bm, 90);
+    delete encoder;
+    return success ? stream->getOffset() : 0;
+}
+
+static bool decode(const SkDynamicMemoryWStream& stream, SkBitmap* bm) {
+    SkAutoMalloc storage(stream.getOffset());
+    stream.copyTo(storage.get());
+    return SkImageDecoder::DecodeMemory(storage.get(), stream.getOffset(), bm,
+                                        SkBitmap::kARGB_8888_Config,
+                                        SkImageDecoder::kDecodePixels_Mode);
+}
+
+static void test_encode(skiatest::Reporter* reporter,
+                        SkImageEncoder::Type type, SkBitmap::Config config,
+                        int width, int height) {
+    SkBitmap bm;
+    make_bitmap(&bm, config, width, height);
+
+    SkDynamicMemoryWStream serialStream;
+    size_t serialSize = encode(type, bm, 1, &serialStream);
+    SkBitmap serial;
+    REPORTER_ASSERT(reporter, serialSize > 0);
+    REPORTER_ASSERT(reporter, decode(serialStream, &serial));
+
+    // banding may only cost a little size, and never the pixels
+    static const int gThreadCounts[] = { 2, 3, 8 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gThreadCounts); i++) {
+        SkDynamicMemoryWStream stream;
+        size_t size = encode(type, bm, gThreadCounts[i], &stream);
+        REPORTER_ASSERT(reporter, size > 0);
+        REPORTER_ASSERT(reporter, size <= serialSize + serialSize / 20 + 64);
+
+        SkBitmap parallel;
+        REPORTER_ASSERT(reporter, decode(stream, &parallel));
+        REPORTER_ASSERT(reporter, skiatest::SamePixels(serial, parallel));
+    }
+}
+
+static void test_type(skiatest::Reporter* reporter,
+                      SkImageEncoder::Type type) {
+    SkImageEncoder* encoder = SkImageEncoder::Create(type);
+    if (NULL == encoder) {
+        return;     // not built into this configuration
+    }
+    REPORTER_ASSERT(reporter, 1 == encoder->getThreadCount());
+    encoder->setThreadCount(0);
+    REPORTER_ASSERT(reporter, 1 == encoder->getThreadCount());
+    delete encoder;
+
+    test_encode(reporter, type, SkBitmap::kARGB_8888_Config, 150, 200);
+    test_encode(reporter, type, SkBitmap::kRGB_565_Config, 97, 131);
+    test_encode(reporter, type, SkBitmap::kARGB_4444_Config, 64, 100);
+    // too short to split
+    test_encode(reporter, type, SkBitmap::kARGB_8888_Config, 300, 40);
+}
+
+static void TestImageEncoder(skiatest::Reporter* reporter) {
+    test_type(reporter, SkImageEncoder::kPNG_Type);
+    test_type(reporter, SkImageEncoder::kJPEG_Type);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageEncoder", ImageEncoderTestClass, TestImageEncoder)
@@ -0,0 +1,205 @@
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkLayerRasterizer.h"
+#include "SkPath.h"
+#include "SkXfermode.h"
+
+struct LayerRec {
+    SkScalar    fDX, fDY;
+    uint8_t     fAlpha;
+    SkScalar    fStrokeWidth;   // < 0 to fill
+    int         fFilter;        // index into Filters::fFilters: 0 none, 1 blur, 2 emboss
+    bool        fSrcMode;       // draw with kSrc_Mode, clearing what's below
+};
+
+// A blur that counts the masks it renders, so we can tell whether the layers
+// using it shared one.
+class CountingBlurFilter : public SkMaskFilter {
+public:
+    CountingBlurFilter() : fCount(0) {
+        fBlur = SkBlurMaskFilter::Create(SkIntToScalar(2),
+                                         SkBlurMaskFilter::kNormal_BlurStyle);
+    }
+    virtual ~CountingBlurFilter() {
+        fBlur->unref();
+    }
+
+    virtual SkMask::Format getFormat() {
+        return fBlur->getFormat();
+    }
+    virtual bool filterMask(SkMask* dst, const SkMask& src,
+                            const SkMatrix& matrix, SkIPoint* margin) {
+        if (src.fImage) {
+            fCount += 1;
+        }
+        return fBlur->filterMask(dst, src, matrix, margin);
+    }
+    virtual Factory getFactory() {
+        return NULL;
+    }
+
+    int fCount;
+
+private:
+    SkMaskFilter* fBlur;
+};
+
+// every layer with the same fFilter shares one instance, as a caller
+// building a layered effect would
+struct Filters {
+    Filters() {
+        static const SkScalar gDirection[] = { SK_Scalar1, SK_Scalar1, SK_Scalar1 };
+        fBlur = new CountingBlurFilter;
+        fFilters[0] = NULL;
+        fFilters[1] = fBlur;
+        fFilters[2] = SkBlurMaskFilter::CreateEmboss(gDirection, SK_Scalar1 / 2,
+                                                     SkIntToScalar(8), SK_Scalar1);
+    }
+    ~Filters() {
+        fFilters[1]->unref();
+        fFilters[2]->unref();
+    }
+
+    CountingBlurFilter* fBlur;
+    SkMaskFilter*       fFilters[3];
+};
+
+static void make_paint(SkPaint* paint, const LayerRec& rec, const Filters& filters) {
+    paint->setAntiAlias(true);
+    paint->setAlpha(rec.fAlpha);
+    if (rec.fStrokeWidth >= 0) {
+        paint->setStyle(SkPaint::kStroke_Style);
+        paint->setStrokeWidth(rec.fStrokeWidth);
+    }
+    paint->setMaskFilter(filters.fFilters[rec.fFilter]);
+    if (rec.fSrcMode) {
+        paint->setXfermodeMode(SkXfermode::kSrc_Mode);
+    }
+}
+
+// each layer drawn by itself into the rasterizer's bounds, the way the
+// rasterizer used to
+static void draw_layers(const LayerRec recs[], int count, const Filters& filters,
+                        const SkPath& path, const SkMatrix& matrix,
+                        const SkMask& mask, SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kA8_Config, mask.fBounds.width(),
+                  mask.fBounds.height());
+    bm->allocPixels();
+    bm->eraseColor(0);
+    SkCanvas canvas(*bm);
+    for (int i = 0; i < count; i++) {
+        SkPaint paint;
+        make_paint(&paint, recs[i], filters);
+        SkMatrix m = matrix;
+        m.postTranslate(-SkIntToScalar(mask.fBounds.fLeft),
+                        -SkIntToScalar(mask.fBounds.fTop));
+        m.preTranslate(recs[i].fDX, recs[i].fDY);
+        canvas.setMatrix(m);
+        canvas.drawPath(path, paint);
+    }
+}
+
+// blurCount is how many blurred masks the rasterizer should render: one per
+// group of blurred layers that can share one
+static void test_layers(skiatest::Reporter* reporter, const LayerRec recs[],
+                        int count, const SkMatrix& matrix, int blurCount) {
+    SkPath path;
+    path.addCircle(SkIntToScalar(20), SkIntToScalar(20), SkIntToScalar(12));
+    path.addRect(SkIntToScalar(4), SkIntToScalar(10), SkIntToScalar(30),
+                 SkIntToScalar(16));
+
+    Filters filters;
+    SkLayerRasterizer* rast = new SkLayerRasterizer;
+    for (int i = 0; i < count; i++) {
+        SkPaint paint;
+        make_paint(&paint, recs[i], filters);
+        rast->addLayer(paint, recs[i].fDX, recs[i].fDY);
+    }
+
+    SkMask bounds, mask;
+    REPORTER_ASSERT(reporter, rast->rasterize(path, matrix, NULL, NULL, &bounds,
+                                    SkMask::kJustComputeBounds_CreateMode));
+    REPORTER_ASSERT(reporter, 0 == filters.fBlur->fCount);
+    REPORTER_ASSERT(reporter, rast->rasterize(path, matrix, NULL, NULL, &mask,
+                                    SkMask::kComputeBoundsAndRenderImage_CreateMode));
+    rast->unref();
+    REPORTER_ASSERT(reporter, bounds.fBounds == mask.fBounds);
+    REPORTER_ASSERT(reporter, blurCount == filters.fBlur->fCount);
+
+    SkBitmap bm;
+    draw_layers(recs, count, filters, path, matrix, mask, &bm);
+    SkAutoLockPixels alp(bm);
+
+    // sharing coverage between layers must not change a single pixel
+    bool same = true;
+    bool drewSomething = false;
+    for (int y = 0; y < mask.fBounds.height(); y++) {
+        const uint8_t* row = mask.fImage + y * mask.fRowBytes;
+        for (int x = 0; x < mask.fBounds.width(); x++) {
+            same &= row[x] == *bm.getAddr8(x, y);
+            drewSomething |= row[x] != 0;
+        }
+    }
+    REPORTER_ASSERT(reporter, drewSomething);
+    REPORTER_ASSERT(reporter, same);
+    SkMask::FreeImage(mask.fImage);
+}
+
+static void TestLayerRasterizer(skiatest::Reporter* reporter) {
+    const SkScalar n1 = -SK_Scalar1;
+    const SkScalar half = SK_Scalar1 / 2;
+
+    // shadow, body and outline, differing only in offset and alpha
+    static const LayerRec gShadow[] = {
+        { SkIntToScalar(2), SkIntToScalar(2), 0x60, n1, 0 },
+        { 0, 0, 0xFF, n1, 0 },
+        { -SK_Scalar1, -SK_Scalar1, 0x40, n1, 0 },
+        { 0, 0, 0x80, SkIntToScalar(2), 0 },
+        { SkIntToScalar(3), 0, 0xC0, SkIntToScalar(2), 0 },
+    };
+    // filtered layers, one of them invisible. The blurred ones share one
+    // blur, except where the matrix doesn't map -3 to whole pixels.
+    static const LayerRec gFiltered[] = {
+        { SkIntToScalar(3), SkIntToScalar(3), 0x80, n1, 1 },
+        { 0, 0, 0xFF, n1, 2 },
+        { SkIntToScalar(-3), SkIntToScalar(-3), 0x80, n1, 1 },
+        { 0, 0, 0, n1, 0 },
+        { SkIntToScalar(3), SkIntToScalar(3), 0x40, n1, 1 },
+    };
+    static const int gFilteredBlurCounts[] = { 1, 1, 2 };
+    // layers that have to be drawn one at a time, between shared ones
+    static const LayerRec gMixed[] = {
+        { 0, 0, 0x80, n1, 0 },
+        { half, half, 0xFF, 0, 0 },
+        { SkIntToScalar(5), 0, 0x80, n1, 0 },
+        { half, 0, 0xA0, n1, 0 },
+        { 0, SkIntToScalar(5), 0x80, n1, 0 },
+        { 0, 0, 0xFF, half / 2, 0 },
+    };
+    // an invisible layer still clears what's below it with kSrc_Mode
+    static const LayerRec gCleared[] = {
+        { 0, 0, 0xFF, n1, 0 },
+        { SkIntToScalar(2), SkIntToScalar(2), 0x80, n1, 0 },
+        { SkIntToScalar(4), SkIntToScalar(4), 0, n1, 0, true },
+        { SkIntToScalar(6), SkIntToScalar(6), 0x60, n1, 0 },
+    };
+
+    SkMatrix matrices[3];
+    matrices[0].reset();
+    matrices[1].setScale(SkIntToScalar(2), SkIntToScalar(2));
+    matrices[1].postTranslate(SkIntToScalar(7), SkIntToScalar(-3));
+    matrices[2].setRotate(SkIntToScalar(30));
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); i++) {
+        test_layers(reporter, gShadow, SK_ARRAY_COUNT(gShadow), matrices[i], 0);
+        test_layers(reporter, gFiltered, SK_ARRAY_COUNT(gFiltered), matrices[i],
+                    gFilteredBlurCounts[i]);
+        test_layers(reporter, gMixed, SK_ARRAY_COUNT(gMixed), matrices[i], 0);
+        test_layers(reporter, gCleared, SK_ARRAY_COUNT(gCleared), matrices[i], 0);
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("LayerRasterizer", LayerRasterizerTestClass, TestLayerRasterizer)
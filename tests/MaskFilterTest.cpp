@@ -0,0 +1,283 @@
+#include "Test.h"
+#include "SkColorPriv.h"
+#include "SkEmbossMask.h"
+#include "SkEmbossMask_Table.h"
+#include "SkKernel33MaskFilter.h"
+#include "SkMaskFilterProcs.h"
+#include "SkMatrix.h"
+#include "SkRandom.h"
+#include "SkTableMaskFilter.h"
+
+static const int gKernel[3][3] = {
+    { -1, -2, -1 }, { -2, 28, -2 }, { -1, -2, -1 }
+};
+static const int gShift = 4;
+
+// mostly empty, like a glyph, with some edges and some solid
+static void make_mask(SkMask* mask, int width, int height) {
+    mask->fBounds.set(3, 5, 3 + width, 5 + height);
+    mask->fRowBytes = width + 3;
+    mask->fFormat = SkMask::kA8_Format;
+    mask->fImage = SkMask::AllocImage(mask->computeImageSize());
+
+    SkRandom rand;
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = mask->fImage + y * mask->fRowBytes;
+        for (int x = 0; x < (int)mask->fRowBytes; x++) {
+            unsigned r = rand.nextU();
+            row[x] = (r & 3) ? 0 : ((r & 4) ? 0xFF : (r >> 24));
+        }
+    }
+}
+
+// the kernel applied a pixel at a time, treating pixels outside as 0
+static int kernel_value(const SkMask& src, int x, int y) {
+    int value = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            int sx = x + j - 1;
+            int sy = y + i - 1;
+            if ((unsigned)sx < (unsigned)src.fBounds.width() &&
+                    (unsigned)sy < (unsigned)src.fBounds.height()) {
+                value += gKernel[i][j] * src.fImage[sy * src.fRowBytes + sx];
+            }
+        }
+    }
+    return SkPin32(value >> gShift, 0, 255);
+}
+
+static int center_value(const SkMask& src, int x, int y) {
+    if ((unsigned)x < (unsigned)src.fBounds.width() &&
+            (unsigned)y < (unsigned)src.fBounds.height()) {
+        return src.fImage[y * src.fRowBytes + x];
+    }
+    return 0;
+}
+
+// only implements computeValue, so it is filtered by the default computeRow
+class KernelValueMaskFilter : public SkKernel33ProcMaskFilter {
+public:
+    KernelValueMaskFilter(int percent256) : INHERITED(percent256) {}
+
+    virtual uint8_t computeValue(uint8_t* const* srcRows) {
+        int value = 0;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                value += gKernel[i][j] * srcRows[i][j];
+            }
+        }
+        return SkPin32(value >> gShift, 0, 255);
+    }
+
+    virtual Factory getFactory() { return NULL; }
+
+private:
+    typedef SkKernel33ProcMaskFilter INHERITED;
+};
+
+static void test_kernel(skiatest::Reporter* reporter, SkMaskFilter* filter,
+                        const SkMask& src, int percent256) {
+    SkMask dst;
+    SkMatrix matrix;
+    matrix.reset();
+    REPORTER_ASSERT(reporter, filter->filterMask(&dst, src, matrix, NULL));
+    SkAutoMaskImage ami(&dst, false);
+
+    REPORTER_ASSERT(reporter, SkMask::kA8_Format == dst.fFormat);
+    REPORTER_ASSERT(reporter, dst.fBounds.width() == src.fBounds.width() + 2);
+    REPORTER_ASSERT(reporter, dst.fBounds.height() == src.fBounds.height() + 2);
+    REPORTER_ASSERT(reporter, SkAlign4(dst.fRowBytes) == dst.fRowBytes);
+
+    bool same = true;
+    for (int y = 0; y < dst.fBounds.height(); y++) {
+        const uint8_t* row = dst.fImage + y * dst.fRowBytes;
+        for (int x = 0; x < dst.fBounds.width(); x++) {
+            int value = kernel_value(src, x - 1, y - 1);
+            if (percent256 < 256) {
+                value = SkAlphaBlend(value, center_value(src, x - 1, y - 1),
+                                     percent256);
+            }
+            same &= (row[x] == value);
+        }
+        // the padding is cleared
+        for (int x = dst.fBounds.width(); x < (int)dst.fRowBytes; x++) {
+            same &= (0 == row[x]);
+        }
+    }
+    REPORTER_ASSERT(reporter, same);
+}
+
+static void test_kernel33(skiatest::Reporter* reporter) {
+    static const int gSizes[][2] = {
+        { 1, 1 }, { 2, 3 }, { 7, 5 }, { 8, 8 }, { 9, 2 }, { 37, 29 }
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSizes); i++) {
+        SkMask src;
+        make_mask(&src, gSizes[i][0], gSizes[i][1]);
+        SkAutoMaskImage ami(&src, false);
+
+        for (int percent256 = 256; percent256 > 0; percent256 -= 128) {
+            SkKernel33MaskFilter kernel(gKernel, gShift, percent256);
+            KernelValueMaskFilter values(percent256);
+            for (int usePlatform = 0; usePlatform <= 1; usePlatform++) {
+                SkMaskFilterProcs::SetUsePlatformProcs(SkToBool(usePlatform));
+                test_kernel(reporter, &kernel, src, percent256);
+            }
+            test_kernel(reporter, &values, src, percent256);
+        }
+    }
+    SkMaskFilterProcs::SetUsePlatformProcs(true);
+}
+
+static void test_table(skiatest::Reporter* reporter) {
+    SkMask src;
+    make_mask(&src, 37, 11);
+    SkAutoMaskImage ami(&src, false);
+
+    uint8_t tables[3][256];
+    SkTableMaskFilter::MakeGammaTable(tables[0], SkFloatToScalar(0.5f));
+    SkTableMaskFilter::MakeClipTable(tables[1], 10, 200);
+    for (int i = 0; i < 256; i++) {
+        tables[2][i] = 255 - i;     // doesn't leave 0 alone
+    }
+
+    for (int t = 0; t < 3; t++) {
+        SkTableMaskFilter filter(tables[t]);
+        SkMask dst;
+        SkMatrix matrix;
+        matrix.reset();
+        REPORTER_ASSERT(reporter, filter.filterMask(&dst, src, matrix, NULL));
+        SkAutoMaskImage ami2(&dst, false);
+
+        bool same = true;
+        for (int y = 0; y < dst.fBounds.height(); y++) {
+            const uint8_t* srcRow = src.fImage + y * src.fRowBytes;
+            const uint8_t* dstRow = dst.fImage + y * dst.fRowBytes;
+            for (int x = 0; x < dst.fBounds.width(); x++) {
+                same &= (dstRow[x] == tables[t][srcRow[x]]);
+            }
+        }
+        REPORTER_ASSERT(reporter, same);
+    }
+}
+
+static unsigned emboss_div255(unsigned x) {
+    return x * ((1 << 24) / 255) >> 24;
+}
+
+// SkEmbossMask::Emboss as it was, lighting a pixel at a time and checking
+// for the mask's edges at every one
+static void emboss_reference(SkMask* mask, const SkEmbossMaskFilter::Light& light) {
+    const int kDelta = kDeltaUsedToBuildTable;
+
+    int     specular = light.fSpecular;
+    int     ambient = light.fAmbient;
+    SkFixed lx = SkScalarToFixed(light.fDirection[0]);
+    SkFixed ly = SkScalarToFixed(light.fDirection[1]);
+    SkFixed lz = SkScalarToFixed(light.fDirection[2]);
+    SkFixed lz_dot_nz = lz * kDelta;
+    int     lz_dot8 = lz >> 8;
+
+    size_t      planeSize = mask->computeImageSize();
+    uint8_t*    alpha = mask->fImage;
+    uint8_t*    multiply = alpha + planeSize;
+    uint8_t*    additive = multiply + planeSize;
+
+    int rowBytes = mask->fRowBytes;
+    int maxy = mask->fBounds.height() - 1;
+    int maxx = mask->fBounds.width() - 1;
+
+    int prev_row = 0;
+    for (int y = 0; y <= maxy; y++) {
+        int next_row = y != maxy ? rowBytes : 0;
+
+        for (int x = 0; x <= maxx; x++) {
+            if (alpha[x]) {
+                int nx = alpha[x + (x != maxx)] - alpha[x - (x != 0)];
+                int ny = alpha[x + next_row] - alpha[x - prev_row];
+
+                SkFixed numer = lx * nx + ly * ny + lz_dot_nz;
+                int     mul = ambient;
+                int     add = 0;
+
+                if (numer > 0) {
+                    SkFixed dot = (unsigned)(numer >> 4) * gInvSqrtTable[(SkAbs32(nx) >> 1 << 7) | (SkAbs32(ny) >> 1)] >> 20;
+                    mul = SkFastMin32(mul + dot, 255);
+
+                    int hilite = (2 * dot - lz_dot8) * lz_dot8 >> 8;
+                    if (hilite > 0) {
+                        hilite = SkClampMax(hilite, 255);
+                        add = hilite;
+                        for (int i = specular >> 4; i > 0; --i) {
+                            add = emboss_div255(add * hilite);
+                        }
+                    }
+                }
+                multiply[x] = SkToU8(mul);
+                additive[x] = SkToU8(add);
+            }
+        }
+        alpha += rowBytes;
+        multiply += rowBytes;
+        additive += rowBytes;
+        prev_row = rowBytes;
+    }
+}
+
+// a k3D mask holding make_mask's alpha, with its other planes set to a value
+// that shows which pixels were lit
+static void make_3d_mask(SkMask* mask, int width, int height) {
+    SkMask src;
+    make_mask(&src, width, height);
+    SkAutoMaskImage ami(&src, false);
+
+    *mask = src;
+    mask->fFormat = SkMask::k3D_Format;
+    size_t planeSize = mask->computeImageSize();
+    mask->fImage = SkMask::AllocImage(planeSize * 3);
+    memcpy(mask->fImage, src.fImage, planeSize);
+    memset(mask->fImage + planeSize, 0xAB, planeSize * 2);
+}
+
+static void test_emboss(skiatest::Reporter* reporter) {
+    static const int gSizes[][2] = {
+        { 1, 1 }, { 1, 6 }, { 2, 1 }, { 2, 5 }, { 3, 3 }, { 37, 29 }
+    };
+    // normalized directions, as SkEmbossMaskFilter keeps them
+    static const float gLights[][5] = {
+        // x, y, z, ambient, specular
+        { 0.6f, 0, 0.8f, 0x40, 0 },
+        { -0.48f, 0.6f, 0.64f, 0x80, 0x30 },
+        { 0.36f, -0.48f, 0.8f, 0x10, 0xF8 },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSizes); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gLights); j++) {
+            SkEmbossMaskFilter::Light light;
+            for (int k = 0; k < 3; k++) {
+                light.fDirection[k] = SkFloatToScalar(gLights[j][k]);
+            }
+            light.fAmbient = SkToU8((int)gLights[j][3]);
+            light.fSpecular = SkToU8((int)gLights[j][4]);
+
+            SkMask mask, expected;
+            make_3d_mask(&mask, gSizes[i][0], gSizes[i][1]);
+            make_3d_mask(&expected, gSizes[i][0], gSizes[i][1]);
+            SkAutoMaskImage ami0(&mask, false);
+            SkAutoMaskImage ami1(&expected, false);
+
+            SkEmbossMask::Emboss(&mask, light);
+            emboss_reference(&expected, light);
+            REPORTER_ASSERT(reporter, !memcmp(mask.fImage, expected.fImage,
+                                              mask.computeImageSize() * 3));
+        }
+    }
+}
+
+static void TestMaskFilter(skiatest::Reporter* reporter) {
+    test_kernel33(reporter);
+    test_table(reporter);
+    test_emboss(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("MaskFilter", MaskFilterTestClass, TestMaskFilter)
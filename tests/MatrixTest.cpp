@@ -1,5 +1,6 @@
 #include "Test.h"
 #include "SkMatrix.h"
+#include "SkRandom.h"
 
 static bool nearly_equal_scalar(SkScalar a, SkScalar b) {
     // Note that we get more compounded error for multiple operations when
@@ -48,6 +49,64 @@ static void test_flatten(skiatest::Reporter* reporter, const SkMatrix& m) {
     REPORTER_ASSERT(reporter, memcmp(buffer, buffer2, size1) == 0);
 }
 
+static bool nearly_equal_point(const SkPoint& a, const SkPoint& b) {
+    return SkScalarAbs(a.fX - b.fX) <= SK_Scalar1/256 &&
+           SkScalarAbs(a.fY - b.fY) <= SK_Scalar1/256;
+}
+
+// mapPoints (which may be vectorized, and may handle points in pairs) must
+// agree with mapping each point by itself, for every type of matrix, for odd
+// and even counts, and when mapping in place.
+static void test_map_points(skiatest::Reporter* reporter) {
+    SkMatrix matrices[7];
+    matrices[0].reset();
+    matrices[1].setTranslate(SkIntToScalar(7), -SK_Scalar1/3);
+    matrices[2].setScale(SkIntToScalar(3), -SK_Scalar1/5);
+    matrices[3].setScale(SK_Scalar1/2, SkIntToScalar(4));
+    matrices[3].postTranslate(-SkIntToScalar(11), SK_Scalar1/7);
+    matrices[4].setRotate(SkIntToScalar(30));
+    matrices[5].setRotate(-SkIntToScalar(75), SkIntToScalar(5),
+                          SkIntToScalar(9));
+    matrices[6] = matrices[5];
+    matrices[6].setPerspX(SK_Scalar1/1000);
+    matrices[6].setPerspY(-SK_Scalar1/700);
+
+    const SkScalar kRange = SkIntToScalar(100);
+    SkRandom rand;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); i++) {
+        const SkMatrix& m = matrices[i];
+        for (int count = 0; count <= 9; count++) {
+            SkPoint src[9], dst[9], inPlace[9];
+            for (int j = 0; j < count; j++) {
+                src[j].set(SkScalarMul(rand.nextSScalar1(), kRange),
+                           SkScalarMul(rand.nextSScalar1(), kRange));
+                inPlace[j] = src[j];
+            }
+            m.mapPoints(dst, src, count);
+            m.mapPoints(inPlace, count);
+            for (int j = 0; j < count; j++) {
+                SkPoint expected;
+                m.mapXY(src[j].fX, src[j].fY, &expected);
+                REPORTER_ASSERT(reporter, nearly_equal_point(dst[j], expected));
+                REPORTER_ASSERT(reporter, dst[j] == inPlace[j]);
+            }
+        }
+
+        SkVector vec[3], mapped[3];
+        vec[0].set(SkIntToScalar(10), 0);
+        vec[1].set(0, -SkIntToScalar(10));
+        vec[2].set(SkIntToScalar(3), SkIntToScalar(4));
+        m.mapVectors(mapped, vec, 3);
+        for (int j = 0; j < 3; j++) {
+            SkPoint origin, tip;
+            m.mapXY(0, 0, &origin);
+            m.mapXY(vec[j].fX, vec[j].fY, &tip);
+            REPORTER_ASSERT(reporter,
+                            nearly_equal_point(mapped[j], tip - origin));
+        }
+    }
+}
+
 void TestMatrix(skiatest::Reporter* reporter) {
     SkMatrix    mat, inverse, iden1, iden2;
 
@@ -117,6 +176,8 @@ void TestMatrix(skiatest::Reporter* reporter) {
                     m.rectStaysRect() == gRectStaysRectSamples[i].mStaysRect);
         }
     }
+
+    test_map_points(reporter);
 }
 
 #include "TestClassDef.h"
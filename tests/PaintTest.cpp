@@ -1,6 +1,9 @@
 #include "Test.h"
 #include "SkPath.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+#include "SkUtils.h"
 
 // found and fixed for webkit: mishandling when we hit recursion limit on
 // mostly degenerate cubic flatness test
@@ -36,8 +39,78 @@ static void regression_cubic(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, maxR.contains(strokeR));
 }
 
+// the bulk ascii/bmp paths must match looking up one character at a time
+static void test_text_encodings(skiatest::Reporter* reporter) {
+    static const SkUnichar gUni[] = { 0xE9, 0x4E2D, 0xFFFD, 0x1F600 };
+
+    SkRandom    rand;
+    char        utf8[400];
+    uint16_t    utf16[200];
+    size_t      length8 = 0;
+    int         length16 = 0;
+    int         count = 0;
+    while (length8 + kMaxBytesInUTF8Sequence <= sizeof(utf8) &&
+           length16 + 2 <= (int)SK_ARRAY_COUNT(utf16)) {
+        SkUnichar uni = (rand.nextU() % 11) ? ' ' + (rand.nextU() % 95) :
+                            gUni[rand.nextU() % SK_ARRAY_COUNT(gUni)];
+        length8 += SkUTF8_FromUnichar(uni, utf8 + length8);
+        length16 += SkUTF16_FromUnichar(uni, utf16 + length16);
+        count += 1;
+    }
+
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(14));
+    REPORTER_ASSERT(reporter, paint.textToGlyphs(utf8, length8, NULL) == count);
+
+    SkAutoTMalloc<uint16_t> storage(3 * count);
+    uint16_t* glyphs8 = storage.get();
+    uint16_t* glyphs16 = glyphs8 + count;
+    uint16_t* glyphs = glyphs16 + count;
+    REPORTER_ASSERT(reporter, paint.textToGlyphs(utf8, length8, glyphs8) == count);
+    const char* text = utf8;
+    for (int i = 0; i < count; i++) {
+        const char* start = text;
+        SkUTF8_NextUnichar(&text);
+        paint.textToGlyphs(start, text - start, &glyphs[i]);
+    }
+    REPORTER_ASSERT(reporter, !memcmp(glyphs8, glyphs, count * sizeof(uint16_t)));
+
+    paint.setTextEncoding(SkPaint::kUTF16_TextEncoding);
+    REPORTER_ASSERT(reporter,
+                    paint.textToGlyphs(utf16, length16 << 1, NULL) == count);
+    REPORTER_ASSERT(reporter,
+                    paint.textToGlyphs(utf16, length16 << 1, glyphs16) == count);
+    REPORTER_ASSERT(reporter, !memcmp(glyphs8, glyphs16, count * sizeof(uint16_t)));
+
+    // and every encoding measures the same
+    for (int kern = 0; kern <= 1; kern++) {
+        paint.setDevKernText(1 == kern);
+        SkRect bounds8, bounds16, bounds;
+        paint.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+        SkScalar width8 = paint.measureText(utf8, length8, &bounds8);
+        paint.setTextEncoding(SkPaint::kUTF16_TextEncoding);
+        SkScalar width16 = paint.measureText(utf16, length16 << 1, &bounds16);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        SkScalar width = paint.measureText(glyphs, count << 1, &bounds);
+        REPORTER_ASSERT(reporter, width8 == width && width16 == width);
+        REPORTER_ASSERT(reporter, bounds8 == bounds && bounds16 == bounds);
+        REPORTER_ASSERT(reporter, paint.measureText(glyphs, count << 1) == width);
+
+        // the same sum as measuring each glyph on its own
+        SkAutoTMalloc<SkScalar> widths(count);
+        REPORTER_ASSERT(reporter,
+                        paint.getTextWidths(glyphs, count << 1, widths.get()) == count);
+        SkScalar sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += widths.get()[i];
+        }
+        REPORTER_ASSERT(reporter, kern || SkScalarNearlyEqual(sum, width));
+    }
+}
+
 static void TestPaint(skiatest::Reporter* reporter) {
     // TODO add general paint tests
+    test_text_encodings(reporter);
 
     // regression tests
     regression_cubic(reporter);
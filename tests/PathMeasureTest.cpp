@@ -1,5 +1,61 @@
 #include "Test.h"
 #include "SkPathMeasure.h"
+#include "SkRandom.h"
+
+static void add_curvy_contour(SkPath* path, SkRandom* rand, int count) {
+    path->moveTo(rand->nextUScalar1() * 100, rand->nextUScalar1() * 100);
+    for (int i = 0; i < count; i++) {
+        SkScalar x = rand->nextUScalar1() * 100;
+        SkScalar y = rand->nextUScalar1() * 100;
+        if (i & 1) {
+            path->quadTo(y, x, x, y);
+        } else {
+            path->cubicTo(x, x, y, y, x + 10, y - 10);
+        }
+    }
+}
+
+static void collect_lengths(const SkPath& path, bool forceClosed,
+                            SkTDArray<SkScalar>* lengths) {
+    SkPathMeasure meas(path, forceClosed);
+    do {
+        *lengths->append() = meas.getLength();
+        SkPoint pos;
+        if (meas.getPosTan(meas.getLength() / 3, &pos, NULL)) {
+            *lengths->append() = pos.fX;
+            *lengths->append() = pos.fY;
+        }
+        *lengths->append() = SkIntToScalar(meas.isClosed());
+    } while (meas.nextContour());
+}
+
+// Measuring a path again reuses its flattened contours, which must match the
+// first measurement, and must not be reused once the path is edited.
+static void test_measure_cache(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkPath path;
+    for (int i = 0; i < 3; i++) {
+        add_curvy_contour(&path, &rand, 10);
+        path.lineTo(0, 0);
+    }
+
+    for (int forceClosed = 0; forceClosed <= 1; forceClosed++) {
+        SkTDArray<SkScalar> first, second;
+        collect_lengths(path, SkToBool(forceClosed), &first);
+        collect_lengths(path, SkToBool(forceClosed), &second);
+        REPORTER_ASSERT(reporter, first.count() == 3 * 4);
+        REPORTER_ASSERT(reporter, first == second);
+    }
+
+    // only the last contour changes
+    SkTDArray<SkScalar> before, after;
+    collect_lengths(path, false, &before);
+    path.setLastPt(SkIntToScalar(1000), SkIntToScalar(1000));
+    collect_lengths(path, false, &after);
+    REPORTER_ASSERT(reporter, !memcmp(before.begin(), after.begin(),
+                                      8 * sizeof(SkScalar)));
+    REPORTER_ASSERT(reporter, after[8] > before[8]);
+}
 
 static void TestPathMeasure(skiatest::Reporter* reporter) {
     SkPath  path;
@@ -36,6 +92,8 @@ static void TestPathMeasure(skiatest::Reporter* reporter) {
                  d, p.fX, p.fY, v.fX, v.fY);
 #endif
     }
+
+    test_measure_cache(reporter);
 }
 
 #include "TestClassDef.h"
@@ -170,6 +170,38 @@ static void test_convexity(skiatest::Reporter* reporter) {
     }
 }
 
+// The generation ID changes with every edit, but not when the path is copied.
+static void test_generation_id(skiatest::Reporter* reporter) {
+    SkPath p;
+    uint32_t id = p.getGenerationID();
+    REPORTER_ASSERT(reporter, id != 0);
+    REPORTER_ASSERT(reporter, p.getGenerationID() == id);
+
+    p.moveTo(0, 0);
+    REPORTER_ASSERT(reporter, p.getGenerationID() != id);
+    id = p.getGenerationID();
+
+    SkPath copy(p);
+    REPORTER_ASSERT(reporter, copy.getGenerationID() == id);
+    copy.lineTo(SK_Scalar1, SK_Scalar1);
+    REPORTER_ASSERT(reporter, copy.getGenerationID() != id);
+    REPORTER_ASSERT(reporter, p.getGenerationID() == id);
+
+    SkPath other;
+    REPORTER_ASSERT(reporter, other.getGenerationID() != id);
+    other = p;
+    REPORTER_ASSERT(reporter, other.getGenerationID() == id);
+
+    p.setLastPt(SK_Scalar1, 0);
+    REPORTER_ASSERT(reporter, p.getGenerationID() != id);
+    id = p.getGenerationID();
+    p.offset(SK_Scalar1, 0);
+    REPORTER_ASSERT(reporter, p.getGenerationID() != id);
+    id = p.getGenerationID();
+    p.reset();
+    REPORTER_ASSERT(reporter, p.getGenerationID() != id);
+}
+
 void TestPath(skiatest::Reporter* reporter);
 void TestPath(skiatest::Reporter* reporter) {
     {
@@ -242,6 +274,7 @@ void TestPath(skiatest::Reporter* reporter) {
 
     test_convexity(reporter);
     test_convexity2(reporter);
+    test_generation_id(reporter);
 }
 
 #include "TestClassDef.h"
@@ -0,0 +1,450 @@
+/*
+    Copyright 2011 Google Inc.
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+         http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCornerPathEffect.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkThread.h"
+
+static const int kSize = 64;
+
+static void record(SkPicture* pict, SkPicture* inner) {
+    SkRandom rand;
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, 8, 8);
+    bm.allocPixels();
+    bm.eraseColor(0xFF00FF00);
+
+    SkCanvas* canvas = pict->beginRecording(kSize, kSize);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 20; i++) {
+        SkPath path;
+        path.moveTo(rand.nextUScalar1() * kSize, rand.nextUScalar1() * kSize);
+        path.quadTo(rand.nextUScalar1() * kSize, rand.nextUScalar1() * kSize,
+                    rand.nextUScalar1() * kSize, rand.nextUScalar1() * kSize);
+        paint.setColor(rand.nextU() | 0xFF000000);
+        canvas->drawPath(path, paint);
+        canvas->save();
+        canvas->rotate(SkIntToScalar(i * 7));
+        canvas->drawBitmap(bm, SkIntToScalar(i), SkIntToScalar(i * 2), &paint);
+        canvas->restore();
+    }
+    canvas->clipRect(SkRect::MakeWH(SkIntToScalar(40), SkIntToScalar(50)));
+    canvas->drawPicture(*inner);
+    pict->endRecording();
+}
+
+static void record_inner(SkPicture* inner) {
+    SkCanvas* canvas = inner->beginRecording(kSize, kSize);
+    SkPaint paint;
+    paint.setColor(0x800000FF);
+    canvas->drawCircle(SkIntToScalar(30), SkIntToScalar(30),
+                       SkIntToScalar(25), paint);
+    inner->endRecording();
+}
+
+static bool draws_same(const SkBitmap& expected, SkPicture* pict) {
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, kSize, kSize);
+    SkCanvas(bm).drawPicture(*pict);
+    return skiatest::SamePixels(expected, bm);
+}
+
+namespace {
+
+struct DrawPictureRec {
+    SkPicture*  fPicture;
+    SkBitmap    fBitmaps[4];
+};
+
+}
+
+static void draw_picture_proc(void* context, int index) {
+    DrawPictureRec* rec = (DrawPictureRec*)context;
+    SkCanvas canvas(rec->fBitmaps[index]);
+    rec->fPicture->draw(&canvas);
+}
+
+// One picture, drawn on several threads at once, must draw what it draws
+// on one.
+static void test_concurrent_draw(skiatest::Reporter* reporter) {
+    SkPicture inner, pict;
+    record_inner(&inner);
+    record(&pict, &inner);
+
+    SkBitmap expected;
+    skiatest::MakeBitmap(&expected, kSize, kSize);
+    SkCanvas(expected).drawPicture(pict);
+
+    DrawPictureRec rec;
+    rec.fPicture = &pict;
+    for (int i = 0; i < 4; i++) {
+        skiatest::MakeBitmap(&rec.fBitmaps[i], kSize, kSize);
+    }
+    sk_parallel_for(draw_picture_proc, &rec, 4);
+
+    for (int i = 0; i < 4; i++) {
+        REPORTER_ASSERT(reporter,
+                        skiatest::SamePixels(expected, rec.fBitmaps[i]));
+    }
+}
+
+namespace {
+
+// aborts the picture it is drawing on its first drawRect
+class AbortCanvas : public SkCanvas {
+public:
+    AbortCanvas(const SkBitmap& bm, SkPicture* pict)
+        : SkCanvas(bm), fPicture(pict), fRectCount(0) {}
+
+    virtual void drawRect(const SkRect& r, const SkPaint& paint) {
+        if (0 == fRectCount++) {
+            fPicture->abortPlayback();
+        }
+        this->INHERITED::drawRect(r, paint);
+    }
+
+    SkPicture*  fPicture;
+    int         fRectCount;
+
+private:
+    typedef SkCanvas INHERITED;
+};
+
+}
+
+static void test_abort(skiatest::Reporter* reporter) {
+    SkPicture pict;
+    SkCanvas* canvas = pict.beginRecording(kSize, kSize);
+    SkPaint paint;
+    for (int i = 0; i < 3; i++) {
+        canvas->drawRect(SkRect::MakeWH(SkIntToScalar(i + 1),
+                                        SkIntToScalar(i + 1)), paint);
+    }
+    pict.endRecording();
+
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, kSize, kSize);
+    AbortCanvas abortCanvas(bm, &pict);
+    pict.draw(&abortCanvas);
+    REPORTER_ASSERT(reporter, 1 == abortCanvas.fRectCount);
+
+    // the abort is over, so the next draw plays everything
+    pict.draw(&abortCanvas);
+    REPORTER_ASSERT(reporter, 4 == abortCanvas.fRectCount);
+}
+
+// A serialized picture, read back by copying or played in place from memory,
+// must draw what the original does. So must a copy of the in-place picture,
+// after the picture and its stream are gone.
+static void test_memory_stream(skiatest::Reporter* reporter) {
+    SkPicture inner, pict;
+    record_inner(&inner);
+    record(&pict, &inner);
+
+    SkBitmap expected;
+    skiatest::MakeBitmap(&expected, kSize, kSize);
+    SkCanvas(expected).drawPicture(pict);
+
+    SkDynamicMemoryWStream wstream;
+    pict.serialize(&wstream);
+    size_t size = wstream.getOffset();
+    void* data = sk_malloc_throw(size);
+    wstream.copyTo(data);
+
+    SkMemoryStream copyStream(data, size);
+    SkPicture copied(&copyStream);
+    REPORTER_ASSERT(reporter, copyStream.peek() == size);
+    REPORTER_ASSERT(reporter, draws_same(expected, &copied));
+
+    SkMemoryStream* stream = SkNEW(SkMemoryStream);
+    stream->setMemoryOwned(data, size);
+    SkPicture* loaded = SkPicture::CreateFromMemoryStream(stream);
+    REPORTER_ASSERT(reporter, stream->peek() == size);
+    stream->unref();
+    REPORTER_ASSERT(reporter, draws_same(expected, loaded));
+
+    SkPicture copy(*loaded);
+    loaded->unref();
+    REPORTER_ASSERT(reporter, draws_same(expected, &copy));
+}
+
+// Built-in effects are serialized by their ID, not their name, and must come
+// back as the same effects.
+static void test_factory_ids(skiatest::Reporter* reporter) {
+    SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kSize), 0 } };
+    SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkShader* shader = SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                      SkShader::kClamp_TileMode);
+    SkPathEffect* effect = new SkCornerPathEffect(SkIntToScalar(5));
+
+    SkFlattenable::Factory factory = shader->getFactory();
+    uint32_t id = SkFlattenable::FactoryToID(factory);
+    REPORTER_ASSERT(reporter, id != 0);
+    REPORTER_ASSERT(reporter, SkFlattenable::IDToFactory(id) == factory);
+    const char* name = SkFlattenable::FactoryToName(factory);
+    REPORTER_ASSERT(reporter, !strcmp(name, "Linear_Gradient"));
+    REPORTER_ASSERT(reporter, SkFlattenable::NameToFactory(name) == factory);
+    REPORTER_ASSERT(reporter, NULL == SkFlattenable::NameToFactory("NoSuch"));
+    REPORTER_ASSERT(reporter, NULL == SkFlattenable::IDToFactory(0));
+
+    SkPicture pict;
+    SkCanvas* canvas = pict.beginRecording(kSize, kSize);
+    SkPaint paint;
+    paint.setShader(shader)->unref();
+    paint.setPathEffect(effect)->unref();
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(3));
+    canvas->drawRect(SkRect::MakeWH(SkIntToScalar(40), SkIntToScalar(50)),
+                     paint);
+    pict.endRecording();
+
+    SkBitmap expected;
+    skiatest::MakeBitmap(&expected, kSize, kSize);
+    SkCanvas(expected).drawPicture(pict);
+
+    SkDynamicMemoryWStream wstream;
+    pict.serialize(&wstream);
+    size_t size = wstream.getOffset();
+    SkAutoMalloc storage(size);
+    wstream.copyTo(storage.get());
+
+    bool hasName = false;
+    for (size_t i = 0; i + strlen(name) <= size; i++) {
+        hasName |= !memcmp((const char*)storage.get() + i, name, strlen(name));
+    }
+    REPORTER_ASSERT(reporter, !hasName);
+
+    SkMemoryStream stream(storage.get(), size);
+    SkPicture copied(&stream);
+    REPORTER_ASSERT(reporter, draws_same(expected, &copied));
+}
+
+namespace {
+
+// counts the calls a picture makes when it is drawn
+class CountingCanvas : public SkCanvas {
+public:
+    CountingCanvas(const SkBitmap& bm) : SkCanvas(bm), fCount(0) {}
+
+    virtual int save(SaveFlags flags) {
+        fCount += 1;
+        return this->INHERITED::save(flags);
+    }
+    virtual int saveLayer(const SkRect* bounds, const SkPaint* paint,
+                          SaveFlags flags) {
+        fCount += 1;
+        return this->INHERITED::saveLayer(bounds, paint, flags);
+    }
+    virtual void restore() {
+        fCount += 1;
+        this->INHERITED::restore();
+    }
+    virtual bool translate(SkScalar dx, SkScalar dy) {
+        fCount += 1;
+        return this->INHERITED::translate(dx, dy);
+    }
+    virtual bool scale(SkScalar sx, SkScalar sy) {
+        fCount += 1;
+        return this->INHERITED::scale(sx, sy);
+    }
+    virtual bool rotate(SkScalar degrees) {
+        fCount += 1;
+        return this->INHERITED::rotate(degrees);
+    }
+    virtual bool clipRect(const SkRect& rect, SkRegion::Op op) {
+        fCount += 1;
+        return this->INHERITED::clipRect(rect, op);
+    }
+    virtual void drawRect(const SkRect& rect, const SkPaint& paint) {
+        fCount += 1;
+        this->INHERITED::drawRect(rect, paint);
+    }
+    virtual void drawPath(const SkPath& path, const SkPaint& paint) {
+        fCount += 1;
+        this->INHERITED::drawPath(path, paint);
+    }
+
+    int fCount;
+
+private:
+    typedef SkCanvas INHERITED;
+};
+
+}
+
+// records 15 calls that kOptimizeOps_RecordingFlag should drop or merge
+static void record_redundant(SkPicture* pict, uint32_t flags) {
+    SkCanvas* canvas = pict->beginRecording(kSize, kSize, flags);
+    SkRect r = SkRect::MakeLTRB(SkIntToScalar(4), SkIntToScalar(6),
+                                SkIntToScalar(50), SkIntToScalar(60));
+    SkPaint paint;
+    paint.setColor(0x80FF4020);
+
+    // empty blocks, and no-op matrix changes
+    canvas->save();
+    canvas->restore();
+    canvas->save();
+    canvas->translate(SkIntToScalar(5), SkIntToScalar(5));
+    canvas->clipRect(r);
+    canvas->restore();
+    canvas->translate(0, 0);
+    canvas->scale(SK_Scalar1, SK_Scalar1);
+
+    // a rotate that nothing sees
+    canvas->save();
+    canvas->translate(SkIntToScalar(3), SkIntToScalar(4));
+    canvas->drawRect(r, paint);
+    canvas->rotate(SkIntToScalar(10));
+    canvas->restore();
+
+    // a clip containing the last one
+    canvas->clipRect(r);
+    canvas->drawRect(r, paint);
+    canvas->clipRect(SkRect::MakeWH(SkIntToScalar(kSize),
+                                    SkIntToScalar(kSize)));
+
+    // a layer around one opaque draw, and one around a translucent draw
+    SkPaint opaque;
+    opaque.setAntiAlias(true);
+    opaque.setColor(0xFF2040C0);
+    SkPath path;
+    path.addCircle(SkIntToScalar(20), SkIntToScalar(30), SkIntToScalar(15));
+    canvas->saveLayer(NULL, NULL);
+    canvas->drawPath(path, opaque);
+    canvas->restore();
+    canvas->saveLayerAlpha(NULL, 0x80);
+    canvas->drawPath(path, opaque);
+    canvas->restore();
+
+    // a row of abutting (scaled) rects, which merge into one, then a rotated
+    // row that must not merge, and antialiased ones
+    canvas->save();
+    canvas->scale(SkIntToScalar(3) / 2, SkIntToScalar(3) / 2);
+    for (int i = 0; i < 4; i++) {
+        SkScalar x = SkIntToScalar(10 * i) + SK_Scalar1 / 4;
+        canvas->drawRect(SkRect::MakeLTRB(x, SkIntToScalar(20),
+                                          x + SkIntToScalar(10),
+                                          SkIntToScalar(27) + SK_Scalar1 / 2),
+                         paint);
+    }
+    canvas->restore();
+    canvas->rotate(SkIntToScalar(7));
+    for (int i = 0; i < 4; i++) {
+        SkScalar x = SkIntToScalar(10 * i) + SK_Scalar1 / 4;
+        canvas->drawRect(SkRect::MakeLTRB(x, SkIntToScalar(30),
+                                          x + SkIntToScalar(10),
+                                          SkIntToScalar(37) + SK_Scalar1 / 2),
+                         paint);
+    }
+    paint.setAntiAlias(true);
+    canvas->drawRect(SkRect::MakeLTRB(SkIntToScalar(5), SkIntToScalar(40),
+                                      SkIntToScalar(15) + SK_Scalar1 / 3,
+                                      SkIntToScalar(50)), paint);
+    canvas->drawRect(SkRect::MakeLTRB(SkIntToScalar(15) + SK_Scalar1 / 3,
+                                      SkIntToScalar(40), SkIntToScalar(25),
+                                      SkIntToScalar(50)), paint);
+    pict->endRecording();
+}
+
+// An optimized picture must draw exactly what an unoptimized one does, with
+// fewer calls, and say how many it saved.
+static void test_optimize(skiatest::Reporter* reporter) {
+    SkPicture plain, optimized;
+    record_redundant(&plain, 0);
+    record_redundant(&optimized, SkPicture::kOptimizeOps_RecordingFlag);
+
+    int removed;
+    int count = plain.getRecordedOpCount(&removed);
+    REPORTER_ASSERT(reporter, 0 == removed);
+    REPORTER_ASSERT(reporter, count == optimized.getRecordedOpCount(&removed));
+    REPORTER_ASSERT(reporter, 15 == removed);
+
+    SkBitmap expected;
+    skiatest::MakeBitmap(&expected, kSize, kSize);
+    CountingCanvas plainCanvas(expected);
+    plain.draw(&plainCanvas);
+    REPORTER_ASSERT(reporter, draws_same(expected, &optimized));
+
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, kSize, kSize);
+    CountingCanvas optimizedCanvas(bm);
+    optimized.draw(&optimizedCanvas);
+    REPORTER_ASSERT(reporter,
+                    plainCanvas.fCount - optimizedCanvas.fCount == removed);
+}
+
+static SkFlattenable* first_factory(SkFlattenableReadBuffer&) {
+    return NULL;
+}
+
+static SkFlattenable* second_factory(SkFlattenableReadBuffer&) {
+    return NULL;
+}
+
+// Registering a name or a factory again replaces it, for every lookup.
+static void test_factory_reregister(skiatest::Reporter* reporter) {
+    SkFlattenable::Register("PictureTest_Name", first_factory);
+    SkFlattenable::Register("PictureTest_Name", second_factory);
+    REPORTER_ASSERT(reporter,
+        SkFlattenable::NameToFactory("PictureTest_Name") == second_factory);
+    REPORTER_ASSERT(reporter, !strcmp("PictureTest_Name",
+                                SkFlattenable::FactoryToName(first_factory)));
+
+    SkFlattenable::Register("PictureTest_OtherName", first_factory);
+    REPORTER_ASSERT(reporter, !strcmp("PictureTest_OtherName",
+                                SkFlattenable::FactoryToName(first_factory)));
+    REPORTER_ASSERT(reporter,
+        SkFlattenable::NameToFactory("PictureTest_Name") == second_factory);
+
+    // a built-in name resolves the same way by name and by ID
+    SkPathEffect* effect = new SkCornerPathEffect(SK_Scalar1);
+    SkFlattenable::Factory builtin = effect->getFactory();
+    effect->unref();
+    const char* name = SkFlattenable::FactoryToName(builtin);
+    uint32_t id = SkFlattenable::FactoryToID(builtin);
+    REPORTER_ASSERT(reporter, name && id != 0);
+    if (NULL == name || 0 == id) {
+        return;
+    }
+    SkFlattenable::Register(name, first_factory);
+    REPORTER_ASSERT(reporter, SkFlattenable::NameToFactory(name) == first_factory);
+    REPORTER_ASSERT(reporter, SkFlattenable::IDToFactory(id) == first_factory);
+    REPORTER_ASSERT(reporter, SkFlattenable::FactoryToID(first_factory) == id);
+    SkFlattenable::Register(name, builtin);
+    REPORTER_ASSERT(reporter, SkFlattenable::NameToFactory(name) == builtin);
+    REPORTER_ASSERT(reporter, SkFlattenable::IDToFactory(id) == builtin);
+}
+
+static void TestPicture(skiatest::Reporter* reporter) {
+    test_concurrent_draw(reporter);
+    test_abort(reporter);
+    test_memory_stream(reporter);
+    test_factory_ids(reporter);
+    test_factory_reregister(reporter);
+    test_optimize(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Picture", PictureTestClass, TestPicture)
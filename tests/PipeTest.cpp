@@ -0,0 +1,151 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkGPipe.h"
+#include "SkPaint.h"
+
+static const int kSize = 64;
+
+namespace {
+
+// collects everything the writer notifies into one contiguous stream
+class MemoryController : public SkGPipeController {
+public:
+    MemoryController() : fBlock(NULL), fOffset(0) {}
+    virtual ~MemoryController() { sk_free(fBlock); }
+
+    virtual void* requestBlock(size_t minRequest, size_t* actual) {
+        sk_free(fBlock);
+        fBlock = (char*)sk_malloc_throw(minRequest);
+        fOffset = 0;
+        *actual = minRequest;
+        return fBlock;
+    }
+
+    virtual void notifyWritten(size_t bytes) {
+        memcpy(fData.append(bytes), fBlock + fOffset, bytes);
+        fOffset += bytes;
+    }
+
+    SkTDArray<char> fData;
+
+private:
+    char*   fBlock;
+    size_t  fOffset;
+};
+
+// stands in for a shared memory segment, mapped by both writer and reader
+class HeapSharedMemory : public SkGPipeSharedMemory {
+public:
+    HeapSharedMemory(size_t size) : fUsed(0), fSize(size), fAllocCount(0) {
+        fBase = (char*)sk_malloc_throw(size);
+    }
+    virtual ~HeapSharedMemory() { sk_free(fBase); }
+
+    virtual void* alloc(size_t size, uint32_t* handle) {
+        if (fUsed + size > fSize) {
+            return NULL;
+        }
+        fAllocCount += 1;
+        *handle = fUsed + 1;
+        fUsed += size;
+        return fBase + *handle - 1;
+    }
+
+    virtual void* lookup(uint32_t handle) {
+        return handle && handle <= fUsed ? fBase + handle - 1 : NULL;
+    }
+
+    int allocCount() const { return fAllocCount; }
+
+private:
+    char*   fBase;
+    size_t  fUsed;
+    size_t  fSize;
+    int     fAllocCount;
+};
+
+}
+
+static void draw_bitmaps(SkCanvas* canvas, const SkBitmap& bm) {
+    SkPaint paint;
+    paint.setAlpha(0x80);
+    canvas->drawBitmap(bm, SkIntToScalar(3), SkIntToScalar(5), NULL);
+    canvas->drawBitmap(bm, SkIntToScalar(20), SkIntToScalar(9), &paint);
+
+    SkIRect src = { 2, 2, 10, 12 };
+    SkRect dst = SkRect::MakeXYWH(SkIntToScalar(30), SkIntToScalar(30),
+                                  SkIntToScalar(20), SkIntToScalar(25));
+    canvas->drawBitmapRect(bm, &src, dst, NULL);
+
+    SkMatrix matrix;
+    matrix.setRotate(SkIntToScalar(30));
+    matrix.postTranslate(SkIntToScalar(40), 0);
+    canvas->drawBitmapMatrix(bm, matrix, &paint);
+    canvas->drawSprite(bm, 7, 40, NULL);
+}
+
+// Draws through a pipe, returning the size of the pipe's data.
+static size_t draw_through_pipe(SkGPipeWriter* writer,
+                                SkGPipeSharedMemory* memory,
+                                const SkBitmap& bm, SkBitmap* dst) {
+    MemoryController controller;
+    draw_bitmaps(writer->startRecording(&controller,
+                                        SkGPipeWriter::kCrossProcess_Flag,
+                                        memory), bm);
+    writer->endRecording();
+
+    SkCanvas canvas(*dst);
+    SkGPipeReader reader(&canvas);
+    reader.setSharedMemory(memory);
+    reader.playback(controller.fData.begin(), controller.fData.count());
+    return controller.fData.count();
+}
+
+static void TestPipe(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, 16, 16);
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            *bm.getAddr32(x, y) = SkPackARGB32(0xFF, x * 16, y * 16, 0x80);
+        }
+    }
+
+    SkBitmap expected;
+    skiatest::MakeBitmap(&expected, kSize, kSize);
+    SkCanvas canvas(expected);
+    draw_bitmaps(&canvas, bm);
+
+    // the pixels are copied into the pipe (once)
+    SkGPipeWriter writer;
+    SkBitmap copied;
+    skiatest::MakeBitmap(&copied, kSize, kSize);
+    size_t copiedSize = draw_through_pipe(&writer, NULL, bm, &copied);
+    REPORTER_ASSERT(reporter, skiatest::SamePixels(expected, copied));
+    REPORTER_ASSERT(reporter, copiedSize > bm.getSize());
+
+    // the pixels are copied into shared memory, once across recordings
+    HeapSharedMemory* memory = new HeapSharedMemory(64 * 1024);
+    for (int i = 0; i < 2; i++) {
+        SkBitmap shared;
+        skiatest::MakeBitmap(&shared, kSize, kSize);
+        size_t sharedSize = draw_through_pipe(&writer, memory, bm, &shared);
+        REPORTER_ASSERT(reporter, skiatest::SamePixels(expected, shared));
+        REPORTER_ASSERT(reporter, sharedSize < bm.getSize());
+        REPORTER_ASSERT(reporter, 1 == memory->allocCount());
+    }
+
+    // new pixels need new shared memory
+    bm.notifyPixelsChanged();
+    SkBitmap shared;
+    skiatest::MakeBitmap(&shared, kSize, kSize);
+    draw_through_pipe(&writer, memory, bm, &shared);
+    REPORTER_ASSERT(reporter, skiatest::SamePixels(expected, shared));
+    REPORTER_ASSERT(reporter, 2 == memory->allocCount());
+    memory->unref();
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Pipe", PipeTestClass, TestPipe)
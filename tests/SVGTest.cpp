@@ -0,0 +1,177 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkSVG.h"
+#include "SkSVGParser.h"
+#include "SkXMLParser.h"
+
+static const int kSize = 100;
+
+static const char gShapes[] =
+    "<svg width='100' height='100' viewBox='0 0 50 50'>"
+    "<g fill='#FF0000' transform='translate(5,5)'>"
+    "<rect x='0' y='0' width='10' height='10' />"
+    "<circle cx='25' cy='10' r='5' fill='blue' stroke='#00FF00' stroke-width='2' />"
+    "</g>"
+    "<path d='M5,30 L20,30 L20,45 z' style='fill:#000080;opacity:0.5' />"
+    "</svg>";
+
+static void draw_shapes(SkCanvas* canvas) {
+    canvas->scale(SkIntToScalar(2), SkIntToScalar(2));
+    canvas->translate(SkIntToScalar(5), SkIntToScalar(5));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    SkPath path;
+    path.addRect(0, 0, SkIntToScalar(10), SkIntToScalar(10));
+    canvas->drawPath(path, paint);
+    path.reset();
+    path.addCircle(SkIntToScalar(25), SkIntToScalar(10), SkIntToScalar(5));
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawPath(path, paint);
+    paint.setColor(SK_ColorGREEN);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(2));
+    paint.setStrokeMiter(SkIntToScalar(4));
+    canvas->drawPath(path, paint);
+    canvas->translate(SkIntToScalar(-5), SkIntToScalar(-5));
+    path.reset();
+    path.moveTo(SkIntToScalar(5), SkIntToScalar(30));
+    path.lineTo(SkIntToScalar(20), SkIntToScalar(30));
+    path.lineTo(SkIntToScalar(20), SkIntToScalar(45));
+    path.close();
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(0xFF000080);
+    paint.setAlpha(0x80);
+    canvas->drawPath(path, paint);
+}
+
+static void test_shapes(skiatest::Reporter* reporter) {
+    SkPicture* picture = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    REPORTER_ASSERT(reporter, picture);
+    if (NULL == picture) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, kSize == picture->width());
+    REPORTER_ASSERT(reporter, kSize == picture->height());
+
+    SkBitmap svg, expected;
+    skiatest::MakeBitmap(&svg, kSize, kSize, SK_ColorWHITE);
+    skiatest::MakeBitmap(&expected, kSize, kSize, SK_ColorWHITE);
+    SkCanvas svgCanvas(svg);
+    picture->draw(&svgCanvas);
+    SkCanvas expectedCanvas(expected);
+    draw_shapes(&expectedCanvas);
+    REPORTER_ASSERT(reporter, skiatest::SamePixels(svg, expected));
+    picture->unref();
+}
+
+static const char gRefs[] =
+    "<svg width='60' height='40'>"
+    "<defs>"
+    "<linearGradient id='grad' x1='0' y1='0' x2='20' y2='0' gradientUnits='userSpaceOnUse'>"
+    "<stop offset='0' stop-color='#FF0000' />"
+    "<stop offset='100%' stop-color='#0000FF' />"
+    "</linearGradient>"
+    "<rect id='box' width='20' height='20' />"
+    "<clipPath id='clip'><rect width='60' height='10' /></clipPath>"
+    "</defs>"
+    "<use xlink:href='#box' x='5' y='5' fill='url(#grad)' />"
+    "<polygon points='40,5 55,5 55,20' fill='black' clip-path='url(#clip)' />"
+    "<line x1='0' y1='35' x2='60' y2='35' stroke='black' stroke-dasharray='4' />"
+    "<use xlink:href='#self' id='self' />"
+    "</svg>";
+
+static void test_references(skiatest::Reporter* reporter) {
+    SkPicture* picture = SkSVG::DecodeMemory(gRefs, sizeof(gRefs) - 1);
+    REPORTER_ASSERT(reporter, picture);
+    if (NULL == picture) {
+        return;
+    }
+    SkBitmap bm;
+    skiatest::MakeBitmap(&bm, kSize, kSize, SK_ColorWHITE);
+    SkCanvas canvas(bm);
+    picture->draw(&canvas);
+    SkAutoLockPixels alp(bm);
+    // the gradient runs from red (left) to blue
+    SkColor left = bm.getColor(6, 10);
+    SkColor right = bm.getColor(23, 10);
+    REPORTER_ASSERT(reporter, SkColorGetR(left) > SkColorGetB(left));
+    REPORTER_ASSERT(reporter, SkColorGetB(right) > SkColorGetR(right));
+    // defs are only drawn where they are used
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bm.getColor(2, 2));
+    // the polygon is clipped to the top 10 rows
+    REPORTER_ASSERT(reporter, SK_ColorBLACK == bm.getColor(54, 7));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bm.getColor(54, 15));
+    // the line is dashed
+    REPORTER_ASSERT(reporter, SK_ColorWHITE != bm.getColor(1, 35));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bm.getColor(5, 35));
+    picture->unref();
+}
+
+static void test_cache(skiatest::Reporter* reporter) {
+    SkSVG::PurgeCache();
+    SkPicture* first = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    SkPicture* second = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    REPORTER_ASSERT(reporter, first && first == second);
+    SkPicture* other = SkSVG::DecodeMemory(gRefs, sizeof(gRefs) - 1);
+    REPORTER_ASSERT(reporter, other && other != first);
+
+    // a limit of one drops the least recently loaded
+    int limit = SkSVG::SetCacheCountLimit(1);
+    SkPicture* third = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    REPORTER_ASSERT(reporter, third != first);
+
+    SkSVG::PurgeCache();
+    SkPicture* fourth = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    REPORTER_ASSERT(reporter, fourth != third);
+
+    SkSVG::SetCacheCountLimit(0);
+    SkPicture* fifth = SkSVG::DecodeMemory(gShapes, sizeof(gShapes) - 1);
+    REPORTER_ASSERT(reporter, fifth != fourth);
+    REPORTER_ASSERT(reporter, 0 == SkSVG::SetCacheCountLimit(limit));
+
+    SkPicture* pictures[] = { first, second, other, third, fourth, fifth };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(pictures); i++) {
+        SkSafeUnref(pictures[i]);
+    }
+
+    SkXMLParserError error;
+    static const char gBad[] = "<svg><rect></svg>";
+    REPORTER_ASSERT(reporter, NULL == SkSVG::DecodeMemory(gBad, sizeof(gBad) - 1,
+                                                         &error));
+    REPORTER_ASSERT(reporter, error.hasError());
+}
+
+static void test_transforms(skiatest::Reporter* reporter) {
+    SkMatrix matrix, expected;
+    REPORTER_ASSERT(reporter, SkSVGParser::ParseTransform(
+            "translate(10, 20) scale(2) rotate(90)", &matrix));
+    expected.setTranslate(SkIntToScalar(10), SkIntToScalar(20));
+    expected.preScale(SkIntToScalar(2), SkIntToScalar(2));
+    expected.preRotate(SkIntToScalar(90));
+    REPORTER_ASSERT(reporter, matrix == expected);
+
+    REPORTER_ASSERT(reporter, SkSVGParser::ParseTransform("matrix(1 0 0 1 3 4)",
+                                                          &matrix));
+    expected.setTranslate(SkIntToScalar(3), SkIntToScalar(4));
+    REPORTER_ASSERT(reporter, matrix == expected);
+
+    REPORTER_ASSERT(reporter, !SkSVGParser::ParseTransform("shear(2)", &matrix));
+    REPORTER_ASSERT(reporter, !SkSVGParser::ParseTransform("scale(1,2,3)", &matrix));
+}
+
+static void TestSVG(skiatest::Reporter* reporter) {
+    test_transforms(reporter);
+    test_shapes(reporter);
+    test_references(reporter);
+    test_cache(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("SVG", SVGTestClass, TestSVG)
@@ -0,0 +1,15 @@
+#include "TestBitmap.h"
+
+void skiatest::MakeBitmap(SkBitmap* bm, int width, int height, SkColor color) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, width, height);
+    bm->allocPixels();
+    bm->eraseColor(color);
+}
+
+bool skiatest::SamePixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alp0(a);
+    SkAutoLockPixels alp1(b);
+    return a.width() == b.width() && a.height() == b.height() &&
+           a.getSize() == b.getSize() &&
+           !memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
@@ -0,0 +1,18 @@
+#ifndef skiatest_TestBitmap_DEFINED
+#define skiatest_TestBitmap_DEFINED
+
+#include "SkBitmap.h"
+#include "SkColor.h"
+
+namespace skiatest {
+    /** Allocates bm as a width x height ARGB_8888 bitmap, erased to color.
+     */
+    void MakeBitmap(SkBitmap* bm, int width, int height, SkColor color = 0);
+
+    /** Returns true if a and b have the same dimensions and their pixel
+        memory matches byte for byte.
+     */
+    bool SamePixels(const SkBitmap& a, const SkBitmap& b);
+}
+
+#endif
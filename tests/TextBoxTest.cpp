@@ -0,0 +1,206 @@
+#include "Test.h"
+#include "TestBitmap.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkTextBox.h"
+
+static const char gText[] =
+    "The quick brown fox jumps over the lazy dog. Pack my box with "
+    "five dozen liquor jugs.   Sphinx of black quartz, judge my vow! "
+    "Antidisestablishmentarianism";
+
+static const int kWidth = 120;
+static const int kHeight = 160;
+
+static bool is_blank(const SkBitmap& bm) {
+    SkAutoLockPixels alp(bm);
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            if (*bm.getAddr32(x, y) != SK_ColorWHITE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool is_ws(char c) {
+    return c == ' ';
+}
+
+static void test_breaks(skiatest::Reporter* reporter, const SkPaint& paint,
+                        SkScalar width) {
+    SkTextLines* lines = SkTextLines::Find(gText, sizeof(gText) - 1, paint, width);
+    int count = lines->countLines();
+    REPORTER_ASSERT(reporter, count > 1);
+    REPORTER_ASSERT(reporter, count == SkTextLineBreaker::CountLines(
+                                            gText, sizeof(gText) - 1, paint, width));
+
+    // the lines cover the text, each one as long as fits
+    const char* expected = gText;
+    for (int i = 0; i < count; i++) {
+        size_t length;
+        const char* text = lines->getLineText(i, &length);
+        REPORTER_ASSERT(reporter, text && !memcmp(text, expected, length));
+        expected += length;
+
+        SkScalar lineWidth = lines->getLineWidth(i);
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(lineWidth,
+                                                paint.measureText(text, length)));
+        size_t trimmed = length;
+        while (trimmed > 0 && is_ws(text[trimmed - 1])) {
+            trimmed -= 1;
+        }
+        bool oneWord = true;
+        for (size_t j = 0; j < trimmed; j++) {
+            oneWord &= !is_ws(text[j]);
+        }
+        REPORTER_ASSERT(reporter, oneWord ||
+                                  paint.measureText(text, trimmed) <= width);
+        if (i < count - 1 && !oneWord) {
+            // the next word would not have fit
+            const char* next = text + length;
+            size_t nextLength = 0;
+            while (next[nextLength] && !is_ws(next[nextLength])) {
+                nextLength += 1;
+            }
+            REPORTER_ASSERT(reporter, paint.measureText(text, next - text + nextLength)
+                                      > width);
+        }
+    }
+    REPORTER_ASSERT(reporter, gText + sizeof(gText) - 1 == expected);
+
+    // drawing a line matches drawing its text
+    static const SkPaint::Align gAligns[] = {
+        SkPaint::kLeft_Align, SkPaint::kCenter_Align, SkPaint::kRight_Align
+    };
+    for (size_t a = 0; a < SK_ARRAY_COUNT(gAligns); a++) {
+        SkPaint alignPaint(paint);
+        alignPaint.setTextAlign(gAligns[a]);
+        SkBitmap linesBM, textBM;
+        skiatest::MakeBitmap(&linesBM, kWidth, kHeight, SK_ColorWHITE);
+        skiatest::MakeBitmap(&textBM, kWidth, kHeight, SK_ColorWHITE);
+        SkCanvas linesCanvas(linesBM);
+        SkCanvas textCanvas(textBM);
+        SkScalar x = SkIntToScalar(kWidth / 2);
+        for (int i = 0; i < count; i++) {
+            SkScalar y = SkIntToScalar(15 * (i + 1));
+            size_t length;
+            const char* text = lines->getLineText(i, &length);
+            lines->drawLine(&linesCanvas, i, x, y, alignPaint);
+            textCanvas.drawText(text, length, x, y, alignPaint);
+        }
+        REPORTER_ASSERT(reporter, !is_blank(linesBM));
+        REPORTER_ASSERT(reporter, skiatest::SamePixels(linesBM, textBM));
+    }
+    lines->unref();
+}
+
+static void test_cache(skiatest::Reporter* reporter, const SkPaint& paint) {
+    SkTextLines::PurgeCache();
+    SkScalar width = SkIntToScalar(100);
+    SkTextLines* first = SkTextLines::Find(gText, sizeof(gText) - 1, paint, width);
+    SkTextLines* second = SkTextLines::Find(gText, sizeof(gText) - 1, paint, width);
+    REPORTER_ASSERT(reporter, first == second);
+
+    SkTextLines* narrow = SkTextLines::Find(gText, sizeof(gText) - 1, paint,
+                                            width / 2);
+    REPORTER_ASSERT(reporter, narrow != first);
+    SkPaint bigger(paint);
+    bigger.setTextSize(paint.getTextSize() * 2);
+    SkTextLines* big = SkTextLines::Find(gText, sizeof(gText) - 1, bigger, width);
+    REPORTER_ASSERT(reporter, big != first);
+    REPORTER_ASSERT(reporter, big->countLines() > first->countLines());
+    // a copy of the text finds the same lines
+    SkString copy(gText);
+    SkTextLines* third = SkTextLines::Find(copy.c_str(), copy.size(), paint, width);
+    REPORTER_ASSERT(reporter, third == first);
+
+    size_t budget = SkTextLines::SetCacheBudget(0);
+    SkTextLines* uncached = SkTextLines::Find(gText, sizeof(gText) - 1, paint, width);
+    REPORTER_ASSERT(reporter, uncached != first);
+    REPORTER_ASSERT(reporter, uncached->getRefCnt() == 1);
+    REPORTER_ASSERT(reporter, uncached->countLines() == first->countLines());
+    REPORTER_ASSERT(reporter, 0 == SkTextLines::SetCacheBudget(budget));
+
+    SkTextLines* all[] = { first, second, narrow, big, third, uncached };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(all); i++) {
+        all[i]->unref();
+    }
+}
+
+static void test_textbox(skiatest::Reporter* reporter, const SkPaint& paint) {
+    SkTextBox box;
+    box.setBox(0, 0, SkIntToScalar(kWidth), SkIntToScalar(kHeight));
+    box.setSpacingAlign(SkTextBox::kCenter_SpacingAlign);
+
+    SkBitmap boxBM, linesBM;
+    skiatest::MakeBitmap(&boxBM, kWidth, kHeight, SK_ColorWHITE);
+    skiatest::MakeBitmap(&linesBM, kWidth, kHeight, SK_ColorWHITE);
+    SkCanvas boxCanvas(boxBM);
+    box.draw(&boxCanvas, gText, sizeof(gText) - 1, paint);
+
+    SkCanvas linesCanvas(linesBM);
+    SkTextLines* lines = SkTextLines::Find(gText, sizeof(gText) - 1, paint,
+                                           SkIntToScalar(kWidth));
+    SkPaint::FontMetrics metrics;
+    SkScalar spacing = paint.getFontMetrics(&metrics);
+    SkScalar y = SkScalarHalf(SkIntToScalar(kHeight) -
+                              spacing * lines->countLines()) - metrics.fAscent;
+    for (int i = 0; i < lines->countLines(); i++) {
+        lines->drawLine(&linesCanvas, i, 0, y, paint);
+        y += spacing;
+    }
+    lines->unref();
+    REPORTER_ASSERT(reporter, !is_blank(boxBM));
+    REPORTER_ASSERT(reporter, skiatest::SamePixels(boxBM, linesBM));
+}
+
+// the line offsets are measured unscaled, so a scaled or rotated canvas must
+// still draw each line where drawText would
+static void test_transformed(skiatest::Reporter* reporter, const SkPaint& paint) {
+    SkTextLines* lines = SkTextLines::Find(gText, sizeof(gText) - 1, paint,
+                                           SkIntToScalar(kWidth / 2));
+    for (int m = 0; m < 2; m++) {
+        SkBitmap linesBM, textBM;
+        skiatest::MakeBitmap(&linesBM, kWidth, kHeight, SK_ColorWHITE);
+        skiatest::MakeBitmap(&textBM, kWidth, kHeight, SK_ColorWHITE);
+        SkCanvas linesCanvas(linesBM);
+        SkCanvas textCanvas(textBM);
+        SkCanvas* canvases[] = { &linesCanvas, &textCanvas };
+        for (size_t c = 0; c < SK_ARRAY_COUNT(canvases); c++) {
+            if (0 == m) {
+                canvases[c]->scale(SkIntToScalar(3) / 2, SkIntToScalar(3) / 2);
+            } else {
+                canvases[c]->rotate(SkIntToScalar(10));
+            }
+        }
+        for (int i = 0; i < lines->countLines(); i++) {
+            SkScalar x = SkIntToScalar(3);
+            SkScalar y = SkIntToScalar(15 * (i + 1));
+            size_t length;
+            const char* text = lines->getLineText(i, &length);
+            lines->drawLine(&linesCanvas, i, x, y, paint);
+            textCanvas.drawText(text, length, x, y, paint);
+        }
+        REPORTER_ASSERT(reporter, !is_blank(linesBM));
+        REPORTER_ASSERT(reporter, skiatest::SamePixels(linesBM, textBM));
+    }
+    lines->unref();
+}
+
+static void TestTextBox(skiatest::Reporter* reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(SkIntToScalar(12));
+
+    test_breaks(reporter, paint, SkIntToScalar(100));
+    test_breaks(reporter, paint, SkIntToScalar(37));
+    test_cache(reporter, paint);
+    test_textbox(reporter, paint);
+    test_transformed(reporter, paint);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("TextBox", TextBoxTestClass, TestTextBox)
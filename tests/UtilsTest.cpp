@@ -132,6 +132,69 @@ static void test_utf16(skiatest::Reporter* reporter) {
     }
 }
 
+static size_t count_ascii(const char utf8[], size_t byteLength) {
+    size_t i = 0;
+    while (i < byteLength && !(utf8[i] & 0x80)) {
+        i += 1;
+    }
+    return i;
+}
+
+static int count_bmp(const uint16_t utf16[], int count) {
+    int i = 0;
+    while (i < count && !SkUTF16_IsHighSurrogate(utf16[i]) &&
+           !SkUTF16_IsLowSurrogate(utf16[i])) {
+        i += 1;
+    }
+    return i;
+}
+
+// mostly ascii text, with the odd 2, 3 and 4 byte character thrown in
+static void test_runs(skiatest::Reporter* reporter) {
+    static const SkUnichar gUni[] = { 0xE9, 0x4E2D, 0xD7FF, 0xE000, 0x1F600 };
+
+    SkRandom    rand;
+    char        utf8[200];
+    uint16_t    utf16[100];
+
+    for (int trial = 0; trial < 50; trial++) {
+        size_t  length8 = 0;
+        int     length16 = 0;
+        int     count = 0;
+        while (length8 + kMaxBytesInUTF8Sequence <= sizeof(utf8) &&
+               length16 + 2 <= (int)SK_ARRAY_COUNT(utf16)) {
+            SkUnichar uni = (rand.nextU() % 23) ? 'a' + (rand.nextU() % 26) :
+                                gUni[rand.nextU() % SK_ARRAY_COUNT(gUni)];
+            length8 += SkUTF8_FromUnichar(uni, utf8 + length8);
+            length16 += SkUTF16_FromUnichar(uni, utf16 + length16);
+            count += 1;
+        }
+        REPORTER_ASSERT(reporter, SkUTF8_CountUnichars(utf8, length8) == count);
+        REPORTER_ASSERT(reporter,
+                        SkUTF16_CountUnichars(utf16, length16) == count);
+
+        // every start (so every alignment) and length
+        for (size_t start = 0; start < 20; start++) {
+            for (size_t len = 0; start + len <= length8; len++) {
+                size_t expected = count_ascii(utf8 + start, len);
+                REPORTER_ASSERT(reporter,
+                        SkUTF8_CountASCII(utf8 + start, len) == expected);
+                REPORTER_ASSERT(reporter,
+                        SkUTF8_CountASCII_portable(utf8 + start, len) == expected);
+            }
+        }
+        for (int start = 0; start < 20; start++) {
+            for (int len = 0; start + len <= length16; len++) {
+                int expected = count_bmp(utf16 + start, len);
+                REPORTER_ASSERT(reporter,
+                        SkUTF16_CountBMP(utf16 + start, len) == expected);
+                REPORTER_ASSERT(reporter,
+                        SkUTF16_CountBMP_portable(utf16 + start, len) == expected);
+            }
+        }
+    }
+}
+
 static void TestUTF(skiatest::Reporter* reporter) {
     static const struct {
         const char* fUtf8;
@@ -164,6 +227,7 @@ static void TestUTF(skiatest::Reporter* reporter) {
     }
 
     test_utf16(reporter);
+    test_runs(reporter);
     test_search(reporter);
     test_refptr(reporter);
     test_autounref(reporter);